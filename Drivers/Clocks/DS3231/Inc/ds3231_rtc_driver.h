@@ -8,9 +8,9 @@
 typedef enum
 {
     DS3231_STATE_IDLE,
-    DS3231_STATE_POINTER_WRITE_FOR_READ,
     DS3231_STATE_DATA_READ,
     DS3231_STATE_DATA_WRITE,
+    DS3231_STATE_MERGE_READ,        /* month and century share a register; the other half is read back first */
 } DS3231_State_t;
 
 typedef enum
@@ -26,17 +26,14 @@ typedef enum
     DS3231_UNIT_YEAR,
     DS3231_UNIT_FULL_DATE,
     DS3231_UNIT_FULL_TIME,
-    DS3231_UNIT_DATETIME
+    DS3231_UNIT_DATETIME,
+    DS3231_UNIT_ALARM_1,
+    DS3231_UNIT_ALARM_2,
+    DS3231_UNIT_ALARM_CONTROL,      /* control and status together, as an alarm is armed */
+    DS3231_UNIT_ALARM_STATUS,       /* the status flags, as a match is serviced */
+    DS3231_NUM_UNITS
 } DS3231_Unit_t;
 
-typedef struct
-{
-    Clock_Device_t                          *clock_dev;
-    DS3231_State_t                          state;
-    DS3231_Unit_t                           curr_unit;
-    I2C_Interface_t                         *i2c_interface;
-} DS3231_Handle_t;
-
 /* Addresses of every DS3231 internal register */
 #define DS3231_ADDR_BASE                    0x00
 #define DS3231_ADDR_SECONDS                 0x00
@@ -71,13 +68,86 @@ typedef struct
 #define DS3231_LEN_YEAR                     1
 #define DS3231_LEN_FULL_DATE                ((DS3231_LEN_DOW) + (DS3231_LEN_DATE) + (DS3231_LEN_MONTH_CENTURY) + (DS3231_LEN_YEAR))
 #define DS3231_LEN_DATETIME                 ((DS3231_LEN_FULL_DATE) + (DS3231_LEN_FULL_TIME))
+#define DS3231_LEN_ALARM_1                  4
+#define DS3231_LEN_ALARM_2                  3       /* no seconds register */
+#define DS3231_LEN_CONTROL                  1
+#define DS3231_LEN_STATUS                   1
+
+/* One interrupt-based access waiting in the I2C queue. Its transfers run over DMA, straight out of and into
+ * these buffers, so they live in the handle rather than on the caller's stack. The TX buffer has room for the
+ * register pointer in front. A slot is free while its state is DS3231_STATE_IDLE. */
+typedef struct
+{
+    DS3231_State_t                          state;
+    DS3231_Unit_t                           unit;
+    uint8_t                                 merge;      /* the month or century a merge read is carrying */
+    uint8_t                                 tx_buffer[DS3231_PTR_LEN + DS3231_LEN_DATETIME];
+    uint8_t                                 rx_buffer[DS3231_LEN_DATETIME];
+} DS3231_Request_t;
+
+/* Where a unit lives and what follows its interrupt-based access, one per DS3231_Unit_t. A read is decoded
+ * into the clock device before the get callback; a NULL entry is skipped. */
+typedef struct
+{
+    uint8_t                                 addr;
+    uint8_t                                 len;
+    void                                    (*p_decode)(uint8_t *p_rx_buffer);
+    void                                    (*p_get_complete)(Clock_Device_t *clock_dev);
+    void                                    (*p_set_complete)(Clock_Device_t *clock_dev);
+} DS3231_Unit_Desc_t;
+
+typedef struct
+{
+    Clock_Device_t                          *clock_dev;
+    I2C_Interface_t                         *i2c_interface;
+    uint8_t                                 control;    /* as last written; only this driver writes it */
+    uint8_t                                 status;     /* as read at Initialize, for its EN32kHz bit */
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+    GPIO_Handle_t                           int_sqw_gpio_handle;
+#endif
+    DS3231_Request_t                        requests[I2C_QUEUE_SIZE];
+} DS3231_Handle_t;
 
 /* Bit positions for various important settings */
 #define DS3231_AM_PM_BIT                    5
 #define DS3231_12_24_BIT                    6
 #define DS3231_CENTURY_BIT                  7
+#define DS3231_ALARM_MASKED_BIT             7       /* AxMy: this register takes no part in the match */
+#define DS3231_ALARM_DY_DT_BIT              6       /* in the day/date register: 1 matches the day of week */
+#define DS3231_CONTROL_A1IE_BIT             0
+#define DS3231_CONTROL_A2IE_BIT             1
+#define DS3231_CONTROL_INTCN_BIT            2       /* INT/SQW pin: 1 for the alarm interrupts, 0 for the square wave */
+#define DS3231_CONTROL_RS1_BIT              3       /* RS2:RS1 pick the square wave's rate; 00 is 1Hz */
+#define DS3231_CONTROL_RS2_BIT              4
+#define DS3231_STATUS_A1F_BIT               0       /* AxF, like OSF, can only be written to 0 */
+#define DS3231_STATUS_A2F_BIT               1
+#define DS3231_STATUS_EN32KHZ_BIT           3
+#define DS3231_STATUS_OSF_BIT               7
+
+/***** INT/SQW pin *****/
+/* Define DS3231_SQW_WIRED if the chip's INT/SQW pin is connected to DS3231_INT_SQW_GPIO_PIN. Initialize then
+ * sets the pin to a 1Hz square wave and Clock_Tick_Callback() is called on each falling edge, which is when the
+ * chip counts on a second. While an alarm is armed, each tick also reads the alarm flags.
+ *
+ * Define DS3231_INT_WIRED instead to use the pin as the alarm interrupt. It falls when an armed alarm matches,
+ * and stays low until the driver has cleared the flag, so the flags are read only then.
+ *
+ * Either way Clock_Alarm_Callback() follows a match. The pin is open drain; the internal pull-up is enough. */
+/* #define DS3231_SQW_WIRED */
+/* #define DS3231_INT_WIRED */
+
+#if defined(DS3231_SQW_WIRED) && defined(DS3231_INT_WIRED)
+#    error "The INT/SQW pin is either the square wave or the alarm interrupt."
+#endif
+
+#define DS3231_INT_SQW_GPIO_PORT            GPIOB
+#define DS3231_INT_SQW_GPIO_PIN             GPIO_PIN_0
+#define DS3231_INT_SQW_IRQ_NO               IRQ_NO_EXTI0
+#define DS3231_INT_SQW_IRQHandler           EXTI0_IRQHandler    /* the vector for DS3231_INT_SQW_GPIO_PIN's line */
+#define DS3231_INT_SQW_IRQ_PRIORITY         3       /* below the display timer, as the clock cache's own tick */
 
 /* Utilities */
 #define DS3231_SLAVE_ADDR                   0b1101000
+#define DS3231_I2C_INSTANCE                 I2C_INSTANCE_1      /* the bus the RTC is wired to */
 
 #endif /* INC_DS3231_RTC_DRIVER_H_ */
@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "ds3231_rtc_driver.h"
 #include "i2c.h"
@@ -58,6 +59,25 @@ static void DS3231_Set_Full_Date_IT(full_date_t full_date);
 static void DS3231_Set_Full_Time_IT(full_time_t full_time);
 static void DS3231_Set_Full_Datetime_IT(full_datetime_t full_datetime);
 
+/*************** ALARM FUNCTIONS *****************/
+static void DS3231_Set_Alarm(Clock_Alarm_t alarm, alarm_t alarm_time);
+static void DS3231_Set_Alarm_IT(Clock_Alarm_t alarm, alarm_t alarm_time);
+static alarm_t DS3231_Get_Alarm(Clock_Alarm_t alarm);
+static void DS3231_Clear_Alarm(Clock_Alarm_t alarm);
+
+/*************** UNIT DECODERS *****************/
+static void DS3231_Decode_Seconds(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Minutes(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Hours(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Day_Of_Week(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Date(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Month(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Year(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Century(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Full_Date(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Full_Time(uint8_t *p_rx_buffer);
+static void DS3231_Decode_Datetime(uint8_t *p_rx_buffer);
+
 /*************** CONVERSION FUNCTIONS FROM DS3231 REGISTER FORMAT *****************/
 static seconds_t Convert_Seconds_From_DS3231(uint8_t sec_byte);
 static minutes_t Convert_Minutes_From_DS3231(uint8_t min_byte);
@@ -70,6 +90,7 @@ static year_t Convert_Year_From_DS3231(uint8_t year_byte);
 static full_time_t Convert_Full_Time_From_DS3231(uint8_t *p_rx_buffer);
 static full_date_t Convert_Full_Date_From_DS3231(uint8_t *p_rx_buffer);
 static full_datetime_t Convert_Datetime_From_DS3231(uint8_t *p_rx_buffer);
+static alarm_t Convert_Alarm_From_DS3231(Clock_Alarm_t alarm, uint8_t *p_rx_buffer);
 static float Convert_Temp_From_DS3231(uint8_t *p_rx_buffer);
 
 /*************** CONVERSION FUNCTIONS TO DS3231 REGISTER FORMAT *****************/
@@ -83,18 +104,67 @@ static uint8_t Convert_Year_To_DS3231(year_t year);
 static void Convert_Full_Time_To_DS3231(full_time_t full_time, uint8_t *p_tx_buffer);
 static void Convert_Full_Date_To_DS3231(full_date_t full_date, uint8_t *p_tx_buffer);
 static void Convert_Datetime_To_DS3231(full_datetime_t datetime, uint8_t *p_tx_buffer);
+static uint8_t Convert_Alarm_To_DS3231(Clock_Alarm_t alarm, alarm_t alarm_time, uint8_t *p_tx_buffer);
 
 /*************** GENERAL UTILITY FUNCTIONS *****************/
 static void Read_From_DS3231(uint8_t *p_rx_buffer, uint8_t ds3231_addr, uint8_t len);
-static void Read_From_DS3231_IT(DS3231_Unit_t ds3231_unit, uint8_t len);
+static void Read_From_DS3231_IT(DS3231_Unit_t ds3231_unit);
+static void Merge_Into_DS3231_IT(DS3231_Unit_t ds3231_unit, uint8_t value);
+static void DS3231_Queue_Read(DS3231_Request_t *p_request);
 static void Write_To_DS3231(uint8_t *p_tx_buffer, uint8_t ds3231_addr, uint8_t len);
-static void Write_To_DS3231_IT(uint8_t *p_tx_buffer, DS3231_Unit_t ds3231_unit, uint8_t len);
+static uint8_t Write_To_DS3231_IT(DS3231_Unit_t ds3231_unit, const uint8_t *p_data);
+static DS3231_Request_t *DS3231_Claim_Request(DS3231_State_t state, DS3231_Unit_t ds3231_unit);
+static void DS3231_Refuse_Request(DS3231_Request_t *p_request);
+static void DS3231_Merge_Write(DS3231_Unit_t ds3231_unit, uint8_t value, uint8_t month_century_byte);
+static void DS3231_Transaction_Complete(void *p_context, I2C_Status_t status);
 static uint8_t Convert_Binary_To_BCD(uint8_t binary_byte);
 static uint8_t Convert_BCD_To_Binary(uint8_t bcd_byte);
+static void DS3231_Alarm_Control_To_Buffer(Clock_Alarm_t alarm, uint8_t arm, uint8_t *p_tx_buffer);
+static uint8_t DS3231_Status_Clearing(uint8_t flags);
+static uint8_t DS3231_Armed_Flags(void);
+static void DS3231_Alarms_Matched(uint8_t *p_rx_buffer);
+static void DS3231_Alarm_Status_Cleared(Clock_Device_t *clock_dev);
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+static void DS3231_Service_Alarms(void);
+static void DS3231_Init_Int_Sqw_Pin(void);
+#endif
 
 
 static DS3231_Handle_t ds3231_handle;
 
+/* Every interrupt-based access is dispatched from here, by unit. Reads are decoded in place and then the get
+ * callback made; writes only make the set callback. */
+static const DS3231_Unit_Desc_t DS3231_UNITS[DS3231_NUM_UNITS] = {
+        [DS3231_UNIT_SECONDS]       = { DS3231_ADDR_SECONDS, DS3231_LEN_SECONDS, DS3231_Decode_Seconds,
+                                        Clock_Get_Seconds_Complete_Callback, Clock_Set_Seconds_Complete_Callback },
+        [DS3231_UNIT_MINUTES]       = { DS3231_ADDR_MINUTES, DS3231_LEN_MINUTES, DS3231_Decode_Minutes,
+                                        Clock_Get_Minutes_Complete_Callback, Clock_Set_Minutes_Complete_Callback },
+        [DS3231_UNIT_HOURS]         = { DS3231_ADDR_HOURS, DS3231_LEN_HOURS, DS3231_Decode_Hours,
+                                        Clock_Get_Hours_Complete_Callback, Clock_Set_Hours_Complete_Callback },
+        [DS3231_UNIT_DATE]          = { DS3231_ADDR_DATE, DS3231_LEN_DATE, DS3231_Decode_Date,
+                                        Clock_Get_Date_Complete_Callback, Clock_Set_Date_Complete_Callback },
+        [DS3231_UNIT_DOW]           = { DS3231_ADDR_DAY, DS3231_LEN_DOW, DS3231_Decode_Day_Of_Week,
+                                        Clock_Get_Day_Of_Week_Complete_Callback, Clock_Set_Day_Of_Week_Complete_Callback },
+        [DS3231_UNIT_MONTHS]        = { DS3231_ADDR_MONTH_CENTURY, DS3231_LEN_MONTH_CENTURY, DS3231_Decode_Month,
+                                        Clock_Get_Month_Complete_Callback, Clock_Set_Months_Complete_Callback },
+        [DS3231_UNIT_CENTURY]       = { DS3231_ADDR_MONTH_CENTURY, DS3231_LEN_MONTH_CENTURY, DS3231_Decode_Century,
+                                        Clock_Get_Century_Complete_Callback, Clock_Set_Century_Complete_Callback },
+        [DS3231_UNIT_YEAR]          = { DS3231_ADDR_YEAR, DS3231_LEN_YEAR, DS3231_Decode_Year,
+                                        Clock_Get_Year_Complete_Callback, Clock_Set_Years_Complete_Callback },
+        [DS3231_UNIT_FULL_DATE]     = { DS3231_ADDR_DAY, DS3231_LEN_FULL_DATE, DS3231_Decode_Full_Date,
+                                        Clock_Get_Full_Date_Complete_Callback, Clock_Set_Full_Date_Complete_Callback },
+        [DS3231_UNIT_FULL_TIME]     = { DS3231_ADDR_SECONDS, DS3231_LEN_FULL_TIME, DS3231_Decode_Full_Time,
+                                        Clock_Get_Full_Time_Complete_Callback, Clock_Set_Full_Time_Complete_Callback },
+        [DS3231_UNIT_DATETIME]      = { DS3231_ADDR_SECONDS, DS3231_LEN_DATETIME, DS3231_Decode_Datetime,
+                                        Clock_Get_Datetime_Complete_Callback, Clock_Set_Datetime_Complete_Callback },
+        [DS3231_UNIT_ALARM_1]       = { DS3231_ADDR_ALARM_1_SECS, DS3231_LEN_ALARM_1, NULL, NULL, NULL },
+        [DS3231_UNIT_ALARM_2]       = { DS3231_ADDR_ALARM_2_MINS, DS3231_LEN_ALARM_2, NULL, NULL, NULL },
+        [DS3231_UNIT_ALARM_CONTROL] = { DS3231_ADDR_CONTROL, DS3231_LEN_CONTROL + DS3231_LEN_STATUS, NULL,
+                                        NULL, Clock_Set_Alarm_Complete_Callback },
+        [DS3231_UNIT_ALARM_STATUS]  = { DS3231_ADDR_CONTROL_STATUS, DS3231_LEN_STATUS, DS3231_Alarms_Matched,
+                                        NULL, DS3231_Alarm_Status_Cleared },
+};
+
 /* Implements the clock driver interface defined in Inc/clock.h for the DS3231 I2C RTC chip */
 static Clock_Driver_t ds3231_clock_driver = {
         .Initialize                = DS3231_Initialize,
@@ -145,7 +215,12 @@ static Clock_Driver_t ds3231_clock_driver = {
         .Set_Century_IT          = DS3231_Set_Century_IT,
         .Set_Full_Date_IT        = DS3231_Set_Full_Date_IT,
         .Set_Full_Time_IT        = DS3231_Set_Full_Time_IT,
-        .Set_Full_Datetime_IT    = DS3231_Set_Full_Datetime_IT
+        .Set_Full_Datetime_IT    = DS3231_Set_Full_Datetime_IT,
+
+        .Set_Alarm               = DS3231_Set_Alarm,
+        .Set_Alarm_IT            = DS3231_Set_Alarm_IT,
+        .Get_Alarm               = DS3231_Get_Alarm,
+        .Clear_Alarm             = DS3231_Clear_Alarm
 };
 
 Clock_Driver_t *get_clock_driver(void)
@@ -155,182 +230,62 @@ Clock_Driver_t *get_clock_driver(void)
 
 static void DS3231_Initialize(Clock_Device_t *ds3231_dev)
 {
-    ds3231_handle.clock_dev = ds3231_dev;
-    ds3231_handle.state = DS3231_STATE_IDLE;
-    ds3231_handle.curr_unit = DS3231_UNIT_NONE;
-    ds3231_handle.i2c_interface = get_i2c_interface();
-    ds3231_handle.i2c_interface->Initialize();
-}
-
-void I2C_Write_Complete_Callback(I2C_Device_t *p_i2c_dev)
-{
-    uint8_t byte_len;
+    uint8_t p_rx_buffer[DS3231_LEN_CONTROL + DS3231_LEN_STATUS];
 
-    switch (ds3231_handle.state)
+    ds3231_handle.clock_dev = ds3231_dev;
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++)
     {
-        case DS3231_STATE_POINTER_WRITE_FOR_READ:
-            ds3231_handle.state = DS3231_STATE_DATA_READ;
-
-            if (ds3231_handle.curr_unit == DS3231_UNIT_SECONDS)
-            {
-                byte_len = DS3231_LEN_SECONDS;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_MINUTES)
-            {
-                byte_len = DS3231_LEN_MINUTES;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_HOURS)
-            {
-                byte_len = DS3231_LEN_HOURS;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_FULL_TIME)
-            {
-                byte_len = DS3231_LEN_FULL_TIME;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_DOW)
-            {
-                byte_len = DS3231_LEN_DOW;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_DATE)
-            {
-                byte_len = DS3231_LEN_DATE;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_MONTHS)
-            {
-                byte_len = DS3231_LEN_MONTH_CENTURY;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_YEAR)
-            {
-                byte_len = DS3231_LEN_YEAR;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_CENTURY)
-            {
-                byte_len = DS3231_LEN_MONTH_CENTURY;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_FULL_DATE)
-            {
-                byte_len = DS3231_LEN_FULL_DATE;
-            }
-            else if (ds3231_handle.curr_unit == DS3231_UNIT_DATETIME)
-            {
-                byte_len = DS3231_LEN_DATETIME;
-            }
-            ds3231_handle.i2c_interface->Read_Bytes_IT(byte_len,
-                                                       DS3231_SLAVE_ADDR,
-                                                       I2C_DISABLE_SR);
-            break;
-        case DS3231_STATE_DATA_WRITE:
-            ds3231_handle.state = DS3231_STATE_IDLE;
-            switch (ds3231_handle.curr_unit)
-            {
-            case DS3231_UNIT_SECONDS:
-                Clock_Set_Seconds_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_MINUTES:
-                Clock_Set_Minutes_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_HOURS:
-                Clock_Set_Hours_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_DOW:
-                Clock_Set_Day_Of_Week_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_DATE:
-                Clock_Set_Date_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_MONTHS:
-                Clock_Set_Months_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_CENTURY:
-                Clock_Set_Century_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_YEAR:
-                Clock_Set_Years_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_FULL_TIME:
-                Clock_Set_Full_Time_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_FULL_DATE:
-                Clock_Set_Full_Date_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            case DS3231_UNIT_DATETIME:
-                Clock_Set_Datetime_Complete_Callback(ds3231_handle.clock_dev);
-                break;
-            }
+        ds3231_handle.requests[i].state = DS3231_STATE_IDLE;
+        ds3231_handle.requests[i].unit = DS3231_UNIT_NONE;
     }
+    ds3231_handle.i2c_interface = get_i2c_interface(DS3231_I2C_INSTANCE);
+    /* The DS3231 supports fast mode, which cuts the bus time of every access to about a quarter */
+    if (ds3231_handle.i2c_interface->Initialize() != I2C_OK
+            || ds3231_handle.i2c_interface->Set_Speed(I2C_SPEED_FM, I2C_FM_DUTY_2) != I2C_OK)
+    {
+        ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+        return;
+    }
+
+    /* Nothing else writes the control register, so the driver keeps its own copy from here on */
+    Read_From_DS3231(p_rx_buffer, DS3231_ADDR_CONTROL, DS3231_LEN_CONTROL + DS3231_LEN_STATUS);
+    if (ds3231_handle.clock_dev->ctrl_stage == CLOCK_CTRL_ERROR)
+        return;
+    ds3231_handle.control = p_rx_buffer[0];
+    ds3231_handle.status = p_rx_buffer[1];
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+    DS3231_Init_Int_Sqw_Pin();
+#endif
 }
 
-void I2C_Read_Complete_Callback(I2C_Device_t *p_i2c_dev)
+/* Completion of a queued request, in interrupt context. The slot is freed first, since the clock callbacks
+ * may well queue the next request, but the bytes are still decoded in place: every unit is decoded before its
+ * callback runs, and a request queued from there cannot receive anything until this interrupt has returned.
+ * A failed request decodes nothing and leaves the device fields as they were. */
+static void DS3231_Transaction_Complete(void *p_context, I2C_Status_t status)
 {
-    uint8_t *out_buffer;
-    full_date_t full_date;
-    full_time_t full_time;
+    DS3231_Request_t *p_request = (DS3231_Request_t *) p_context;
+    DS3231_State_t state = p_request->state;
+    const DS3231_Unit_Desc_t *p_unit = &DS3231_UNITS[p_request->unit];
 
-    switch (ds3231_handle.curr_unit)
+    p_request->state = DS3231_STATE_IDLE;
+
+    if (status != I2C_OK)
     {
-        case DS3231_UNIT_SECONDS:
-            seconds_t new_secs = Convert_Seconds_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_SECONDS));
-            ds3231_handle.clock_dev->time.seconds = new_secs;
-            Clock_Get_Seconds_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_MINUTES:
-            minutes_t new_mins = Convert_Minutes_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_MINUTES));
-            ds3231_handle.clock_dev->time.minutes = new_mins;
-            Clock_Get_Minutes_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_HOURS:
-            hours_t new_hours = Convert_Hours_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_HOURS));
-            ds3231_handle.clock_dev->time.hours = new_hours;
-            Clock_Get_Hours_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_DOW:
-            day_of_week_t new_dow = Convert_Day_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_DOW));
-            ds3231_handle.clock_dev->date.day_of_week = new_dow;
-            Clock_Get_Day_Of_Week_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_DATE:
-            date_t new_date = Convert_Date_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_DATE));
-            ds3231_handle.clock_dev->date.date = new_date;
-            Clock_Get_Date_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_MONTHS:
-            month_t new_month = Convert_Month_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_MONTH_CENTURY));
-            ds3231_handle.clock_dev->date.month = new_month;
-            Clock_Get_Month_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_YEAR:
-            year_t new_year = Convert_Month_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_YEAR));
-            ds3231_handle.clock_dev->date.year = new_year;
-            Clock_Get_Year_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_CENTURY:
-            century_t new_century = Convert_Month_From_DS3231(*I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_MONTH_CENTURY));
-            ds3231_handle.state = DS3231_STATE_IDLE;
-            ds3231_handle.clock_dev->date.century = new_century;
-            Clock_Get_Century_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_FULL_DATE:
-            out_buffer = I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_FULL_DATE);
-            full_date = Convert_Full_Date_From_DS3231(out_buffer);
-            ds3231_handle.clock_dev->date = full_date;
-            Clock_Get_Full_Date_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_FULL_TIME:
-            out_buffer = I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_FULL_TIME);
-            full_time = Convert_Full_Time_From_DS3231(out_buffer);
-            ds3231_handle.clock_dev->time = full_time;
-            Clock_Get_Full_Time_Complete_Callback(ds3231_handle.clock_dev);
-            break;
-        case DS3231_UNIT_DATETIME:
-            out_buffer = I2C_RX_Ring_Buffer_Read(p_i2c_dev, DS3231_LEN_DATETIME);
-            full_time = Convert_Full_Time_From_DS3231(out_buffer);
-            full_date = Convert_Full_Date_From_DS3231(out_buffer + DS3231_LEN_FULL_TIME);
-            ds3231_handle.clock_dev->time = full_time;
-            ds3231_handle.clock_dev->date = full_date;
-            Clock_Get_Datetime_Complete_Callback(ds3231_handle.clock_dev);
-            break;
+        ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+        Clock_Error_Callback(ds3231_handle.clock_dev);
     }
-    ds3231_handle.state = DS3231_STATE_IDLE;
+    else if (state == DS3231_STATE_MERGE_READ)
+        DS3231_Merge_Write(p_request->unit, p_request->merge, p_request->rx_buffer[0]);
+    else if (state == DS3231_STATE_DATA_READ)
+    {
+        if (p_unit->p_decode != NULL)
+            p_unit->p_decode(p_request->rx_buffer);
+        if (p_unit->p_get_complete != NULL)
+            p_unit->p_get_complete(ds3231_handle.clock_dev);
+    }
+    else if (p_unit->p_set_complete != NULL)
+        p_unit->p_set_complete(ds3231_handle.clock_dev);
 }
 
 /***************************************************************/
@@ -362,13 +317,13 @@ static hours_t DS3231_Get_Hours(void)
     return new_hours;
 }
 
+/* The multi-register getters read in one burst. The DS3231 copies its counters into the user buffer at every
+ * start, so a burst cannot straddle a rollover the way separate register reads can. */
 static full_time_t DS3231_Get_Full_Time(void)
 {
-    hours_t hours = DS3231_Get_Hours();
-    minutes_t mins = DS3231_Get_Minutes();
-    seconds_t secs = DS3231_Get_Seconds();
-    full_time_t full_time = { .hours = hours, .minutes = mins, .seconds = secs };
-    return full_time;
+    uint8_t p_rx_buffer[DS3231_LEN_FULL_TIME];
+    Read_From_DS3231(p_rx_buffer, DS3231_ADDR_SECONDS, DS3231_LEN_FULL_TIME);
+    return Convert_Full_Time_From_DS3231(p_rx_buffer);
 }
 
 static day_of_week_t DS3231_Get_Day_Of_Week(void)
@@ -413,21 +368,16 @@ static year_t DS3231_Get_Year(void)
 
 static full_date_t DS3231_Get_Full_Date(void)
 {
-    full_date_t full_date;
-    full_date.date = DS3231_Get_Date();
-    full_date.day_of_week = DS3231_Get_Day_Of_Week();
-    full_date.month = DS3231_Get_Month();
-    full_date.year = DS3231_Get_Year();
-    full_date.century = DS3231_Get_Century();
-    return full_date;
+    uint8_t p_rx_buffer[DS3231_LEN_FULL_DATE];
+    Read_From_DS3231(p_rx_buffer, DS3231_ADDR_DAY, DS3231_LEN_FULL_DATE);
+    return Convert_Full_Date_From_DS3231(p_rx_buffer);
 }
 
 static full_datetime_t DS3231_Get_Full_Datetime(void)
 {
-    full_datetime_t datetime;
-    datetime.time = DS3231_Get_Full_Time();
-    datetime.date = DS3231_Get_Full_Date();
-    return datetime;
+    uint8_t p_rx_buffer[DS3231_LEN_DATETIME];
+    Read_From_DS3231(p_rx_buffer, DS3231_ADDR_SECONDS, DS3231_LEN_DATETIME);
+    return Convert_Datetime_From_DS3231(p_rx_buffer);
 }
 
 static float DS3231_Get_Temp(void)
@@ -444,57 +394,57 @@ static float DS3231_Get_Temp(void)
 /***************************************************************/
 static void DS3231_Get_Seconds_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_SECONDS, DS3231_LEN_SECONDS);
+    Read_From_DS3231_IT(DS3231_UNIT_SECONDS);
 }
 
 static void DS3231_Get_Minutes_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_MINUTES, DS3231_LEN_MINUTES);
+    Read_From_DS3231_IT(DS3231_UNIT_MINUTES);
 }
 
 static void DS3231_Get_Hours_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_HOURS, DS3231_LEN_HOURS);
+    Read_From_DS3231_IT(DS3231_UNIT_HOURS);
 }
 
 static void DS3231_Get_Day_Of_Week_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_DOW, DS3231_LEN_DOW);
+    Read_From_DS3231_IT(DS3231_UNIT_DOW);
 }
 
 static void DS3231_Get_Date_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_DATE, DS3231_LEN_DATE);
+    Read_From_DS3231_IT(DS3231_UNIT_DATE);
 }
 
 static void DS3231_Get_Month_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_MONTHS, DS3231_LEN_MONTH_CENTURY);
+    Read_From_DS3231_IT(DS3231_UNIT_MONTHS);
 }
 
 static void DS3231_Get_Year_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_YEAR, DS3231_LEN_YEAR);
+    Read_From_DS3231_IT(DS3231_UNIT_YEAR);
 }
 
 static void DS3231_Get_Century_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_CENTURY, DS3231_LEN_MONTH_CENTURY);
+    Read_From_DS3231_IT(DS3231_UNIT_CENTURY);
 }
 
 static void DS3231_Get_Full_Date_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_FULL_DATE, DS3231_LEN_FULL_DATE);
+    Read_From_DS3231_IT(DS3231_UNIT_FULL_DATE);
 }
 
 static void DS3231_Get_Full_Time_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_FULL_TIME, DS3231_LEN_FULL_TIME);
+    Read_From_DS3231_IT(DS3231_UNIT_FULL_TIME);
 }
 
 static void DS3231_Get_Datetime_IT(void)
 {
-    Read_From_DS3231_IT(DS3231_UNIT_DATETIME, DS3231_LEN_DATETIME);
+    Read_From_DS3231_IT(DS3231_UNIT_DATETIME);
 }
 
 /***************************************************************/
@@ -554,23 +504,27 @@ static void DS3231_Set_Year(year_t year)
 
 static void DS3231_Set_Full_Date(full_date_t full_date)
 {
-    DS3231_Set_Day_Of_Week(full_date.day_of_week);
-    DS3231_Set_Date(full_date.date);
-    DS3231_Set_Month(full_date.month);
-    DS3231_Set_Year(full_date.year);
+    uint8_t p_tx_buffer[DS3231_LEN_FULL_DATE + 1];
+    p_tx_buffer[0] = DS3231_ADDR_DAY;
+    Convert_Full_Date_To_DS3231(full_date, p_tx_buffer + 1);
+    Write_To_DS3231(p_tx_buffer, DS3231_ADDR_DAY, DS3231_LEN_FULL_DATE + 1);
 }
 
 static void DS3231_Set_Full_Time(full_time_t full_time)
 {
-    DS3231_Set_Seconds(full_time.seconds);
-    DS3231_Set_Minutes(full_time.minutes);
-    DS3231_Set_Hours(full_time.hours);
+    uint8_t p_tx_buffer[DS3231_LEN_FULL_TIME + 1];
+    p_tx_buffer[0] = DS3231_ADDR_SECONDS;
+    Convert_Full_Time_To_DS3231(full_time, p_tx_buffer + 1);
+    Write_To_DS3231(p_tx_buffer, DS3231_ADDR_SECONDS, DS3231_LEN_FULL_TIME + 1);
 }
 
+/* One burst, so the chip cannot carry between the date and the time landing */
 static void DS3231_Set_Full_Datetime(full_datetime_t full_datetime)
 {
-    DS3231_Set_Full_Date(full_datetime.date);
-    DS3231_Set_Full_Time(full_datetime.time);
+    uint8_t p_tx_buffer[DS3231_LEN_DATETIME + 1];
+    p_tx_buffer[0] = DS3231_ADDR_SECONDS;
+    Convert_Datetime_To_DS3231(full_datetime, p_tx_buffer + 1);
+    Write_To_DS3231(p_tx_buffer, DS3231_ADDR_SECONDS, DS3231_LEN_DATETIME + 1);
 }
 
 
@@ -581,78 +535,137 @@ static void DS3231_Set_Full_Datetime(full_datetime_t full_datetime)
 /***************************************************************/
 static void DS3231_Set_Seconds_IT(seconds_t seconds)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_SECONDS + 1] = { DS3231_ADDR_SECONDS, Convert_Seconds_To_DS3231(seconds) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_SECONDS, DS3231_LEN_SECONDS + 1);
+    uint8_t seconds_byte = Convert_Seconds_To_DS3231(seconds);
+    Write_To_DS3231_IT(DS3231_UNIT_SECONDS, &seconds_byte);
 }
 
 static void DS3231_Set_Minutes_IT(minutes_t minutes)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_MINUTES + 1] = { DS3231_ADDR_MINUTES, Convert_Minutes_To_DS3231(minutes) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_MINUTES, DS3231_LEN_MINUTES + 1);
+    uint8_t minutes_byte = Convert_Minutes_To_DS3231(minutes);
+    Write_To_DS3231_IT(DS3231_UNIT_MINUTES, &minutes_byte);
 }
 
 static void DS3231_Set_Hours_IT(hours_t hours)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_HOURS + 1] = { DS3231_ADDR_HOURS, Convert_Hours_To_DS3231(hours) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_HOURS, DS3231_LEN_HOURS + 1);
+    uint8_t hours_byte = Convert_Hours_To_DS3231(hours);
+    Write_To_DS3231_IT(DS3231_UNIT_HOURS, &hours_byte);
 }
 
 static void DS3231_Set_Day_Of_Week_IT(day_of_week_t dow)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_DOW + 1] = { DS3231_ADDR_DAY, Convert_Day_To_DS3231(dow) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_DOW, DS3231_LEN_DOW + 1);
+    uint8_t dow_byte = Convert_Day_To_DS3231(dow);
+    Write_To_DS3231_IT(DS3231_UNIT_DOW, &dow_byte);
 }
 
 static void DS3231_Set_Date_IT(date_t date)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_DATE + 1] = { DS3231_ADDR_DATE, Convert_Day_To_DS3231(date) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_DATE, DS3231_LEN_DATE + 1);
+    uint8_t date_byte = Convert_Date_To_DS3231(date);
+    Write_To_DS3231_IT(DS3231_UNIT_DATE, &date_byte);
 }
 
+/* The century bit is read back through the queue and the write follows from its completion */
 static void DS3231_Set_Month_IT(month_t month)
 {
-    /* TODO: find way to avoid this blocking call in the middle of an interrupt call */
-    month_t current_century = DS3231_Get_Century();
-    uint8_t p_tx_buffer[DS3231_LEN_MONTH_CENTURY + 1] = { DS3231_ADDR_MONTH_CENTURY, Convert_Month_Century_To_DS3231(month, current_century) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_MONTHS, DS3231_LEN_MONTH_CENTURY + 1);
+    Merge_Into_DS3231_IT(DS3231_UNIT_MONTHS, month);
 }
 
 static void DS3231_Set_Year_IT(year_t year)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_YEAR + 1] = { DS3231_ADDR_YEAR, Convert_Year_To_DS3231(year) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_YEAR, DS3231_LEN_YEAR + 1);
+    uint8_t year_byte = Convert_Year_To_DS3231(year);
+    Write_To_DS3231_IT(DS3231_UNIT_YEAR, &year_byte);
 }
 
+/* As Set_Month_IT, the other way round */
 static void DS3231_Set_Century_IT(century_t century)
 {
-    /* TODO: find way to avoid this blocking call in the middle of an interrupt call */
-    month_t current_month = DS3231_Get_Month();
-    uint8_t p_tx_buffer[DS3231_LEN_MONTH_CENTURY + 1] = { DS3231_ADDR_MONTH_CENTURY, Convert_Month_Century_To_DS3231(current_month, century) };
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_CENTURY, DS3231_LEN_MONTH_CENTURY + 1);
+    Merge_Into_DS3231_IT(DS3231_UNIT_CENTURY, century);
 }
 
 static void DS3231_Set_Full_Date_IT(full_date_t full_date)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_FULL_DATE + 1];
-    p_tx_buffer[0] = DS3231_ADDR_DAY;
-    Convert_Full_Date_To_DS3231(full_date, p_tx_buffer + 1);
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_FULL_DATE, DS3231_LEN_FULL_DATE + 1);
+    uint8_t p_data[DS3231_LEN_FULL_DATE];
+    Convert_Full_Date_To_DS3231(full_date, p_data);
+    Write_To_DS3231_IT(DS3231_UNIT_FULL_DATE, p_data);
 }
 
 static void DS3231_Set_Full_Time_IT(full_time_t full_time)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_FULL_TIME + 1];
-    p_tx_buffer[0] = DS3231_ADDR_SECONDS;
-    Convert_Full_Time_To_DS3231(full_time, p_tx_buffer + 1);
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_FULL_TIME, DS3231_LEN_FULL_TIME + 1);
+    uint8_t p_data[DS3231_LEN_FULL_TIME];
+    Convert_Full_Time_To_DS3231(full_time, p_data);
+    Write_To_DS3231_IT(DS3231_UNIT_FULL_TIME, p_data);
 }
 
 static void DS3231_Set_Full_Datetime_IT(full_datetime_t full_datetime)
 {
-    uint8_t p_tx_buffer[DS3231_LEN_DATETIME + 1];
-    p_tx_buffer[0] = DS3231_ADDR_SECONDS;
-    Convert_Datetime_To_DS3231(full_datetime, p_tx_buffer + 1);
-    Write_To_DS3231_IT(p_tx_buffer, DS3231_UNIT_DATETIME, DS3231_LEN_DATETIME + 1);
+    uint8_t p_data[DS3231_LEN_DATETIME];
+    Convert_Datetime_To_DS3231(full_datetime, p_data);
+    Write_To_DS3231_IT(DS3231_UNIT_DATETIME, p_data);
+}
+
+/***************************************************************/
+/***************************************************************/
+/* Alarm APIs                                                  */
+/***************************************************************/
+/***************************************************************/
+/* The alarm's registers go first, then control and status in one burst, so the alarm is armed with its old
+ * flag cleared only once its new match is in place */
+static void DS3231_Set_Alarm(Clock_Alarm_t alarm, alarm_t alarm_time)
+{
+    uint8_t p_tx_buffer[DS3231_PTR_LEN + DS3231_LEN_ALARM_1];
+    uint8_t p_control_buffer[DS3231_PTR_LEN + DS3231_LEN_CONTROL + DS3231_LEN_STATUS];
+    uint8_t len = Convert_Alarm_To_DS3231(alarm, alarm_time, p_tx_buffer);
+
+    if (len == 0)
+    {
+        ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+        return;
+    }
+    Write_To_DS3231(p_tx_buffer, p_tx_buffer[0], len);
+    DS3231_Alarm_Control_To_Buffer(alarm, ENABLE, p_control_buffer);
+    Write_To_DS3231(p_control_buffer, DS3231_ADDR_CONTROL, sizeof(p_control_buffer));
+}
+
+/* Two queued writes; Clock_Set_Alarm_Complete_Callback() follows the second */
+static void DS3231_Set_Alarm_IT(Clock_Alarm_t alarm, alarm_t alarm_time)
+{
+    uint8_t p_tx_buffer[DS3231_PTR_LEN + DS3231_LEN_ALARM_1];
+    uint8_t p_control_buffer[DS3231_PTR_LEN + DS3231_LEN_CONTROL + DS3231_LEN_STATUS];
+    uint8_t len = Convert_Alarm_To_DS3231(alarm, alarm_time, p_tx_buffer);
+
+    if (len == 0)
+    {
+        ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+        Clock_Error_Callback(ds3231_handle.clock_dev);
+        return;
+    }
+    /* Arming goes out only behind the match registers, or the alarm could fire on its old match */
+    if (!Write_To_DS3231_IT((alarm == CLOCK_ALARM_1) ? DS3231_UNIT_ALARM_1 : DS3231_UNIT_ALARM_2,
+                            p_tx_buffer + DS3231_PTR_LEN))
+    {
+        return;
+    }
+    DS3231_Alarm_Control_To_Buffer(alarm, ENABLE, p_control_buffer);
+    Write_To_DS3231_IT(DS3231_UNIT_ALARM_CONTROL, p_control_buffer + DS3231_PTR_LEN);
+}
+
+static alarm_t DS3231_Get_Alarm(Clock_Alarm_t alarm)
+{
+    uint8_t p_rx_buffer[DS3231_LEN_ALARM_1];
+
+    if (alarm == CLOCK_ALARM_1)
+        Read_From_DS3231(p_rx_buffer, DS3231_ADDR_ALARM_1_SECS, DS3231_LEN_ALARM_1);
+    else
+        Read_From_DS3231(p_rx_buffer, DS3231_ADDR_ALARM_2_MINS, DS3231_LEN_ALARM_2);
+    return Convert_Alarm_From_DS3231(alarm, p_rx_buffer);
+}
+
+/* Disarms the alarm and clears its flag; the match registers are left as they were */
+static void DS3231_Clear_Alarm(Clock_Alarm_t alarm)
+{
+    uint8_t p_tx_buffer[DS3231_PTR_LEN + DS3231_LEN_CONTROL + DS3231_LEN_STATUS];
+
+    DS3231_Alarm_Control_To_Buffer(alarm, DISABLE, p_tx_buffer);
+    Write_To_DS3231(p_tx_buffer, DS3231_ADDR_CONTROL, sizeof(p_tx_buffer));
 }
 
 /*************** UTILITY FUNCTIONS *****************/
@@ -661,79 +674,211 @@ static void Read_From_DS3231(uint8_t *p_rx_buffer, uint8_t ds3231_addr, uint8_t
 {
     /* Every read from DS3231 must begin with writing the register pointer, which the read will start from */
     uint8_t p_tx_buffer[1] = { ds3231_addr };
-    ds3231_handle.i2c_interface->Write_Bytes(p_tx_buffer, DS3231_PTR_LEN, DS3231_SLAVE_ADDR, I2C_ENABLE_SR);
-    ds3231_handle.i2c_interface->Read_Bytes(p_rx_buffer, len, DS3231_SLAVE_ADDR, I2C_DISABLE_SR);
+    I2C_Status_t status;
+
+    status = ds3231_handle.i2c_interface->Write_Bytes(p_tx_buffer, DS3231_PTR_LEN, DS3231_SLAVE_ADDR, I2C_ENABLE_SR);
+    if (status == I2C_OK)
+        status = ds3231_handle.i2c_interface->Read_Bytes(p_rx_buffer, len, DS3231_SLAVE_ADDR, I2C_DISABLE_SR);
+
+    if (status != I2C_OK)
+    {
+        /* The getters decode whatever is here; zeros at least decode to something in range */
+        memset(p_rx_buffer, 0, len);
+        ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+    }
 }
 
-static void Read_From_DS3231_IT(DS3231_Unit_t ds3231_unit, uint8_t len)
+/* The pointer write and the data read go out as one queued transaction, joined by a repeated start */
+static void Read_From_DS3231_IT(DS3231_Unit_t ds3231_unit)
 {
-    if (ds3231_handle.state != DS3231_STATE_IDLE)
+    DS3231_Request_t *p_request = DS3231_Claim_Request(DS3231_STATE_DATA_READ, ds3231_unit);
+
+    if (p_request == NULL)
     {
+        DS3231_Refuse_Request(NULL);
         return;
     }
+    DS3231_Queue_Read(p_request);
+}
 
-    uint8_t    *p_tx_buffer;
-    uint8_t ds3231_addr;
+/* Reads the month/century register and, from its completion, writes it back with the one half replaced */
+static void Merge_Into_DS3231_IT(DS3231_Unit_t ds3231_unit, uint8_t value)
+{
+    DS3231_Request_t *p_request = DS3231_Claim_Request(DS3231_STATE_MERGE_READ, ds3231_unit);
 
-    switch (ds3231_unit)
+    if (p_request == NULL)
     {
-    case DS3231_UNIT_SECONDS:
-        ds3231_addr = DS3231_ADDR_SECONDS;
-        break;
-    case DS3231_UNIT_MINUTES:
-        ds3231_addr = DS3231_ADDR_MINUTES;
-        break;
-    case DS3231_UNIT_HOURS:
-        ds3231_addr = DS3231_ADDR_HOURS;
-        break;
-    case DS3231_UNIT_DOW:
-        ds3231_addr = DS3231_ADDR_DAY;
-        break;
-    case DS3231_UNIT_DATE:
-        ds3231_addr = DS3231_ADDR_DATE;
-        break;
-    case DS3231_UNIT_MONTHS:
-        ds3231_addr = DS3231_ADDR_MONTH_CENTURY;
-        break;
-    case DS3231_UNIT_YEAR:
-        ds3231_addr = DS3231_ADDR_YEAR;
-        break;
-    case DS3231_UNIT_CENTURY:
-        ds3231_addr = DS3231_ADDR_MONTH_CENTURY;
-        break;
-    case DS3231_UNIT_FULL_DATE:
-        ds3231_addr = DS3231_ADDR_DAY;
-        break;
-    case DS3231_UNIT_FULL_TIME:
-        ds3231_addr = DS3231_ADDR_SECONDS;
-        break;
-    case DS3231_UNIT_DATETIME:
-        ds3231_addr = DS3231_ADDR_SECONDS;
-        break;
+        DS3231_Refuse_Request(NULL);
+        return;
     }
-    p_tx_buffer = &ds3231_addr;
+    p_request->merge = value;
+    DS3231_Queue_Read(p_request);
+}
+
+static void DS3231_Queue_Read(DS3231_Request_t *p_request)
+{
+    DS3231_Unit_t ds3231_unit = p_request->unit;
+
+    p_request->tx_buffer[0] = DS3231_UNITS[ds3231_unit].addr;
 
-    ds3231_handle.state = DS3231_STATE_POINTER_WRITE_FOR_READ;
-    ds3231_handle.curr_unit = ds3231_unit;
-    ds3231_handle.i2c_interface->Write_Bytes_IT(p_tx_buffer, DS3231_PTR_LEN, DS3231_SLAVE_ADDR, I2C_ENABLE_SR);
+    I2C_Transaction_t txn = {
+            .slave_addr = DS3231_SLAVE_ADDR,
+            .p_tx_buffer = p_request->tx_buffer,
+            .tx_len = DS3231_PTR_LEN,
+            .p_rx_buffer = p_request->rx_buffer,
+            .rx_len = DS3231_UNITS[ds3231_unit].len,
+            .repeat_start = I2C_DISABLE_SR,
+            .p_callback = DS3231_Transaction_Complete,
+            .p_context = p_request,
+    };
+    if (!ds3231_handle.i2c_interface->Queue_Transaction(&txn))
+    {
+        DS3231_Refuse_Request(p_request);
+    }
 }
 
 static void Write_To_DS3231(uint8_t *p_tx_buffer, uint8_t ds3231_addr, uint8_t len)
 {
-    ds3231_handle.i2c_interface->Write_Bytes(p_tx_buffer, len, DS3231_SLAVE_ADDR, I2C_DISABLE_SR);
+    if (ds3231_handle.i2c_interface->Write_Bytes(p_tx_buffer, len, DS3231_SLAVE_ADDR, I2C_DISABLE_SR) != I2C_OK)
+    {
+        ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+    }
+}
+
+/* The unit's register pointer goes in front of its data. Returns 1 once queued; 0 once the refusal has been
+ * reported. */
+static uint8_t Write_To_DS3231_IT(DS3231_Unit_t ds3231_unit, const uint8_t *p_data)
+{
+    DS3231_Request_t *p_request = DS3231_Claim_Request(DS3231_STATE_DATA_WRITE, ds3231_unit);
+    uint8_t len = DS3231_UNITS[ds3231_unit].len;
+
+    if (p_request == NULL)
+    {
+        DS3231_Refuse_Request(NULL);
+        return 0;
+    }
 
+    /* The caller's buffer is on its stack; the DMA reads from the request's copy after this returns */
+    p_request->tx_buffer[0] = DS3231_UNITS[ds3231_unit].addr;
+    memcpy(p_request->tx_buffer + DS3231_PTR_LEN, p_data, len);
+
+    I2C_Transaction_t txn = {
+            .slave_addr = DS3231_SLAVE_ADDR,
+            .p_tx_buffer = p_request->tx_buffer,
+            .tx_len = DS3231_PTR_LEN + len,
+            .p_rx_buffer = NULL,
+            .rx_len = 0,
+            .repeat_start = I2C_DISABLE_SR,
+            .p_callback = DS3231_Transaction_Complete,
+            .p_context = p_request,
+    };
+    if (!ds3231_handle.i2c_interface->Queue_Transaction(&txn))
+    {
+        DS3231_Refuse_Request(p_request);
+        return 0;
+    }
+    return 1;
 }
 
-static void Write_To_DS3231_IT(uint8_t *p_tx_buffer, DS3231_Unit_t ds3231_unit, uint8_t len)
+/* Requests are claimed from the application and from clock callbacks alike, so the search runs masked */
+static DS3231_Request_t *DS3231_Claim_Request(DS3231_State_t state, DS3231_Unit_t ds3231_unit)
 {
-    if (ds3231_handle.state != DS3231_STATE_IDLE)
+    DS3231_Request_t *p_request = NULL;
+    uint32_t primask = Critical_Section_Enter();
+
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++)
     {
-        return;
+        if (ds3231_handle.requests[i].state == DS3231_STATE_IDLE)
+        {
+            p_request = &ds3231_handle.requests[i];
+            p_request->state = state;
+            p_request->unit = ds3231_unit;
+            break;
+        }
     }
+    Critical_Section_Exit(primask);
+    return p_request;
+}
+
+/* An interrupt-based call that could not be queued fails the way one that failed on the bus does, only sooner */
+static void DS3231_Refuse_Request(DS3231_Request_t *p_request)
+{
+    if (p_request != NULL)
+        p_request->state = DS3231_STATE_IDLE;
+    ds3231_handle.clock_dev->ctrl_stage = CLOCK_CTRL_ERROR;
+    Clock_Error_Callback(ds3231_handle.clock_dev);
+}
+
+/* The second half of Merge_Into_DS3231_IT(); its write makes the set callback */
+static void DS3231_Merge_Write(DS3231_Unit_t ds3231_unit, uint8_t value, uint8_t month_century_byte)
+{
+    uint8_t merged;
+
+    if (ds3231_unit == DS3231_UNIT_MONTHS)
+        merged = Convert_Month_Century_To_DS3231(value, Convert_Century_From_DS3231(month_century_byte));
+    else
+        merged = Convert_Month_Century_To_DS3231(Convert_Month_From_DS3231(month_century_byte), value);
+    Write_To_DS3231_IT(ds3231_unit, &merged);
+}
+
+/*************** UNIT DECODERS *****************/
+/* A completed read into the clock device, through DS3231_UNITS */
+static void DS3231_Decode_Seconds(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->time.seconds = Convert_Seconds_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Minutes(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->time.minutes = Convert_Minutes_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Hours(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->time.hours = Convert_Hours_From_DS3231(*p_rx_buffer);
+}
 
-    ds3231_handle.state = DS3231_STATE_DATA_WRITE;
-    ds3231_handle.curr_unit = ds3231_unit;
-    ds3231_handle.i2c_interface->Write_Bytes_IT(p_tx_buffer, len, DS3231_SLAVE_ADDR, I2C_DISABLE_SR);
+static void DS3231_Decode_Day_Of_Week(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->date.day_of_week = Convert_Day_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Date(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->date.date = Convert_Date_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Month(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->date.month = Convert_Month_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Year(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->date.year = Convert_Year_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Century(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->date.century = Convert_Century_From_DS3231(*p_rx_buffer);
+}
+
+static void DS3231_Decode_Full_Date(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->date = Convert_Full_Date_From_DS3231(p_rx_buffer);
+}
+
+static void DS3231_Decode_Full_Time(uint8_t *p_rx_buffer)
+{
+    ds3231_handle.clock_dev->time = Convert_Full_Time_From_DS3231(p_rx_buffer);
+}
+
+static void DS3231_Decode_Datetime(uint8_t *p_rx_buffer)
+{
+    full_datetime_t datetime = Convert_Datetime_From_DS3231(p_rx_buffer);
+
+    ds3231_handle.clock_dev->time = datetime.time;
+    ds3231_handle.clock_dev->date = datetime.date;
 }
 
 /*********** CONVERSION FUNCTIONS FROM TIME TYPES TO DS3231 REGISTER FORMAT *************/
@@ -824,6 +969,50 @@ static full_datetime_t Convert_Datetime_From_DS3231(uint8_t *p_rx_buffer)
     return datetime;
 }
 
+/* The match mode is the first register, counting down from day/date, that is not masked off. Alarm 2 has no
+ * seconds register, so its seconds count as masked. */
+static alarm_t Convert_Alarm_From_DS3231(Clock_Alarm_t alarm, uint8_t *p_rx_buffer)
+{
+    uint8_t regs[DS3231_LEN_ALARM_1];
+    uint8_t mask = (1 << DS3231_ALARM_MASKED_BIT);
+    alarm_t alarm_time = { 0 };
+
+    if (alarm == CLOCK_ALARM_1)
+        memcpy(regs, p_rx_buffer, DS3231_LEN_ALARM_1);
+    else
+    {
+        regs[0] = mask;
+        memcpy(regs + 1, p_rx_buffer, DS3231_LEN_ALARM_2);
+    }
+
+    alarm_time.seconds = Convert_Seconds_From_DS3231(regs[0] & ~mask);
+    alarm_time.minutes = Convert_Minutes_From_DS3231(regs[1] & ~mask);
+    alarm_time.hours = Convert_Hours_From_DS3231(regs[2] & ~mask);
+
+    if (!(regs[3] & mask) && (regs[3] & (1 << DS3231_ALARM_DY_DT_BIT)))
+    {
+        alarm_time.match = ALARM_MATCH_DAY_OF_WEEK;
+        alarm_time.day_of_week = Convert_Day_From_DS3231(regs[3]);
+    }
+    else if (!(regs[3] & mask))
+    {
+        alarm_time.match = ALARM_MATCH_DATE;
+        alarm_time.date = Convert_Date_From_DS3231(regs[3] & 0x3F);
+    }
+    else if (!(regs[2] & mask))
+        alarm_time.match = ALARM_MATCH_HOURS;
+    else if (!(regs[1] & mask))
+        alarm_time.match = ALARM_MATCH_MINUTES;
+    else if (!(regs[0] & mask))
+        alarm_time.match = ALARM_MATCH_SECONDS;
+    else if (alarm == CLOCK_ALARM_1)
+        alarm_time.match = ALARM_MATCH_EVERY_SECOND;
+    else
+        alarm_time.match = ALARM_MATCH_EVERY_MINUTE;
+
+    return alarm_time;
+}
+
 static float Convert_Temp_From_DS3231(uint8_t *p_rx_buffer)
 {
     float temp = 0;
@@ -909,6 +1098,70 @@ static void Convert_Datetime_To_DS3231(full_datetime_t datetime, uint8_t *p_tx_b
     Convert_Full_Date_To_DS3231(datetime.date, p_tx_buffer + DS3231_LEN_FULL_TIME);
 }
 
+/* Fills in the register pointer and the alarm's registers, and returns the length of the write, or 0 for a match
+ * mode the alarm cannot do. Alarm 1 can match every second but has no mode for every minute; alarm 2, having no
+ * seconds register, the other way round. */
+static uint8_t Convert_Alarm_To_DS3231(Clock_Alarm_t alarm, alarm_t alarm_time, uint8_t *p_tx_buffer)
+{
+    uint8_t regs[DS3231_LEN_ALARM_1];
+    uint8_t masked;     /* one bit per register, seconds first, for those that take no part in the match */
+
+    switch (alarm_time.match)
+    {
+    case ALARM_MATCH_EVERY_SECOND:
+        if (alarm != CLOCK_ALARM_1)
+            return 0;
+        masked = 0xF;
+        break;
+    case ALARM_MATCH_EVERY_MINUTE:
+        if (alarm != CLOCK_ALARM_2)
+            return 0;
+        masked = 0xF;
+        break;
+    case ALARM_MATCH_SECONDS:
+        if (alarm != CLOCK_ALARM_1)
+            return 0;
+        masked = 0xE;
+        break;
+    case ALARM_MATCH_MINUTES:
+        masked = 0xC;
+        break;
+    case ALARM_MATCH_HOURS:
+        masked = 0x8;
+        break;
+    case ALARM_MATCH_DATE:
+    case ALARM_MATCH_DAY_OF_WEEK:
+        masked = 0;
+        break;
+    default:
+        return 0;
+    }
+
+    regs[0] = Convert_Seconds_To_DS3231(alarm_time.seconds);
+    regs[1] = Convert_Minutes_To_DS3231(alarm_time.minutes);
+    regs[2] = Convert_Hours_To_DS3231(alarm_time.hours);
+    if (alarm_time.match == ALARM_MATCH_DAY_OF_WEEK)
+        regs[3] = Convert_Day_To_DS3231(alarm_time.day_of_week) | (1 << DS3231_ALARM_DY_DT_BIT);
+    else
+        regs[3] = Convert_Date_To_DS3231(alarm_time.date);
+
+    for (uint8_t i = 0; i < DS3231_LEN_ALARM_1; i++)
+    {
+        if (masked & (1 << i))
+            regs[i] |= (1 << DS3231_ALARM_MASKED_BIT);
+    }
+
+    if (alarm == CLOCK_ALARM_1)
+    {
+        p_tx_buffer[0] = DS3231_ADDR_ALARM_1_SECS;
+        memcpy(p_tx_buffer + DS3231_PTR_LEN, regs, DS3231_LEN_ALARM_1);
+        return DS3231_PTR_LEN + DS3231_LEN_ALARM_1;
+    }
+    p_tx_buffer[0] = DS3231_ADDR_ALARM_2_MINS;
+    memcpy(p_tx_buffer + DS3231_PTR_LEN, regs + 1, DS3231_LEN_ALARM_2);
+    return DS3231_PTR_LEN + DS3231_LEN_ALARM_2;
+}
+
 /*************** GENERAL UTILITY FUNCTIONS *****************/
 static uint8_t Convert_Binary_To_BCD(uint8_t binary_byte)
 {
@@ -923,7 +1176,125 @@ static uint8_t Convert_BCD_To_Binary(uint8_t bcd_byte)
     // zeroes place (bottom 4 bits)
     uint8_t zeroes_place = bcd_byte & 0xF;
     // tens place (top 4 bits)
-    uint8_t tens_place = (bcd_byte >> 4)& 0x7;
+    uint8_t tens_place = (bcd_byte >> 4)& 0xF;
 
     return zeroes_place + (tens_place * 10);
 }
+
+/*************** ALARM UTILITY FUNCTIONS *****************/
+/* Arms or disarms the alarm in the kept control register, and fills in the burst that writes it along with the
+ * status byte that clears the alarm's flag */
+static void DS3231_Alarm_Control_To_Buffer(Clock_Alarm_t alarm, uint8_t arm, uint8_t *p_tx_buffer)
+{
+    uint8_t ie_bit = (alarm == CLOCK_ALARM_1) ? DS3231_CONTROL_A1IE_BIT : DS3231_CONTROL_A2IE_BIT;
+    uint8_t flag_bit = (alarm == CLOCK_ALARM_1) ? DS3231_STATUS_A1F_BIT : DS3231_STATUS_A2F_BIT;
+
+    if (arm)
+        ds3231_handle.control |= (1 << ie_bit);
+    else
+        ds3231_handle.control &= ~(1 << ie_bit);
+
+    p_tx_buffer[0] = DS3231_ADDR_CONTROL;
+    p_tx_buffer[1] = ds3231_handle.control;
+    p_tx_buffer[2] = DS3231_Status_Clearing(1 << flag_bit);
+}
+
+/* The status byte that clears the given flags and no others. The flags can only be written to 0, so writing 1
+ * leaves one as it is, including one that has just been set. */
+static uint8_t DS3231_Status_Clearing(uint8_t flags)
+{
+    uint8_t status = (1 << DS3231_STATUS_OSF_BIT) | (1 << DS3231_STATUS_A2F_BIT) | (1 << DS3231_STATUS_A1F_BIT);
+
+    status |= ds3231_handle.status & (1 << DS3231_STATUS_EN32KHZ_BIT);
+    return status & ~flags;
+}
+
+/* The flags of the armed alarms; a disarmed alarm still sets its flag when it matches */
+static uint8_t DS3231_Armed_Flags(void)
+{
+    uint8_t flags = 0;
+
+    if (ds3231_handle.control & (1 << DS3231_CONTROL_A1IE_BIT))
+        flags |= (1 << DS3231_STATUS_A1F_BIT);
+    if (ds3231_handle.control & (1 << DS3231_CONTROL_A2IE_BIT))
+        flags |= (1 << DS3231_STATUS_A2F_BIT);
+    return flags;
+}
+
+/* Clears the flags of the armed alarms that matched, then calls back for each */
+static void DS3231_Alarms_Matched(uint8_t *p_rx_buffer)
+{
+    uint8_t matched = *p_rx_buffer & DS3231_Armed_Flags();
+    uint8_t status;
+
+    if (matched == 0)
+        return;
+
+    status = DS3231_Status_Clearing(matched);
+    Write_To_DS3231_IT(DS3231_UNIT_ALARM_STATUS, &status);
+
+    if (matched & (1 << DS3231_STATUS_A1F_BIT))
+        Clock_Alarm_Callback(ds3231_handle.clock_dev, CLOCK_ALARM_1);
+    if (matched & (1 << DS3231_STATUS_A2F_BIT))
+        Clock_Alarm_Callback(ds3231_handle.clock_dev, CLOCK_ALARM_2);
+}
+
+/* The matched flags are written back cleared */
+static void DS3231_Alarm_Status_Cleared(Clock_Device_t *clock_dev)
+{
+#ifdef DS3231_INT_WIRED
+    /* A match between the flags being read and cleared was written back as it was, so the pin is still low and
+     * there will be no edge for it */
+    if (!GPIO_Read_From_Input_Pin(DS3231_INT_SQW_GPIO_PORT, DS3231_INT_SQW_GPIO_PIN))
+        DS3231_Service_Alarms();
+#endif
+}
+
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+/* Queues a read of the flags, which DS3231_Alarms_Matched() takes from there */
+static void DS3231_Service_Alarms(void)
+{
+    Read_From_DS3231_IT(DS3231_UNIT_ALARM_STATUS);
+}
+
+/* Points INT/SQW at the 1Hz square wave or at the alarm interrupt, keeping the rest of the control register,
+ * then arms the falling edge */
+static void DS3231_Init_Int_Sqw_Pin(void)
+{
+    uint8_t p_tx_buffer[DS3231_PTR_LEN + DS3231_LEN_CONTROL] = { DS3231_ADDR_CONTROL };
+    GPIO_Pin_Config_t pin_conf = { DS3231_INT_SQW_GPIO_PIN, GPIO_MODE_IN_FE, GPIO_SPEED_LOW, GPIO_PUPD_PU, GPIO_OUT_PP, 0 };
+
+#ifdef DS3231_SQW_WIRED
+    ds3231_handle.control &= ~((1 << DS3231_CONTROL_INTCN_BIT) | (1 << DS3231_CONTROL_RS2_BIT) | (1 << DS3231_CONTROL_RS1_BIT));
+#else
+    ds3231_handle.control |= (1 << DS3231_CONTROL_INTCN_BIT);
+#endif
+    p_tx_buffer[1] = ds3231_handle.control;
+    Write_To_DS3231(p_tx_buffer, DS3231_ADDR_CONTROL, sizeof(p_tx_buffer));
+
+    ds3231_handle.int_sqw_gpio_handle.p_gpio_x = DS3231_INT_SQW_GPIO_PORT;
+    ds3231_handle.int_sqw_gpio_handle.gpio_pin_config = pin_conf;
+    GPIO_Init(&ds3231_handle.int_sqw_gpio_handle);
+    GPIO_IRQ_Priority_Config(DS3231_INT_SQW_IRQ_NO, DS3231_INT_SQW_IRQ_PRIORITY);
+    GPIO_IRQ_Interrupt_Config(DS3231_INT_SQW_IRQ_NO, ENABLE);
+
+#ifdef DS3231_INT_WIRED
+    /* An alarm that matched before the MCU reset holds the pin low, with no edge to come for it */
+    if (!GPIO_Read_From_Input_Pin(DS3231_INT_SQW_GPIO_PORT, DS3231_INT_SQW_GPIO_PIN))
+        DS3231_Service_Alarms();
+#endif
+}
+
+/*************** INTERRUPT HANDLERS *****************/
+void DS3231_INT_SQW_IRQHandler(void)
+{
+    GPIO_IRQ_Handler(DS3231_INT_SQW_GPIO_PIN);
+#ifdef DS3231_SQW_WIRED
+    /* The square wave falls as the chip counts on a second, which is also the only time an alarm can match */
+    Clock_Tick_Callback(ds3231_handle.clock_dev);
+    if (DS3231_Armed_Flags() == 0)
+        return;
+#endif
+    DS3231_Service_Alarms();
+}
+#endif
@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_tim_driver.h"
 #include "display.h"
 
 /***** GPIO pin and port configurations *****/
@@ -22,6 +23,26 @@
 #define DB7_GPIO_PORT               GPIOA
 #define RW_GPIO_PIN                 GPIO_PIN_7
 #define RW_GPIO_PORT                GPIOA
+/* DB4-DB7 should share a port so a nybble goes out in a single BSRR store; if E is on that port too, the
+ * rising enable edge rides along in the same store. Split wiring still works, one pin at a time. */
+
+/* Define LCD1602A_8_BIT_BUS when DB0-DB3 are wired as well. Every byte is then latched with a single
+ * enable pulse instead of two. DB0-DB3 must share a port; if it is also the DB4-DB7 port the whole byte
+ * goes out in one store. */
+/* #define LCD1602A_8_BIT_BUS */
+#ifdef LCD1602A_8_BIT_BUS
+#define DB0_GPIO_PIN                GPIO_PIN_8
+#define DB0_GPIO_PORT               GPIOE
+#define DB1_GPIO_PIN                GPIO_PIN_9
+#define DB1_GPIO_PORT               GPIOE
+#define DB2_GPIO_PIN                GPIO_PIN_10
+#define DB2_GPIO_PORT               GPIOE
+#define DB3_GPIO_PIN                GPIO_PIN_11
+#define DB3_GPIO_PORT               GPIOE
+#define LCD1602A_BUS_WIDTH          LCD_8_BIT
+#else
+#define LCD1602A_BUS_WIDTH          LCD_4_BIT
+#endif
 
 /***** LCD configuration bits *****/
 #define LCD_INCREMENT               1
@@ -40,6 +61,65 @@
 #define LCD_2_LINES                 1
 #define LCD_5_8_DOTS                0
 #define LCD_5_10_DOTS               1
+#define LCD_SHIFT_CURSOR            0
+#define LCD_SHIFT_DISPLAY           1
+#define LCD_SHIFT_LEFT              0
+#define LCD_SHIFT_RIGHT             1
+
+/***** Panel geometry *****/
+/* The driver runs any HD44780 module with one controller; pick the panel at build time (16x2 when none is
+ * defined). Row base addresses are where each visible row starts in DDRAM. */
+/* #define LCD1602A_PANEL_20X4 */
+/* #define LCD1602A_PANEL_40X2 */
+#if defined(LCD1602A_PANEL_20X4)
+#define LCD1602A_NUM_ROWS           4
+#define LCD1602A_NUM_COLS           20
+#define LCD1602A_ROW_BASE_ADDRS     { 0x00, 0x40, 0x14, 0x54 }
+#elif defined(LCD1602A_PANEL_40X2)
+#define LCD1602A_NUM_ROWS           2
+#define LCD1602A_NUM_COLS           40
+#define LCD1602A_ROW_BASE_ADDRS     { 0x00, 0x40 }
+#else
+#define LCD1602A_NUM_ROWS           2
+#define LCD1602A_NUM_COLS           16
+#define LCD1602A_ROW_BASE_ADDRS     { 0x00, 0x40 }
+#endif
+/* Whatever the panel, DDRAM is two lines of 40 cells (line 1 starts at 0x40). The visible rows are windows
+ * onto those lines which the display shift slides along, wrapping at the end of the line. */
+#define LCD1602A_DDRAM_LINES        2
+#define LCD1602A_DDRAM_LINE_LEN     40
+#define LCD1602A_DDRAM_LINE_BIT     6
+#define LCD1602A_DDRAM_COL_MASK     0x3F
+
+/***** CGRAM custom characters *****/
+/* Character codes 0-7 display whatever 5x8 bitmap is loaded in the matching CGRAM slot. Slots are
+ * handed out by an LRU cache keyed on the bitmap's address; a slot is only reused when no cell on
+ * screen shows it and the current frame has not claimed it. */
+#define LCD1602A_CGRAM_SLOTS        8
+#define LCD1602A_GLYPH_ROWS         8
+#define LCD1602A_GLYPH_FALLBACK     ((char)0xFF)    /* ROM full block, drawn if every slot is pinned */
+#define LCD1602A_CURSOR_UNKNOWN     0xFF            /* address counter left in CGRAM */
+#define LCD1602A_SHADOW_UNKNOWN     ((char)0x80)    /* cell contents unknown; never produced by the formatters */
+
+/***** Big digit clock face *****/
+/* HH:MM drawn three columns wide across the top two rows, AM/PM and seconds to the right */
+#define LCD1602A_BIG_DIGIT_WIDTH    3
+#define LCD1602A_BIG_DIGIT_HEIGHT   2
+#define LCD1602A_BIG_HRS_COL        0
+#define LCD1602A_BIG_COLON_COL      6
+#define LCD1602A_BIG_MINS_COL       7
+#define LCD1602A_BIG_HR_FMT_ROW     0
+#define LCD1602A_BIG_HR_FMT_COL     14
+#define LCD1602A_BIG_SECS_ROW       1
+#define LCD1602A_BIG_SECS_COL       14
+#define LCD1602A_BIG_COLON_CHAR     ((char)0xA5)    /* ROM middle dot, one on each row */
+
+/***** Shadow DDRAM diffing cost model *****/
+/* Costs are counted in bus bytes (one byte = two nybbles in 4-bit mode). When two dirty runs are
+ * separated by a gap of unchanged cells, the gap is rewritten if that costs no more than moving
+ * the cursor with a set_ddram_addr command; otherwise the next run is re-addressed. */
+#define LCD1602A_ADDR_CMD_COST      1       /* one set_ddram_addr command */
+#define LCD1602A_DATA_CELL_COST     1       /* one character written to DDRAM */
 
 /* Offsets of various fields in the date and time string buffers */
 #define LCD1602A_HRS_OFFSET         0
@@ -51,35 +131,117 @@
 #define LCD1602A_DATE_OFFSET        7
 #define LCD1602A_YEAR_OFFSET        10
 
-/***** Location of each date and time field on the 16x2 grid *****/
-/* Time field locations */
+/* Width of each string buffer as drawn */
+#define LCD1602A_TIME_WIDTH         11      /* "HH:MM:SS AM" */
+#define LCD1602A_FULL_DATE_WIDTH    14      /* "DOW MM/DD/YYYY" */
+#define LCD1602A_TEMPERATURE_WIDTH  7       /* " 23.25C" */
+#define LCD1602A_ALARM_WIDTH        8       /* "AL HH:MM" */
+
+/***** Panel layout *****/
+/* Where the time, date, temperature and alarm strings sit on the selected panel. The sub-fields (hours,
+ * month, ...) follow from the offsets above. A block that does not fit is hidden with SHOW 0; updating
+ * it then only touches the string buffer. */
+#if defined(LCD1602A_PANEL_20X4)
+#define LCD1602A_TIME_ROW           0
+#define LCD1602A_TIME_COL           0
+#define LCD1602A_FULL_DATE_ROW      1
+#define LCD1602A_FULL_DATE_COL      0
+#define LCD1602A_SHOW_TEMPERATURE   1
+#define LCD1602A_TEMPERATURE_ROW    0
+#define LCD1602A_TEMPERATURE_COL    13
+#define LCD1602A_SHOW_ALARM         1
+#define LCD1602A_ALARM_ROW          2
+#define LCD1602A_ALARM_COL          0
+#elif defined(LCD1602A_PANEL_40X2)
+#define LCD1602A_TIME_ROW           0
+#define LCD1602A_TIME_COL           0
+#define LCD1602A_FULL_DATE_ROW      1
+#define LCD1602A_FULL_DATE_COL      0
+#define LCD1602A_SHOW_TEMPERATURE   1
+#define LCD1602A_TEMPERATURE_ROW    0
+#define LCD1602A_TEMPERATURE_COL    14
+#define LCD1602A_SHOW_ALARM         1
+#define LCD1602A_ALARM_ROW          1
+#define LCD1602A_ALARM_COL          16
+#else
 #define LCD1602A_TIME_ROW           0
 #define LCD1602A_TIME_COL           0
-#define LCD1602A_HRS_ROW            LCD1602A_TIME_ROW
-#define LCD1602A_HRS_COL            LCD1602A_TIME_COL
-#define LCD1602A_MINS_ROW           LCD1602A_TIME_ROW
-#define LCD1602A_MINS_COL           (LCD1602A_TIME_COL + LCD1602A_MINS_OFFSET)
-#define LCD1602A_SECS_ROW           LCD1602A_TIME_ROW
-#define LCD1602A_SECS_COL           (LCD1602A_TIME_COL + LCD1602A_SECS_OFFSET)
-#define LCD1602A_HR_FMT_ROW         LCD1602A_TIME_ROW
-#define LCD1602A_HR_FMT_COL         (LCD1602A_TIME_COL + LCD1602A_HR_FMT_OFFSET)
-
-/* Date field locations */
 #define LCD1602A_FULL_DATE_ROW      1
 #define LCD1602A_FULL_DATE_COL      0
-#define LCD1602A_DOW_ROW            LCD1602A_FULL_DATE_ROW
-#define LCD1602A_DOW_COL            LCD1602A_FULL_DATE_COL
-#define LCD1602A_MONTH_ROW          LCD1602A_FULL_DATE_ROW
-#define LCD1602A_MONTH_COL          (LCD1602A_FULL_DATE_COL + LCD1602A_MONTH_OFFSET)
-#define LCD1602A_DATE_ROW           LCD1602A_FULL_DATE_ROW
-#define LCD1602A_DATE_COL           (LCD1602A_FULL_DATE_COL + LCD1602A_DATE_OFFSET)
-#define LCD1602A_YEAR_ROW           LCD1602A_FULL_DATE_ROW
-#define LCD1602A_YEAR_COL           (LCD1602A_FULL_DATE_COL + LCD1602A_YEAR_OFFSET)
+#define LCD1602A_SHOW_TEMPERATURE   0
+#define LCD1602A_TEMPERATURE_ROW    0
+#define LCD1602A_TEMPERATURE_COL    0
+#define LCD1602A_SHOW_ALARM         0
+#define LCD1602A_ALARM_ROW          0
+#define LCD1602A_ALARM_COL          0
+#endif
+
+/* Index into the field layout table */
+typedef enum
+{
+    LCD1602A_FIELD_TIME,
+    LCD1602A_FIELD_HRS,
+    LCD1602A_FIELD_MINS,
+    LCD1602A_FIELD_SECS,
+    LCD1602A_FIELD_HR_FMT,
+    LCD1602A_FIELD_FULL_DATE,
+    LCD1602A_FIELD_DOW,
+    LCD1602A_FIELD_MONTH,
+    LCD1602A_FIELD_DATE,
+    LCD1602A_FIELD_YEAR,
+    LCD1602A_FIELD_TEMPERATURE,
+    LCD1602A_FIELD_ALARM,
+    LCD1602A_NUM_FIELDS
+} LCD1602A_Field_t;
+
+typedef struct
+{
+    uint8_t                         row;
+    uint8_t                         col;
+    uint8_t                         width;      /* 0 hides the field */
+} LCD1602A_Field_Pos_t;
+
+/* A top-level field and the string buffer holding its text, for rebuilding whole rows */
+typedef struct
+{
+    LCD1602A_Field_t                field;
+    const char                      *buffer;
+} LCD1602A_Field_Source_t;
 
 /***** Command timing configuration *****/
-#define ENALBE_PULSE_US             500     /* how long to hold enable high when sending nybble */
-#define LCD_TAS_US                  1       /* how long to wait after toggling RS or RW pins for address setup */
-#define LCD_HOLD_TIME_US            500     /* how long to hold data lines valid after enable high to low transition */
+/* Define LCD1602A_RW_WIRED if the R/W pin is connected to RW_GPIO_PIN. The busy flag is then polled after
+ * every instruction, so the driver waits exactly as long as the controller needs. Leave it undefined when
+ * R/W is tied to ground (as in the README wiring); every instruction then waits out its worst-case
+ * execution time from the datasheet instead. */
+/* #define LCD1602A_RW_WIRED */
+
+#define LCD_TAS_US                  1       /* address setup time after toggling RS or RW pins (60ns min) */
+#define LCD_PW_EH_US                1       /* how long to hold enable high (450ns min) */
+#define LCD_TCYC_E_US               1       /* how long to wait after enable falls before the next pulse (1000ns cycle min) */
+#define LCD_TDDR_US                 1       /* delay from enable high until read data is valid (360ns max) */
+#define LCD_EXEC_TIME_US            41      /* most instructions take 37us, plus 4us to update the address counter */
+#define LCD_EXEC_TIME_LONG_US       1600    /* clear display and return home take 1.52ms */
+#define LCD_BUSY_TIMEOUT_FACTOR     4       /* give up polling the busy flag after this many worst-case execution times */
+#define LCD_BUSY_FLAG_MASK          0x80
+#define LCD_ADDR_COUNTER_MASK       0x7F
+
+/***** Interrupt-driven update engine *****/
+/* The Display_Update_*_IT calls queue their bytes and a basic timer clocks them out, one nybble per tick.
+ * Two ticks per byte already covers the 41us execution time, so only clear/home hold the queue back. */
+#define LCD1602A_TIM                TIM7
+#define LCD1602A_TIM_IRQ_PRIORITY   2       /* below the I2C event interrupt, whose callbacks start display updates */
+#define LCD1602A_TICK_US            50
+#define LCD1602A_TX_QUEUE_SIZE      128     /* power of 2, at most 128 (8-bit indices); a big-digit frame loading all 8 glyphs is ~110 bytes */
+#define LCD1602A_TX_QUEUE_MASK      (LCD1602A_TX_QUEUE_SIZE - 1)
+
+/***** Marquee *****/
+/* A second basic timer paces the display shift. It runs at the engine's priority so a step never lands in
+ * the middle of an engine tick. */
+#define LCD1602A_MARQUEE_TIM                TIM6
+#define LCD1602A_MARQUEE_IRQ_PRIORITY       LCD1602A_TIM_IRQ_PRIORITY
+#define LCD1602A_MARQUEE_COUNTER_HZ         10000   /* 0.1ms per count */
+#define LCD1602A_MARQUEE_MAX_STEP_MS        6553    /* TIM6 ARR is 16 bits */
+#define LCD1602A_MARQUEE_OFF                0xFF    /* marquee_line when no marquee is running */
 
 /***** Utility *****/
 #define ASCII_DIGIT_OFFSET          48
@@ -100,14 +262,76 @@ typedef enum
     READ_FROM_RAM
 } LCD_1602A_Commands_t;
 
+/* Which _IT call the engine is working on, so the matching completion callback can be raised */
+typedef enum
+{
+    LCD1602A_UPDATE_NONE,
+    LCD1602A_UPDATE_CLEAR,
+    LCD1602A_UPDATE_SECONDS,
+    LCD1602A_UPDATE_MINUTES,
+    LCD1602A_UPDATE_HOURS,
+    LCD1602A_UPDATE_TIME,
+    LCD1602A_UPDATE_DATE,
+    LCD1602A_UPDATE_DAY_OF_WEEK,
+    LCD1602A_UPDATE_MONTH,
+    LCD1602A_UPDATE_YEAR,
+    LCD1602A_UPDATE_FULL_DATE,
+    LCD1602A_UPDATE_DATETIME,
+    LCD1602A_UPDATE_TEMPERATURE,
+    LCD1602A_UPDATE_ALARM,
+    LCD1602A_UPDATE_BIG_TIME,
+    LCD1602A_UPDATE_MARQUEE_STEP
+} LCD1602A_Update_t;
+
+/* One queued bus byte; exec_ticks is how many extra ticks to hold off the next byte */
+typedef struct
+{
+    uint8_t                         data;
+    uint8_t                         rs;
+    uint8_t                         exec_ticks;
+} LCD1602A_Tx_Entry_t;
+
 typedef struct
 {
     Display_Device_t                *display_dev;
     LCD_1602A_Commands_t            cmd_stage;
     char                            time_str_buffer[12];
     char                            date_str_buffer[15];
-    uint8_t                         cursor_row_pos;
-    uint8_t                         cursor_col_pos;
+    char                            temperature_str_buffer[LCD1602A_TEMPERATURE_WIDTH + 1];
+    char                            alarm_str_buffer[LCD1602A_ALARM_WIDTH + 1];
+    char                            shadow_ddram[LCD1602A_DDRAM_LINES][LCD1602A_DDRAM_LINE_LEN];
+    uint8_t                         cursor_addr;            /* DDRAM address counter, or LCD1602A_CURSOR_UNKNOWN */
+    uint8_t                         display_shift;          /* cells the display has been shifted left */
+    uint8_t                         marquee_line;           /* DDRAM line being scrolled, or LCD1602A_MARQUEE_OFF */
+    uint32_t                        bytes_sent;
+    uint32_t                        frame_start_bytes;
+    uint32_t                        frame_count;
+    const uint8_t                   *cgram_glyph[LCD1602A_CGRAM_SLOTS];      /* bitmap resident in each slot */
+    uint32_t                        cgram_last_use[LCD1602A_CGRAM_SLOTS];    /* frame_count of last use */
+    uint8_t                         cgram_refs[LCD1602A_CGRAM_SLOTS];        /* shadow cells showing each slot */
+    LCD1602A_Tx_Entry_t             tx_queue[LCD1602A_TX_QUEUE_SIZE];
+    volatile uint8_t                tx_head;
+    volatile uint8_t                tx_tail;
+    uint8_t                         tx_low_nybble_next;
+    uint8_t                         tx_wait_ticks;
+    uint8_t                         queue_output;           /* set while an _IT call is building its frame */
+    volatile uint8_t                engine_busy;            /* held by an _IT update, or by a blocking call */
+    uint8_t                         blocking_depth;         /* nested blocking frames and bytes holding it */
+    LCD1602A_Update_t               curr_update;
+    TIM_Handle_t                    tim_handle;
+    TIM_Handle_t                    marquee_tim_handle;
+    uint32_t                        nybble_bsrr[16];        /* BSRR word putting each nybble on DB4-DB7 */
+    uint32_t                        e_set_bsrr;             /* raises E; 0 when nybble_bsrr already does */
+    uint32_t                        e_reset_bsrr;
+    uint8_t                         data_single_port;
+#ifdef LCD1602A_8_BIT_BUS
+    uint32_t                        low_nybble_bsrr[16];    /* same, for DB0-DB3; never carries E */
+    uint8_t                         byte_single_port;
+    GPIO_Handle_t                   db0_gpio_handle;
+    GPIO_Handle_t                   db1_gpio_handle;
+    GPIO_Handle_t                   db2_gpio_handle;
+    GPIO_Handle_t                   db3_gpio_handle;
+#endif
     GPIO_Handle_t                   db4_gpio_handle;
     GPIO_Handle_t                   db5_gpio_handle;
     GPIO_Handle_t                   db6_gpio_handle;
@@ -25,16 +25,75 @@ static void LCD1602A_Update_Year(year_t year, century_t century);
 static void LCD1602A_Update_Buffer_Year(year_t year, century_t century);
 static void LCD1602A_Update_Full_Date(full_date_t full_date);
 static void LCD1602A_Update_Buffer_Full_Date(full_date_t full_date);
+static void LCD1602A_Update_Buffer_Datetime(full_datetime_t datetime);
 static void LCD1602A_Update_Datetime(full_datetime_t datetime);
-static void LCD1602A_Set_Cursor(uint8_t row, uint8_t column);
+static void LCD1602A_Update_Temperature(temperature_t temperature);
+static void LCD1602A_Update_Buffer_Temperature(temperature_t temperature);
+static void LCD1602A_Update_Alarm(hours_t hours, minutes_t minutes, uint8_t enabled);
+static void LCD1602A_Update_Buffer_Alarm(hours_t hours, minutes_t minutes, uint8_t enabled);
+static void LCD1602A_Update_Big_Time(full_time_t full_time);
+static void LCD1602A_Draw_Big_Digit(char rows[][LCD1602A_NUM_COLS], uint8_t column, char digit);
+static void LCD1602A_Marquee_Start(uint8_t row, const char *msg, uint32_t step_ms);
+static void LCD1602A_Marquee_Stop(void);
+static void LCD1602A_Marquee_Step(void);
+static void LCD1602A_Compose_Row(uint8_t row, char *dst);
+static void LCD1602A_Clear_IT(void);
+static void LCD1602A_Update_Seconds_IT(seconds_t seconds);
+static void LCD1602A_Update_Minutes_IT(minutes_t minutes);
+static void LCD1602A_Update_Hours_IT(hours_t hours);
+static void LCD1602A_Update_Time_IT(full_time_t full_time);
+static void LCD1602A_Update_Date_IT(date_t date);
+static void LCD1602A_Update_Day_Of_Week_IT(day_of_week_t dow);
+static void LCD1602A_Update_Month_IT(month_t month);
+static void LCD1602A_Update_Year_IT(year_t year, century_t century);
+static void LCD1602A_Update_Full_Date_IT(full_date_t full_date);
+static void LCD1602A_Update_Datetime_IT(full_datetime_t datetime);
+static void LCD1602A_Update_Temperature_IT(temperature_t temperature);
+static void LCD1602A_Update_Alarm_IT(hours_t hours, minutes_t minutes, uint8_t enabled);
+static void LCD1602A_Update_Big_Time_IT(full_time_t full_time);
+static uint8_t LCD1602A_Claim_Engine(void);
+static void LCD1602A_Acquire_Engine(void);
+static void LCD1602A_Release_Engine(void);
+static uint8_t LCD1602A_Begin_Update_IT(LCD1602A_Update_t update);
+static void LCD1602A_Start_Update_IT(void);
+static void LCD1602A_Complete_Update_IT(void);
+static void LCD1602A_Engine_Tick(void);
+static void LCD1602A_Set_Cursor(uint8_t ddram_addr);
 static void LCD1602A_Display_Char(char ch);
-static void LCD1602A_Display_Str(char *str, size_t num_chars);
-
-static char int_to_ascii_char(uint8_t int_to_covert);
-static void int_to_zero_padded_ascii(char *result, uint8_t int_to_convert);
+static void LCD1602A_Flush(uint8_t row, uint8_t column, const char *src, size_t num_chars);
+static void LCD1602A_Flush_Span(uint8_t line, uint8_t index, const char *src, size_t num_chars);
+static void LCD1602A_Flush_Field(LCD1602A_Field_t field, const char *src);
+static void LCD1602A_Reset_Shadow(void);
+static void LCD1602A_Invalidate_Shadow(void);
+static char LCD1602A_Glyph_Char(const uint8_t *bitmap);
+static void LCD1602A_Upload_Glyph(uint8_t slot, const uint8_t *bitmap);
+static void LCD1602A_Track_Glyph_Refs(char old_ch, char new_ch);
+static void LCD1602A_Begin_Frame(void);
+static void LCD1602A_End_Frame(void);
+
+static void put_digit_pair(char *dst, uint32_t value);
 static void write_char(char ch);
-static void write_command(uint8_t cmd_word, uint32_t address_setup_us);
+static void write_command(uint8_t cmd_word, uint32_t exec_time_us);
+static void transfer_byte(uint8_t rs, uint8_t data, uint32_t exec_time_us);
+static void set_register_select(uint8_t rs);
+static void build_nybble_table(void);
+static void put_data_lines(uint32_t bsrr);
+static void latch_enable(void);
+#ifdef LCD1602A_8_BIT_BUS
+static void send_byte(uint8_t data);
+#else
 static void send_nybble(uint8_t nybble);
+#endif
+static void wait_until_ready(uint32_t exec_time_us);
+#ifdef LCD1602A_RW_WIRED
+static uint8_t read_busy_flag_and_address(void);
+#ifdef LCD1602A_8_BIT_BUS
+static uint8_t receive_byte(void);
+#else
+static uint8_t receive_nybble(void);
+#endif
+static void set_data_direction(uint8_t gpio_mode);
+#endif
 static void clear_display();
 static void return_home();
 static void entry_mode_set(uint8_t inc_dec, uint8_t shift);
@@ -43,30 +102,159 @@ static void cursor_display_shift(uint8_t shift_or_cursor, uint8_t right_left);
 static void function_set(uint8_t bit_len, uint8_t num_lines, uint8_t font);
 static void set_cgram_addr(uint8_t cgram_addr);
 static void set_ddram_addr(uint8_t ddram_addr);
-static void pulse_enable(uint32_t us_hold_time);
 static void mdelay(uint32_t cnt);
 static void udelay(uint32_t cnt);
 
 static LCD1602A_Handle_t lcd1602a_handle;
 static const char RESET_TIME_STR[] = "HH:MM:SS AM";
 static const char RESET_DATE_STR[] = "DOW MM/DD/YYYY";
+static const char RESET_TEMPERATURE_STR[] = " --.--C";
+static const char RESET_ALARM_STR[] = "AL --:--";
+
+static const uint8_t ROW_BASE_ADDR[LCD1602A_NUM_ROWS] = LCD1602A_ROW_BASE_ADDRS;
+
+#if (LCD1602A_TIME_COL + LCD1602A_TIME_WIDTH) > LCD1602A_NUM_COLS || \
+    (LCD1602A_FULL_DATE_COL + LCD1602A_FULL_DATE_WIDTH) > LCD1602A_NUM_COLS
+#error "Time and date must fit on the selected panel."
+#endif
+#if LCD1602A_SHOW_TEMPERATURE && (LCD1602A_TEMPERATURE_COL + LCD1602A_TEMPERATURE_WIDTH) > LCD1602A_NUM_COLS
+#error "Temperature field runs off the selected panel."
+#endif
+#if LCD1602A_SHOW_ALARM && (LCD1602A_ALARM_COL + LCD1602A_ALARM_WIDTH) > LCD1602A_NUM_COLS
+#error "Alarm field runs off the selected panel."
+#endif
+
+/* Position and width of every field on the selected panel. All constant, so a flush of a fixed field
+ * folds down to the same immediate row/column/width the hand-written calls used to pass. */
+static const LCD1602A_Field_Pos_t FIELD_LAYOUT[LCD1602A_NUM_FIELDS] = {
+        [LCD1602A_FIELD_TIME]           = { LCD1602A_TIME_ROW, LCD1602A_TIME_COL, LCD1602A_TIME_WIDTH },
+        [LCD1602A_FIELD_HRS]            = { LCD1602A_TIME_ROW, LCD1602A_TIME_COL + LCD1602A_HRS_OFFSET, 2 },
+        [LCD1602A_FIELD_MINS]           = { LCD1602A_TIME_ROW, LCD1602A_TIME_COL + LCD1602A_MINS_OFFSET, 2 },
+        [LCD1602A_FIELD_SECS]           = { LCD1602A_TIME_ROW, LCD1602A_TIME_COL + LCD1602A_SECS_OFFSET, 2 },
+        [LCD1602A_FIELD_HR_FMT]         = { LCD1602A_TIME_ROW, LCD1602A_TIME_COL + LCD1602A_HR_FMT_OFFSET, 2 },
+        [LCD1602A_FIELD_FULL_DATE]      = { LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL, LCD1602A_FULL_DATE_WIDTH },
+        [LCD1602A_FIELD_DOW]            = { LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL + LCD1602A_DOW_OFFSET, 3 },
+        [LCD1602A_FIELD_MONTH]          = { LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL + LCD1602A_MONTH_OFFSET, 2 },
+        [LCD1602A_FIELD_DATE]           = { LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL + LCD1602A_DATE_OFFSET, 2 },
+        [LCD1602A_FIELD_YEAR]           = { LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL + LCD1602A_YEAR_OFFSET, 4 },
+        [LCD1602A_FIELD_TEMPERATURE]    = { LCD1602A_TEMPERATURE_ROW, LCD1602A_TEMPERATURE_COL,
+                                            LCD1602A_SHOW_TEMPERATURE ? LCD1602A_TEMPERATURE_WIDTH : 0 },
+        [LCD1602A_FIELD_ALARM]          = { LCD1602A_ALARM_ROW, LCD1602A_ALARM_COL,
+                                            LCD1602A_SHOW_ALARM ? LCD1602A_ALARM_WIDTH : 0 },
+};
+
+/* The fields which between them make up the text face */
+static const LCD1602A_Field_Source_t ROW_FIELDS[] = {
+        { LCD1602A_FIELD_TIME,          lcd1602a_handle.time_str_buffer },
+        { LCD1602A_FIELD_FULL_DATE,     lcd1602a_handle.date_str_buffer },
+        { LCD1602A_FIELD_TEMPERATURE,   lcd1602a_handle.temperature_str_buffer },
+        { LCD1602A_FIELD_ALARM,         lcd1602a_handle.alarm_str_buffer },
+};
+#define NUM_ROW_FIELDS  (sizeof(ROW_FIELDS) / sizeof(ROW_FIELDS[0]))
+
+/* Formatting tables; every field is a fixed-width copy out of one of these, no division at run time */
+/* The pair after "99" is the blank an out of range value shows as, as in the name tables */
+static const char DIGIT_PAIRS[101 * 2 + 1] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899"
+        "  ";
+static const char DOW_NAMES[][3] = {
+        "   ", "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+static const char HOUR_FORMAT_NAMES[][2] = {
+        [AM_PM_AM] = "AM", [AM_PM_PM] = "PM", [AM_PM_NONE] = "  "
+};
+static const char CENTURY_NAMES[][2] = {
+        [CENTURY_20TH] = "19", [CENTURY_21ST] = "20"
+};
+
+/* Segments the big digits are assembled from; 5 pixels wide, so only the low 5 bits of each row count */
+static const uint8_t BIG_SEG_UPPER_LEFT[LCD1602A_GLYPH_ROWS]  = { 0x07, 0x0F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+static const uint8_t BIG_SEG_UPPER_BAR[LCD1602A_GLYPH_ROWS]   = { 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00 };
+static const uint8_t BIG_SEG_UPPER_RIGHT[LCD1602A_GLYPH_ROWS] = { 0x1C, 0x1E, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+static const uint8_t BIG_SEG_LOWER_LEFT[LCD1602A_GLYPH_ROWS]  = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x0F, 0x07 };
+static const uint8_t BIG_SEG_LOWER_BAR[LCD1602A_GLYPH_ROWS]   = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F };
+static const uint8_t BIG_SEG_LOWER_RIGHT[LCD1602A_GLYPH_ROWS] = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1E, 0x1C };
+static const uint8_t BIG_SEG_UPPER_MID[LCD1602A_GLYPH_ROWS]   = { 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x1F, 0x1F };
+static const uint8_t BIG_SEG_LOWER_MID[LCD1602A_GLYPH_ROWS]   = { 0x1F, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F };
+
+typedef enum
+{
+    UL, UB, UR, LL, LB, LR, UM, LM,
+    NUM_BIG_SEGS
+} Big_Segment_t;
+
+static const uint8_t *const BIG_SEGMENTS[NUM_BIG_SEGS] = {
+        [UL] = BIG_SEG_UPPER_LEFT,
+        [UB] = BIG_SEG_UPPER_BAR,
+        [UR] = BIG_SEG_UPPER_RIGHT,
+        [LL] = BIG_SEG_LOWER_LEFT,
+        [LB] = BIG_SEG_LOWER_BAR,
+        [LR] = BIG_SEG_LOWER_RIGHT,
+        [UM] = BIG_SEG_UPPER_MID,
+        [LM] = BIG_SEG_LOWER_MID,
+};
+
+/* Cells of each big digit, top row then bottom row. Values below NUM_BIG_SEGS are segments, anything
+ * else is a character from the controller ROM. */
+#define BIG_BLANK   ' '
+#define BIG_FULL    0xFF
+static const uint8_t BIG_DIGIT_FONT[10][LCD1602A_BIG_DIGIT_HEIGHT][LCD1602A_BIG_DIGIT_WIDTH] = {
+        { { UL, UB, UR },               { LL, LB, LR } },
+        { { UB, UR, BIG_BLANK },        { LB, BIG_FULL, LB } },
+        { { UM, UM, UR },               { LL, LB, LB } },
+        { { UM, UM, UR },               { LB, LB, LR } },
+        { { LL, LB, BIG_FULL },         { BIG_BLANK, BIG_BLANK, BIG_FULL } },
+        { { LL, UM, UM },               { LB, LB, LR } },
+        { { UL, UM, UM },               { LL, LB, LR } },
+        { { UB, UB, UR },               { BIG_BLANK, BIG_BLANK, BIG_FULL } },
+        { { UL, UM, UR },               { LL, LB, LR } },
+        { { UL, UM, UR },               { BIG_BLANK, BIG_BLANK, BIG_FULL } },
+};
 
 /* Implements the display driver interface defined in Inc/display.h for a HD44780U-controlled 16x2 LCD*/
 static Display_Driver_t lcd1602_display_driver = {
-        .Display_Initialize             = LCD1602A_Initialize,
-        .Display_On                     = LCD1602A_On,
-        .Display_Off                    = LCD1602A_Off,
-        .Display_Clear                  = LCD1602A_Clear,
-        .Display_Update_Seconds         = LCD1602A_Update_Seconds,
-        .Display_Update_Minutes         = LCD1602A_Update_Minutes,
-        .Display_Update_Hours           = LCD1602A_Update_Hours,
-        .Display_Update_Time            = LCD1602A_Update_Time,
-        .Display_Update_Date            = LCD1602A_Update_Date,
-        .Display_Update_Day_Of_Week     = LCD1602A_Update_Day_Of_Week,
-        .Display_Update_Month           = LCD1602A_Update_Month,
-        .Display_Update_Year            = LCD1602A_Update_Year,
-        .Display_Update_Full_Date       = LCD1602A_Update_Full_Date,
-        .Display_Update_Datetime        = LCD1602A_Update_Datetime,
+        .Display_Initialize                 = LCD1602A_Initialize,
+        .Display_On                         = LCD1602A_On,
+        .Display_Off                        = LCD1602A_Off,
+        .Display_Clear                      = LCD1602A_Clear,
+        .Display_Update_Seconds             = LCD1602A_Update_Seconds,
+        .Display_Update_Minutes             = LCD1602A_Update_Minutes,
+        .Display_Update_Hours               = LCD1602A_Update_Hours,
+        .Display_Update_Time                = LCD1602A_Update_Time,
+        .Display_Update_Date                = LCD1602A_Update_Date,
+        .Display_Update_Day_Of_Week         = LCD1602A_Update_Day_Of_Week,
+        .Display_Update_Month               = LCD1602A_Update_Month,
+        .Display_Update_Year                = LCD1602A_Update_Year,
+        .Display_Update_Full_Date           = LCD1602A_Update_Full_Date,
+        .Display_Update_Datetime            = LCD1602A_Update_Datetime,
+        .Display_Update_Temperature         = LCD1602A_Update_Temperature,
+        .Display_Update_Alarm               = LCD1602A_Update_Alarm,
+        .Display_Marquee_Start              = LCD1602A_Marquee_Start,
+        .Display_Marquee_Stop               = LCD1602A_Marquee_Stop,
+        .Display_Update_Big_Time            = LCD1602A_Update_Big_Time,
+        .Display_Clear_IT                   = LCD1602A_Clear_IT,
+        .Display_Update_Seconds_IT          = LCD1602A_Update_Seconds_IT,
+        .Display_Update_Minutes_IT          = LCD1602A_Update_Minutes_IT,
+        .Display_Update_Hours_IT            = LCD1602A_Update_Hours_IT,
+        .Display_Update_Time_IT             = LCD1602A_Update_Time_IT,
+        .Display_Update_Date_IT             = LCD1602A_Update_Date_IT,
+        .Display_Update_Day_Of_Week_IT      = LCD1602A_Update_Day_Of_Week_IT,
+        .Display_Update_Month_IT            = LCD1602A_Update_Month_IT,
+        .Display_Update_Year_IT             = LCD1602A_Update_Year_IT,
+        .Display_Update_Full_Date_IT        = LCD1602A_Update_Full_Date_IT,
+        .Display_Update_Datetime_IT         = LCD1602A_Update_Datetime_IT,
+        .Display_Update_Temperature_IT      = LCD1602A_Update_Temperature_IT,
+        .Display_Update_Alarm_IT            = LCD1602A_Update_Alarm_IT,
+        .Display_Update_Big_Time_IT         = LCD1602A_Update_Big_Time_IT,
 };
 
 Display_Driver_t *get_display_driver()
@@ -118,41 +306,102 @@ static void LCD1602A_Initialize(Display_Device_t *lcd1602a_dev)
     lcd1602a_handle.db7_gpio_handle.gpio_pin_config = pin_conf;
     GPIO_Init(&lcd1602a_handle.db7_gpio_handle);
 
-    lcd1602a_handle.cursor_col_pos = 0;
-    lcd1602a_handle.cursor_row_pos = 0;
-    lcd1602a_handle.display_dev = lcd1602a_dev;
+#ifdef LCD1602A_8_BIT_BUS
+    /* Data lines - DB0 */
+    pin_conf.gpio_pin_num = DB0_GPIO_PIN;
+    lcd1602a_handle.db0_gpio_handle.p_gpio_x = DB0_GPIO_PORT;
+    lcd1602a_handle.db0_gpio_handle.gpio_pin_config = pin_conf;
+    GPIO_Init(&lcd1602a_handle.db0_gpio_handle);
+
+    /* DB1 */
+    pin_conf.gpio_pin_num = DB1_GPIO_PIN;
+    lcd1602a_handle.db1_gpio_handle.p_gpio_x = DB1_GPIO_PORT;
+    lcd1602a_handle.db1_gpio_handle.gpio_pin_config = pin_conf;
+    GPIO_Init(&lcd1602a_handle.db1_gpio_handle);
+
+    /* DB2 */
+    pin_conf.gpio_pin_num = DB2_GPIO_PIN;
+    lcd1602a_handle.db2_gpio_handle.p_gpio_x = DB2_GPIO_PORT;
+    lcd1602a_handle.db2_gpio_handle.gpio_pin_config = pin_conf;
+    GPIO_Init(&lcd1602a_handle.db2_gpio_handle);
+
+    /* DB3 */
+    pin_conf.gpio_pin_num = DB3_GPIO_PIN;
+    lcd1602a_handle.db3_gpio_handle.p_gpio_x = DB3_GPIO_PORT;
+    lcd1602a_handle.db3_gpio_handle.gpio_pin_config = pin_conf;
+    GPIO_Init(&lcd1602a_handle.db3_gpio_handle);
+#endif
 
-    strncpy(lcd1602a_handle.time_str_buffer,
-            RESET_TIME_STR,
-            sizeof(lcd1602a_handle.time_str_buffer) - 1);
-    strncpy(lcd1602a_handle.date_str_buffer,
-            RESET_DATE_STR,
-            sizeof(lcd1602a_handle.date_str_buffer) - 1);
+    lcd1602a_handle.display_dev = lcd1602a_dev;
+    lcd1602a_handle.bytes_sent = 0;
+    lcd1602a_handle.frame_count = 0;
+    /* CGRAM holds garbage after power-up, treat every slot as empty */
+    memset(lcd1602a_handle.cgram_glyph, 0, sizeof(lcd1602a_handle.cgram_glyph));
+    memset(lcd1602a_handle.cgram_last_use, 0, sizeof(lcd1602a_handle.cgram_last_use));
+    build_nybble_table();
+
+    /* Tick source for the _IT calls; counts microseconds so the tick is set directly in LCD1602A_TICK_US */
+    lcd1602a_handle.tim_handle.p_tim_x = LCD1602A_TIM;
+    lcd1602a_handle.tim_handle.counter_freq_hz = 1000000u;
+    lcd1602a_handle.tim_handle.period = LCD1602A_TICK_US;
+    lcd1602a_handle.tim_handle.irq_priority = LCD1602A_TIM_IRQ_PRIORITY;
+    lcd1602a_handle.tim_handle.p_update_callback = LCD1602A_Engine_Tick;
+    TIM_Init(&lcd1602a_handle.tim_handle);
+    lcd1602a_handle.tx_head = 0;
+    lcd1602a_handle.tx_tail = 0;
+    lcd1602a_handle.queue_output = 0;
+    lcd1602a_handle.engine_busy = 0;
+    lcd1602a_handle.blocking_depth = 0;
+    lcd1602a_handle.curr_update = LCD1602A_UPDATE_NONE;
+    lcd1602a_handle.marquee_line = LCD1602A_MARQUEE_OFF;
+    lcd1602a_handle.marquee_tim_handle.p_tim_x = LCD1602A_MARQUEE_TIM;
+    lcd1602a_handle.marquee_tim_handle.counter_freq_hz = LCD1602A_MARQUEE_COUNTER_HZ;
+    lcd1602a_handle.marquee_tim_handle.irq_priority = LCD1602A_MARQUEE_IRQ_PRIORITY;
+    lcd1602a_handle.marquee_tim_handle.p_update_callback = LCD1602A_Marquee_Step;
+
+    memcpy(lcd1602a_handle.time_str_buffer, RESET_TIME_STR, LCD1602A_TIME_WIDTH);
+    memcpy(lcd1602a_handle.date_str_buffer, RESET_DATE_STR, LCD1602A_FULL_DATE_WIDTH);
+    memcpy(lcd1602a_handle.temperature_str_buffer, RESET_TEMPERATURE_STR, LCD1602A_TEMPERATURE_WIDTH);
+    memcpy(lcd1602a_handle.alarm_str_buffer, RESET_ALARM_STR, LCD1602A_ALARM_WIDTH);
 
     /* set all pins to ground (clear entire GPIOD ODR port) */
     GPIO_Write_To_Output_Port(LCD_GPIO_PORT, 0);
     mdelay(40);
 
+#ifdef LCD1602A_8_BIT_BUS
+    /* Initialization by instruction: function set 8-bit three times, busy flag is not valid until after */
+    send_byte(0x30);
+    mdelay(5);
+    send_byte(0x30);
+    udelay(150);
+    send_byte(0x30);
+    udelay(LCD_EXEC_TIME_US);
+#else
     /* as part of initialization, 0x3 must be sent twice, then 0x2 to initiate 4-bit mode */
     send_nybble(0x3);
     mdelay(5);
     send_nybble(0x3);
     udelay(150);
     send_nybble(0x3);
+    udelay(LCD_EXEC_TIME_US);
     send_nybble(0x2);
+    /* Busy flag cannot be read until the interface is in 4-bit mode, so this one is a fixed wait */
+    udelay(LCD_EXEC_TIME_US);
 
     /* now we need to start sending 8-bit words in 2 nybbles separately (4-bit mode) */
-    /* 0x28 = 0010 1000, sets line number to 2 and style to 5x8 dot characters */
-    function_set(LCD_4_BIT, LCD_2_LINES, LCD_5_8_DOTS);
+#endif
+    /* sets the bus width, line number to 2 and style to 5x8 dot characters (0x28 on the 4-bit bus) */
+    LCD1602A_Begin_Frame();
+    function_set(LCD1602A_BUS_WIDTH, LCD_2_LINES, LCD_5_8_DOTS);
     display_on_off(LCD_DISP_ON, LCD_CURSOR_OFF, LCD_BLINK_OFF);
     clear_display();
+    /* The shadow relies on the address counter auto-incrementing after every character */
     entry_mode_set(LCD_INCREMENT, LCD_NO_SHIFT);
-    LCD1602A_Set_Cursor(LCD1602A_TIME_ROW, LCD1602A_TIME_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.time_str_buffer,
-                         sizeof(lcd1602a_handle.time_str_buffer) - 1);
-    LCD1602A_Set_Cursor(LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer,
-                         sizeof(lcd1602a_handle.date_str_buffer) - 1);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_TIME, lcd1602a_handle.time_str_buffer);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_FULL_DATE, lcd1602a_handle.date_str_buffer);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_TEMPERATURE, lcd1602a_handle.temperature_str_buffer);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_ALARM, lcd1602a_handle.alarm_str_buffer);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_On(void)
@@ -165,98 +414,80 @@ static void LCD1602A_Off(void)
     display_on_off(LCD_DISP_OFF, LCD_CURSOR_OFF, LCD_BLINK_OFF);
 }
 
-/* Resets the date and time to the default strings defined in this file */
+/* Resets every field to the default strings defined in this file. Whole rows are redrawn, so cells outside
+ * the fields (left over from the big-digit face, say) are blanked as well. */
 static void LCD1602A_Clear(void)
 {
-    strncpy(lcd1602a_handle.time_str_buffer,
-            RESET_TIME_STR,
-            sizeof(RESET_TIME_STR) - 1);
-    LCD1602A_Set_Cursor(LCD1602A_TIME_ROW, LCD1602A_TIME_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.time_str_buffer,
-                         sizeof(lcd1602a_handle.time_str_buffer) - 1);
+    char row_str[LCD1602A_NUM_COLS];
+
+    LCD1602A_Begin_Frame();
+    memcpy(lcd1602a_handle.time_str_buffer, RESET_TIME_STR, LCD1602A_TIME_WIDTH);
+    memcpy(lcd1602a_handle.date_str_buffer, RESET_DATE_STR, LCD1602A_FULL_DATE_WIDTH);
+    memcpy(lcd1602a_handle.temperature_str_buffer, RESET_TEMPERATURE_STR, LCD1602A_TEMPERATURE_WIDTH);
+    memcpy(lcd1602a_handle.alarm_str_buffer, RESET_ALARM_STR, LCD1602A_ALARM_WIDTH);
 
-    strncpy(lcd1602a_handle.date_str_buffer,
-           RESET_DATE_STR,
-           sizeof(RESET_DATE_STR) - 1);
-    LCD1602A_Set_Cursor(LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer,
-                         sizeof(lcd1602a_handle.date_str_buffer) - 1);
+    for (uint8_t row = 0; row < LCD1602A_NUM_ROWS; row++)
+    {
+        LCD1602A_Compose_Row(row, row_str);
+        LCD1602A_Flush(row, 0, row_str, LCD1602A_NUM_COLS);
+    }
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Seconds(seconds_t seconds)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Seconds(seconds);
-    LCD1602A_Set_Cursor(LCD1602A_SECS_ROW, LCD1602A_SECS_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.time_str_buffer + LCD1602A_SECS_OFFSET, 2);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_SECS, lcd1602a_handle.time_str_buffer + LCD1602A_SECS_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Seconds(seconds_t seconds)
 {
-    char seconds_str[3] = {0};
-    int_to_zero_padded_ascii(seconds_str, (uint8_t)seconds);
-    strncpy(lcd1602a_handle.time_str_buffer + LCD1602A_SECS_OFFSET,
-            seconds_str,
-            2);
+    put_digit_pair(lcd1602a_handle.time_str_buffer + LCD1602A_SECS_OFFSET, seconds);
 }
 
 static void LCD1602A_Update_Minutes(minutes_t minutes)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Minutes(minutes);
-    LCD1602A_Set_Cursor(LCD1602A_MINS_ROW, LCD1602A_MINS_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.time_str_buffer + LCD1602A_MINS_OFFSET, 2);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_MINS, lcd1602a_handle.time_str_buffer + LCD1602A_MINS_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Minutes(minutes_t minutes)
 {
-    char minutes_str[3] = {0};
-    int_to_zero_padded_ascii(minutes_str, (uint8_t)minutes);
-    strncpy(lcd1602a_handle.time_str_buffer + LCD1602A_MINS_OFFSET,
-            minutes_str,
-            2);
+    put_digit_pair(lcd1602a_handle.time_str_buffer + LCD1602A_MINS_OFFSET, minutes);
 }
 
 static void LCD1602A_Update_Hours(hours_t hours)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Hours(hours);
-    LCD1602A_Set_Cursor(LCD1602A_HRS_ROW, LCD1602A_HRS_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.time_str_buffer + LCD1602A_HRS_OFFSET, 2);
-    LCD1602A_Set_Cursor(LCD1602A_HR_FMT_ROW, LCD1602A_HR_FMT_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.time_str_buffer + LCD1602A_HR_FMT_OFFSET, 2);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_HRS, lcd1602a_handle.time_str_buffer + LCD1602A_HRS_OFFSET);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_HR_FMT, lcd1602a_handle.time_str_buffer + LCD1602A_HR_FMT_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Hours(hours_t hours)
 {
-    char hours_str[3] = {0};
-    char hour_format[3] = "  ";
-
-    int_to_zero_padded_ascii(hours_str, (uint8_t)hours.hour);
-    strncpy(lcd1602a_handle.time_str_buffer + LCD1602A_HRS_OFFSET,
-            hours_str,
-            2);
+    am_pm_t am_pm = AM_PM_NONE;
 
-    if (hours.hour_format == HOUR_FORMAT_12_HOUR)
+    if (hours.hour_format == HOUR_FORMAT_12_HOUR && hours.am_pm <= AM_PM_NONE)
     {
-        if (hours.am_pm == AM_PM_AM)
-        {
-            strncpy(hour_format, "AM", sizeof(hour_format));
-        }
-        else
-        {
-            strncpy(hour_format, "PM", sizeof(hour_format));
-        }
+        am_pm = hours.am_pm;
     }
 
-    strncpy(lcd1602a_handle.time_str_buffer + LCD1602A_HR_FMT_OFFSET,
-            hour_format,
-            2);
+    put_digit_pair(lcd1602a_handle.time_str_buffer + LCD1602A_HRS_OFFSET, hours.hour);
+    memcpy(lcd1602a_handle.time_str_buffer + LCD1602A_HR_FMT_OFFSET, HOUR_FORMAT_NAMES[am_pm], 2);
 }
 
 static void LCD1602A_Update_Time(full_time_t full_time)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Time(full_time);
-    LCD1602A_Update_Hours(full_time.hours);
-    LCD1602A_Update_Minutes(full_time.minutes);
-    LCD1602A_Update_Seconds(full_time.seconds);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_TIME, lcd1602a_handle.time_str_buffer);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Time(full_time_t full_time)
@@ -268,108 +499,69 @@ static void LCD1602A_Update_Buffer_Time(full_time_t full_time)
 
 static void LCD1602A_Update_Date(date_t date)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Date(date);
-    LCD1602A_Set_Cursor(LCD1602A_DATE_ROW, LCD1602A_DATE_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer + LCD1602A_DATE_OFFSET, 2);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_DATE, lcd1602a_handle.date_str_buffer + LCD1602A_DATE_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Date(date_t date)
 {
-    char date_str[3] = {0};
-    int_to_zero_padded_ascii(date_str, (uint8_t)date);
-    strncpy(lcd1602a_handle.date_str_buffer + LCD1602A_DATE_OFFSET,
-            date_str,
-            2);
+    put_digit_pair(lcd1602a_handle.date_str_buffer + LCD1602A_DATE_OFFSET, date);
 }
 
 static void LCD1602A_Update_Day_Of_Week(day_of_week_t dow)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Day_Of_Week(dow);
-    LCD1602A_Set_Cursor(LCD1602A_DOW_ROW, LCD1602A_DOW_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer + LCD1602A_DOW_OFFSET, 3);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_DOW, lcd1602a_handle.date_str_buffer + LCD1602A_DOW_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Day_Of_Week(day_of_week_t dow)
 {
-    char dow_str[4] = {0};
-    switch (dow)
+    /* Out of range values show as blanks */
+    if (dow > DAY_OF_WEEK_SAT)
     {
-    case DAY_OF_WEEK_SUN:
-        strncpy(dow_str, "Sun", 3);
-        break;
-    case DAY_OF_WEEK_MON:
-        strncpy(dow_str, "Mon", 3);
-        break;
-    case DAY_OF_WEEK_TUE:
-        strncpy(dow_str, "Tue", 3);
-        break;
-    case DAY_OF_WEEK_WED:
-        strncpy(dow_str, "Wed", 3);
-        break;
-    case DAY_OF_WEEK_THU:
-        strncpy(dow_str, "Thu", 3);
-        break;
-    case DAY_OF_WEEK_FRI:
-        strncpy(dow_str, "Fri", 3);
-        break;
-    case DAY_OF_WEEK_SAT:
-        strncpy(dow_str, "Sat", 3);
-        break;
+        dow = 0;
     }
-    strncpy(lcd1602a_handle.date_str_buffer + LCD1602A_DOW_OFFSET,
-            dow_str,
-            3);
+    memcpy(lcd1602a_handle.date_str_buffer + LCD1602A_DOW_OFFSET, DOW_NAMES[dow], 3);
 }
 
-
 static void LCD1602A_Update_Month(month_t month)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Month(month);
-    LCD1602A_Set_Cursor(LCD1602A_MONTH_ROW, LCD1602A_MONTH_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer + LCD1602A_MONTH_OFFSET, 2);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_MONTH, lcd1602a_handle.date_str_buffer + LCD1602A_MONTH_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Month(month_t month)
 {
-    char month_str[3] = {0};
-    int_to_zero_padded_ascii(month_str, (uint8_t) month);
-    strncpy(lcd1602a_handle.date_str_buffer + LCD1602A_MONTH_OFFSET,
-            month_str,
-            2);
+    put_digit_pair(lcd1602a_handle.date_str_buffer + LCD1602A_MONTH_OFFSET, month);
 }
 
 static void LCD1602A_Update_Year(year_t year, century_t century)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Year(year, century);
-    LCD1602A_Set_Cursor(LCD1602A_YEAR_ROW, LCD1602A_YEAR_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer + LCD1602A_YEAR_OFFSET, 4);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_YEAR, lcd1602a_handle.date_str_buffer + LCD1602A_YEAR_OFFSET);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Year(year_t year, century_t century)
 {
-    char year_str[5] = {0};
-    int_to_zero_padded_ascii(year_str + 2, (uint8_t)year);
-
-    if (century == CENTURY_20TH)
-    {
-        strncpy(year_str, "19", 2);
-    }
-    else
-    {
-        strncpy(year_str, "20", 2);
-    }
-
-    strncpy(lcd1602a_handle.date_str_buffer + LCD1602A_YEAR_OFFSET,
-            year_str,
-            4);
+    memcpy(lcd1602a_handle.date_str_buffer + LCD1602A_YEAR_OFFSET,
+           CENTURY_NAMES[century == CENTURY_20TH ? CENTURY_20TH : CENTURY_21ST], 2);
+    put_digit_pair(lcd1602a_handle.date_str_buffer + LCD1602A_YEAR_OFFSET + 2, year);
 }
 
 static void LCD1602A_Update_Full_Date(full_date_t full_date)
 {
+    LCD1602A_Begin_Frame();
     LCD1602A_Update_Buffer_Full_Date(full_date);
-    LCD1602A_Set_Cursor(LCD1602A_FULL_DATE_ROW, LCD1602A_FULL_DATE_COL);
-    LCD1602A_Display_Str(lcd1602a_handle.date_str_buffer,
-                         sizeof(lcd1602a_handle.date_str_buffer) - 1);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_FULL_DATE, lcd1602a_handle.date_str_buffer);
+    LCD1602A_End_Frame();
 }
 
 static void LCD1602A_Update_Buffer_Full_Date(full_date_t full_date)
@@ -380,23 +572,520 @@ static void LCD1602A_Update_Buffer_Full_Date(full_date_t full_date)
     LCD1602A_Update_Buffer_Year(full_date.year, full_date.century);
 }
 
+/* Renders both rows whole, separators included, left to right in one pass. Out of range fields show as blanks,
+ * as they do through the per-field updates. */
+static void LCD1602A_Update_Buffer_Datetime(full_datetime_t datetime)
+{
+    char *time_str = lcd1602a_handle.time_str_buffer;
+    char *date_str = lcd1602a_handle.date_str_buffer;
+    am_pm_t am_pm = AM_PM_NONE;
+    day_of_week_t dow = (datetime.date.day_of_week <= DAY_OF_WEEK_SAT) ? datetime.date.day_of_week : 0;
+    century_t century = (datetime.date.century == CENTURY_20TH) ? CENTURY_20TH : CENTURY_21ST;
+
+    if (datetime.time.hours.hour_format == HOUR_FORMAT_12_HOUR && datetime.time.hours.am_pm <= AM_PM_NONE)
+    {
+        am_pm = datetime.time.hours.am_pm;
+    }
+
+    put_digit_pair(time_str + LCD1602A_HRS_OFFSET, datetime.time.hours.hour);
+    time_str[LCD1602A_HRS_OFFSET + 2] = ':';
+    put_digit_pair(time_str + LCD1602A_MINS_OFFSET, datetime.time.minutes);
+    time_str[LCD1602A_MINS_OFFSET + 2] = ':';
+    put_digit_pair(time_str + LCD1602A_SECS_OFFSET, datetime.time.seconds);
+    time_str[LCD1602A_SECS_OFFSET + 2] = ' ';
+    memcpy(time_str + LCD1602A_HR_FMT_OFFSET, HOUR_FORMAT_NAMES[am_pm], 2);
+
+    memcpy(date_str + LCD1602A_DOW_OFFSET, DOW_NAMES[dow], 3);
+    date_str[LCD1602A_DOW_OFFSET + 3] = ' ';
+    put_digit_pair(date_str + LCD1602A_MONTH_OFFSET, datetime.date.month);
+    date_str[LCD1602A_MONTH_OFFSET + 2] = '/';
+    put_digit_pair(date_str + LCD1602A_DATE_OFFSET, datetime.date.date);
+    date_str[LCD1602A_DATE_OFFSET + 2] = '/';
+    memcpy(date_str + LCD1602A_YEAR_OFFSET, CENTURY_NAMES[century], 2);
+    put_digit_pair(date_str + LCD1602A_YEAR_OFFSET + 2, datetime.date.year);
+}
+
 static void LCD1602A_Update_Datetime(full_datetime_t datetime)
 {
-    LCD1602A_Update_Time(datetime.time);
-    LCD1602A_Update_Full_Date(datetime.date);
+    LCD1602A_Begin_Frame();
+    LCD1602A_Update_Buffer_Datetime(datetime);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_TIME, lcd1602a_handle.time_str_buffer);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_FULL_DATE, lcd1602a_handle.date_str_buffer);
+    LCD1602A_End_Frame();
+}
+
+static void LCD1602A_Update_Temperature(temperature_t temperature)
+{
+    LCD1602A_Begin_Frame();
+    LCD1602A_Update_Buffer_Temperature(temperature);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_TEMPERATURE, lcd1602a_handle.temperature_str_buffer);
+    LCD1602A_End_Frame();
+}
+
+/* Formats quarter degrees as " 23.25C" / "-05.75C"; the magnitude saturates at 99.75 */
+static void LCD1602A_Update_Buffer_Temperature(temperature_t temperature)
+{
+    char *temperature_str = lcd1602a_handle.temperature_str_buffer;
+    uint16_t quarters = (temperature < 0) ? -temperature : temperature;
+    uint16_t whole = quarters >> 2;
+
+    temperature_str[0] = (temperature < 0) ? '-' : ' ';
+    put_digit_pair(temperature_str + 1, (whole > 99) ? 99 : whole);
+    temperature_str[3] = '.';
+    put_digit_pair(temperature_str + 4, (quarters & 0x3) * 25);
+    temperature_str[6] = 'C';
+}
+
+static void LCD1602A_Update_Alarm(hours_t hours, minutes_t minutes, uint8_t enabled)
+{
+    LCD1602A_Begin_Frame();
+    LCD1602A_Update_Buffer_Alarm(hours, minutes, enabled);
+    LCD1602A_Flush_Field(LCD1602A_FIELD_ALARM, lcd1602a_handle.alarm_str_buffer);
+    LCD1602A_End_Frame();
 }
 
-static void LCD1602A_Set_Cursor(uint8_t row, uint8_t column)
+/* Alarm time is shown as "AL HH:MM", hours as the RTC reports them; a disabled alarm shows dashes */
+static void LCD1602A_Update_Buffer_Alarm(hours_t hours, minutes_t minutes, uint8_t enabled)
 {
-    uint8_t ddram_addr = 0;
-    if (row == 1)
+    char *alarm_str = lcd1602a_handle.alarm_str_buffer;
+
+    memcpy(alarm_str, RESET_ALARM_STR, LCD1602A_ALARM_WIDTH);
+    if (enabled)
     {
-        /* 6th bit in DDRAM defines first row vs. second row address */
-        ddram_addr |= (1 << 6);
+        put_digit_pair(alarm_str + 3, hours.hour);
+        put_digit_pair(alarm_str + 6, minutes);
+    }
+}
+
+static void LCD1602A_Clear_IT(void)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_CLEAR))
+        return;
+    LCD1602A_Clear();
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Seconds_IT(seconds_t seconds)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_SECONDS))
+        return;
+    LCD1602A_Update_Seconds(seconds);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Minutes_IT(minutes_t minutes)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_MINUTES))
+        return;
+    LCD1602A_Update_Minutes(minutes);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Hours_IT(hours_t hours)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_HOURS))
+        return;
+    LCD1602A_Update_Hours(hours);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Time_IT(full_time_t full_time)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_TIME))
+        return;
+    LCD1602A_Update_Time(full_time);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Date_IT(date_t date)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_DATE))
+        return;
+    LCD1602A_Update_Date(date);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Day_Of_Week_IT(day_of_week_t dow)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_DAY_OF_WEEK))
+        return;
+    LCD1602A_Update_Day_Of_Week(dow);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Month_IT(month_t month)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_MONTH))
+        return;
+    LCD1602A_Update_Month(month);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Year_IT(year_t year, century_t century)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_YEAR))
+        return;
+    LCD1602A_Update_Year(year, century);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Full_Date_IT(full_date_t full_date)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_FULL_DATE))
+        return;
+    LCD1602A_Update_Full_Date(full_date);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Datetime_IT(full_datetime_t datetime)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_DATETIME))
+        return;
+    LCD1602A_Update_Datetime(datetime);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Temperature_IT(temperature_t temperature)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_TEMPERATURE))
+        return;
+    LCD1602A_Update_Temperature(temperature);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Alarm_IT(hours_t hours, minutes_t minutes, uint8_t enabled)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_ALARM))
+        return;
+    LCD1602A_Update_Alarm(hours, minutes, enabled);
+    LCD1602A_Start_Update_IT();
+}
+
+static void LCD1602A_Update_Big_Time_IT(full_time_t full_time)
+{
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_BIG_TIME))
+        return;
+    LCD1602A_Update_Big_Time(full_time);
+    LCD1602A_Start_Update_IT();
+}
+
+/* Claims the engine for an _IT call. While claimed, every byte the update produces is queued instead of
+ * being clocked out; the shadow and cursor bookkeeping run now, exactly as for a blocking call. */
+static uint8_t LCD1602A_Begin_Update_IT(LCD1602A_Update_t update)
+{
+    if (!LCD1602A_Claim_Engine())
+        return 0;
+
+    lcd1602a_handle.curr_update = update;
+    lcd1602a_handle.display_dev->ctrl_stage = DISPLAY_CTRL_UPDATING;
+    lcd1602a_handle.queue_output = 1;
+    return 1;
+}
+
+/* _IT calls come from interrupts as well as the application, so the test and the set must not be split */
+static uint8_t LCD1602A_Claim_Engine(void)
+{
+    uint32_t primask = Critical_Section_Enter();
+    uint8_t claimed = !lcd1602a_handle.engine_busy;
+
+    lcd1602a_handle.engine_busy = 1;
+    Critical_Section_Exit(primask);
+    return claimed;
+}
+
+/* A blocking call waits out any queued update, then holds the engine until it is done, so an _IT call made
+ * meanwhile is refused rather than interleaved. Blocking calls are made from thread context only. */
+static void LCD1602A_Acquire_Engine(void)
+{
+    if (lcd1602a_handle.blocking_depth++ == 0)
+    {
+        while (!LCD1602A_Claim_Engine()) {}
+    }
+}
+
+static void LCD1602A_Release_Engine(void)
+{
+    if (--lcd1602a_handle.blocking_depth == 0)
+        lcd1602a_handle.engine_busy = 0;
+}
+
+static void LCD1602A_Start_Update_IT(void)
+{
+    lcd1602a_handle.queue_output = 0;
+
+    if (lcd1602a_handle.tx_head == lcd1602a_handle.tx_tail)
+    {
+        /* Nothing on screen changed */
+        LCD1602A_Complete_Update_IT();
+        return;
+    }
+
+    lcd1602a_handle.tx_low_nybble_next = 0;
+    lcd1602a_handle.tx_wait_ticks = 0;
+    TIM_Start(&lcd1602a_handle.tim_handle);
+}
+
+static void LCD1602A_Complete_Update_IT(void)
+{
+    /* A completion callback may start the next update, which overwrites curr_update */
+    LCD1602A_Update_t update = lcd1602a_handle.curr_update;
+
+    TIM_Stop(&lcd1602a_handle.tim_handle);
+    lcd1602a_handle.curr_update = LCD1602A_UPDATE_NONE;
+    lcd1602a_handle.engine_busy = 0;
+    lcd1602a_handle.display_dev->ctrl_stage = DISPLAY_CTRL_IDLE;
+
+    switch (update)
+    {
+    case LCD1602A_UPDATE_CLEAR:
+        Display_Clear_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_SECONDS:
+        Display_Update_Seconds_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_MINUTES:
+        Display_Update_Minutes_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_HOURS:
+        Display_Update_Hours_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_TIME:
+        Display_Update_Time_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_DATE:
+        Display_Update_Date_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_DAY_OF_WEEK:
+        Display_Update_Day_Of_Week_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_MONTH:
+        Display_Update_Month_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_YEAR:
+        Display_Update_Year_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_FULL_DATE:
+        Display_Update_Full_Date_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_DATETIME:
+        Display_Update_Datetime_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_TEMPERATURE:
+        Display_Update_Temperature_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_ALARM:
+        Display_Update_Alarm_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_BIG_TIME:
+        Display_Update_Big_Time_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    case LCD1602A_UPDATE_MARQUEE_STEP:
+        Display_Marquee_Step_Complete_Callback(lcd1602a_handle.display_dev);
+        break;
+    default:
+        break;
+    }
+}
+
+/* Timer update handler; performs at most one bus transfer per call, a nybble or on the 8-bit bus a byte. After the low nybble of a byte the
+ * queue is held for that byte's execution time, or with R/W wired until the busy flag clears. */
+static void LCD1602A_Engine_Tick(void)
+{
+    LCD1602A_Tx_Entry_t *p_entry;
+
+    if (lcd1602a_handle.tx_wait_ticks > 0)
+    {
+#ifdef LCD1602A_RW_WIRED
+        if (read_busy_flag_and_address() & LCD_BUSY_FLAG_MASK)
+        {
+            lcd1602a_handle.tx_wait_ticks--;
+            return;
+        }
+        lcd1602a_handle.tx_wait_ticks = 0;
+#else
+        lcd1602a_handle.tx_wait_ticks--;
+        return;
+#endif
+    }
+
+    if (lcd1602a_handle.tx_head == lcd1602a_handle.tx_tail)
+    {
+        LCD1602A_Complete_Update_IT();
+        return;
+    }
+
+    p_entry = &lcd1602a_handle.tx_queue[lcd1602a_handle.tx_tail & LCD1602A_TX_QUEUE_MASK];
+#ifdef LCD1602A_8_BIT_BUS
+    set_register_select(p_entry->rs);
+    send_byte(p_entry->data);
+    lcd1602a_handle.tx_wait_ticks = p_entry->exec_ticks;
+    lcd1602a_handle.tx_tail++;
+#else
+    if (!lcd1602a_handle.tx_low_nybble_next)
+    {
+        set_register_select(p_entry->rs);
+        send_nybble(p_entry->data >> 4);
+        lcd1602a_handle.tx_low_nybble_next = 1;
+    }
+    else
+    {
+        send_nybble(p_entry->data & 0xF);
+        lcd1602a_handle.tx_low_nybble_next = 0;
+        lcd1602a_handle.tx_wait_ticks = p_entry->exec_ticks;
+        lcd1602a_handle.tx_tail++;
+    }
+#endif
+}
+
+/* Draws the time as big digits across the top LCD1602A_BIG_DIGIT_HEIGHT rows. The text fields share those
+ * rows, so going back to them takes a Display_Clear first. */
+static void LCD1602A_Update_Big_Time(full_time_t full_time)
+{
+    char rows[LCD1602A_BIG_DIGIT_HEIGHT][LCD1602A_NUM_COLS];
+    char *time_str = lcd1602a_handle.time_str_buffer;
+
+    LCD1602A_Begin_Frame();
+    /* Format through the text buffer so both faces agree on the digits */
+    LCD1602A_Update_Buffer_Time(full_time);
+
+    memset(rows, ' ', sizeof(rows));
+    LCD1602A_Draw_Big_Digit(rows, LCD1602A_BIG_HRS_COL, time_str[LCD1602A_HRS_OFFSET]);
+    LCD1602A_Draw_Big_Digit(rows, LCD1602A_BIG_HRS_COL + LCD1602A_BIG_DIGIT_WIDTH, time_str[LCD1602A_HRS_OFFSET + 1]);
+    rows[0][LCD1602A_BIG_COLON_COL] = LCD1602A_BIG_COLON_CHAR;
+    rows[1][LCD1602A_BIG_COLON_COL] = LCD1602A_BIG_COLON_CHAR;
+    LCD1602A_Draw_Big_Digit(rows, LCD1602A_BIG_MINS_COL, time_str[LCD1602A_MINS_OFFSET]);
+    LCD1602A_Draw_Big_Digit(rows, LCD1602A_BIG_MINS_COL + LCD1602A_BIG_DIGIT_WIDTH, time_str[LCD1602A_MINS_OFFSET + 1]);
+    memcpy(&rows[LCD1602A_BIG_HR_FMT_ROW][LCD1602A_BIG_HR_FMT_COL], time_str + LCD1602A_HR_FMT_OFFSET, 2);
+    memcpy(&rows[LCD1602A_BIG_SECS_ROW][LCD1602A_BIG_SECS_COL], time_str + LCD1602A_SECS_OFFSET, 2);
+
+    for (uint8_t row = 0; row < LCD1602A_BIG_DIGIT_HEIGHT; row++)
+    {
+        LCD1602A_Flush(row, 0, rows[row], LCD1602A_NUM_COLS);
+    }
+    LCD1602A_End_Frame();
+}
+
+static void LCD1602A_Draw_Big_Digit(char rows[][LCD1602A_NUM_COLS], uint8_t column, char digit)
+{
+    const uint8_t (*font)[LCD1602A_BIG_DIGIT_WIDTH] = BIG_DIGIT_FONT[digit - ASCII_DIGIT_OFFSET];
+    uint8_t cell;
+
+    for (uint8_t row = 0; row < LCD1602A_BIG_DIGIT_HEIGHT; row++)
+    {
+        for (uint8_t col = 0; col < LCD1602A_BIG_DIGIT_WIDTH; col++)
+        {
+            cell = font[row][col];
+            rows[row][column + col] = (cell < NUM_BIG_SEGS) ? LCD1602A_Glyph_Char(BIG_SEGMENTS[cell])
+                                                            : (char)cell;
+        }
+    }
+}
+
+/* Loads msg into every cell of the DDRAM line behind row, then lets the marquee timer scroll it. The line
+ * is written once; each step after that costs one shift command plus whatever the other rows need. */
+static void LCD1602A_Marquee_Start(uint8_t row, const char *msg, uint32_t step_ms)
+{
+    char line_str[LCD1602A_DDRAM_LINE_LEN];
+    uint8_t line;
+    size_t len = 0;
+
+    if (row >= LCD1602A_NUM_ROWS || step_ms == 0)
+        return;
+
+    if (step_ms > LCD1602A_MARQUEE_MAX_STEP_MS)
+        step_ms = LCD1602A_MARQUEE_MAX_STEP_MS;
+
+    LCD1602A_Marquee_Stop();
+
+    memset(line_str, ' ', sizeof(line_str));
+    while (len < LCD1602A_DDRAM_LINE_LEN && msg[len] != '\0')
+    {
+        line_str[len] = msg[len];
+        len++;
+    }
+
+    /* The display is unshifted here, so message cell i lands at line address i */
+    line = ROW_BASE_ADDR[row] >> LCD1602A_DDRAM_LINE_BIT;
+    LCD1602A_Begin_Frame();
+    LCD1602A_Flush_Span(line, 0, line_str, LCD1602A_DDRAM_LINE_LEN);
+    LCD1602A_End_Frame();
+    lcd1602a_handle.marquee_line = line;
+
+    lcd1602a_handle.marquee_tim_handle.period = step_ms * (LCD1602A_MARQUEE_COUNTER_HZ / 1000);
+    TIM_Init(&lcd1602a_handle.marquee_tim_handle);
+    TIM_Start(&lcd1602a_handle.marquee_tim_handle);
+}
+
+/* Stops the scroll, returns the display to its unshifted position and redraws the text face over the
+ * marquee line */
+static void LCD1602A_Marquee_Stop(void)
+{
+    char row_str[LCD1602A_NUM_COLS];
+
+    if (lcd1602a_handle.marquee_line == LCD1602A_MARQUEE_OFF)
+        return;
+
+    TIM_Stop(&lcd1602a_handle.marquee_tim_handle);
+    lcd1602a_handle.marquee_line = LCD1602A_MARQUEE_OFF;
+
+    LCD1602A_Begin_Frame();
+    return_home();
+    for (uint8_t row = 0; row < LCD1602A_NUM_ROWS; row++)
+    {
+        LCD1602A_Compose_Row(row, row_str);
+        LCD1602A_Flush(row, 0, row_str, LCD1602A_NUM_COLS);
+    }
+    LCD1602A_End_Frame();
+}
+
+/* Marquee timer handler. Shifts the display one cell left, then redraws the rows the marquee does not own
+ * so they stay put: their cells are re-based onto the shifted addresses, and the shadow diff only sends
+ * what differs there. A step that finds another update in flight is skipped. */
+static void LCD1602A_Marquee_Step(void)
+{
+    char row_str[LCD1602A_NUM_COLS];
+
+    if (!LCD1602A_Begin_Update_IT(LCD1602A_UPDATE_MARQUEE_STEP))
+        return;
+
+    LCD1602A_Begin_Frame();
+    cursor_display_shift(LCD_SHIFT_DISPLAY, LCD_SHIFT_LEFT);
+    lcd1602a_handle.display_shift = (lcd1602a_handle.display_shift + 1) % LCD1602A_DDRAM_LINE_LEN;
+    for (uint8_t row = 0; row < LCD1602A_NUM_ROWS; row++)
+    {
+        LCD1602A_Compose_Row(row, row_str);
+        LCD1602A_Flush(row, 0, row_str, LCD1602A_NUM_COLS);
+    }
+    LCD1602A_End_Frame();
+    LCD1602A_Start_Update_IT();
+}
+
+/* Rebuilds what a row of the text face shows from the field buffers */
+static void LCD1602A_Compose_Row(uint8_t row, char *dst)
+{
+    const LCD1602A_Field_Pos_t *pos;
+
+    memset(dst, ' ', LCD1602A_NUM_COLS);
+    for (uint8_t i = 0; i < NUM_ROW_FIELDS; i++)
+    {
+        pos = &FIELD_LAYOUT[ROW_FIELDS[i].field];
+        if (pos->row == row && pos->width != 0)
+        {
+            memcpy(dst + pos->col, ROW_FIELDS[i].buffer, pos->width);
+        }
+    }
+}
+
+static void LCD1602A_Set_Cursor(uint8_t ddram_addr)
+{
+    if (ddram_addr == lcd1602a_handle.cursor_addr)
+    {
+        /* Address counter already points here, no need to spend a command moving it */
+        return;
     }
 
-    ddram_addr |= (column & 0xF);
     set_ddram_addr(ddram_addr);
+    lcd1602a_handle.cursor_addr = ddram_addr;
 }
 
 static void LCD1602A_Display_Char(char ch)
@@ -404,163 +1093,584 @@ static void LCD1602A_Display_Char(char ch)
     write_char(ch);
 }
 
-static void LCD1602A_Display_Str(char *str, size_t num_chars)
+/* Brings the visible cells starting at (row, column) in line with src. The cells are re-based by the
+ * display shift to find the DDRAM they currently show. Rows on a line the marquee owns are left alone. */
+static void LCD1602A_Flush(uint8_t row, uint8_t column, const char *src, size_t num_chars)
+{
+    uint8_t line = ROW_BASE_ADDR[row] >> LCD1602A_DDRAM_LINE_BIT;
+    uint8_t index;
+    size_t span;
+
+    if (line == lcd1602a_handle.marquee_line)
+        return;
+
+    index = ((ROW_BASE_ADDR[row] & LCD1602A_DDRAM_COL_MASK) + column + lcd1602a_handle.display_shift)
+            % LCD1602A_DDRAM_LINE_LEN;
+
+    /* A shifted window can wrap past the end of the line, which the address counter does not follow */
+    span = LCD1602A_DDRAM_LINE_LEN - index;
+    if (span > num_chars)
+        span = num_chars;
+
+    LCD1602A_Flush_Span(line, index, src, span);
+    if (span < num_chars)
+        LCD1602A_Flush_Span(line, 0, src + span, num_chars - span);
+}
+
+/* Brings DDRAM cells [index, index + num_chars) of a line in line with src, sending only the cells which
+ * differ from the shadow copy of DDRAM. Each dirty run is written under a single cursor move, relying on
+ * entry mode auto-increment. A clean gap between two dirty runs is rewritten when that is no more
+ * expensive than re-addressing the cursor (see LCD1602A_*_COST). */
+static void LCD1602A_Flush_Span(uint8_t line, uint8_t index, const char *src, size_t num_chars)
 {
-    char curr;
-    for (int i = 0; i < num_chars; i++)
+    char *shadow = &lcd1602a_handle.shadow_ddram[line][index];
+    size_t run_start = 0;
+    size_t run_end;
+    size_t gap;
+
+    while (run_start < num_chars)
     {
-        curr = *str;
-        LCD1602A_Display_Char(curr);
-        str++;
+        if (shadow[run_start] == src[run_start])
+        {
+            run_start++;
+            continue;
+        }
+
+        /* Grow the dirty run, swallowing clean gaps which are cheaper to rewrite than to skip */
+        run_end = run_start + 1;
+        while (run_end < num_chars)
+        {
+            if (shadow[run_end] != src[run_end])
+            {
+                run_end++;
+                continue;
+            }
+
+            gap = 0;
+            while ((run_end + gap) < num_chars && shadow[run_end + gap] == src[run_end + gap])
+            {
+                gap++;
+            }
+            if ((run_end + gap) == num_chars ||
+                (gap * LCD1602A_DATA_CELL_COST) > LCD1602A_ADDR_CMD_COST)
+            {
+                break;
+            }
+            run_end += gap;
+        }
+
+        LCD1602A_Set_Cursor((line << LCD1602A_DDRAM_LINE_BIT) + index + run_start);
+        for (size_t i = run_start; i < run_end; i++)
+        {
+            LCD1602A_Display_Char(src[i]);
+            LCD1602A_Track_Glyph_Refs(shadow[i], src[i]);
+            shadow[i] = src[i];
+        }
+        run_start = run_end;
     }
 }
 
-/* Utility Functions*/
-static char int_to_ascii_char(uint8_t int_to_covert)
+/* Flushes one field of the panel layout; fields the selected panel has no room for are skipped */
+static void LCD1602A_Flush_Field(LCD1602A_Field_t field, const char *src)
 {
-    return int_to_covert + ASCII_DIGIT_OFFSET;
+    const LCD1602A_Field_Pos_t *pos = &FIELD_LAYOUT[field];
+
+    if (pos->width == 0)
+        return;
+
+    LCD1602A_Flush(pos->row, pos->col, src, pos->width);
+}
+
+/* After a clear display instruction DDRAM is filled with spaces, the address counter is 0 and the display
+ * is back in its unshifted position */
+static void LCD1602A_Reset_Shadow(void)
+{
+    memset(lcd1602a_handle.shadow_ddram, ' ', sizeof(lcd1602a_handle.shadow_ddram));
+    memset(lcd1602a_handle.cgram_refs, 0, sizeof(lcd1602a_handle.cgram_refs));
+    lcd1602a_handle.cursor_addr = 0;
+    lcd1602a_handle.display_shift = 0;
+}
+
+/* Forgets what the panel shows so the next flush of every cell rewrites it */
+static void LCD1602A_Invalidate_Shadow(void)
+{
+    memset(lcd1602a_handle.shadow_ddram, LCD1602A_SHADOW_UNKNOWN, sizeof(lcd1602a_handle.shadow_ddram));
+    memset(lcd1602a_handle.cgram_refs, 0, sizeof(lcd1602a_handle.cgram_refs));
+    lcd1602a_handle.cursor_addr = LCD1602A_CURSOR_UNKNOWN;
 }
 
-static void int_to_zero_padded_ascii(char *result, uint8_t int_to_convert)
+/* Returns the character code showing bitmap. A bitmap that is not resident is uploaded into the least
+ * recently used slot that no cell on screen shows and that this frame has not already claimed; redefining
+ * a slot changes every cell showing it, so those slots are off limits. */
+static char LCD1602A_Glyph_Char(const uint8_t *bitmap)
 {
-    if (int_to_convert < 10)
+    int8_t victim = -1;
+
+    for (uint8_t slot = 0; slot < LCD1602A_CGRAM_SLOTS; slot++)
     {
-        result[0] = '0';
-        result[1] = int_to_ascii_char(int_to_convert);
+        if (lcd1602a_handle.cgram_glyph[slot] == bitmap)
+        {
+            lcd1602a_handle.cgram_last_use[slot] = lcd1602a_handle.frame_count;
+            return (char)slot;
+        }
     }
-    else
+
+    for (uint8_t slot = 0; slot < LCD1602A_CGRAM_SLOTS; slot++)
+    {
+        if (lcd1602a_handle.cgram_refs[slot] != 0 ||
+            (lcd1602a_handle.cgram_glyph[slot] != NULL &&
+             lcd1602a_handle.cgram_last_use[slot] == lcd1602a_handle.frame_count))
+        {
+            continue;
+        }
+        if (victim < 0 || lcd1602a_handle.cgram_last_use[slot] < lcd1602a_handle.cgram_last_use[victim])
+        {
+            victim = slot;
+        }
+    }
+
+    if (victim < 0)
+    {
+        return LCD1602A_GLYPH_FALLBACK;
+    }
+
+    LCD1602A_Upload_Glyph(victim, bitmap);
+    lcd1602a_handle.cgram_glyph[victim] = bitmap;
+    lcd1602a_handle.cgram_last_use[victim] = lcd1602a_handle.frame_count;
+    return (char)victim;
+}
+
+static void LCD1602A_Upload_Glyph(uint8_t slot, const uint8_t *bitmap)
+{
+    set_cgram_addr(slot * LCD1602A_GLYPH_ROWS);
+    for (uint8_t row = 0; row < LCD1602A_GLYPH_ROWS; row++)
     {
-        result[0] = int_to_ascii_char(int_to_convert / 10);
-        result[1] = int_to_ascii_char(int_to_convert % 10);
+        transfer_byte(HIGH, bitmap[row] & 0x1F, LCD_EXEC_TIME_US);
     }
+    /* The address counter now points into CGRAM, so the next DDRAM write has to re-address */
+    lcd1602a_handle.cursor_addr = LCD1602A_CURSOR_UNKNOWN;
+}
+
+/* Keeps count of how many shadow cells show each CGRAM slot */
+static void LCD1602A_Track_Glyph_Refs(char old_ch, char new_ch)
+{
+    if ((uint8_t)old_ch < LCD1602A_CGRAM_SLOTS)
+        lcd1602a_handle.cgram_refs[(uint8_t)old_ch]--;
+    if ((uint8_t)new_ch < LCD1602A_CGRAM_SLOTS)
+        lcd1602a_handle.cgram_refs[(uint8_t)new_ch]++;
+}
+
+/* Every Display_Update_* call is one frame; the bytes it puts on the bus are reported to the
+ * application through the display device. */
+/* An _IT frame already holds the engine; a blocking one claims it here */
+static void LCD1602A_Begin_Frame(void)
+{
+    if (!lcd1602a_handle.queue_output)
+        LCD1602A_Acquire_Engine();
+    lcd1602a_handle.frame_start_bytes = lcd1602a_handle.bytes_sent;
+    lcd1602a_handle.frame_count++;
+}
+
+static void LCD1602A_End_Frame(void)
+{
+    lcd1602a_handle.display_dev->frame_bytes_sent = lcd1602a_handle.bytes_sent - lcd1602a_handle.frame_start_bytes;
+    if (!lcd1602a_handle.queue_output)
+        LCD1602A_Release_Engine();
+}
+
+/* Utility Functions*/
+/* Writes value as two zero padded digits; anything above 99 shows as blanks */
+static void put_digit_pair(char *dst, uint32_t value)
+{
+    const char *pair = &DIGIT_PAIRS[(value < 100 ? value : 100) * 2];
+
+    dst[0] = pair[0];
+    dst[1] = pair[1];
 }
 
 static void write_char(char ch)
 {
-    uint8_t low_nybble = (ch & 0xF);
-    uint8_t high_nybble = (ch >> 4);
+    transfer_byte(HIGH, (uint8_t)ch, LCD_EXEC_TIME_US);
+    /* Entry mode is increment, so the address counter moves one cell right after every character */
+    lcd1602a_handle.cursor_addr++;
+}
+
+static void write_command(uint8_t cmd_word, uint32_t exec_time_us)
+{
+    transfer_byte(LOW, cmd_word, exec_time_us);
+}
+
+/* Sends one byte with RS set for data (HIGH) or instruction (LOW), or queues it for the engine when an
+ * _IT call is building its frame. */
+static void transfer_byte(uint8_t rs, uint8_t data, uint32_t exec_time_us)
+{
+    LCD1602A_Tx_Entry_t *p_entry;
+
+    lcd1602a_handle.bytes_sent++;
 
-    /* Since I'm writing data, not a command, set RS high */
+    if (lcd1602a_handle.queue_output)
+    {
+        if ((uint8_t)(lcd1602a_handle.tx_head - lcd1602a_handle.tx_tail) >= LCD1602A_TX_QUEUE_SIZE)
+        {
+            /* Frame does not fit; the shadow no longer matches the panel, so force a full redraw next time */
+            LCD1602A_Invalidate_Shadow();
+            lcd1602a_handle.display_dev->ctrl_stage = DISPLAY_CTRL_ERROR;
+            return;
+        }
+        p_entry = &lcd1602a_handle.tx_queue[lcd1602a_handle.tx_head & LCD1602A_TX_QUEUE_MASK];
+        p_entry->data = data;
+        p_entry->rs = rs;
+        /* The tick after the low nybble is already LCD1602A_TICK_US later */
+        p_entry->exec_ticks = ((exec_time_us + LCD1602A_TICK_US - 1) / LCD1602A_TICK_US) - 1;
+        lcd1602a_handle.tx_head++;
+        return;
+    }
+
+    /* Inside a blocking frame the engine is already held; outside one, it is held for this byte */
+    LCD1602A_Acquire_Engine();
+    set_register_select(rs);
+#ifdef LCD1602A_8_BIT_BUS
+    send_byte(data);
+#else
+    send_nybble(data >> 4);
+    send_nybble(data & 0xF);
+#endif
+    wait_until_ready(exec_time_us);
+    LCD1602A_Release_Engine();
+}
+
+/* Wait for address setup time, 60ns minimum, after changing RS */
+static void set_register_select(uint8_t rs)
+{
     GPIO_Write_To_Output_Pin(lcd1602a_handle.rs_gpio_handle.p_gpio_x,
                              lcd1602a_handle.rs_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             HIGH);
+                             rs);
     udelay(LCD_TAS_US);
+}
+
+/* Precomputes the BSRR word for every nybble value, so send_nybble never has to read-modify-write ODR */
+static void build_nybble_table(void)
+{
+    GPIO_Handle_t *db_handles[4] = {
+            &lcd1602a_handle.db4_gpio_handle,
+            &lcd1602a_handle.db5_gpio_handle,
+            &lcd1602a_handle.db6_gpio_handle,
+            &lcd1602a_handle.db7_gpio_handle
+    };
+    uint8_t e_pin = lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num;
+    uint8_t e_shares_port;
+    uint8_t pin;
+
+    lcd1602a_handle.data_single_port = (DB5_GPIO_PORT == DB4_GPIO_PORT) &&
+                                       (DB6_GPIO_PORT == DB4_GPIO_PORT) &&
+                                       (DB7_GPIO_PORT == DB4_GPIO_PORT);
+    e_shares_port = lcd1602a_handle.data_single_port && (E_GPIO_PORT == DB4_GPIO_PORT);
+
+    for (uint8_t nybble = 0; nybble < 16; nybble++)
+    {
+        uint32_t bsrr = 0;
+        for (uint8_t bit = 0; bit < 4; bit++)
+        {
+            pin = db_handles[bit]->gpio_pin_config.gpio_pin_num;
+            /* BS bits occupy the low half-word, BR bits the high half-word */
+            bsrr |= ((nybble >> bit) & 1) ? (1U << pin) : (1U << (pin + 16));
+        }
+        if (e_shares_port)
+            bsrr |= (1U << e_pin);
+        lcd1602a_handle.nybble_bsrr[nybble] = bsrr;
+    }
+
+    lcd1602a_handle.e_set_bsrr = e_shares_port ? 0 : (1U << e_pin);
+    lcd1602a_handle.e_reset_bsrr = (1U << (e_pin + 16));
+
+#ifdef LCD1602A_8_BIT_BUS
+    GPIO_Handle_t *low_handles[4] = {
+            &lcd1602a_handle.db0_gpio_handle,
+            &lcd1602a_handle.db1_gpio_handle,
+            &lcd1602a_handle.db2_gpio_handle,
+            &lcd1602a_handle.db3_gpio_handle
+    };
 
-    send_nybble(high_nybble);
-    send_nybble(low_nybble);
+    /* A byte is then the OR of one entry from each table */
+    lcd1602a_handle.byte_single_port = lcd1602a_handle.data_single_port && (DB0_GPIO_PORT == DB4_GPIO_PORT);
+
+    for (uint8_t nybble = 0; nybble < 16; nybble++)
+    {
+        uint32_t bsrr = 0;
+        for (uint8_t bit = 0; bit < 4; bit++)
+        {
+            pin = low_handles[bit]->gpio_pin_config.gpio_pin_num;
+            bsrr |= ((nybble >> bit) & 1) ? (1U << pin) : (1U << (pin + 16));
+        }
+        lcd1602a_handle.low_nybble_bsrr[nybble] = bsrr;
+    }
+#endif
 }
 
-static void write_command(uint8_t cmd_word, uint32_t address_setup_us)
+/* Drives DB4-DB7 from a nybble_bsrr entry, raising E with them when the entry carries it */
+static void put_data_lines(uint32_t bsrr)
 {
-    uint8_t low_nybble = (cmd_word & 0xF);
-    uint8_t high_nybble = (cmd_word >> 4);
+    if (lcd1602a_handle.data_single_port)
+    {
+        /* DB4-7 (and E, if it shares the port) change in one store; data only has to be valid by E falling */
+        GPIO_Write_Set_Reset(DB4_GPIO_PORT, bsrr);
+    }
+    else
+    {
+        GPIO_Write_Set_Reset(DB4_GPIO_PORT, bsrr & (0x10001U << DB4_GPIO_PIN));
+        GPIO_Write_Set_Reset(DB5_GPIO_PORT, bsrr & (0x10001U << DB5_GPIO_PIN));
+        GPIO_Write_Set_Reset(DB6_GPIO_PORT, bsrr & (0x10001U << DB6_GPIO_PIN));
+        GPIO_Write_Set_Reset(DB7_GPIO_PORT, bsrr & (0x10001U << DB7_GPIO_PIN));
+    }
+}
+
+/* Completes the enable pulse put_data_lines may already have started */
+static void latch_enable(void)
+{
+    if (lcd1602a_handle.e_set_bsrr)
+    {
+        GPIO_Write_Set_Reset(E_GPIO_PORT, lcd1602a_handle.e_set_bsrr);
+    }
+
+    /* Enable pulse width is 450ns minimum */
+    udelay(LCD_PW_EH_US);
+    GPIO_Write_Set_Reset(E_GPIO_PORT, lcd1602a_handle.e_reset_bsrr);
+    /* Data must be held valid for 10ns, enable cannot pulse high again until the 1000ns cycle is over */
+    udelay(LCD_TCYC_E_US);
+}
+
+#ifdef LCD1602A_8_BIT_BUS
+static void send_byte(uint8_t data)
+{
+    uint32_t low_bsrr = lcd1602a_handle.low_nybble_bsrr[data & 0xF];
+    uint32_t high_bsrr = lcd1602a_handle.nybble_bsrr[data >> 4];
+
+    if (lcd1602a_handle.byte_single_port)
+    {
+        GPIO_Write_Set_Reset(DB0_GPIO_PORT, low_bsrr | high_bsrr);
+    }
+    else
+    {
+        /* Low lines first, so they are settled by the time the high-line store raises E */
+        GPIO_Write_Set_Reset(DB0_GPIO_PORT, low_bsrr);
+        put_data_lines(high_bsrr);
+    }
+    latch_enable();
+}
+#else
+static void send_nybble(uint8_t nybble)
+{
+    put_data_lines(lcd1602a_handle.nybble_bsrr[nybble & 0xF]);
+    latch_enable();
+}
+#endif
 
-    /* Since I'm sending a command, set RS low; wait for address setup time, 60ns minimum */
+/* Returns once the controller has finished the instruction that was just sent. With R/W wired the busy
+ * flag is polled, which usually returns well before the datasheet maximum; otherwise that maximum is
+ * waited out. */
+static void wait_until_ready(uint32_t exec_time_us)
+{
+#ifdef LCD1602A_RW_WIRED
+    uint32_t start = Timebase_Get_Cycles();
+    uint32_t timeout_cycles = exec_time_us * LCD_BUSY_TIMEOUT_FACTOR * (Timebase_Get_Core_Clk_Frequency() / 1000000u);
+
+    while (read_busy_flag_and_address() & LCD_BUSY_FLAG_MASK)
+    {
+        if ((Timebase_Get_Cycles() - start) > timeout_cycles)
+        {
+            /* Controller is not answering; carry on rather than hang the caller */
+            lcd1602a_handle.display_dev->ctrl_stage = DISPLAY_CTRL_ERROR;
+            return;
+        }
+    }
+#else
+    udelay(exec_time_us);
+#endif
+}
+
+#ifdef LCD1602A_RW_WIRED
+/* Reads the busy flag (bit 7) and address counter (bits 0-6). The data lines are only turned around for
+ * the duration of the read, every write path leaves them as outputs. */
+static uint8_t read_busy_flag_and_address(void)
+{
+    uint8_t bf_ac;
+
+    /* Stop driving the data lines before the LCD starts driving them */
+    set_data_direction(GPIO_MODE_IN);
     GPIO_Write_To_Output_Pin(lcd1602a_handle.rs_gpio_handle.p_gpio_x,
                              lcd1602a_handle.rs_gpio_handle.gpio_pin_config.gpio_pin_num,
                              LOW);
-    udelay(address_setup_us);
+    GPIO_Write_To_Output_Pin(lcd1602a_handle.rw_gpio_handle.p_gpio_x,
+                             lcd1602a_handle.rw_gpio_handle.gpio_pin_config.gpio_pin_num,
+                             HIGH);
+    udelay(LCD_TAS_US);
 
-    send_nybble(high_nybble);
-    send_nybble(low_nybble);
+#ifdef LCD1602A_8_BIT_BUS
+    bf_ac = receive_byte();
+#else
+    /* In 4-bit mode the high nybble comes out on the first enable pulse, low nybble on the second */
+    bf_ac = receive_nybble() << 4;
+    bf_ac |= receive_nybble();
+#endif
+
+    GPIO_Write_To_Output_Pin(lcd1602a_handle.rw_gpio_handle.p_gpio_x,
+                             lcd1602a_handle.rw_gpio_handle.gpio_pin_config.gpio_pin_num,
+                             LOW);
+    set_data_direction(GPIO_MODE_OUT);
+
+    return bf_ac;
 }
 
-static void send_nybble(uint8_t nybble)
+#ifdef LCD1602A_8_BIT_BUS
+static uint8_t receive_byte(void)
+{
+    uint8_t data = 0;
+
+    GPIO_Write_To_Output_Pin(lcd1602a_handle.e_gpio_handle.p_gpio_x,
+                             lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num,
+                             HIGH);
+    udelay(LCD_TDDR_US);
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db0_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db0_gpio_handle.gpio_pin_config.gpio_pin_num) << 0;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db1_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db1_gpio_handle.gpio_pin_config.gpio_pin_num) << 1;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db2_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db2_gpio_handle.gpio_pin_config.gpio_pin_num) << 2;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db3_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db3_gpio_handle.gpio_pin_config.gpio_pin_num) << 3;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db4_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db4_gpio_handle.gpio_pin_config.gpio_pin_num) << 4;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db5_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db5_gpio_handle.gpio_pin_config.gpio_pin_num) << 5;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db6_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db6_gpio_handle.gpio_pin_config.gpio_pin_num) << 6;
+    data |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db7_gpio_handle.p_gpio_x,
+                                     lcd1602a_handle.db7_gpio_handle.gpio_pin_config.gpio_pin_num) << 7;
+    GPIO_Write_To_Output_Pin(lcd1602a_handle.e_gpio_handle.p_gpio_x,
+                             lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num,
+                             LOW);
+    udelay(LCD_TCYC_E_US);
+
+    return data;
+}
+#else
+static uint8_t receive_nybble(void)
 {
-    /* Configure DB4-7 GPIO pins with the nybble value */
-    GPIO_Write_To_Output_Pin(lcd1602a_handle.db4_gpio_handle.p_gpio_x,
-                             lcd1602a_handle.db4_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             ((nybble >> 0) & 1));
-    GPIO_Write_To_Output_Pin(lcd1602a_handle.db5_gpio_handle.p_gpio_x,
-                             lcd1602a_handle.db5_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             ((nybble >> 1) & 1));
-    GPIO_Write_To_Output_Pin(lcd1602a_handle.db6_gpio_handle.p_gpio_x,
-                             lcd1602a_handle.db6_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             ((nybble >> 2) & 1));
-    GPIO_Write_To_Output_Pin(lcd1602a_handle.db7_gpio_handle.p_gpio_x,
-                             lcd1602a_handle.db7_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             ((nybble >> 3) & 1));
-
-    /* To send nybble to the LCD: pulse enable, then delay 1us for (enable pulse width = 450ns min) */
-    pulse_enable(ENALBE_PULSE_US);
-    /* wait for LCD to read data. Data must be held valid for 10ns, enable cannot pulse high again for 500ns */
-    udelay(LCD_HOLD_TIME_US);
+    uint8_t nybble = 0;
+
+    GPIO_Write_To_Output_Pin(lcd1602a_handle.e_gpio_handle.p_gpio_x,
+                             lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num,
+                             HIGH);
+    udelay(LCD_TDDR_US);
+    nybble |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db4_gpio_handle.p_gpio_x,
+                                       lcd1602a_handle.db4_gpio_handle.gpio_pin_config.gpio_pin_num) << 0;
+    nybble |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db5_gpio_handle.p_gpio_x,
+                                       lcd1602a_handle.db5_gpio_handle.gpio_pin_config.gpio_pin_num) << 1;
+    nybble |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db6_gpio_handle.p_gpio_x,
+                                       lcd1602a_handle.db6_gpio_handle.gpio_pin_config.gpio_pin_num) << 2;
+    nybble |= GPIO_Read_From_Input_Pin(lcd1602a_handle.db7_gpio_handle.p_gpio_x,
+                                       lcd1602a_handle.db7_gpio_handle.gpio_pin_config.gpio_pin_num) << 3;
+    GPIO_Write_To_Output_Pin(lcd1602a_handle.e_gpio_handle.p_gpio_x,
+                             lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num,
+                             LOW);
+    udelay(LCD_TCYC_E_US);
+
+    return nybble;
 }
+#endif
+
+static void set_data_direction(uint8_t gpio_mode)
+{
+#ifdef LCD1602A_8_BIT_BUS
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db0_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db0_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db1_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db1_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db2_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db2_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db3_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db3_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+#endif
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db4_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db4_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db5_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db5_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db6_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db6_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+    GPIO_Set_Pin_Mode(lcd1602a_handle.db7_gpio_handle.p_gpio_x,
+                      lcd1602a_handle.db7_gpio_handle.gpio_pin_config.gpio_pin_num,
+                      gpio_mode);
+}
+#endif
 
 static void clear_display()
 {
-    write_command(CLEAR_DISPLAY, LCD_TAS_US);
-    /* 2ms delay - clear display takes ~1.5ms for LCD to internally process */
-    mdelay(2);
+    write_command(CLEAR_DISPLAY, LCD_EXEC_TIME_LONG_US);
+    LCD1602A_Reset_Shadow();
 }
 
 static void return_home()
 {
-    write_command(RETURN_HOME, LCD_TAS_US);
-    /* 2ms delay - clear display takes ~1.5ms for LCD to internally process */
-    mdelay(2);
+    write_command(RETURN_HOME, LCD_EXEC_TIME_LONG_US);
+    lcd1602a_handle.cursor_addr = 0;
+    lcd1602a_handle.display_shift = 0;
 }
 
 static void entry_mode_set(uint8_t inc_dec, uint8_t shift)
 {
     uint8_t cmd_byte = ENTRY_MODE_SET;
     cmd_byte |= (inc_dec << 1) + (shift << 0);
-    write_command(cmd_byte, LCD_TAS_US);
+    write_command(cmd_byte, LCD_EXEC_TIME_US);
 }
 
 static void display_on_off(uint8_t disp, uint8_t cursor, uint8_t blink)
 {
     uint8_t cmd_byte = DISPLAY_ON_OFF_CTRL;
     cmd_byte |= (disp << 2) + (cursor << 1) + (blink << 0);
-    write_command(cmd_byte, LCD_TAS_US);
+    write_command(cmd_byte, LCD_EXEC_TIME_US);
 }
 
 static void cursor_display_shift(uint8_t shift_or_cursor, uint8_t right_left)
 {
     uint8_t cmd_byte = CURSOR_DISPLAY_SHIFT;
     cmd_byte |= (shift_or_cursor << 3) + (right_left << 2);
-    write_command(cmd_byte, LCD_TAS_US);
+    write_command(cmd_byte, LCD_EXEC_TIME_US);
 }
 
 static void function_set(uint8_t bit_len, uint8_t num_lines, uint8_t font)
 {
     uint8_t cmd_byte = FUNCTION_SET;
     cmd_byte |= (bit_len << 4) + (num_lines << 3) + (font << 2);
-    write_command(cmd_byte, LCD_TAS_US);
+    write_command(cmd_byte, LCD_EXEC_TIME_US);
 }
 
 static void set_cgram_addr(uint8_t cgram_addr)
 {
     uint8_t cmd_byte = SET_CGRAM_ADDR;
     cmd_byte |= (cgram_addr & 0x3F);
-    write_command(cmd_byte, LCD_TAS_US);
+    write_command(cmd_byte, LCD_EXEC_TIME_US);
 }
 
 static void set_ddram_addr(uint8_t ddram_addr)
 {
     uint8_t cmd_byte = SET_DDRAM_ADDR;
     cmd_byte |= (ddram_addr & 0x7F);
-    write_command(cmd_byte, LCD_TAS_US);
-}
-
-static void pulse_enable(uint32_t us_hold_time)
-{
-    /* pulse E again for 1us, */
-    GPIO_Write_To_Output_Pin(lcd1602a_handle.e_gpio_handle.p_gpio_x,
-                             lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             HIGH);
-    udelay(us_hold_time);
-    GPIO_Write_To_Output_Pin(lcd1602a_handle.e_gpio_handle.p_gpio_x,
-                             lcd1602a_handle.e_gpio_handle.gpio_pin_config.gpio_pin_num,
-                             LOW);
+    write_command(cmd_byte, LCD_EXEC_TIME_US);
 }
 
 static void mdelay(uint32_t cnt)
 {
-    for (uint32_t i=0; i < (cnt * 1000); i++);
+    Delay_Ms(cnt);
 }
 
 static void udelay(uint32_t cnt)
 {
-    for (uint32_t i=0; i < (cnt * 1); i++);
+    Delay_Us(cnt);
 }
@@ -0,0 +1,75 @@
+#ifndef INC_DS3231_MODEL_H_
+#define INC_DS3231_MODEL_H_
+
+#include <stdint.h>
+
+#include "i2c_bus_model.h"
+
+/* Host-side model of a DS3231, attached to an I2C_Bus_t as a slave. It holds the whole register file
+ * (0x00-0x12) and keeps time from whatever clock it is given: the host's virtual clock, so a run is
+ * repeatable and bus time moves the calendar, or the wall clock. The calendar counts in BCD through 12/24
+ * hour mode, month lengths, leap years and the century bit, the way the chip's own counter chain does. */
+
+#define DS3231_MODEL_ADDR           0x68
+#define DS3231_MODEL_NUM_REGS       0x13
+#define DS3231_MODEL_NUM_TIME_REGS  7       /* 0x00-0x06, read through the user buffer */
+
+/* Register addresses, kept apart from the driver's so the model does not share its mistakes */
+#define DS3231_REG_SECONDS          0x00
+#define DS3231_REG_MINUTES          0x01
+#define DS3231_REG_HOURS            0x02
+#define DS3231_REG_DAY              0x03
+#define DS3231_REG_DATE             0x04
+#define DS3231_REG_MONTH_CENTURY    0x05
+#define DS3231_REG_YEAR             0x06
+#define DS3231_REG_ALARM_1_SECS     0x07
+#define DS3231_REG_ALARM_1_DAY_DATE 0x0A
+#define DS3231_REG_ALARM_2_MINS     0x0B
+#define DS3231_REG_ALARM_2_DAY_DATE 0x0D
+#define DS3231_REG_CONTROL          0x0E
+#define DS3231_REG_STATUS           0x0F
+#define DS3231_REG_AGING            0x10
+#define DS3231_REG_TEMP_MSB         0x11
+#define DS3231_REG_TEMP_LSB         0x12
+
+/* Bits the model acts on */
+#define DS3231_HOURS_12_HOUR        0x40
+#define DS3231_HOURS_PM             0x20
+#define DS3231_MONTH_CENTURY        0x80
+#define DS3231_ALARM_MASK_BIT       0x80    /* AxMy, bit 7 of every alarm register */
+#define DS3231_ALARM_DY_DT          0x40
+#define DS3231_CONTROL_RS_MASK      0x18    /* RS2:RS1, the square wave's rate */
+#define DS3231_CONTROL_INTCN        0x04
+#define DS3231_CONTROL_A2IE         0x02
+#define DS3231_CONTROL_A1IE         0x01
+#define DS3231_STATUS_OSF           0x80
+#define DS3231_STATUS_A2F           0x02
+#define DS3231_STATUS_A1F           0x01
+
+typedef struct
+{
+    uint8_t                         regs[DS3231_MODEL_NUM_REGS];    /* the time registers hold the live count */
+    uint8_t                         user_buffer[DS3231_MODEL_NUM_TIME_REGS];    /* the count as of the last start */
+    uint8_t                         reg_ptr;
+    uint8_t                         ptr_pending;    /* the next byte written is the register pointer */
+    uint64_t                        (*p_now_ns)(void);
+    uint64_t                        next_tick_ns;   /* when the countdown chain next carries into the seconds */
+    uint32_t                        ticks;          /* seconds counted since init */
+} DS3231_Model_t;
+
+extern const I2C_Bus_Slave_Ops_t DS3231_MODEL_OPS;
+
+/* Registers as after the first power up: midnight 1 Jan 2000, OSF and EN32kHz set, 25 degrees C */
+void DS3231_Model_Init(DS3231_Model_t *p_model, uint64_t (*p_now_ns)(void));
+uint64_t DS3231_Model_Wall_Clock_Ns(void);
+
+/* Runs the counter chain up to now. The bus calls this on every start; a test calls it before peeking. */
+void DS3231_Model_Sync(DS3231_Model_t *p_model);
+uint8_t DS3231_Model_Peek(DS3231_Model_t *p_model, uint8_t reg);
+void DS3231_Model_Poke(DS3231_Model_t *p_model, uint8_t reg, uint8_t value);
+void DS3231_Model_Set_Temp(DS3231_Model_t *p_model, int16_t quarter_degrees);
+
+/* Level of the INT/SQW pin: the alarm interrupt, active low, when INTCN is set, else the 1Hz square wave */
+uint8_t DS3231_Model_Int_Pin(DS3231_Model_t *p_model);
+
+#endif /* INC_DS3231_MODEL_H_ */
@@ -0,0 +1,132 @@
+#ifndef INC_HD44780_MODEL_H_
+#define INC_HD44780_MODEL_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Host-side model of an HD44780 controller, driven by pin levels against a virtual clock in nanoseconds.
+ * Enable edges are decoded into instructions, DDRAM/CGRAM and the display state are kept up to date, and
+ * every transfer is checked against the datasheet bus timing and execution times. */
+
+/***** Bus timing minimums (2.7V-4.5V column, the stricter one) *****/
+#define HD44780_T_AS_NS             60          /* RS/RW setup before E rises */
+#define HD44780_T_AH_NS             20          /* RS/RW hold after E falls */
+#define HD44780_PW_EH_NS            450         /* E high pulse width */
+#define HD44780_T_CYC_E_NS          1000        /* E rising edge to rising edge */
+#define HD44780_T_DSW_NS            195         /* write data setup before E falls */
+#define HD44780_T_H_NS              10          /* write data hold after E falls */
+#define HD44780_T_DDR_NS            360         /* read data valid after E rises */
+
+/***** Execution times at fosc = 270kHz *****/
+#define HD44780_EXEC_NS             37000
+#define HD44780_EXEC_LONG_NS        1520000     /* clear display, return home */
+#define HD44780_POWER_ON_NS         40000000    /* Vcc rise to first instruction */
+#define HD44780_INIT_FIRST_NS       4100000     /* after the first function set of the reset sequence */
+#define HD44780_INIT_SECOND_NS      100000      /* after the second */
+
+#define HD44780_DDRAM_SIZE          0x80
+#define HD44780_CGRAM_SIZE          0x40
+#define HD44780_LINE_LEN            40
+#define HD44780_MAX_ROWS            4
+
+/* Controller pins, as bit positions in the level vectors passed to the model */
+typedef enum
+{
+    HD44780_SIG_RS,
+    HD44780_SIG_RW,
+    HD44780_SIG_E,
+    HD44780_SIG_DB0,
+    HD44780_SIG_DB1,
+    HD44780_SIG_DB2,
+    HD44780_SIG_DB3,
+    HD44780_SIG_DB4,
+    HD44780_SIG_DB5,
+    HD44780_SIG_DB6,
+    HD44780_SIG_DB7,
+    HD44780_NUM_SIGNALS
+} HD44780_Signal_t;
+
+#define HD44780_SIG_MASK(sig)       (1U << (sig))
+#define HD44780_ADDR_SIG_MASK       (HD44780_SIG_MASK(HD44780_SIG_RS) | HD44780_SIG_MASK(HD44780_SIG_RW))
+#define HD44780_DATA_SIG_MASK       (0xFFU << HD44780_SIG_DB0)
+
+typedef struct
+{
+    uint8_t                         num_rows;
+    uint8_t                         num_cols;
+    uint8_t                         row_base_addr[HD44780_MAX_ROWS];
+} HD44780_Geometry_t;
+
+/* Running count of every timing rule broken since HD44780_Model_Init() */
+typedef struct
+{
+    uint32_t                        power_on;           /* instruction before the power-on wait was over */
+    uint32_t                        address_setup;      /* E rose less than tAS after RS/RW changed */
+    uint32_t                        address_hold;       /* RS/RW changed while E was high or within tAH of it falling */
+    uint32_t                        pulse_width;        /* E high for less than PWEH */
+    uint32_t                        cycle_time;         /* E rose less than tcycE after the previous rise */
+    uint32_t                        data_setup;         /* E fell less than tDSW after the write data changed */
+    uint32_t                        data_hold;          /* write data changed within tH of E falling */
+    uint32_t                        busy;               /* write latched before the previous instruction finished */
+    uint32_t                        read_delay;         /* read data sampled less than tDDR after E rose */
+    uint32_t                        contention;         /* MCU still driving the data lines during a read */
+} HD44780_Violations_t;
+
+/* Bus traffic since the last HD44780_Model_Start_Frame(). Bus time runs from the first enable pulse of the
+ * frame until its last instruction has finished executing. */
+typedef struct
+{
+    uint32_t                        bytes_written;
+    uint32_t                        bytes_read;
+    uint32_t                        enable_pulses;
+    uint64_t                        first_pulse_ns;
+    uint64_t                        last_done_ns;
+    uint64_t                        bus_time_ns;
+} HD44780_Frame_Stats_t;
+
+typedef struct
+{
+    HD44780_Geometry_t              geometry;
+    uint8_t                         ddram[HD44780_DDRAM_SIZE];
+    uint8_t                         cgram[HD44780_CGRAM_SIZE];
+    uint8_t                         addr_counter;
+    uint8_t                         addr_in_cgram;
+    uint8_t                         increment;
+    uint8_t                         entry_shift;
+    uint8_t                         display_shift;
+    uint8_t                         display_on;
+    uint8_t                         cursor_on;
+    uint8_t                         blink_on;
+    uint8_t                         bus_8_bit;
+    uint8_t                         two_lines;
+    uint8_t                         function_sets;      /* counts the reset sequence's function sets */
+    uint8_t                         nybble_pending;
+    uint8_t                         high_nybble;
+    uint8_t                         read_value;
+    uint8_t                         read_low_next;
+    uint8_t                         e_seen;
+    uint16_t                        levels;
+    uint16_t                        driven;
+    uint64_t                        power_on_ns;
+    uint64_t                        e_rise_ns;
+    uint64_t                        e_fall_ns;
+    uint64_t                        addr_change_ns;
+    uint64_t                        data_change_ns;
+    uint64_t                        busy_until_ns;
+    HD44780_Violations_t            violations;
+    HD44780_Frame_Stats_t           frame;
+} HD44780_Model_t;
+
+void HD44780_Model_Init(const HD44780_Geometry_t *p_geometry, uint64_t now_ns);
+void HD44780_Model_Drive(uint16_t levels, uint16_t driven, uint64_t now_ns);
+uint16_t HD44780_Model_Sample(uint64_t now_ns);
+
+void HD44780_Model_Start_Frame(uint64_t now_ns);
+const HD44780_Frame_Stats_t *HD44780_Model_Get_Frame_Stats(void);
+const HD44780_Violations_t *HD44780_Model_Get_Violations(void);
+uint32_t HD44780_Model_Count_Violations(void);
+
+uint8_t HD44780_Model_Get_Cell(uint8_t row, uint8_t col);
+void HD44780_Model_Render(FILE *p_out);
+
+#endif /* INC_HD44780_MODEL_H_ */
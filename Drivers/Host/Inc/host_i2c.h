@@ -0,0 +1,22 @@
+#ifndef INC_HOST_I2C_H_
+#define INC_HOST_I2C_H_
+
+#include <stdint.h>
+
+#include "i2c.h"
+#include "i2c_bus_model.h"
+
+/* Host build of the I2C interface. get_i2c_interface() hands out the same I2C_Interface_t as on the target,
+ * but every instance drives an I2C_Bus_t with simulated slaves on it instead of a peripheral. Blocking calls
+ * run on the bus straight away and advance the virtual clock by their bus time. Queued calls wait, as they
+ * would for the interrupts, until Host_Step_I2C() or Check_Timeout() runs them; the callbacks are made from
+ * there. */
+
+void Host_I2C_Init(void);
+I2C_Bus_t *Host_I2C_Get_Bus(I2C_Instance_t instance);
+
+/* Runs the transaction at the head of each instance's queue. Returns 0 once every queue is empty, so a caller
+ * can pump queued work to completion. */
+uint8_t Host_Step_I2C(void);
+
+#endif /* INC_HOST_I2C_H_ */
@@ -0,0 +1,51 @@
+#ifndef INC_HOST_PORT_H_
+#define INC_HOST_PORT_H_
+
+#include <stdint.h>
+
+#include "stm32f407xx.h"
+#include "hd44780_model.h"
+
+/* Host build of the display path. The GPIO, TIM and timebase drivers are replaced by versions which run
+ * against a virtual clock and feed the LCD pins into the HD44780 model; nothing touches real registers.
+ * Every GPIO driver call costs HOST_GPIO_ACCESS_NS of virtual time. That is a little quicker than the
+ * real calls at the 16MHz reset clock, so timing margins measured here are on the safe side. The same
+ * virtual clock, and the critical sections, serve the I2C bus model in host_i2c.h. */
+
+#define HOST_GPIO_ACCESS_NS         250
+#define HOST_NUM_GPIO_PORTS         9       /* GPIOA through GPIOI */
+#define HOST_NUM_TIMERS             6       /* TIM2 through TIM7 */
+#define HOST_NUM_INPUT_SOURCES      2
+
+/* Which MCU pin drives each controller line, taken from the LCD1602A wiring */
+typedef struct
+{
+    HD44780_Signal_t                signal;
+    GPIO_Register_Map_t             *p_gpio_x;
+    uint8_t                         pin_num;
+} Host_Lcd_Pin_t;
+
+typedef struct
+{
+    TIM_Handle_t                    *p_tim_handle;
+    uint8_t                         running;
+    uint64_t                        period_ns;
+    uint64_t                        next_update_ns;
+} Host_Timer_t;
+
+/* An input pin driven by a model outside the MCU, such as an RTC's interrupt line */
+typedef struct
+{
+    GPIO_Register_Map_t             *p_gpio_x;
+    uint8_t                         pin_num;
+    uint8_t                         (*p_level)(void);
+} Host_Input_Source_t;
+
+void Host_Init(void);
+uint64_t Host_Now_Ns(void);
+void Host_Advance_Ns(uint64_t ns);
+uint8_t Host_Step_Timers(void);
+/* From here on reading the pin returns p_level(), sampled at the time of the read */
+void Host_Set_Input_Source(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t (*p_level)(void));
+
+#endif /* INC_HOST_PORT_H_ */
@@ -0,0 +1,72 @@
+#ifndef INC_I2C_BUS_MODEL_H_
+#define INC_I2C_BUS_MODEL_H_
+
+#include <stdint.h>
+
+#include "i2c.h"
+
+/* Byte-level model of one I2C bus with a single master. Slaves are attached by address and see the same
+ * start, byte and stop events a real slave would. Every event is charged at the bus clock: nine bit times
+ * for a byte with its ACK, one for a start, repeated start or stop. That is the ideal SCL timing; clock
+ * stretching and the peripheral's own gaps between bytes are not modelled. */
+
+#define I2C_BUS_MAX_SLAVES          4
+
+typedef struct
+{
+    uint8_t                         (*Start)(void *p_slave, uint8_t read);      /* returns 1 to ACK the address */
+    uint8_t                         (*Write_Byte)(void *p_slave, uint8_t byte); /* returns 1 to ACK the byte */
+    uint8_t                         (*Read_Byte)(void *p_slave);
+    void                            (*Stop)(void *p_slave);
+} I2C_Bus_Slave_Ops_t;
+
+typedef struct
+{
+    uint8_t                         addr;           /* 7-bit */
+    const I2C_Bus_Slave_Ops_t       *p_ops;
+    void                            *p_slave;
+} I2C_Bus_Slave_t;
+
+/* Counted since I2C_Bus_Init() or the last I2C_Bus_Reset_Stats() */
+typedef struct
+{
+    uint32_t                        transactions;   /* start to stop; repeated starts do not add one */
+    uint32_t                        starts;         /* including repeated starts */
+    uint32_t                        bytes;          /* including address bytes */
+    uint32_t                        nacks;
+    uint32_t                        read_nacks;     /* read bytes the master NACKed */
+    uint32_t                        overreads;      /* bytes clocked out of a slave after the master NACKed */
+    uint64_t                        bus_ns;
+} I2C_Bus_Stats_t;
+
+typedef struct
+{
+    uint32_t                        clock_speed;
+    I2C_Bus_Slave_t                 slaves[I2C_BUS_MAX_SLAVES];
+    uint8_t                         num_slaves;
+    I2C_Bus_Slave_t                 *p_active;      /* addressed by the last start, until the stop */
+    uint8_t                         held;           /* a start has gone out and no stop yet */
+    uint8_t                         read_nacked;    /* the master NACKed the last byte read */
+    I2C_Bus_Stats_t                 stats;
+} I2C_Bus_t;
+
+void I2C_Bus_Init(I2C_Bus_t *p_bus, uint32_t clock_speed);
+void I2C_Bus_Set_Speed(I2C_Bus_t *p_bus, uint32_t clock_speed);
+uint8_t I2C_Bus_Attach(I2C_Bus_t *p_bus, uint8_t addr, const I2C_Bus_Slave_Ops_t *p_ops, void *p_slave);
+void I2C_Bus_Reset_Stats(I2C_Bus_t *p_bus);
+
+/* One phase of a transaction: a start (repeated if the bus is still held), the address and len bytes. With
+ * stop set the bus is released afterwards, otherwise the next call goes out behind a repeated start. A NACK
+ * always ends in a stop. */
+I2C_Status_t I2C_Bus_Write(I2C_Bus_t *p_bus, uint8_t addr, const uint8_t *p_data, uint32_t len, uint8_t stop);
+I2C_Status_t I2C_Bus_Read(I2C_Bus_t *p_bus, uint8_t addr, uint8_t *p_data, uint32_t len, uint8_t stop);
+void I2C_Bus_Stop(I2C_Bus_t *p_bus);
+
+/* Single bus events, for a master model that keeps its own time. They count toward the stats like the calls
+ * above but leave the virtual clock alone. */
+uint8_t I2C_Bus_Start_Event(I2C_Bus_t *p_bus, uint8_t addr, uint8_t read);     /* returns 1 if ACKed */
+uint8_t I2C_Bus_Write_Event(I2C_Bus_t *p_bus, uint8_t byte);                   /* returns 1 if ACKed */
+uint8_t I2C_Bus_Read_Event(I2C_Bus_t *p_bus, uint8_t ack);
+void I2C_Bus_Stop_Event(I2C_Bus_t *p_bus);
+
+#endif /* INC_I2C_BUS_MODEL_H_ */
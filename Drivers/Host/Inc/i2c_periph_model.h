@@ -0,0 +1,92 @@
+#ifndef INC_I2C_PERIPH_MODEL_H_
+#define INC_I2C_PERIPH_MODEL_H_
+
+#include <stdint.h>
+
+#include "stm32f407xx.h"
+#include "stm32f407xx_dma_driver.h"
+#include "i2c.h"
+#include "i2c_bus_model.h"
+
+/* Register-level model of the STM32F407 I2C peripheral in master mode, for running the real
+ * stm32f407xx_i2c_driver.c on the host. Memory is mapped at the peripheral addresses, so I2C1-I2C3, RCC,
+ * NVIC and DWT all point where the driver expects. The page holding the I2C registers is kept inaccessible:
+ * every load or store the driver makes faults, is single stepped, and is handed to the model. That is how
+ * the side effects of reads are seen: SR1 then SR2 clearing ADDR, SR1 then DR clearing BTF, DR clearing
+ * RXNE. Only x86-64 Linux is supported.
+ *
+ * Each register access costs I2C_PERIPH_REG_ACCESS_NS of virtual time. Bus events are timed from CCR and
+ * CR2.FREQ: a start, repeated start or stop takes one SCL period, a byte nine. A byte received while RXNE is
+ * still set stretches SCL with BTF set, and its ACK is sampled from CR1.ACK (or CR2.LAST under DMA) once it
+ * moves into DR. Error flags beyond AF, 10-bit addressing and slave mode are not modelled.
+ *
+ * Interrupts are only taken from I2C_Periph_Model_Step(), never in the middle of the code the driver is
+ * running, which stands in for the NVIC with every I2C interrupt enabled at the same priority. A line that
+ * stays raised after its handler returns is taken again, as a level-sensitive interrupt would be. */
+
+#define I2C_PERIPH_REG_ACCESS_NS    125     /* two core clocks at 16MHz; APB1 runs at the core clock */
+#define I2C_PERIPH_LINE_LOW         UINT64_MAX
+
+/* Counted since I2C_Periph_Model_Init() or the last I2C_Periph_Model_Reset_Stats() */
+typedef struct
+{
+    uint32_t                        ev_irqs;
+    uint32_t                        er_irqs;
+    uint32_t                        dma_irqs;
+    uint32_t                        reg_accesses;
+    uint32_t                        isr_reg_accesses;   /* the part of reg_accesses made from a handler */
+    uint32_t                        stretches;          /* bytes held with BTF set because DR was full */
+} I2C_Periph_Model_Stats_t;
+
+typedef enum
+{
+    I2C_PERIPH_EVT_NONE,
+    I2C_PERIPH_EVT_START,
+    I2C_PERIPH_EVT_ADDR,
+    I2C_PERIPH_EVT_BYTE_SENT,
+    I2C_PERIPH_EVT_BYTE_RECEIVED,
+    I2C_PERIPH_EVT_STOP
+} I2C_Periph_Event_t;
+
+typedef struct
+{
+    DMA_Handle_t                    *p_handle;
+    uint8_t                         *p_mem;
+    uint16_t                        remaining;
+    uint8_t                         active;
+} I2C_Periph_DMA_t;
+
+typedef struct
+{
+    I2C_Register_Map_t              regs;               /* the values the driver sees */
+    I2C_Bus_t                       *p_bus;
+    I2C_Periph_Event_t              event;
+    uint64_t                        event_ns;
+    uint8_t                         sr1_read;           /* SR1 read since the last flag it can clear */
+    uint8_t                         shift_byte;         /* byte on its way out, or held in while stretching */
+    uint8_t                         rx_held;            /* a received byte waits in the shift register */
+    uint8_t                         rx_nacked;          /* the last byte received was NACKed */
+    I2C_Periph_DMA_t                dma_rx;
+    I2C_Periph_DMA_t                dma_tx;
+    DMA_Handle_t                    *p_dma_irq;         /* stream whose transfer complete interrupt is pending */
+    uint64_t                        ev_raised_ns;       /* when each line went up, or I2C_PERIPH_LINE_LOW */
+    uint64_t                        er_raised_ns;
+    uint64_t                        dma_raised_ns;
+    I2C_Periph_Model_Stats_t        stats;
+} I2C_Periph_Model_t;
+
+/* Maps the memory and installs the fault handlers. Every instance starts out with its registers at their
+ * reset values and no bus attached. */
+void I2C_Periph_Model_Init(void);
+void I2C_Periph_Model_Attach_Bus(I2C_Instance_t instance, I2C_Bus_t *p_bus);
+I2C_Periph_Model_t *I2C_Periph_Model_Get(I2C_Instance_t instance);
+void I2C_Periph_Model_Reset_Stats(I2C_Instance_t instance);
+
+/* Time from a line going up to its handler running. Anything over a byte time makes the receiver stretch. */
+void I2C_Periph_Model_Set_Irq_Latency(uint64_t latency_ns);
+
+/* Runs the clock on to whichever comes first: the next bus event, or the next interrupt to be taken, which is
+ * then taken. Returns 0 with nothing left to do, so a caller can pump queued work to completion. */
+uint8_t I2C_Periph_Model_Step(void);
+
+#endif /* INC_I2C_PERIPH_MODEL_H_ */
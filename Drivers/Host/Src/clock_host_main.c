@@ -0,0 +1,1039 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "clock.h"
+#include "clock_cache.h"
+#include "i2c.h"
+#include "host_port.h"
+#include "host_i2c.h"
+#include "ds3231_model.h"
+
+/* Runs the DS3231 clock driver against the register model on a simulated I2C bus. Every getter and setter,
+ * blocking and interrupt based, is checked against what lands in, or comes out of, the model's registers,
+ * including the calendar rollovers the chip does on its own. The cached driver is then run in front of it,
+ * counting on from its own tick and checked against the chip. Built with DS3231_SQW_WIRED, the chip's 1Hz
+ * square wave is edge-detected on the model's INT/SQW pin and ticks the cache instead. The alarms are checked
+ * register by register, and built with either pin define, counted as they fire over runs of up to a day.
+ * Each call's bus cost is printed as it goes. Exits non-zero if any check failed. */
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void Bench_Begin(void);
+static void Bench_End(const char *name);
+static void Check(const char *name, uint32_t got, uint32_t expected);
+static void Check_Hours(const char *name, hours_t got, hours_t expected);
+static void Check_Datetime(const char *name, full_datetime_t got, full_datetime_t expected);
+static void Check_Registers(const char *name, const uint8_t *p_expected);
+static void Check_Callbacks(const char *name, const char *p_expected);
+static void Log_Callback(const char *name);
+static void Run_Blocking_Checks(void);
+static void Run_Interrupt_Checks(void);
+static void Run_Rollover_Checks(void);
+static void Run_Rollover(const char *name, full_datetime_t before, full_datetime_t after);
+static void Run_Cache_Checks(void);
+static void Run_Cache_Rollover(const char *name, full_datetime_t before, full_datetime_t after);
+static void Step_Cache_Seconds(uint32_t seconds);
+static void Run_Alarm_Checks(void);
+static void Run_Alarm_Round_Trips(void);
+static uint8_t Int_Sqw_Level(void);
+#ifdef DS3231_SQW_WIRED
+static void Run_Tick_Checks(void);
+#endif
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+static void Run_Alarm_Pin_Checks(void);
+static void Step_Pin_Seconds(uint32_t seconds);
+#endif
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+void DS3231_INT_SQW_IRQHandler(void);
+#endif
+
+#define NS_PER_SECOND               1000000000ull
+#define MID_READ_TICK_NS            100000ull   /* into a 7 byte read at 400kHz, which takes about 230us */
+#define CACHE_READS                 1000
+#define CACHE_RESYNC_S              10
+#define CACHE_RUN_S                 (3 * 24 * 60 * 60 + 5)
+#define SQW_RUN_S                   (25 * 60 * 60)
+#define SQW_SAMPLE_NS               100000000ull    /* into each second, well clear of either edge */
+#define ALARM_FLAGS                 (DS3231_STATUS_A1F | DS3231_STATUS_A2F)
+
+/* One alarm set on its own and run from LEAP_EVE, against how often it should fire */
+typedef struct
+{
+    const char                      *name;
+    Clock_Alarm_t                   alarm;
+    alarm_t                         alarm_time;
+    uint32_t                        run_s;
+    uint32_t                        expected;
+} Alarm_Case_t;
+
+static Clock_Device_t clock_dev;
+static Clock_Driver_t *p_clock;
+static DS3231_Model_t rtc;
+static I2C_Bus_t *p_bus;
+static uint32_t num_checks;
+static uint32_t num_failures;
+static uint32_t num_clock_errors;
+static uint32_t num_datetime_callbacks;
+static char callback_log[256];      /* the complete callbacks since the last Check_Callbacks(), in order */
+static uint32_t num_set_alarm_callbacks;
+static uint32_t num_alarms[2];
+#ifdef DS3231_SQW_WIRED
+static uint32_t num_ticks;
+static uint8_t sqw_ticks_cache;
+#endif
+
+/* Thu 28 Feb 2024, 23:59:58, a second short of the leap day */
+static const full_datetime_t LEAP_EVE = {
+        .time = {
+                .hours = { .hour = 23, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE },
+                .minutes = 59,
+                .seconds = 58,
+        },
+        .date = {
+                .day_of_week = DAY_OF_WEEK_THU,
+                .date = 28,
+                .month = MONTH_FEB,
+                .year = 24,
+                .century = CENTURY_21ST,
+        },
+};
+
+int main(void)
+{
+    I2C_Interface_t *p_clock_i2c;
+    I2C_Stats_t i2c_stats;
+
+    Host_Init();
+    Host_I2C_Init();
+    DS3231_Model_Init(&rtc, Host_Now_Ns);
+    p_bus = Host_I2C_Get_Bus(DS3231_I2C_INSTANCE);
+    I2C_Bus_Attach(p_bus, DS3231_MODEL_ADDR, &DS3231_MODEL_OPS, &rtc);
+    Host_Set_Input_Source(DS3231_INT_SQW_GPIO_PORT, DS3231_INT_SQW_GPIO_PIN, Int_Sqw_Level);
+
+    p_clock = get_clock_driver();
+
+    printf("%-28s %6s %6s %10s\n", "call", "txns", "bytes", "bus_us");
+
+    Bench_Begin();
+    p_clock->Initialize(&clock_dev);
+    Bench_End("Initialize");
+
+    Run_Blocking_Checks();
+    Run_Interrupt_Checks();
+    Run_Rollover_Checks();
+    Run_Cache_Checks();
+#ifdef DS3231_SQW_WIRED
+    Run_Tick_Checks();
+#endif
+    Run_Alarm_Checks();
+
+    Check("clock errors", num_clock_errors, 0);
+
+    p_clock_i2c = get_i2c_interface(DS3231_I2C_INSTANCE);
+    p_clock_i2c->Get_Stats(&i2c_stats);
+    printf("\n");
+    I2C_Print_Stats(DS3231_I2C_INSTANCE, &i2c_stats);
+
+    printf("\n%u checks, %u failed\n", num_checks, num_failures);
+    return num_failures ? 1 : 0;
+}
+
+void Clock_Error_Callback(Clock_Device_t *p_clock_dev)
+{
+    num_clock_errors++;
+}
+
+void Clock_Get_Datetime_Complete_Callback(Clock_Device_t *p_clock_dev)
+{
+    num_datetime_callbacks++;
+    Log_Callback("Get_Datetime");
+}
+
+/* The rest of the complete callbacks only log themselves, so each _IT call is checked against its own */
+#define LOG_COMPLETE_CALLBACK(name)                                                                         \
+void Clock_##name##_Complete_Callback(Clock_Device_t *p_clock_dev)                                          \
+{                                                                                                           \
+    Log_Callback(#name);                                                                                    \
+}
+
+LOG_COMPLETE_CALLBACK(Get_Seconds)
+LOG_COMPLETE_CALLBACK(Get_Minutes)
+LOG_COMPLETE_CALLBACK(Get_Hours)
+LOG_COMPLETE_CALLBACK(Get_Day_Of_Week)
+LOG_COMPLETE_CALLBACK(Get_Date)
+LOG_COMPLETE_CALLBACK(Get_Month)
+LOG_COMPLETE_CALLBACK(Get_Year)
+LOG_COMPLETE_CALLBACK(Get_Century)
+LOG_COMPLETE_CALLBACK(Get_Full_Date)
+LOG_COMPLETE_CALLBACK(Get_Full_Time)
+LOG_COMPLETE_CALLBACK(Set_Seconds)
+LOG_COMPLETE_CALLBACK(Set_Minutes)
+LOG_COMPLETE_CALLBACK(Set_Hours)
+LOG_COMPLETE_CALLBACK(Set_Day_Of_Week)
+LOG_COMPLETE_CALLBACK(Set_Date)
+LOG_COMPLETE_CALLBACK(Set_Months)
+LOG_COMPLETE_CALLBACK(Set_Century)
+LOG_COMPLETE_CALLBACK(Set_Years)
+LOG_COMPLETE_CALLBACK(Set_Full_Time)
+LOG_COMPLETE_CALLBACK(Set_Full_Date)
+LOG_COMPLETE_CALLBACK(Set_Datetime)
+
+void Clock_Set_Alarm_Complete_Callback(Clock_Device_t *p_clock_dev)
+{
+    num_set_alarm_callbacks++;
+}
+
+void Clock_Alarm_Callback(Clock_Device_t *p_clock_dev, Clock_Alarm_t alarm)
+{
+    num_alarms[alarm]++;
+}
+
+#ifdef DS3231_SQW_WIRED
+void Clock_Tick_Callback(Clock_Device_t *p_clock_dev)
+{
+    num_ticks++;
+    if (sqw_ticks_cache)
+        Clock_Cache_Tick();
+}
+#endif
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void Run_Blocking_Checks(void)
+{
+    static const uint8_t LEAP_EVE_REGS[DS3231_MODEL_NUM_TIME_REGS] = { 0x58, 0x59, 0x23, 0x05, 0x28, 0x82, 0x24 };
+    full_datetime_t leap_day = LEAP_EVE;
+    full_datetime_t datetime;
+    hours_t hours;
+    uint32_t value;
+
+    Bench_Begin();
+    p_clock->Set_Century(CENTURY_21ST);
+    Bench_End("Set_Century");
+
+    Bench_Begin();
+    p_clock->Set_Full_Datetime(LEAP_EVE);
+    Bench_End("Set_Full_Datetime");
+    Check_Registers("Set_Full_Datetime", LEAP_EVE_REGS);
+
+    Bench_Begin();
+    datetime = p_clock->Get_Full_Datetime();
+    Bench_End("Get_Full_Datetime");
+    Check_Datetime("Get_Full_Datetime", datetime, LEAP_EVE);
+
+    /* Two seconds on, the chip has counted into the leap day on its own */
+    Host_Advance_Ns(2 * NS_PER_SECOND);
+    leap_day.time.hours.hour = 0;
+    leap_day.time.minutes = 0;
+    leap_day.time.seconds = 0;
+    leap_day.date.day_of_week = DAY_OF_WEEK_FRI;
+    leap_day.date.date = 29;
+
+    Bench_Begin();
+    datetime.time = p_clock->Get_Full_Time();
+    Bench_End("Get_Full_Time");
+    Bench_Begin();
+    datetime.date = p_clock->Get_Full_Date();
+    Bench_End("Get_Full_Date");
+    Check_Datetime("Get_Full_Time/Get_Full_Date", datetime, leap_day);
+
+    Bench_Begin();
+    value = p_clock->Get_Seconds();
+    Bench_End("Get_Seconds");
+    Check("Get_Seconds", value, 0);
+
+    Bench_Begin();
+    value = p_clock->Get_Minutes();
+    Bench_End("Get_Minutes");
+    Check("Get_Minutes", value, 0);
+
+    Bench_Begin();
+    hours = p_clock->Get_Hours();
+    Bench_End("Get_Hours");
+    Check_Hours("Get_Hours", hours, leap_day.time.hours);
+
+    Bench_Begin();
+    value = p_clock->Get_Day_Of_Week();
+    Bench_End("Get_Day_Of_Week");
+    Check("Get_Day_Of_Week", value, DAY_OF_WEEK_FRI);
+
+    Bench_Begin();
+    value = p_clock->Get_Date();
+    Bench_End("Get_Date");
+    Check("Get_Date", value, 29);
+
+    Bench_Begin();
+    value = p_clock->Get_Month();
+    Bench_End("Get_Month");
+    Check("Get_Month", value, MONTH_FEB);
+
+    Bench_Begin();
+    value = p_clock->Get_Year();
+    Bench_End("Get_Year");
+    Check("Get_Year", value, 24);
+
+    Bench_Begin();
+    value = p_clock->Get_Century();
+    Bench_End("Get_Century");
+    Check("Get_Century", value, CENTURY_21ST);
+
+    Bench_Begin();
+    p_clock->Set_Seconds(7);
+    Bench_End("Set_Seconds");
+    Check("Set_Seconds", DS3231_Model_Peek(&rtc, DS3231_REG_SECONDS), 0x07);
+
+    Bench_Begin();
+    p_clock->Set_Minutes(34);
+    Bench_End("Set_Minutes");
+    Check("Set_Minutes", DS3231_Model_Peek(&rtc, DS3231_REG_MINUTES), 0x34);
+
+    Bench_Begin();
+    p_clock->Set_Hours((hours_t){ .hour = 9, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM });
+    Bench_End("Set_Hours");
+    Check("Set_Hours", DS3231_Model_Peek(&rtc, DS3231_REG_HOURS), 0x69);
+
+    Bench_Begin();
+    p_clock->Set_Day_Of_Week(DAY_OF_WEEK_TUE);
+    Bench_End("Set_Day_Of_Week");
+    Check("Set_Day_Of_Week", DS3231_Model_Peek(&rtc, DS3231_REG_DAY), DAY_OF_WEEK_TUE);
+
+    Bench_Begin();
+    p_clock->Set_Date(17);
+    Bench_End("Set_Date");
+    Check("Set_Date", DS3231_Model_Peek(&rtc, DS3231_REG_DATE), 0x17);
+
+    Bench_Begin();
+    p_clock->Set_Month(MONTH_OCT);
+    Bench_End("Set_Month");
+    Check("Set_Month", DS3231_Model_Peek(&rtc, DS3231_REG_MONTH_CENTURY), 0x90);
+
+    Bench_Begin();
+    p_clock->Set_Year(26);
+    Bench_End("Set_Year");
+    Check("Set_Year", DS3231_Model_Peek(&rtc, DS3231_REG_YEAR), 0x26);
+}
+
+static void Run_Interrupt_Checks(void)
+{
+    full_datetime_t datetime = LEAP_EVE;
+    uint32_t errors_before;
+
+    callback_log[0] = '\0';
+    Bench_Begin();
+    p_clock->Set_Full_Datetime_IT(LEAP_EVE);
+    Bench_End("Set_Full_Datetime_IT");
+    Check_Callbacks("Set_Full_Datetime_IT", " Set_Datetime");
+
+    Bench_Begin();
+    p_clock->Get_Datetime_IT();
+    Bench_End("Get_Datetime_IT");
+    Check_Callbacks("Get_Datetime_IT", " Get_Datetime");
+    Check_Datetime("Get_Datetime_IT", clock_device_get_datetime(&clock_dev), LEAP_EVE);
+
+    clock_dev.time = (full_time_t){ 0 };
+    clock_dev.date = (full_date_t){ 0 };
+
+    Bench_Begin();
+    p_clock->Get_Full_Time_IT();
+    Bench_End("Get_Full_Time_IT");
+    Bench_Begin();
+    p_clock->Get_Full_Date_IT();
+    Bench_End("Get_Full_Date_IT");
+    Check_Callbacks("Get_Full_Time_IT/Get_Full_Date_IT", " Get_Full_Time Get_Full_Date");
+    Check_Datetime("Get_Full_Time_IT/Get_Full_Date_IT", clock_device_get_datetime(&clock_dev), LEAP_EVE);
+
+    clock_dev.time = (full_time_t){ 0 };
+    clock_dev.date = (full_date_t){ 0 };
+
+    /* The single unit reads, queued back to back and completed together */
+    Bench_Begin();
+    p_clock->Get_Seconds_IT();
+    p_clock->Get_Minutes_IT();
+    p_clock->Get_Hours_IT();
+    p_clock->Get_Day_Of_Week_IT();
+    p_clock->Get_Date_IT();
+    p_clock->Get_Month_IT();
+    p_clock->Get_Year_IT();
+    p_clock->Get_Century_IT();
+    Bench_End("Get_<unit>_IT x8");
+    Check_Callbacks("Get_<unit>_IT", " Get_Seconds Get_Minutes Get_Hours Get_Day_Of_Week Get_Date Get_Month Get_Year"
+                    " Get_Century");
+    Check_Datetime("Get_<unit>_IT", clock_device_get_datetime(&clock_dev), datetime);
+
+    Bench_Begin();
+    p_clock->Set_Seconds_IT(45);
+    Bench_End("Set_Seconds_IT");
+    Check_Callbacks("Set_Seconds_IT", " Set_Seconds");
+    Check("Set_Seconds_IT", DS3231_Model_Peek(&rtc, DS3231_REG_SECONDS), 0x45);
+
+    Bench_Begin();
+    p_clock->Set_Minutes_IT(12);
+    Bench_End("Set_Minutes_IT");
+    Check_Callbacks("Set_Minutes_IT", " Set_Minutes");
+    Check("Set_Minutes_IT", DS3231_Model_Peek(&rtc, DS3231_REG_MINUTES), 0x12);
+
+    Bench_Begin();
+    p_clock->Set_Hours_IT((hours_t){ .hour = 11, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_AM });
+    Bench_End("Set_Hours_IT");
+    Check_Callbacks("Set_Hours_IT", " Set_Hours");
+    Check("Set_Hours_IT", DS3231_Model_Peek(&rtc, DS3231_REG_HOURS), 0x51);
+
+    Bench_Begin();
+    p_clock->Set_Day_Of_Week_IT(DAY_OF_WEEK_SAT);
+    Bench_End("Set_Day_Of_Week_IT");
+    Check_Callbacks("Set_Day_Of_Week_IT", " Set_Day_Of_Week");
+    Check("Set_Day_Of_Week_IT", DS3231_Model_Peek(&rtc, DS3231_REG_DAY), DAY_OF_WEEK_SAT);
+
+    Bench_Begin();
+    p_clock->Set_Date_IT(25);
+    Bench_End("Set_Date_IT");
+    Check_Callbacks("Set_Date_IT", " Set_Date");
+    Check("Set_Date_IT", DS3231_Model_Peek(&rtc, DS3231_REG_DATE), 0x25);
+
+    Bench_Begin();
+    p_clock->Set_Month_IT(MONTH_DEC);
+    Check("Set_Month_IT nothing on the bus yet", p_bus->stats.transactions, 0);
+    Bench_End("Set_Month_IT");
+    Check_Callbacks("Set_Month_IT", " Set_Months");
+    Check("Set_Month_IT", DS3231_Model_Peek(&rtc, DS3231_REG_MONTH_CENTURY), 0x92);
+
+    Bench_Begin();
+    p_clock->Set_Year_IT(99);
+    Bench_End("Set_Year_IT");
+    Check_Callbacks("Set_Year_IT", " Set_Years");
+    Check("Set_Year_IT", DS3231_Model_Peek(&rtc, DS3231_REG_YEAR), 0x99);
+
+    Bench_Begin();
+    p_clock->Set_Century_IT(CENTURY_20TH);
+    Check("Set_Century_IT nothing on the bus yet", p_bus->stats.transactions, 0);
+    Bench_End("Set_Century_IT");
+    Check_Callbacks("Set_Century_IT", " Set_Century");
+    Check("Set_Century_IT", DS3231_Model_Peek(&rtc, DS3231_REG_MONTH_CENTURY), 0x12);
+
+    Bench_Begin();
+    p_clock->Set_Full_Time_IT(LEAP_EVE.time);
+    Bench_End("Set_Full_Time_IT");
+    Bench_Begin();
+    p_clock->Set_Full_Date_IT(LEAP_EVE.date);
+    Bench_End("Set_Full_Date_IT");
+    Check_Callbacks("Set_Full_Time_IT/Set_Full_Date_IT", " Set_Full_Time Set_Full_Date");
+    Bench_Begin();
+    datetime = p_clock->Get_Full_Datetime();
+    Bench_End("Get_Full_Datetime");
+    Check_Datetime("Set_Full_Time_IT/Set_Full_Date_IT", datetime, LEAP_EVE);
+
+    /* One read more than there are requests to carry it is refused at once, through the error callback */
+    errors_before = num_clock_errors;
+    callback_log[0] = '\0';
+    for (uint8_t i = 0; i <= I2C_QUEUE_SIZE; i++)
+        p_clock->Get_Seconds_IT();
+    Check("queue full IT error", num_clock_errors - errors_before, 1);
+    Check("queue full IT stage", clock_dev.ctrl_stage, CLOCK_CTRL_ERROR);
+    while (Host_Step_I2C());
+    Check_Callbacks("queue full IT", " Get_Seconds Get_Seconds Get_Seconds Get_Seconds Get_Seconds Get_Seconds"
+                    " Get_Seconds Get_Seconds");
+    num_clock_errors = errors_before;
+    clock_dev.ctrl_stage = CLOCK_CTRL_IDLE;
+}
+
+static void Run_Rollover_Checks(void)
+{
+    full_datetime_t before = {
+            .time = {
+                    .hours = { .hour = 23, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE },
+                    .minutes = 59,
+                    .seconds = 59,
+            },
+            .date = { DAY_OF_WEEK_SAT, 31, MONTH_DEC, 99, CENTURY_20TH },
+    };
+    full_datetime_t after = {
+            .time = {
+                    .hours = { .hour = 0, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE },
+                    .minutes = 0,
+                    .seconds = 0,
+            },
+            .date = { DAY_OF_WEEK_SUN, 1, MONTH_JAN, 0, CENTURY_21ST },
+    };
+
+    /* Across the century, where the chip toggles the century bit itself */
+    Run_Rollover("century", before, after);
+
+    /* Out of a common year's February */
+    before.date = (full_date_t){ DAY_OF_WEEK_TUE, 28, MONTH_FEB, 23, CENTURY_21ST };
+    after.date = (full_date_t){ DAY_OF_WEEK_WED, 1, MONTH_MAR, 23, CENTURY_21ST };
+    Run_Rollover("common year February", before, after);
+
+    /* 12 hour mode: noon keeps the date, midnight moves it */
+    before.time.hours = (hours_t){ .hour = 11, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_AM };
+    after.time.hours = (hours_t){ .hour = 12, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    before.date = (full_date_t){ DAY_OF_WEEK_MON, 30, MONTH_APR, 26, CENTURY_21ST };
+    after.date = before.date;
+    Run_Rollover("12 hour noon", before, after);
+
+    before.time.hours = (hours_t){ .hour = 11, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    after.time.hours = (hours_t){ .hour = 12, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_AM };
+    after.date = (full_date_t){ DAY_OF_WEEK_TUE, 1, MONTH_MAY, 26, CENTURY_21ST };
+    Run_Rollover("12 hour midnight", before, after);
+}
+
+/* Sets the clock a second short of a rollover, lets the model count through it, and reads it back both ways */
+static void Run_Rollover(const char *name, full_datetime_t before, full_datetime_t after)
+{
+    char label[64];
+
+    p_clock->Set_Full_Datetime_IT(before);
+    while (Host_Step_I2C());
+    Host_Advance_Ns(NS_PER_SECOND);
+
+    snprintf(label, sizeof(label), "rollover, %s", name);
+    Check_Datetime(label, p_clock->Get_Full_Datetime(), after);
+
+    p_clock->Get_Datetime_IT();
+    while (Host_Step_I2C());
+    snprintf(label, sizeof(label), "rollover _IT, %s", name);
+    Check_Datetime(label, clock_device_get_datetime(&clock_dev), after);
+
+    /* Again with the carry landing in the middle of a blocking read, which must still see one side of it whole:
+     * the burst's start went out first, so the before side */
+    p_clock->Set_Full_Datetime_IT(before);
+    while (Host_Step_I2C());
+    Host_Advance_Ns(rtc.next_tick_ns - Host_Now_Ns() - MID_READ_TICK_NS);
+
+    snprintf(label, sizeof(label), "rollover mid-read, %s", name);
+    Check_Datetime(label, p_clock->Get_Full_Datetime(), before);
+}
+
+static void Run_Cache_Checks(void)
+{
+    Clock_Driver_t *p_chip = p_clock;
+    full_datetime_t datetime = LEAP_EVE;
+    full_datetime_t before = {
+            .time = {
+                    .hours = { .hour = 23, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE },
+                    .minutes = 59,
+                    .seconds = 59,
+            },
+            .date = { DAY_OF_WEEK_SAT, 31, MONTH_DEC, 99, CENTURY_20TH },
+    };
+    full_datetime_t after = {
+            .time = {
+                    .hours = { .hour = 0, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE },
+                    .minutes = 0,
+                    .seconds = 0,
+            },
+            .date = { DAY_OF_WEEK_SUN, 1, MONTH_JAN, 0, CENTURY_21ST },
+    };
+    uint32_t resyncs;
+
+    printf("\n");
+    p_chip->Set_Full_Datetime(LEAP_EVE);
+    p_clock = get_cached_clock_driver();
+    Clock_Cache_Set_Resync_Period(0);
+
+    Bench_Begin();
+    p_clock->Initialize(&clock_dev);
+    Bench_End("cache Initialize");
+    Check("cache Initialize resyncs", Clock_Cache_Get_Resyncs(), 1);
+
+    /* Served from RAM: not one transaction however often it is asked */
+    Bench_Begin();
+    for (uint32_t i = 0; i < CACHE_READS; i++)
+        datetime = p_clock->Get_Full_Datetime();
+    Bench_End("cache Get_Full_Datetime x1000");
+    Check("cache reads transactions", p_bus->stats.transactions, 0);
+    Check_Datetime("cache Get_Full_Datetime", datetime, LEAP_EVE);
+
+    num_datetime_callbacks = 0;
+    clock_dev.time = (full_time_t){ 0 };
+    clock_dev.date = (full_date_t){ 0 };
+    p_clock->Get_Datetime_IT();
+    Check("cache Get_Datetime_IT callbacks", num_datetime_callbacks, 1);
+    Check_Datetime("cache Get_Datetime_IT", clock_device_get_datetime(&clock_dev), LEAP_EVE);
+    Check_Hours("cache Get_Hours", p_clock->Get_Hours(), LEAP_EVE.time.hours);
+    Check("cache Get_Year", p_clock->Get_Year(), LEAP_EVE.date.year);
+
+    /* The same rollovers the chip makes, made by the tick alone */
+    Run_Cache_Rollover("century", before, after);
+
+    before.date = (full_date_t){ DAY_OF_WEEK_TUE, 28, MONTH_FEB, 23, CENTURY_21ST };
+    after.date = (full_date_t){ DAY_OF_WEEK_WED, 1, MONTH_MAR, 23, CENTURY_21ST };
+    Run_Cache_Rollover("common year February", before, after);
+
+    before.date = LEAP_EVE.date;
+    after.date = (full_date_t){ DAY_OF_WEEK_FRI, 29, MONTH_FEB, 24, CENTURY_21ST };
+    Run_Cache_Rollover("leap year February", before, after);
+
+    before.time.hours = (hours_t){ .hour = 11, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_AM };
+    after.time.hours = (hours_t){ .hour = 12, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    before.date = (full_date_t){ DAY_OF_WEEK_MON, 30, MONTH_APR, 26, CENTURY_21ST };
+    after.date = before.date;
+    Run_Cache_Rollover("12 hour noon", before, after);
+
+    before.time.hours = (hours_t){ .hour = 11, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    after.time.hours = (hours_t){ .hour = 12, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_AM };
+    after.date = (full_date_t){ DAY_OF_WEEK_TUE, 1, MONTH_MAY, 26, CENTURY_21ST };
+    Run_Cache_Rollover("12 hour midnight", before, after);
+
+    before.time.hours = (hours_t){ .hour = 12, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    after.time.hours = (hours_t){ .hour = 1, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    after.date = before.date;
+    Run_Cache_Rollover("12 hour one o'clock", before, after);
+
+    /* Days on end with no resync, counting through months and the leap day, still agreeing with the chip */
+    p_clock->Set_Full_Datetime(LEAP_EVE);
+    resyncs = Clock_Cache_Get_Resyncs();
+    Bench_Begin();
+    Step_Cache_Seconds(CACHE_RUN_S);
+    Bench_End("cache 3 days unsynced");
+    Check("cache 3 days transactions", p_bus->stats.transactions, 0);
+    Check_Datetime("cache 3 days", p_clock->Get_Full_Datetime(), p_chip->Get_Full_Datetime());
+    Check("cache 3 days resyncs", Clock_Cache_Get_Resyncs(), resyncs);
+
+    /* Periodic resync: the chip is changed behind the cache's back and only the resync brings it over */
+    Clock_Cache_Set_Resync_Period(CACHE_RESYNC_S);
+    Clock_Cache_Resync();
+    DS3231_Model_Poke(&rtc, DS3231_REG_YEAR, 0x30);
+    Step_Cache_Seconds(CACHE_RESYNC_S - 1);
+    Check("cache before resync year", p_clock->Get_Year(), 24);
+    Step_Cache_Seconds(1);
+    Bench_Begin();
+    datetime = p_clock->Get_Full_Datetime();
+    Bench_End("cache resync on get");
+    Check("cache resync on get transactions", p_bus->stats.transactions, 1);
+    Check("cache resync on get year", datetime.date.year, 30);
+    Check_Datetime("cache resync on get", datetime, p_chip->Get_Full_Datetime());
+
+    /* And on demand, with periodic resync off */
+    Clock_Cache_Set_Resync_Period(0);
+    DS3231_Model_Poke(&rtc, DS3231_REG_YEAR, 0x31);
+    Step_Cache_Seconds(2 * CACHE_RESYNC_S);
+    Check("cache no periodic resync year", p_clock->Get_Year(), 30);
+    Bench_Begin();
+    Clock_Cache_Resync();
+    Bench_End("Clock_Cache_Resync");
+    Check("cache resync on demand year", p_clock->Get_Year(), 31);
+
+    p_clock = p_chip;
+}
+
+/* Sets the clock through the cache a second short of a rollover, lets its tick count through it, and checks
+ * both the cache and the chip landed on the same side */
+static void Run_Cache_Rollover(const char *name, full_datetime_t before, full_datetime_t after)
+{
+    char label[64];
+
+    p_clock->Set_Full_Datetime(before);
+    Bench_Begin();
+    Step_Cache_Seconds(1);
+
+    snprintf(label, sizeof(label), "cache rollover, %s", name);
+    Check_Datetime(label, p_clock->Get_Full_Datetime(), after);
+    Check(label, p_bus->stats.transactions, 0);
+    snprintf(label, sizeof(label), "cache rollover chip, %s", name);
+    Check_Datetime(label, get_clock_driver()->Get_Full_Datetime(), after);
+}
+
+/* Runs the virtual clock from one cache tick to the next, the only timer running here */
+static void Step_Cache_Seconds(uint32_t seconds)
+{
+    for (uint32_t i = 0; i < seconds; i++)
+        Host_Step_Timers();
+}
+
+#ifdef DS3231_SQW_WIRED
+static void Run_Tick_Checks(void)
+{
+    Clock_Driver_t *p_chip = p_clock;
+    full_datetime_t before = LEAP_EVE;
+    full_datetime_t after = LEAP_EVE;
+    uint32_t mismatches = 0;
+
+    printf("\n");
+    Check("SQW control INTCN/RS", DS3231_Model_Peek(&rtc, DS3231_REG_CONTROL) & 0x1C, 0);
+
+    /* The chip alone: one falling edge, so one tick, a second */
+    num_ticks = 0;
+    Step_Pin_Seconds(10);
+    Check("SQW ticks in 10s", num_ticks, 10);
+
+    /* Ticked by the square wave, the cache's timer is stopped and the copy turns over with the chip */
+    p_clock = get_cached_clock_driver();
+    Clock_Cache_Set_Tick_Source(CLOCK_CACHE_TICK_EXTERNAL);
+    sqw_ticks_cache = 1;
+    Check("SQW cache timer stopped", Host_Step_Timers(), 0);
+
+    before.time.seconds = 59;
+    after.time.hours.hour = 0;
+    after.time.minutes = 0;
+    after.time.seconds = 0;
+    after.date.day_of_week = DAY_OF_WEEK_FRI;
+    after.date.date = 29;
+    p_clock->Set_Full_Datetime(before);
+    Bench_Begin();
+    Step_Pin_Seconds(1);
+    Bench_End("SQW tick");
+    Check("SQW tick transactions", p_bus->stats.transactions, 0);
+    Check_Datetime("SQW cache rollover", p_clock->Get_Full_Datetime(), after);
+    Check_Datetime("SQW chip rollover", p_chip->Get_Full_Datetime(), after);
+
+    /* Resynced part way into a second the copy stays in step, where a restarted timer would lag the chip */
+    Host_Advance_Ns(NS_PER_SECOND / 3);
+    Clock_Cache_Resync();
+    for (uint32_t i = 0; i < SQW_RUN_S; i++)
+    {
+        Step_Pin_Seconds(1);
+        Host_Advance_Ns(SQW_SAMPLE_NS);
+        if (p_clock->Get_Seconds() != p_chip->Get_Seconds())
+            mismatches++;
+    }
+    Check("SQW cache out of step", mismatches, 0);
+    Check_Datetime("SQW cache after a day", p_clock->Get_Full_Datetime(), p_chip->Get_Full_Datetime());
+
+    sqw_ticks_cache = 0;
+    Clock_Cache_Set_Tick_Source(CLOCK_CACHE_TICK_TIM);
+    p_clock = p_chip;
+}
+
+#endif
+
+static void Run_Alarm_Checks(void)
+{
+    alarm_t alarm_time = { 0 };
+    alarm_t got;
+    uint32_t errors_before;
+
+    printf("\n");
+
+    /* Alarm 1 on the 30th second of every minute: the other three registers are masked off. Setting it clears
+     * its own flag and no other. */
+    alarm_time.match = ALARM_MATCH_SECONDS;
+    alarm_time.seconds = 30;
+    alarm_time.minutes = 15;
+    alarm_time.hours = (hours_t){ .hour = 7, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE };
+    alarm_time.date = 12;
+    DS3231_Model_Poke(&rtc, DS3231_REG_STATUS, DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) | ALARM_FLAGS);
+    Bench_Begin();
+    p_clock->Set_Alarm(CLOCK_ALARM_1, alarm_time);
+    Bench_End("Set_Alarm");
+    Check("alarm 1 seconds register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_SECS), 0x30);
+    Check("alarm 1 minutes register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_SECS + 1), 0x95);
+    Check("alarm 1 hours register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_SECS + 2), 0x87);
+    Check("alarm 1 day/date register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_DAY_DATE), 0x92);
+    Check("alarm 1 armed", DS3231_Model_Peek(&rtc, DS3231_REG_CONTROL) & DS3231_CONTROL_A1IE, DS3231_CONTROL_A1IE);
+    Check("alarm 1 flag cleared", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & ALARM_FLAGS, DS3231_STATUS_A2F);
+    Check("alarm EN32kHz kept", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & 0x08, 0x08);
+    Bench_Begin();
+    got = p_clock->Get_Alarm(CLOCK_ALARM_1);
+    Bench_End("Get_Alarm");
+    Check("alarm 1 seconds match", got.match, ALARM_MATCH_SECONDS);
+    Check("alarm 1 seconds", got.seconds, 30);
+
+    /* Alarm 1 at 7:45:10 PM on Saturdays, in 12 hour mode */
+    alarm_time.match = ALARM_MATCH_DAY_OF_WEEK;
+    alarm_time.seconds = 10;
+    alarm_time.minutes = 45;
+    alarm_time.hours = (hours_t){ .hour = 7, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM };
+    alarm_time.day_of_week = DAY_OF_WEEK_SAT;
+    p_clock->Set_Alarm(CLOCK_ALARM_1, alarm_time);
+    Check("alarm 1 day seconds register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_SECS), 0x10);
+    Check("alarm 1 day minutes register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_SECS + 1), 0x45);
+    Check("alarm 1 day hours register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_SECS + 2), 0x67);
+    Check("alarm 1 day register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_1_DAY_DATE), 0x40 | DAY_OF_WEEK_SAT);
+    got = p_clock->Get_Alarm(CLOCK_ALARM_1);
+    Check("alarm 1 day match", got.match, ALARM_MATCH_DAY_OF_WEEK);
+    Check("alarm 1 day seconds", got.seconds, 10);
+    Check("alarm 1 day minutes", got.minutes, 45);
+    Check_Hours("alarm 1 day", got.hours, alarm_time.hours);
+    Check("alarm 1 day of week", got.day_of_week, DAY_OF_WEEK_SAT);
+
+    /* Alarm 2 at 23:05 on the 31st, queued */
+    alarm_time.match = ALARM_MATCH_DATE;
+    alarm_time.minutes = 5;
+    alarm_time.hours = (hours_t){ .hour = 23, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE };
+    alarm_time.date = 31;
+    num_set_alarm_callbacks = 0;
+    Bench_Begin();
+    p_clock->Set_Alarm_IT(CLOCK_ALARM_2, alarm_time);
+    Bench_End("Set_Alarm_IT");
+    Check("alarm 2 set callbacks", num_set_alarm_callbacks, 1);
+    Check("alarm 2 minutes register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_2_MINS), 0x05);
+    Check("alarm 2 hours register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_2_MINS + 1), 0x23);
+    Check("alarm 2 date register", DS3231_Model_Peek(&rtc, DS3231_REG_ALARM_2_DAY_DATE), 0x31);
+    Check("alarm 2 armed", DS3231_Model_Peek(&rtc, DS3231_REG_CONTROL) & DS3231_CONTROL_A2IE, DS3231_CONTROL_A2IE);
+    Check("alarm 2 flag cleared", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & ALARM_FLAGS, 0);
+    got = p_clock->Get_Alarm(CLOCK_ALARM_2);
+    Check("alarm 2 date match", got.match, ALARM_MATCH_DATE);
+    Check("alarm 2 date minutes", got.minutes, 5);
+    Check_Hours("alarm 2 date", got.hours, alarm_time.hours);
+    Check("alarm 2 date", got.date, 31);
+
+    /* A queued set the alarm cannot do is refused at once, through the error callback */
+    errors_before = num_clock_errors;
+    alarm_time.match = ALARM_MATCH_SECONDS;
+    p_clock->Set_Alarm_IT(CLOCK_ALARM_2, alarm_time);
+    while (Host_Step_I2C());
+    Check("alarm 2 refused IT error", num_clock_errors - errors_before, 1);
+    Check("alarm 2 refused IT match", p_clock->Get_Alarm(CLOCK_ALARM_2).match, ALARM_MATCH_DATE);
+    num_clock_errors = errors_before;
+    clock_dev.ctrl_stage = CLOCK_CTRL_IDLE;
+
+    Run_Alarm_Round_Trips();
+
+    /* Clearing disarms the one alarm and clears its flag, leaving the other armed and flagged */
+    DS3231_Model_Poke(&rtc, DS3231_REG_STATUS, DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) | ALARM_FLAGS);
+    Bench_Begin();
+    p_clock->Clear_Alarm(CLOCK_ALARM_1);
+    Bench_End("Clear_Alarm");
+    Check("alarm 1 cleared control", DS3231_Model_Peek(&rtc, DS3231_REG_CONTROL) & (DS3231_CONTROL_A1IE | DS3231_CONTROL_A2IE),
+          DS3231_CONTROL_A2IE);
+    Check("alarm 1 cleared status", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & ALARM_FLAGS, DS3231_STATUS_A2F);
+    p_clock->Clear_Alarm(CLOCK_ALARM_2);
+    Check("alarms cleared control", DS3231_Model_Peek(&rtc, DS3231_REG_CONTROL) & (DS3231_CONTROL_A1IE | DS3231_CONTROL_A2IE), 0);
+    Check("alarms cleared status", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & ALARM_FLAGS, 0);
+
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+    Run_Alarm_Pin_Checks();
+#endif
+}
+
+/* Every match mode each alarm can do comes back as it went in. The others set CLOCK_CTRL_ERROR and leave the
+ * alarm as it was. */
+static void Run_Alarm_Round_Trips(void)
+{
+    static const alarm_match_t MODES[] = {
+            ALARM_MATCH_EVERY_SECOND, ALARM_MATCH_EVERY_MINUTE, ALARM_MATCH_SECONDS, ALARM_MATCH_MINUTES,
+            ALARM_MATCH_HOURS, ALARM_MATCH_DATE, ALARM_MATCH_DAY_OF_WEEK,
+    };
+    alarm_t alarm_time = {
+            .seconds = 59,
+            .minutes = 30,
+            .hours = { .hour = 12, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_AM },
+            .date = 29,
+            .day_of_week = DAY_OF_WEEK_WED,
+    };
+    alarm_t got;
+    alarm_match_t before;
+    uint8_t supported;
+    char label[80];
+
+    for (Clock_Alarm_t alarm = CLOCK_ALARM_1; alarm <= CLOCK_ALARM_2; alarm++)
+    {
+        for (uint8_t i = 0; i < sizeof(MODES) / sizeof(MODES[0]); i++)
+        {
+            alarm_time.match = MODES[i];
+            if (alarm == CLOCK_ALARM_1)
+                supported = (MODES[i] != ALARM_MATCH_EVERY_MINUTE);
+            else
+                supported = (MODES[i] != ALARM_MATCH_EVERY_SECOND && MODES[i] != ALARM_MATCH_SECONDS);
+
+            before = p_clock->Get_Alarm(alarm).match;
+            clock_dev.ctrl_stage = CLOCK_CTRL_IDLE;
+            p_clock->Set_Alarm(alarm, alarm_time);
+            got = p_clock->Get_Alarm(alarm);
+
+            snprintf(label, sizeof(label), "alarm %u mode %u stage", alarm + 1, MODES[i]);
+            Check(label, clock_dev.ctrl_stage, supported ? CLOCK_CTRL_IDLE : CLOCK_CTRL_ERROR);
+            snprintf(label, sizeof(label), "alarm %u mode %u match", alarm + 1, MODES[i]);
+            Check(label, got.match, supported ? MODES[i] : before);
+            if (!supported)
+                continue;
+
+            snprintf(label, sizeof(label), "alarm %u mode %u", alarm + 1, MODES[i]);
+            if (alarm == CLOCK_ALARM_1 && MODES[i] != ALARM_MATCH_EVERY_SECOND)
+                Check(label, got.seconds, alarm_time.seconds);
+            if (MODES[i] >= ALARM_MATCH_MINUTES)
+                Check(label, got.minutes, alarm_time.minutes);
+            if (MODES[i] >= ALARM_MATCH_HOURS)
+                Check_Hours(label, got.hours, alarm_time.hours);
+            if (MODES[i] == ALARM_MATCH_DATE)
+                Check(label, got.date, alarm_time.date);
+            if (MODES[i] == ALARM_MATCH_DAY_OF_WEEK)
+                Check(label, got.day_of_week, alarm_time.day_of_week);
+        }
+    }
+    clock_dev.ctrl_stage = CLOCK_CTRL_IDLE;
+}
+
+static uint8_t Int_Sqw_Level(void)
+{
+    return DS3231_Model_Int_Pin(&rtc);
+}
+
+#if defined(DS3231_SQW_WIRED) || defined(DS3231_INT_WIRED)
+static void Run_Alarm_Pin_Checks(void)
+{
+    static const hours_t MIDNIGHT = { .hour = 0, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE };
+    static const hours_t ONE_AM = { .hour = 1, .hour_format = HOUR_FORMAT_24_HOUR, .am_pm = AM_PM_NONE };
+    static const Alarm_Case_t CASES[] = {
+            { "every second", CLOCK_ALARM_1, { .match = ALARM_MATCH_EVERY_SECOND }, 10, 10 },
+            { "seconds match", CLOCK_ALARM_1, { .match = ALARM_MATCH_SECONDS, .seconds = 30 }, 180, 3 },
+            { "every minute", CLOCK_ALARM_2, { .match = ALARM_MATCH_EVERY_MINUTE }, 180, 3 },
+            { "minutes match", CLOCK_ALARM_2, { .match = ALARM_MATCH_MINUTES, .minutes = 2 }, 2 * 60 * 60, 2 },
+            { "hours match", CLOCK_ALARM_1, { .match = ALARM_MATCH_HOURS, .hours = ONE_AM }, 26 * 60 * 60, 2 },
+            { "date match", CLOCK_ALARM_2, { .match = ALARM_MATCH_DATE, .hours = MIDNIGHT, .date = 1 },
+              26 * 60 * 60, 1 },
+            { "day match", CLOCK_ALARM_1,
+              { .match = ALARM_MATCH_DAY_OF_WEEK, .hours = MIDNIGHT, .day_of_week = DAY_OF_WEEK_SAT },
+              26 * 60 * 60, 1 },
+    };
+    char label[80];
+
+    /* LEAP_EVE is set as a Thursday, so the 1st of March counts as a Saturday */
+    for (uint8_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++)
+    {
+        p_clock->Clear_Alarm(CLOCK_ALARM_1);
+        p_clock->Clear_Alarm(CLOCK_ALARM_2);
+        p_clock->Set_Full_Datetime(LEAP_EVE);
+        p_clock->Set_Alarm(CASES[i].alarm, CASES[i].alarm_time);
+        num_alarms[CLOCK_ALARM_1] = 0;
+        num_alarms[CLOCK_ALARM_2] = 0;
+        Step_Pin_Seconds(CASES[i].run_s);
+
+        snprintf(label, sizeof(label), "alarm pin %s fired", CASES[i].name);
+        Check(label, num_alarms[CASES[i].alarm], CASES[i].expected);
+        snprintf(label, sizeof(label), "alarm pin %s other fired", CASES[i].name);
+        Check(label, num_alarms[!CASES[i].alarm], 0);
+        snprintf(label, sizeof(label), "alarm pin %s flag left", CASES[i].name);
+        Check(label, DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & (CASES[i].alarm == CLOCK_ALARM_1 ? DS3231_STATUS_A1F : DS3231_STATUS_A2F), 0);
+    }
+
+    /* Both at once: alarm 1 every second and alarm 2 every minute, so they match together as each minute begins */
+    p_clock->Set_Full_Datetime(LEAP_EVE);
+    p_clock->Set_Alarm(CLOCK_ALARM_1, CASES[0].alarm_time);
+    p_clock->Set_Alarm(CLOCK_ALARM_2, CASES[2].alarm_time);
+    num_alarms[CLOCK_ALARM_1] = 0;
+    num_alarms[CLOCK_ALARM_2] = 0;
+    Step_Pin_Seconds(180);
+    Check("alarm pin both alarm 1 fired", num_alarms[CLOCK_ALARM_1], 180);
+    Check("alarm pin both alarm 2 fired", num_alarms[CLOCK_ALARM_2], 3);
+    Check("alarm pin both flags left", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & ALARM_FLAGS, 0);
+
+#ifdef DS3231_INT_WIRED
+    /* A match left from before a reset holds the pin low; Initialize services it, since no edge will come */
+    DS3231_Model_Poke(&rtc, DS3231_REG_STATUS, DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) | DS3231_STATUS_A2F);
+    Check("alarm pin held low", Int_Sqw_Level(), 0);
+    num_alarms[CLOCK_ALARM_2] = 0;
+    p_clock->Initialize(&clock_dev);
+    while (Host_Step_I2C());
+    Check("alarm pin at Initialize fired", num_alarms[CLOCK_ALARM_2], 1);
+    Check("alarm pin at Initialize released", Int_Sqw_Level(), 1);
+#endif
+
+    /* Cleared, neither fires, though the chip still flags the matches */
+    p_clock->Clear_Alarm(CLOCK_ALARM_1);
+    p_clock->Clear_Alarm(CLOCK_ALARM_2);
+    num_alarms[CLOCK_ALARM_1] = 0;
+    num_alarms[CLOCK_ALARM_2] = 0;
+    Step_Pin_Seconds(180);
+    Check("alarm pin cleared fired", num_alarms[CLOCK_ALARM_1] + num_alarms[CLOCK_ALARM_2], 0);
+    Check("alarm pin cleared flags", DS3231_Model_Peek(&rtc, DS3231_REG_STATUS) & ALARM_FLAGS, ALARM_FLAGS);
+    p_clock->Clear_Alarm(CLOCK_ALARM_1);
+    p_clock->Clear_Alarm(CLOCK_ALARM_2);
+}
+
+/* Runs the virtual clock up to each of the chip's seconds and, like the EXTI line, calls the handler when the
+ * INT/SQW pin is seen to fall. Whatever the handler queued is run through before the next second. */
+static void Step_Pin_Seconds(uint32_t seconds)
+{
+    uint8_t level;
+
+    for (uint32_t i = 0; i < seconds; i++)
+    {
+        DS3231_Model_Sync(&rtc);
+        Host_Advance_Ns(rtc.next_tick_ns - Host_Now_Ns() - 1);
+        level = DS3231_Model_Int_Pin(&rtc);
+        Host_Advance_Ns(1);
+        if (level && !DS3231_Model_Int_Pin(&rtc))
+            DS3231_INT_SQW_IRQHandler();
+        while (Host_Step_I2C());
+    }
+}
+#endif
+
+/*************** BENCH AND CHECK UTILITIES *****************/
+static void Bench_Begin(void)
+{
+    I2C_Bus_Reset_Stats(p_bus);
+}
+
+/* Queued calls are pumped to completion first, so their bus time counts against the call that queued them */
+static void Bench_End(const char *name)
+{
+    while (Host_Step_I2C());
+
+    printf("%-28s %6u %6u %10.1f\n", name, p_bus->stats.transactions, p_bus->stats.bytes,
+           p_bus->stats.bus_ns / 1000.0);
+}
+
+static void Check(const char *name, uint32_t got, uint32_t expected)
+{
+    num_checks++;
+    if (got == expected)
+        return;
+
+    num_failures++;
+    printf("FAIL %s: got %u (0x%02X), expected %u (0x%02X)\n", name, got, got, expected, expected);
+}
+
+static void Check_Hours(const char *name, hours_t got, hours_t expected)
+{
+    char label[80];
+
+    snprintf(label, sizeof(label), "%s hour", name);
+    Check(label, got.hour, expected.hour);
+    snprintf(label, sizeof(label), "%s hour format", name);
+    Check(label, got.hour_format, expected.hour_format);
+    snprintf(label, sizeof(label), "%s AM/PM", name);
+    Check(label, got.am_pm, expected.am_pm);
+}
+
+static void Check_Datetime(const char *name, full_datetime_t got, full_datetime_t expected)
+{
+    char label[80];
+
+    snprintf(label, sizeof(label), "%s seconds", name);
+    Check(label, got.time.seconds, expected.time.seconds);
+    snprintf(label, sizeof(label), "%s minutes", name);
+    Check(label, got.time.minutes, expected.time.minutes);
+    Check_Hours(name, got.time.hours, expected.time.hours);
+    snprintf(label, sizeof(label), "%s day of week", name);
+    Check(label, got.date.day_of_week, expected.date.day_of_week);
+    snprintf(label, sizeof(label), "%s date", name);
+    Check(label, got.date.date, expected.date.date);
+    snprintf(label, sizeof(label), "%s month", name);
+    Check(label, got.date.month, expected.date.month);
+    snprintf(label, sizeof(label), "%s year", name);
+    Check(label, got.date.year, expected.date.year);
+    snprintf(label, sizeof(label), "%s century", name);
+    Check(label, got.date.century, expected.date.century);
+}
+
+static void Check_Registers(const char *name, const uint8_t *p_expected)
+{
+    char label[80];
+
+    for (uint8_t reg = 0; reg < DS3231_MODEL_NUM_TIME_REGS; reg++)
+    {
+        snprintf(label, sizeof(label), "%s register 0x%02X", name, reg);
+        Check(label, DS3231_Model_Peek(&rtc, reg), p_expected[reg]);
+    }
+}
+
+static void Check_Callbacks(const char *name, const char *p_expected)
+{
+    num_checks++;
+    if (strcmp(callback_log, p_expected) != 0)
+    {
+        num_failures++;
+        printf("FAIL %s callbacks: got \"%s\", expected \"%s\"\n", name, callback_log, p_expected);
+    }
+    callback_log[0] = '\0';
+}
+
+/* Appends " name"; once the log is full the rest is dropped, which fails the next check rather than overflowing */
+static void Log_Callback(const char *name)
+{
+    size_t used = strlen(callback_log);
+
+    snprintf(callback_log + used, sizeof(callback_log) - used, " %s", name);
+}
@@ -0,0 +1,354 @@
+#include <string.h>
+#include <time.h>
+
+#include "ds3231_model.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static uint8_t DS3231_Model_Start(void *p_slave, uint8_t read);
+static uint8_t DS3231_Model_Write_Byte(void *p_slave, uint8_t byte);
+static uint8_t DS3231_Model_Read_Byte(void *p_slave);
+static void DS3231_Model_Stop(void *p_slave);
+static void DS3231_Model_Write_Reg(DS3231_Model_t *p_model, uint8_t reg, uint8_t value);
+static void DS3231_Model_Next_Reg(DS3231_Model_t *p_model);
+static void DS3231_Model_Latch(DS3231_Model_t *p_model);
+static void DS3231_Model_Tick(DS3231_Model_t *p_model);
+static uint8_t DS3231_Model_Tick_Hours(uint8_t hours_reg, uint8_t *p_carry);
+static void DS3231_Model_Check_Alarms(DS3231_Model_t *p_model);
+static uint8_t DS3231_Model_Alarm_Matches(DS3231_Model_t *p_model, uint8_t first_alarm_reg, uint8_t first_time_reg);
+static uint8_t DS3231_Model_Days_In_Month(uint8_t month, uint8_t year);
+static uint8_t BCD_Step(uint8_t bcd, uint8_t first, uint8_t last, uint8_t *p_carry);
+static uint8_t BCD_To_Binary(uint8_t bcd);
+static uint8_t Binary_To_BCD(uint8_t binary);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+#define NS_PER_SECOND               1000000000ull
+
+/* Bits a write can change. Status is handled on its own, since its flags can only be cleared, and the
+ * temperature registers are read only. */
+static const uint8_t WRITE_MASKS[DS3231_MODEL_NUM_REGS] = {
+        0x7F, 0x7F, 0x7F, 0x07, 0x3F, 0x9F, 0xFF,      /* time and calendar */
+        0xFF, 0xFF, 0xFF, 0xFF,                        /* alarm 1 */
+        0xFF, 0xFF, 0xFF,                              /* alarm 2 */
+        0xFF, 0x08, 0xFF,                              /* control, status, aging offset */
+        0x00, 0x00,                                    /* temperature */
+};
+
+#define STATUS_CLEAR_ONLY_MASK      (DS3231_STATUS_OSF | DS3231_STATUS_A2F | DS3231_STATUS_A1F)
+
+const I2C_Bus_Slave_Ops_t DS3231_MODEL_OPS = {
+        .Start = DS3231_Model_Start,
+        .Write_Byte = DS3231_Model_Write_Byte,
+        .Read_Byte = DS3231_Model_Read_Byte,
+        .Stop = DS3231_Model_Stop,
+};
+
+void DS3231_Model_Init(DS3231_Model_t *p_model, uint64_t (*p_now_ns)(void))
+{
+    memset(p_model, 0, sizeof(*p_model));
+    p_model->p_now_ns = p_now_ns;
+    p_model->regs[DS3231_REG_DAY] = 0x01;
+    p_model->regs[DS3231_REG_DATE] = 0x01;
+    p_model->regs[DS3231_REG_MONTH_CENTURY] = 0x01;
+    p_model->regs[DS3231_REG_CONTROL] = 0x1C;
+    p_model->regs[DS3231_REG_STATUS] = 0x88;
+    DS3231_Model_Set_Temp(p_model, 25 * 4);
+    p_model->next_tick_ns = p_now_ns() + NS_PER_SECOND;
+    DS3231_Model_Latch(p_model);
+}
+
+uint64_t DS3231_Model_Wall_Clock_Ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SECOND + (uint64_t)ts.tv_nsec;
+}
+
+void DS3231_Model_Sync(DS3231_Model_t *p_model)
+{
+    uint64_t now_ns = p_model->p_now_ns();
+
+    while (now_ns >= p_model->next_tick_ns)
+    {
+        DS3231_Model_Tick(p_model);
+        p_model->next_tick_ns += NS_PER_SECOND;
+    }
+}
+
+uint8_t DS3231_Model_Peek(DS3231_Model_t *p_model, uint8_t reg)
+{
+    DS3231_Model_Sync(p_model);
+    return p_model->regs[reg % DS3231_MODEL_NUM_REGS];
+}
+
+/* Sets a register as is, flags included, for a test to stage a state the bus could not write */
+void DS3231_Model_Poke(DS3231_Model_t *p_model, uint8_t reg, uint8_t value)
+{
+    DS3231_Model_Sync(p_model);
+    reg %= DS3231_MODEL_NUM_REGS;
+    p_model->regs[reg] = value;
+    if (reg == DS3231_REG_SECONDS)
+        p_model->next_tick_ns = p_model->p_now_ns() + NS_PER_SECOND;
+}
+
+/* The temperature is a 10-bit two's complement count of quarter degrees, left aligned over the two registers */
+void DS3231_Model_Set_Temp(DS3231_Model_t *p_model, int16_t quarter_degrees)
+{
+    p_model->regs[DS3231_REG_TEMP_MSB] = (uint8_t)(quarter_degrees >> 2);
+    p_model->regs[DS3231_REG_TEMP_LSB] = (uint8_t)((quarter_degrees & 0x3) << 6);
+}
+
+uint8_t DS3231_Model_Int_Pin(DS3231_Model_t *p_model)
+{
+    uint8_t control;
+    uint8_t status;
+
+    DS3231_Model_Sync(p_model);
+    control = p_model->regs[DS3231_REG_CONTROL];
+    status = p_model->regs[DS3231_REG_STATUS];
+
+    /* The 1Hz square wave falls as the seconds count on and rises half way through; the faster rates are not
+     * modelled and hold the pin high */
+    if (!(control & DS3231_CONTROL_INTCN))
+    {
+        if (control & DS3231_CONTROL_RS_MASK)
+            return 1;
+        return (p_model->p_now_ns() + NS_PER_SECOND - p_model->next_tick_ns) >= NS_PER_SECOND / 2;
+    }
+    if ((status & DS3231_STATUS_A1F) && (control & DS3231_CONTROL_A1IE))
+        return 0;
+    if ((status & DS3231_STATUS_A2F) && (control & DS3231_CONTROL_A2IE))
+        return 0;
+    return 1;
+}
+
+/*************** BUS EVENTS *****************/
+/* Every start copies the count into the user buffer, so a burst read of the time cannot tear across a tick */
+static uint8_t DS3231_Model_Start(void *p_slave, uint8_t read)
+{
+    DS3231_Model_t *p_model = (DS3231_Model_t *) p_slave;
+
+    DS3231_Model_Sync(p_model);
+    DS3231_Model_Latch(p_model);
+    p_model->ptr_pending = !read;
+    return 1;
+}
+
+static uint8_t DS3231_Model_Write_Byte(void *p_slave, uint8_t byte)
+{
+    DS3231_Model_t *p_model = (DS3231_Model_t *) p_slave;
+
+    if (p_model->ptr_pending)
+    {
+        p_model->reg_ptr = byte % DS3231_MODEL_NUM_REGS;
+        p_model->ptr_pending = 0;
+        return 1;
+    }
+
+    DS3231_Model_Write_Reg(p_model, p_model->reg_ptr, byte);
+    DS3231_Model_Next_Reg(p_model);
+    return 1;
+}
+
+static uint8_t DS3231_Model_Read_Byte(void *p_slave)
+{
+    DS3231_Model_t *p_model = (DS3231_Model_t *) p_slave;
+    uint8_t reg = p_model->reg_ptr;
+    uint8_t value;
+
+    if (reg < DS3231_MODEL_NUM_TIME_REGS)
+        value = p_model->user_buffer[reg];
+    else
+        value = p_model->regs[reg];
+
+    DS3231_Model_Next_Reg(p_model);
+    return value;
+}
+
+static void DS3231_Model_Stop(void *p_slave)
+{
+    ((DS3231_Model_t *) p_slave)->ptr_pending = 0;
+}
+
+/*************** REGISTER FILE *****************/
+static void DS3231_Model_Write_Reg(DS3231_Model_t *p_model, uint8_t reg, uint8_t value)
+{
+    uint8_t old = p_model->regs[reg];
+
+    if (reg == DS3231_REG_STATUS)
+    {
+        /* Writing 0 clears a flag; writing 1 leaves it as it was */
+        p_model->regs[reg] = (old & ~(WRITE_MASKS[reg] | STATUS_CLEAR_ONLY_MASK))
+                             | (value & WRITE_MASKS[reg])
+                             | (old & value & STATUS_CLEAR_ONLY_MASK);
+        return;
+    }
+
+    p_model->regs[reg] = (old & ~WRITE_MASKS[reg]) | (value & WRITE_MASKS[reg]);
+
+    if (reg < DS3231_MODEL_NUM_TIME_REGS)
+        p_model->user_buffer[reg] = p_model->regs[reg];
+
+    /* Writing the seconds restarts the countdown chain, so the next tick is a whole second away */
+    if (reg == DS3231_REG_SECONDS)
+        p_model->next_tick_ns = p_model->p_now_ns() + NS_PER_SECOND;
+}
+
+/* The pointer wraps from the last register to the first, and the user buffer is refreshed as it does */
+static void DS3231_Model_Next_Reg(DS3231_Model_t *p_model)
+{
+    p_model->reg_ptr++;
+    if (p_model->reg_ptr == DS3231_MODEL_NUM_REGS)
+    {
+        p_model->reg_ptr = 0;
+        DS3231_Model_Sync(p_model);
+        DS3231_Model_Latch(p_model);
+    }
+}
+
+static void DS3231_Model_Latch(DS3231_Model_t *p_model)
+{
+    memcpy(p_model->user_buffer, p_model->regs, DS3231_MODEL_NUM_TIME_REGS);
+}
+
+/*************** COUNTER CHAIN *****************/
+static void DS3231_Model_Tick(DS3231_Model_t *p_model)
+{
+    uint8_t *p_regs = p_model->regs;
+    uint8_t carry = 0;
+    uint8_t month;
+    uint8_t year;
+
+    p_model->ticks++;
+
+    p_regs[DS3231_REG_SECONDS] = BCD_Step(p_regs[DS3231_REG_SECONDS] & 0x7F, 0, 59, &carry);
+    if (carry)
+    {
+        carry = 0;
+        p_regs[DS3231_REG_MINUTES] = BCD_Step(p_regs[DS3231_REG_MINUTES] & 0x7F, 0, 59, &carry);
+    }
+    if (carry)
+    {
+        carry = 0;
+        p_regs[DS3231_REG_HOURS] = DS3231_Model_Tick_Hours(p_regs[DS3231_REG_HOURS], &carry);
+    }
+    if (carry)
+    {
+        month = BCD_To_Binary(p_regs[DS3231_REG_MONTH_CENTURY] & 0x1F);
+        year = BCD_To_Binary(p_regs[DS3231_REG_YEAR]);
+
+        /* The day of week counts on its own, whatever the date */
+        p_regs[DS3231_REG_DAY] = (p_regs[DS3231_REG_DAY] & 0x07) % 7 + 1;
+
+        carry = 0;
+        p_regs[DS3231_REG_DATE] = BCD_Step(p_regs[DS3231_REG_DATE] & 0x3F, 1,
+                                           DS3231_Model_Days_In_Month(month, year), &carry);
+    }
+    if (carry)
+    {
+        carry = 0;
+        p_regs[DS3231_REG_MONTH_CENTURY] = (p_regs[DS3231_REG_MONTH_CENTURY] & DS3231_MONTH_CENTURY)
+                                           | BCD_Step(p_regs[DS3231_REG_MONTH_CENTURY] & 0x1F, 1, 12, &carry);
+    }
+    if (carry)
+    {
+        carry = 0;
+        p_regs[DS3231_REG_YEAR] = BCD_Step(p_regs[DS3231_REG_YEAR], 0, 99, &carry);
+        if (carry)
+            p_regs[DS3231_REG_MONTH_CENTURY] ^= DS3231_MONTH_CENTURY;
+    }
+
+    DS3231_Model_Check_Alarms(p_model);
+}
+
+/* In 12 hour mode the count runs 12, 1 .. 11, with AM/PM flipping on the way into 12 and the day carrying
+ * at midnight, which is 12 AM */
+static uint8_t DS3231_Model_Tick_Hours(uint8_t hours_reg, uint8_t *p_carry)
+{
+    uint8_t pm = hours_reg & DS3231_HOURS_PM;
+    uint8_t hour;
+
+    if (!(hours_reg & DS3231_HOURS_12_HOUR))
+        return BCD_Step(hours_reg & 0x3F, 0, 23, p_carry);
+
+    hour = BCD_To_Binary(hours_reg & 0x1F) + 1;
+    if (hour == 12)
+    {
+        pm ^= DS3231_HOURS_PM;
+        *p_carry = !pm;
+    }
+    else if (hour == 13)
+    {
+        hour = 1;
+    }
+
+    return DS3231_HOURS_12_HOUR | pm | Binary_To_BCD(hour);
+}
+
+/* Alarm 1 is compared on every tick and alarm 2, which has no seconds register, as each minute begins */
+static void DS3231_Model_Check_Alarms(DS3231_Model_t *p_model)
+{
+    if (DS3231_Model_Alarm_Matches(p_model, DS3231_REG_ALARM_1_SECS, DS3231_REG_SECONDS))
+        p_model->regs[DS3231_REG_STATUS] |= DS3231_STATUS_A1F;
+
+    if (p_model->regs[DS3231_REG_SECONDS] == 0
+            && DS3231_Model_Alarm_Matches(p_model, DS3231_REG_ALARM_2_MINS, DS3231_REG_MINUTES))
+        p_model->regs[DS3231_REG_STATUS] |= DS3231_STATUS_A2F;
+}
+
+/* Walks an alarm's registers against the time registers from first_time_reg up, so both alarms share it.
+ * The last alarm register holds the day or date, picked by DY/DT. Masked registers always match. */
+static uint8_t DS3231_Model_Alarm_Matches(DS3231_Model_t *p_model, uint8_t first_alarm_reg, uint8_t first_time_reg)
+{
+    uint8_t alarm_reg = first_alarm_reg;
+    uint8_t alarm;
+
+    for (uint8_t time_reg = first_time_reg; time_reg <= DS3231_REG_HOURS; time_reg++, alarm_reg++)
+    {
+        alarm = p_model->regs[alarm_reg];
+        if (!(alarm & DS3231_ALARM_MASK_BIT) && (alarm & 0x7F) != (p_model->regs[time_reg] & 0x7F))
+            return 0;
+    }
+
+    alarm = p_model->regs[alarm_reg];
+    if (alarm & DS3231_ALARM_MASK_BIT)
+        return 1;
+    if (alarm & DS3231_ALARM_DY_DT)
+        return (alarm & 0x0F) == p_model->regs[DS3231_REG_DAY];
+    return (alarm & 0x3F) == p_model->regs[DS3231_REG_DATE];
+}
+
+/* Every year divisible by four is a leap year, which holds for the chip's 2000-2099 range */
+static uint8_t DS3231_Model_Days_In_Month(uint8_t month, uint8_t year)
+{
+    static const uint8_t DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    if (month < 1 || month > 12)
+        return 31;
+    if (month == 2 && (year % 4) == 0)
+        return 29;
+    return DAYS[month - 1];
+}
+
+/*************** BCD UTILITIES *****************/
+static uint8_t BCD_Step(uint8_t bcd, uint8_t first, uint8_t last, uint8_t *p_carry)
+{
+    uint8_t value = BCD_To_Binary(bcd) + 1;
+
+    if (value > last)
+    {
+        value = first;
+        *p_carry = 1;
+    }
+    return Binary_To_BCD(value);
+}
+
+static uint8_t BCD_To_Binary(uint8_t bcd)
+{
+    return (bcd >> 4) * 10 + (bcd & 0xF);
+}
+
+static uint8_t Binary_To_BCD(uint8_t binary)
+{
+    return ((binary / 10) << 4) | (binary % 10);
+}
@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_port.h"
+
+/* The formatter is private to the driver, so the driver is built into this file rather than linked */
+#include "../../Displays/LCD1602A/Src/lcd1602a_display_driver.c"
+
+/* Microbenchmark of the display formatter. LCD1602A_Update_Buffer_Datetime() renders a datetime into the time
+ * and date rows from the digit and name tables; the reference below is the formatter it replaced, kept as it
+ * was apart from writing into its own rows. Both must render every in-range datetime the same, and the table
+ * formatter must render out of range fields as blanks, the same one pass as field by field. Then each is timed
+ * over the same datetimes. Exits non-zero if any rendering check failed. */
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static full_datetime_t Make_Datetime(uint32_t seed);
+static void Run_Reference_Checks(void);
+static void Run_Range_Checks(void);
+static void Run_Timing(const char *name, void (*p_render)(full_datetime_t datetime), const char *time_str);
+static void Check_Rows(const char *name, const char *time_str, const char *date_str,
+                       const char *expected_time, const char *expected_date);
+static void Table_Update_Buffer_Datetime(full_datetime_t datetime);
+static void Ref_Update_Buffer_Datetime(full_datetime_t datetime);
+static void Ref_Update_Buffer_Seconds(seconds_t seconds);
+static void Ref_Update_Buffer_Minutes(minutes_t minutes);
+static void Ref_Update_Buffer_Hours(hours_t hours);
+static void Ref_Update_Buffer_Time(full_time_t full_time);
+static void Ref_Update_Buffer_Date(date_t date);
+static void Ref_Update_Buffer_Day_Of_Week(day_of_week_t dow);
+static void Ref_Update_Buffer_Month(month_t month);
+static void Ref_Update_Buffer_Year(year_t year, century_t century);
+static void Ref_Update_Buffer_Full_Date(full_date_t full_date);
+static char int_to_ascii_char(uint8_t int_to_covert);
+static void int_to_zero_padded_ascii(char *result, uint8_t int_to_convert);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+#define BENCH_CHECK_DATETIMES       100000
+#define BENCH_NUM_DATETIMES         1024        /* cycled through by the timed loops; a power of two */
+#define BENCH_CALLS                 20000000
+
+static char ref_time_str_buffer[LCD1602A_TIME_WIDTH + 1];
+static char ref_date_str_buffer[LCD1602A_FULL_DATE_WIDTH + 1];
+static full_datetime_t datetimes[BENCH_NUM_DATETIMES];
+static uint32_t num_checks;
+static uint32_t num_failures;
+
+int main(void)
+{
+    memcpy(lcd1602a_handle.time_str_buffer, RESET_TIME_STR, LCD1602A_TIME_WIDTH);
+    memcpy(lcd1602a_handle.date_str_buffer, RESET_DATE_STR, LCD1602A_FULL_DATE_WIDTH);
+    memcpy(ref_time_str_buffer, RESET_TIME_STR, LCD1602A_TIME_WIDTH);
+    memcpy(ref_date_str_buffer, RESET_DATE_STR, LCD1602A_FULL_DATE_WIDTH);
+
+    Run_Reference_Checks();
+    Run_Range_Checks();
+
+    for (uint32_t i = 0; i < BENCH_NUM_DATETIMES; i++)
+        datetimes[i] = Make_Datetime(i * 7919u);
+    printf("%-12s %10s %8s\n", "formatter", "calls", "ns/call");
+    Run_Timing("reference", Ref_Update_Buffer_Datetime, ref_time_str_buffer);
+    Run_Timing("table", Table_Update_Buffer_Datetime, lcd1602a_handle.time_str_buffer);
+
+    printf("\n%u checks, %u failed\n", num_checks, num_failures);
+    return num_failures ? 1 : 0;
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+/* An in-range datetime, spread over both hour formats and centuries */
+static full_datetime_t Make_Datetime(uint32_t seed)
+{
+    full_datetime_t datetime;
+
+    if (seed & 1)
+    {
+        datetime.time.hours.hour_format = HOUR_FORMAT_12_HOUR;
+        datetime.time.hours.hour = 1 + (seed / 2) % 12;
+        datetime.time.hours.am_pm = ((seed / 24) & 1) ? AM_PM_PM : AM_PM_AM;
+    }
+    else
+    {
+        datetime.time.hours.hour_format = HOUR_FORMAT_24_HOUR;
+        datetime.time.hours.hour = (seed / 2) % 24;
+        datetime.time.hours.am_pm = AM_PM_NONE;
+    }
+    datetime.time.minutes = (seed * 7) % 60;
+    datetime.time.seconds = (seed * 13) % 60;
+    datetime.date.day_of_week = DAY_OF_WEEK_SUN + seed % 7;
+    datetime.date.date = 1 + (seed * 3) % 31;
+    datetime.date.month = MONTH_JAN + (seed * 5) % 12;
+    datetime.date.year = (seed * 11) % 100;
+    datetime.date.century = ((seed / 100) & 1) ? CENTURY_20TH : CENTURY_21ST;
+    return datetime;
+}
+
+static void Run_Reference_Checks(void)
+{
+    full_datetime_t datetime;
+
+    for (uint32_t i = 0; i < BENCH_CHECK_DATETIMES; i++)
+    {
+        datetime = Make_Datetime(i);
+        LCD1602A_Update_Buffer_Datetime(datetime);
+        Ref_Update_Buffer_Datetime(datetime);
+        if (memcmp(lcd1602a_handle.time_str_buffer, ref_time_str_buffer, LCD1602A_TIME_WIDTH) != 0
+                || memcmp(lcd1602a_handle.date_str_buffer, ref_date_str_buffer, LCD1602A_FULL_DATE_WIDTH) != 0)
+        {
+            Check_Rows("reference", lcd1602a_handle.time_str_buffer, lcd1602a_handle.date_str_buffer,
+                       ref_time_str_buffer, ref_date_str_buffer);
+            return;
+        }
+    }
+    Check_Rows("reference", lcd1602a_handle.time_str_buffer, lcd1602a_handle.date_str_buffer,
+               ref_time_str_buffer, ref_date_str_buffer);
+}
+
+/* Every field past what it can show, rendered in one pass and then field by field */
+static void Run_Range_Checks(void)
+{
+    full_datetime_t datetime = {
+            .time = {
+                    .hours = { .hour = 100, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = 7 },
+                    .minutes = 255,
+                    .seconds = 5,
+            },
+            .date = {
+                    .day_of_week = 9,
+                    .date = 17,
+                    .month = 300,
+                    .year = 356,
+                    .century = CENTURY_21ST,
+            },
+    };
+
+    LCD1602A_Update_Buffer_Datetime(datetime);
+    Check_Rows("out of range", lcd1602a_handle.time_str_buffer, lcd1602a_handle.date_str_buffer,
+               "  :  :05   ", "      /17/20  ");
+
+    memcpy(lcd1602a_handle.time_str_buffer, RESET_TIME_STR, LCD1602A_TIME_WIDTH);
+    memcpy(lcd1602a_handle.date_str_buffer, RESET_DATE_STR, LCD1602A_FULL_DATE_WIDTH);
+    LCD1602A_Update_Buffer_Time(datetime.time);
+    LCD1602A_Update_Buffer_Full_Date(datetime.date);
+    Check_Rows("out of range by field", lcd1602a_handle.time_str_buffer, lcd1602a_handle.date_str_buffer,
+               "  :  :05   ", "      /17/20  ");
+}
+
+static void Run_Timing(const char *name, void (*p_render)(full_datetime_t datetime), const char *time_str)
+{
+    struct timespec start;
+    struct timespec end;
+    volatile char sink = 0;
+    double elapsed_ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < BENCH_CALLS; i++)
+    {
+        p_render(datetimes[i & (BENCH_NUM_DATETIMES - 1)]);
+        sink ^= time_str[LCD1602A_SECS_OFFSET + 1];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("%-12s %10u %8.1f\n", name, BENCH_CALLS, elapsed_ns / BENCH_CALLS);
+}
+
+static void Check_Rows(const char *name, const char *time_str, const char *date_str,
+                       const char *expected_time, const char *expected_date)
+{
+    num_checks++;
+    if (memcmp(time_str, expected_time, LCD1602A_TIME_WIDTH) == 0
+            && memcmp(date_str, expected_date, LCD1602A_FULL_DATE_WIDTH) == 0)
+    {
+        return;
+    }
+    num_failures++;
+    printf("FAIL %s: got \"%.*s\" \"%.*s\", expected \"%.*s\" \"%.*s\"\n", name,
+           LCD1602A_TIME_WIDTH, time_str, LCD1602A_FULL_DATE_WIDTH, date_str,
+           LCD1602A_TIME_WIDTH, expected_time, LCD1602A_FULL_DATE_WIDTH, expected_date);
+}
+
+/* The driver's formatter is static; this gives the timed loop the same call through a pointer as the reference */
+static void Table_Update_Buffer_Datetime(full_datetime_t datetime)
+{
+    LCD1602A_Update_Buffer_Datetime(datetime);
+}
+
+/*************** REFERENCE FORMATTER *****************/
+/* The driver's formatter before the digit and name tables. Its fixed-width strncpy copies are what is being
+ * measured, so they stay as they were rather than being rewritten around the truncation warning */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-truncation"
+static void Ref_Update_Buffer_Datetime(full_datetime_t datetime)
+{
+    Ref_Update_Buffer_Time(datetime.time);
+    Ref_Update_Buffer_Full_Date(datetime.date);
+}
+
+static void Ref_Update_Buffer_Seconds(seconds_t seconds)
+{
+    char seconds_str[3] = {0};
+    int_to_zero_padded_ascii(seconds_str, (uint8_t)seconds);
+    strncpy(ref_time_str_buffer + LCD1602A_SECS_OFFSET,
+            seconds_str,
+            2);
+}
+
+static void Ref_Update_Buffer_Minutes(minutes_t minutes)
+{
+    char minutes_str[3] = {0};
+    int_to_zero_padded_ascii(minutes_str, (uint8_t)minutes);
+    strncpy(ref_time_str_buffer + LCD1602A_MINS_OFFSET,
+            minutes_str,
+            2);
+}
+
+static void Ref_Update_Buffer_Hours(hours_t hours)
+{
+    char hours_str[3] = {0};
+    char hour_format[3] = "  ";
+
+    int_to_zero_padded_ascii(hours_str, (uint8_t)hours.hour);
+    strncpy(ref_time_str_buffer + LCD1602A_HRS_OFFSET,
+            hours_str,
+            2);
+
+    if (hours.hour_format == HOUR_FORMAT_12_HOUR)
+    {
+        if (hours.am_pm == AM_PM_AM)
+        {
+            strncpy(hour_format, "AM", sizeof(hour_format));
+        }
+        else
+        {
+            strncpy(hour_format, "PM", sizeof(hour_format));
+        }
+    }
+
+    strncpy(ref_time_str_buffer + LCD1602A_HR_FMT_OFFSET,
+            hour_format,
+            2);
+}
+
+static void Ref_Update_Buffer_Time(full_time_t full_time)
+{
+    Ref_Update_Buffer_Hours(full_time.hours);
+    Ref_Update_Buffer_Minutes(full_time.minutes);
+    Ref_Update_Buffer_Seconds(full_time.seconds);
+}
+
+static void Ref_Update_Buffer_Date(date_t date)
+{
+    char date_str[3] = {0};
+    int_to_zero_padded_ascii(date_str, (uint8_t)date);
+    strncpy(ref_date_str_buffer + LCD1602A_DATE_OFFSET,
+            date_str,
+            2);
+}
+
+static void Ref_Update_Buffer_Day_Of_Week(day_of_week_t dow)
+{
+    char dow_str[4] = {0};
+    switch (dow)
+    {
+    case DAY_OF_WEEK_SUN:
+        strncpy(dow_str, "Sun", 3);
+        break;
+    case DAY_OF_WEEK_MON:
+        strncpy(dow_str, "Mon", 3);
+        break;
+    case DAY_OF_WEEK_TUE:
+        strncpy(dow_str, "Tue", 3);
+        break;
+    case DAY_OF_WEEK_WED:
+        strncpy(dow_str, "Wed", 3);
+        break;
+    case DAY_OF_WEEK_THU:
+        strncpy(dow_str, "Thu", 3);
+        break;
+    case DAY_OF_WEEK_FRI:
+        strncpy(dow_str, "Fri", 3);
+        break;
+    case DAY_OF_WEEK_SAT:
+        strncpy(dow_str, "Sat", 3);
+        break;
+    }
+    strncpy(ref_date_str_buffer + LCD1602A_DOW_OFFSET,
+            dow_str,
+            3);
+}
+
+static void Ref_Update_Buffer_Month(month_t month)
+{
+    char month_str[3] = {0};
+    int_to_zero_padded_ascii(month_str, (uint8_t) month);
+    strncpy(ref_date_str_buffer + LCD1602A_MONTH_OFFSET,
+            month_str,
+            2);
+}
+
+static void Ref_Update_Buffer_Year(year_t year, century_t century)
+{
+    char year_str[5] = {0};
+    int_to_zero_padded_ascii(year_str + 2, (uint8_t)year);
+
+    if (century == CENTURY_20TH)
+    {
+        strncpy(year_str, "19", 2);
+    }
+    else
+    {
+        strncpy(year_str, "20", 2);
+    }
+
+    strncpy(ref_date_str_buffer + LCD1602A_YEAR_OFFSET,
+            year_str,
+            4);
+}
+
+static void Ref_Update_Buffer_Full_Date(full_date_t full_date)
+{
+    Ref_Update_Buffer_Date(full_date.date);
+    Ref_Update_Buffer_Day_Of_Week(full_date.day_of_week);
+    Ref_Update_Buffer_Month(full_date.month);
+    Ref_Update_Buffer_Year(full_date.year, full_date.century);
+}
+
+static char int_to_ascii_char(uint8_t int_to_covert)
+{
+    return int_to_covert + ASCII_DIGIT_OFFSET;
+}
+
+static void int_to_zero_padded_ascii(char *result, uint8_t int_to_convert)
+{
+    if (int_to_convert < 10)
+    {
+        result[0] = '0';
+        result[1] = int_to_ascii_char(int_to_convert);
+    }
+    else
+    {
+        result[0] = int_to_ascii_char(int_to_convert / 10);
+        result[1] = int_to_ascii_char(int_to_convert % 10);
+    }
+}
+#pragma GCC diagnostic pop
@@ -0,0 +1,425 @@
+#include <string.h>
+
+#include "hd44780_model.h"
+
+#define SIG(sig)                    HD44780_SIG_MASK(HD44780_SIG_##sig)
+#define HIGH_NYBBLE_SIG_MASK        (0xF0U << HD44780_SIG_DB0)
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void enable_rise(uint64_t now_ns);
+static void enable_fall(uint16_t bus, uint64_t now_ns);
+static void latch_write(uint16_t bus, uint64_t now_ns);
+static void finish_read(uint16_t bus);
+static void execute(uint8_t rs, uint8_t byte, uint64_t now_ns);
+static void write_ram(uint8_t byte);
+static void step_addr_counter(uint8_t increment);
+static void check_ready(uint64_t now_ns);
+static void note_done(uint64_t done_ns);
+static uint16_t data_sig_mask(void);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+static HD44780_Model_t model;
+
+void HD44780_Model_Init(const HD44780_Geometry_t *p_geometry, uint64_t now_ns)
+{
+    memset(&model, 0, sizeof(model));
+    model.geometry = *p_geometry;
+
+    /* State after the internal reset circuit: 8-bit bus, one line, display off, increment. DDRAM content is
+     * undefined at power on; blanks render more readably than noise. */
+    memset(model.ddram, ' ', sizeof(model.ddram));
+    model.increment = 1;
+    model.bus_8_bit = 1;
+    model.power_on_ns = now_ns;
+    model.busy_until_ns = now_ns;
+}
+
+/* levels holds the MCU's output level on every line, driven which of those lines it is driving at all.
+ * One call is one store to the port, so lines changing together change at the same instant. */
+void HD44780_Model_Drive(uint16_t levels, uint16_t driven, uint64_t now_ns)
+{
+    uint16_t prev = model.levels;
+    uint16_t changed = (levels ^ prev) & driven;
+    uint8_t e_rose = (changed & SIG(E)) && (levels & SIG(E));
+    uint8_t e_fell = (changed & SIG(E)) && !(levels & SIG(E));
+
+    model.levels = (prev & ~driven) | (levels & driven);
+    model.driven = driven;
+
+    /* A falling edge samples the lines as they were before this store */
+    if (e_fell)
+    {
+        enable_fall(prev, now_ns);
+    }
+
+    if (changed & HD44780_ADDR_SIG_MASK)
+    {
+        if ((prev & SIG(E)) ||
+            (model.e_seen && (now_ns - model.e_fall_ns) < HD44780_T_AH_NS))
+        {
+            model.violations.address_hold++;
+        }
+        model.addr_change_ns = now_ns;
+    }
+
+    if (changed & data_sig_mask())
+    {
+        if (!(model.levels & SIG(E)) && !(model.levels & SIG(RW)) &&
+            model.e_seen && (now_ns - model.e_fall_ns) < HD44780_T_H_NS)
+        {
+            model.violations.data_hold++;
+        }
+        model.data_change_ns = now_ns;
+    }
+
+    if (e_rose)
+    {
+        enable_rise(now_ns);
+    }
+}
+
+/* Returns the level on every line as the MCU would read it; during a read pulse the controller drives
+ * the data lines. */
+uint16_t HD44780_Model_Sample(uint64_t now_ns)
+{
+    uint16_t bus = model.levels;
+    uint16_t lines = data_sig_mask();
+    uint8_t out;
+
+    if ((bus & SIG(RW)) && (bus & SIG(E)))
+    {
+        if ((now_ns - model.e_rise_ns) < HD44780_T_DDR_NS)
+        {
+            model.violations.read_delay++;
+        }
+
+        if (model.bus_8_bit)
+            out = model.read_value;
+        else
+            out = model.read_low_next ? (uint8_t)(model.read_value << 4) : (model.read_value & 0xF0);
+
+        bus = (bus & ~lines) | (((uint16_t)out << HD44780_SIG_DB0) & lines);
+    }
+
+    return bus;
+}
+
+void HD44780_Model_Start_Frame(uint64_t now_ns)
+{
+    memset(&model.frame, 0, sizeof(model.frame));
+    model.frame.first_pulse_ns = now_ns;
+    model.frame.last_done_ns = now_ns;
+}
+
+const HD44780_Frame_Stats_t *HD44780_Model_Get_Frame_Stats(void)
+{
+    model.frame.bus_time_ns = model.frame.enable_pulses ? (model.frame.last_done_ns - model.frame.first_pulse_ns) : 0;
+    return &model.frame;
+}
+
+const HD44780_Violations_t *HD44780_Model_Get_Violations(void)
+{
+    return &model.violations;
+}
+
+uint32_t HD44780_Model_Count_Violations(void)
+{
+    const HD44780_Violations_t *p_v = &model.violations;
+
+    return p_v->power_on + p_v->address_setup + p_v->address_hold + p_v->pulse_width + p_v->cycle_time +
+           p_v->data_setup + p_v->data_hold + p_v->busy + p_v->read_delay + p_v->contention;
+}
+
+/* Character code shown at a visible cell, following the display shift */
+uint8_t HD44780_Model_Get_Cell(uint8_t row, uint8_t col)
+{
+    uint8_t base = model.geometry.row_base_addr[row];
+    uint8_t addr;
+
+    if (model.two_lines)
+        addr = (base & 0x40) | (((base & 0x3F) + col + model.display_shift) % HD44780_LINE_LEN);
+    else
+        addr = (base + col + model.display_shift) % (2 * HD44780_LINE_LEN);
+
+    return model.ddram[addr];
+}
+
+/* Draws the panel as text. CGRAM characters show as their slot number, the ROM middle dot and full block
+ * as '.' and '#', and anything else outside printable ASCII as '?'. */
+void HD44780_Model_Render(FILE *p_out)
+{
+    uint8_t ch;
+
+    for (uint8_t row = 0; row < model.geometry.num_rows; row++)
+    {
+        fputc('|', p_out);
+        for (uint8_t col = 0; col < model.geometry.num_cols; col++)
+        {
+            ch = HD44780_Model_Get_Cell(row, col);
+            if (ch < 8)
+                ch = '0' + ch;
+            else if (ch == 0xA5)
+                ch = '.';
+            else if (ch == 0xFF)
+                ch = '#';
+            else if (ch < 0x20 || ch > 0x7E)
+                ch = '?';
+            fputc(ch, p_out);
+        }
+        fputs("|\n", p_out);
+    }
+
+    if (!model.display_on)
+    {
+        fputs("(display off)\n", p_out);
+    }
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void enable_rise(uint64_t now_ns)
+{
+    uint16_t bus = model.levels;
+
+    if (model.e_seen && (now_ns - model.e_rise_ns) < HD44780_T_CYC_E_NS)
+    {
+        model.violations.cycle_time++;
+    }
+    if ((now_ns - model.addr_change_ns) < HD44780_T_AS_NS)
+    {
+        model.violations.address_setup++;
+    }
+
+    model.e_rise_ns = now_ns;
+    model.e_seen = 1;
+    if (model.frame.enable_pulses == 0)
+    {
+        model.frame.first_pulse_ns = now_ns;
+    }
+    model.frame.enable_pulses++;
+
+    if (!(bus & SIG(RW)))
+        return;
+
+    if (model.driven & data_sig_mask())
+    {
+        model.violations.contention++;
+    }
+
+    /* A 4-bit read outputs the high nybble first; the value is latched once for both pulses */
+    if (model.bus_8_bit || !model.read_low_next)
+    {
+        if (bus & SIG(RS))
+        {
+            model.read_value = model.addr_in_cgram ? model.cgram[model.addr_counter & (HD44780_CGRAM_SIZE - 1)]
+                                                   : model.ddram[model.addr_counter];
+        }
+        else
+        {
+            model.read_value = ((now_ns < model.busy_until_ns) ? 0x80 : 0) | (model.addr_counter & 0x7F);
+        }
+    }
+}
+
+static void enable_fall(uint16_t bus, uint64_t now_ns)
+{
+    if ((now_ns - model.e_rise_ns) < HD44780_PW_EH_NS)
+    {
+        model.violations.pulse_width++;
+    }
+    model.e_fall_ns = now_ns;
+    note_done(now_ns);
+
+    if (bus & SIG(RW))
+        finish_read(bus);
+    else
+        latch_write(bus, now_ns);
+}
+
+static void latch_write(uint16_t bus, uint64_t now_ns)
+{
+    uint8_t data = (uint8_t)(bus >> HD44780_SIG_DB0);
+
+    if ((now_ns - model.data_change_ns) < HD44780_T_DSW_NS)
+    {
+        model.violations.data_setup++;
+    }
+
+    if (model.bus_8_bit)
+    {
+        check_ready(now_ns);
+        execute((bus & SIG(RS)) != 0, data, now_ns);
+        return;
+    }
+
+    /* 4-bit bus: DB4-DB7 carry the high nybble, then the low nybble */
+    if (!model.nybble_pending)
+    {
+        check_ready(now_ns);
+        model.high_nybble = data & 0xF0;
+        model.nybble_pending = 1;
+        return;
+    }
+    model.nybble_pending = 0;
+    execute((bus & SIG(RS)) != 0, model.high_nybble | (data >> 4), now_ns);
+}
+
+static void finish_read(uint16_t bus)
+{
+    if (!model.bus_8_bit && !model.read_low_next)
+    {
+        model.read_low_next = 1;
+        return;
+    }
+    model.read_low_next = 0;
+    model.frame.bytes_read++;
+
+    if (bus & SIG(RS))
+    {
+        step_addr_counter(model.increment);
+    }
+}
+
+static void execute(uint8_t rs, uint8_t byte, uint64_t now_ns)
+{
+    uint64_t exec_ns = HD44780_EXEC_NS;
+
+    model.frame.bytes_written++;
+
+    if (rs)
+    {
+        write_ram(byte);
+    }
+    else if (byte & 0x80)
+    {
+        model.addr_in_cgram = 0;
+        model.addr_counter = byte & 0x7F;
+    }
+    else if (byte & 0x40)
+    {
+        model.addr_in_cgram = 1;
+        model.addr_counter = byte & 0x3F;
+    }
+    else if (byte & 0x20)
+    {
+        /* The reset sequence's first two function sets take far longer than the datasheet exec time */
+        if (model.function_sets == 0)
+            exec_ns = HD44780_INIT_FIRST_NS;
+        else if (model.function_sets == 1)
+            exec_ns = HD44780_INIT_SECOND_NS;
+        if (model.function_sets < 2)
+            model.function_sets++;
+
+        model.bus_8_bit = (byte >> 4) & 1;
+        model.two_lines = (byte >> 3) & 1;
+        model.nybble_pending = 0;
+    }
+    else if (byte & 0x10)
+    {
+        if (byte & 0x08)
+        {
+            /* Shifting the display left brings the next cell of each line into view */
+            model.display_shift = (model.display_shift + ((byte & 0x04) ? HD44780_LINE_LEN - 1 : 1)) % HD44780_LINE_LEN;
+        }
+        else
+        {
+            step_addr_counter((byte >> 2) & 1);
+        }
+    }
+    else if (byte & 0x08)
+    {
+        model.display_on = (byte >> 2) & 1;
+        model.cursor_on = (byte >> 1) & 1;
+        model.blink_on = byte & 1;
+    }
+    else if (byte & 0x04)
+    {
+        model.increment = (byte >> 1) & 1;
+        model.entry_shift = byte & 1;
+    }
+    else if (byte & 0x02)
+    {
+        model.addr_in_cgram = 0;
+        model.addr_counter = 0;
+        model.display_shift = 0;
+        exec_ns = HD44780_EXEC_LONG_NS;
+    }
+    else if (byte & 0x01)
+    {
+        memset(model.ddram, ' ', sizeof(model.ddram));
+        model.addr_in_cgram = 0;
+        model.addr_counter = 0;
+        model.display_shift = 0;
+        model.increment = 1;
+        exec_ns = HD44780_EXEC_LONG_NS;
+    }
+
+    model.busy_until_ns = now_ns + exec_ns;
+    note_done(model.busy_until_ns);
+}
+
+static void write_ram(uint8_t byte)
+{
+    if (model.addr_in_cgram)
+    {
+        model.cgram[model.addr_counter & (HD44780_CGRAM_SIZE - 1)] = byte;
+    }
+    else
+    {
+        model.ddram[model.addr_counter] = byte;
+        if (model.entry_shift)
+        {
+            model.display_shift = (model.display_shift + (model.increment ? 1 : HD44780_LINE_LEN - 1)) % HD44780_LINE_LEN;
+        }
+    }
+    step_addr_counter(model.increment);
+}
+
+/* Moves the address counter one cell. In two-line mode DDRAM is 0x00-0x27 and 0x40-0x67, and the counter
+ * runs from the end of one line into the start of the other. */
+static void step_addr_counter(uint8_t increment)
+{
+    uint8_t ac = model.addr_counter;
+
+    if (model.addr_in_cgram)
+    {
+        model.addr_counter = (ac + (increment ? 1 : -1)) & (HD44780_CGRAM_SIZE - 1);
+        return;
+    }
+
+    if (!model.two_lines)
+    {
+        model.addr_counter = (ac + (increment ? 1 : 2 * HD44780_LINE_LEN - 1)) % (2 * HD44780_LINE_LEN);
+        return;
+    }
+
+    if (increment)
+        model.addr_counter = (ac == 0x27) ? 0x40 : (ac == 0x67) ? 0x00 : ac + 1;
+    else
+        model.addr_counter = (ac == 0x40) ? 0x27 : (ac == 0x00) ? 0x67 : ac - 1;
+}
+
+static void check_ready(uint64_t now_ns)
+{
+    if ((now_ns - model.power_on_ns) < HD44780_POWER_ON_NS)
+    {
+        model.violations.power_on++;
+    }
+    else if (now_ns < model.busy_until_ns)
+    {
+        model.violations.busy++;
+    }
+}
+
+static void note_done(uint64_t done_ns)
+{
+    if (done_ns > model.frame.last_done_ns)
+    {
+        model.frame.last_done_ns = done_ns;
+    }
+}
+
+/* Only DB4-DB7 are looked at on the 4-bit bus */
+static uint16_t data_sig_mask(void)
+{
+    return model.bus_8_bit ? HD44780_DATA_SIG_MASK : HIGH_NYBBLE_SIG_MASK;
+}
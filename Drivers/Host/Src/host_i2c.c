@@ -0,0 +1,381 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "host_i2c.h"
+#include "host_port.h"
+#include "stm32f407xx.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void Host_I2C_Initialize(I2C_Instance_t instance);
+static I2C_Status_t Host_I2C_Master_Send(I2C_Instance_t instance, uint8_t *p_tx_buffer, uint32_t len,
+                                         uint8_t slave_addr, uint8_t repeat_start);
+static I2C_Status_t Host_I2C_Master_Receive(I2C_Instance_t instance, uint8_t *p_rx_buffer, uint32_t len,
+                                            uint8_t slave_addr, uint8_t repeat_start);
+static void Host_I2C_Queue_Call(I2C_Instance_t instance, uint8_t *p_tx_buffer, uint32_t tx_len, uint32_t rx_len,
+                                uint8_t slave_addr, uint8_t repeat_start);
+static uint8_t Host_I2C_Queue_Transaction(I2C_Instance_t instance, const I2C_Transaction_t *p_txn);
+static void Host_I2C_Set_Speed(I2C_Instance_t instance, uint32_t clock_speed);
+static uint8_t Host_I2C_Run_Next(I2C_Instance_t instance);
+static I2C_Status_t Host_I2C_Run_Write(I2C_Instance_t instance, const I2C_Transaction_t *p_txn);
+static I2C_Status_t Host_I2C_Run_Read(I2C_Instance_t instance, const I2C_Transaction_t *p_txn);
+static void Host_I2C_Wait_For_Idle(I2C_Instance_t instance);
+static void Host_I2C_Write_Done(void *p_context, I2C_Status_t status);
+static void Host_I2C_Read_Done(void *p_context, I2C_Status_t status);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+static I2C_Bus_t buses[I2C_NUM_INSTANCES];
+static I2C_Device_t i2c_devs[I2C_NUM_INSTANCES];
+static uint8_t tx_ring_storage[I2C_NUM_INSTANCES][TX_RING_BUFFER_SIZE];
+static uint8_t rx_ring_storage[I2C_NUM_INSTANCES][RX_RING_BUFFER_SIZE];
+
+/* Same shape as the target driver's table: one set of wrappers per instance around shared implementations */
+#define HOST_I2C_DEFINE_INTERFACE(n)                                                                            \
+    static I2C_Status_t I2C##n##_Init(void)                                                                     \
+    {                                                                                                           \
+        Host_I2C_Initialize(I2C_INSTANCE_##n);                                                                  \
+        return I2C_OK;                                                                                          \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Master_Send(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,            \
+                                             uint8_t repeat_start)                                              \
+    {                                                                                                           \
+        return Host_I2C_Master_Send(I2C_INSTANCE_##n, p_tx_buffer, len, slave_addr, repeat_start);              \
+    }                                                                                                           \
+    static void I2C##n##_Master_Send_IT(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,                 \
+                                        uint8_t repeat_start)                                                   \
+    {                                                                                                           \
+        Host_I2C_Queue_Call(I2C_INSTANCE_##n, p_tx_buffer, len, 0, slave_addr, repeat_start);                   \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Master_Receive(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr,         \
+                                                uint8_t repeat_start)                                           \
+    {                                                                                                           \
+        return Host_I2C_Master_Receive(I2C_INSTANCE_##n, p_rx_buffer, len, slave_addr, repeat_start);           \
+    }                                                                                                           \
+    static void I2C##n##_Master_Receive_IT(uint32_t len, uint8_t slave_addr, uint8_t repeat_start)              \
+    {                                                                                                           \
+        Host_I2C_Queue_Call(I2C_INSTANCE_##n, NULL, 0, len, slave_addr, repeat_start);                          \
+    }                                                                                                           \
+    static void I2C##n##_Master_Send_DMA(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,                \
+                                         uint8_t repeat_start)                                                  \
+    {                                                                                                           \
+        I2C_Transaction_t txn = {                                                                               \
+                .slave_addr = slave_addr, .p_tx_buffer = p_tx_buffer, .tx_len = len,                            \
+                .repeat_start = repeat_start, .p_callback = Host_I2C_Write_Done,                                \
+                .p_context = &i2c_devs[I2C_INSTANCE_##n],                                                       \
+        };                                                                                                      \
+        if (!Host_I2C_Queue_Transaction(I2C_INSTANCE_##n, &txn))                                                \
+            txn.p_callback(txn.p_context, I2C_ERR_BUSY);                                                        \
+    }                                                                                                           \
+    static void I2C##n##_Master_Receive_DMA(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr,             \
+                                            uint8_t repeat_start)                                               \
+    {                                                                                                           \
+        I2C_Transaction_t txn = {                                                                               \
+                .slave_addr = slave_addr, .p_rx_buffer = p_rx_buffer, .rx_len = len,                            \
+                .repeat_start = repeat_start, .p_callback = Host_I2C_Read_Done,                                 \
+                .p_context = &i2c_devs[I2C_INSTANCE_##n],                                                       \
+        };                                                                                                      \
+        if (!Host_I2C_Queue_Transaction(I2C_INSTANCE_##n, &txn))                                                \
+            txn.p_callback(txn.p_context, I2C_ERR_BUSY);                                                        \
+    }                                                                                                           \
+    static void I2C##n##_Master_Write_Read_IT(uint8_t *p_tx_buffer, uint32_t tx_len, uint32_t rx_len,           \
+                                              uint8_t slave_addr)                                               \
+    {                                                                                                           \
+        Host_I2C_Queue_Call(I2C_INSTANCE_##n, p_tx_buffer, tx_len, rx_len, slave_addr, I2C_DISABLE_SR);         \
+    }                                                                                                           \
+    static uint8_t I2C##n##_Queue_Transaction(const I2C_Transaction_t *p_txn)                                   \
+    {                                                                                                           \
+        return Host_I2C_Queue_Transaction(I2C_INSTANCE_##n, p_txn);                                             \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Set_Speed(uint32_t clock_speed, uint8_t fm_duty_cycle)                         \
+    {                                                                                                           \
+        Host_I2C_Set_Speed(I2C_INSTANCE_##n, clock_speed);                                                      \
+        return I2C_OK;                                                                                          \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Clock_Changed(void)                                                            \
+    {                                                                                                           \
+        return I2C_OK;                                                                                          \
+    }                                                                                                           \
+    static void I2C##n##_Check_Timeout(void)                                                                    \
+    {                                                                                                           \
+        Host_I2C_Run_Next(I2C_INSTANCE_##n);                                                                    \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Recover_Bus(void)                                                              \
+    {                                                                                                           \
+        I2C_Bus_Stop(&buses[I2C_INSTANCE_##n]);                                                                 \
+        return I2C_OK;                                                                                          \
+    }                                                                                                           \
+    static void I2C##n##_Get_Stats(I2C_Stats_t *p_stats)                                                        \
+    {                                                                                                           \
+        *p_stats = i2c_devs[I2C_INSTANCE_##n].stats;                                                            \
+    }                                                                                                           \
+    static void I2C##n##_Reset_Stats(void)                                                                      \
+    {                                                                                                           \
+        memset(&i2c_devs[I2C_INSTANCE_##n].stats, 0, sizeof(I2C_Stats_t));                                      \
+    }                                                                                                           \
+    static void I2C##n##_DeInit(void)                                                                           \
+    {                                                                                                           \
+        Host_I2C_Wait_For_Idle(I2C_INSTANCE_##n);                                                               \
+    }                                                                                                           \
+    static I2C_Interface_t i2c##n##_driver = {                                                                  \
+            .Initialize             = I2C##n##_Init,                                                            \
+            .Write_Bytes            = I2C##n##_Master_Send,                                                     \
+            .Write_Bytes_IT         = I2C##n##_Master_Send_IT,                                                  \
+            .Read_Bytes             = I2C##n##_Master_Receive,                                                  \
+            .Read_Bytes_IT          = I2C##n##_Master_Receive_IT,                                               \
+            .Write_Bytes_DMA        = I2C##n##_Master_Send_DMA,                                                 \
+            .Read_Bytes_DMA         = I2C##n##_Master_Receive_DMA,                                              \
+            .Write_Read_IT          = I2C##n##_Master_Write_Read_IT,                                            \
+            .Queue_Transaction      = I2C##n##_Queue_Transaction,                                               \
+            .Set_Speed              = I2C##n##_Set_Speed,                                                       \
+            .Clock_Changed          = I2C##n##_Clock_Changed,                                                   \
+            .Check_Timeout          = I2C##n##_Check_Timeout,                                                   \
+            .Recover_Bus            = I2C##n##_Recover_Bus,                                                     \
+            .Get_Stats              = I2C##n##_Get_Stats,                                                       \
+            .Reset_Stats            = I2C##n##_Reset_Stats,                                                     \
+            .Deinitialize           = I2C##n##_DeInit,                                                          \
+    };
+
+HOST_I2C_DEFINE_INTERFACE(1)
+HOST_I2C_DEFINE_INTERFACE(2)
+HOST_I2C_DEFINE_INTERFACE(3)
+
+I2C_Interface_t *get_i2c_interface(I2C_Instance_t instance)
+{
+    switch (instance)
+    {
+    case I2C_INSTANCE_1:
+        return &i2c1_driver;
+    case I2C_INSTANCE_2:
+        return &i2c2_driver;
+    case I2C_INSTANCE_3:
+        return &i2c3_driver;
+    default:
+        return NULL;
+    }
+}
+
+/* Brings every bus up empty at standard mode. Slaves are attached afterwards, before the driver under test
+ * initializes its interface. */
+void Host_I2C_Init(void)
+{
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        I2C_Bus_Init(&buses[i], I2C_SPEED_SM);
+        Host_I2C_Initialize(i);
+    }
+}
+
+I2C_Bus_t *Host_I2C_Get_Bus(I2C_Instance_t instance)
+{
+    return &buses[instance];
+}
+
+uint8_t Host_Step_I2C(void)
+{
+    uint8_t ran = 0;
+
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        ran |= Host_I2C_Run_Next(i);
+    }
+    return ran;
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void Host_I2C_Initialize(I2C_Instance_t instance)
+{
+    I2C_Device_t *p_dev = &i2c_devs[instance];
+
+    memset(p_dev, 0, sizeof(*p_dev));
+    p_dev->instance = instance;
+    p_dev->clock_speed = buses[instance].clock_speed;
+    p_dev->ack_ctrl = I2C_ACK_EN;
+    p_dev->control_stage = I2C_CTRL_IDLE;
+    Ring_Buffer_Init(&p_dev->tx_ring, tx_ring_storage[instance], TX_RING_BUFFER_SIZE);
+    Ring_Buffer_Init(&p_dev->rx_ring, rx_ring_storage[instance], RX_RING_BUFFER_SIZE);
+}
+
+/* The blocking calls go out behind whatever is queued, as on the target */
+static I2C_Status_t Host_I2C_Master_Send(I2C_Instance_t instance, uint8_t *p_tx_buffer, uint32_t len,
+                                         uint8_t slave_addr, uint8_t repeat_start)
+{
+    I2C_Status_t status;
+
+    Host_I2C_Wait_For_Idle(instance);
+    status = I2C_Bus_Write(&buses[instance], slave_addr, p_tx_buffer, len, repeat_start == I2C_DISABLE_SR);
+    I2C_Stats_Record_Blocking(&i2c_devs[instance].stats, status);
+    return status;
+}
+
+static I2C_Status_t Host_I2C_Master_Receive(I2C_Instance_t instance, uint8_t *p_rx_buffer, uint32_t len,
+                                            uint8_t slave_addr, uint8_t repeat_start)
+{
+    I2C_Status_t status;
+
+    Host_I2C_Wait_For_Idle(instance);
+    status = I2C_Bus_Read(&buses[instance], slave_addr, p_rx_buffer, len, repeat_start == I2C_DISABLE_SR);
+    I2C_Stats_Record_Blocking(&i2c_devs[instance].stats, status);
+    return status;
+}
+
+/* The ring-based _IT calls. Bytes to write are copied into the TX ring only once the transaction has a place
+ * in the queue, and received bytes go to the RX ring. */
+static void Host_I2C_Queue_Call(I2C_Instance_t instance, uint8_t *p_tx_buffer, uint32_t tx_len, uint32_t rx_len,
+                                uint8_t slave_addr, uint8_t repeat_start)
+{
+    I2C_Device_t *p_dev = &i2c_devs[instance];
+    I2C_Transaction_t txn = {
+            .slave_addr = slave_addr,
+            .p_tx_buffer = NULL,
+            .tx_len = tx_len,
+            .p_rx_buffer = NULL,
+            .rx_len = rx_len,
+            .repeat_start = repeat_start,
+            .p_callback = (rx_len > 0) ? Host_I2C_Read_Done : Host_I2C_Write_Done,
+            .p_context = p_dev,
+    };
+
+    /* Refused the way the target driver refuses it, at once and in the caller's context */
+    if (p_dev->txn_queue_count == I2C_QUEUE_SIZE
+            || (tx_len > 0 && !Ring_Buffer_Write(&p_dev->tx_ring, p_tx_buffer, tx_len))
+            || !Host_I2C_Queue_Transaction(instance, &txn))
+    {
+        txn.p_callback(txn.p_context, I2C_ERR_BUSY);
+    }
+}
+
+static uint8_t Host_I2C_Queue_Transaction(I2C_Instance_t instance, const I2C_Transaction_t *p_txn)
+{
+    I2C_Device_t *p_dev = &i2c_devs[instance];
+
+    if (p_dev->txn_queue_count == I2C_QUEUE_SIZE || (p_txn->tx_len == 0 && p_txn->rx_len == 0))
+        return 0;
+
+    p_dev->txn_queue[(p_dev->txn_queue_head + p_dev->txn_queue_count) % I2C_QUEUE_SIZE] = *p_txn;
+    p_dev->txn_queue_count++;
+    return 1;
+}
+
+static void Host_I2C_Set_Speed(I2C_Instance_t instance, uint32_t clock_speed)
+{
+    if (clock_speed == 0)
+        clock_speed = I2C_SPEED_SM;
+    else if (clock_speed > I2C_SPEED_FM)
+        clock_speed = I2C_SPEED_FM;
+
+    Host_I2C_Wait_For_Idle(instance);
+    i2c_devs[instance].clock_speed = clock_speed;
+    I2C_Bus_Set_Speed(&buses[instance], clock_speed);
+}
+
+/* Takes the head of the queue through both of its phases and retires it, making the callback the event
+ * interrupt would have made. Returns 0 if the queue was empty. */
+static uint8_t Host_I2C_Run_Next(I2C_Instance_t instance)
+{
+    I2C_Device_t *p_dev = &i2c_devs[instance];
+    I2C_Transaction_t txn;
+    I2C_Status_t status = I2C_OK;
+    uint64_t start_ns = Host_Now_Ns();
+
+    if (p_dev->txn_queue_count == 0)
+        return 0;
+
+    txn = p_dev->txn_queue[p_dev->txn_queue_head];
+
+    if (txn.tx_len > 0)
+    {
+        p_dev->control_stage = (txn.p_tx_buffer != NULL) ? I2C_CTRL_BUSY_TX_DMA : I2C_CTRL_BUSY_TX;
+        status = Host_I2C_Run_Write(instance, &txn);
+    }
+    if (status == I2C_OK && txn.rx_len > 0)
+    {
+        p_dev->control_stage = (txn.p_rx_buffer != NULL) ? I2C_CTRL_BUSY_RX_DMA : I2C_CTRL_BUSY_RX;
+        status = Host_I2C_Run_Read(instance, &txn);
+    }
+
+    /* There are no interrupts to count; the latency is the bus time */
+    I2C_Stats_Record(&p_dev->stats, &txn, status, (uint32_t)((Host_Now_Ns() - start_ns) / 1000u));
+
+    p_dev->txn_queue_head = (p_dev->txn_queue_head + 1) % I2C_QUEUE_SIZE;
+    p_dev->txn_queue_count--;
+    p_dev->control_stage = I2C_CTRL_IDLE;
+
+    if (txn.p_callback != NULL)
+        txn.p_callback(txn.p_context, status);
+
+    return 1;
+}
+
+/* A ring-based write takes its bytes out of the TX ring whether or not the slave ACKs them all, as an aborted
+ * one does on the target */
+static I2C_Status_t Host_I2C_Run_Write(I2C_Instance_t instance, const I2C_Transaction_t *p_txn)
+{
+    uint8_t stop = (p_txn->rx_len == 0 && p_txn->repeat_start == I2C_DISABLE_SR);
+    uint8_t ring_bytes[TX_RING_BUFFER_SIZE];
+
+    if (p_txn->p_tx_buffer != NULL)
+        return I2C_Bus_Write(&buses[instance], p_txn->slave_addr, p_txn->p_tx_buffer, p_txn->tx_len, stop);
+
+    Ring_Buffer_Read(&i2c_devs[instance].tx_ring, ring_bytes, p_txn->tx_len);
+    return I2C_Bus_Write(&buses[instance], p_txn->slave_addr, ring_bytes, p_txn->tx_len, stop);
+}
+
+static I2C_Status_t Host_I2C_Run_Read(I2C_Instance_t instance, const I2C_Transaction_t *p_txn)
+{
+    uint8_t stop = (p_txn->repeat_start == I2C_DISABLE_SR);
+    uint8_t ring_bytes[RX_RING_BUFFER_SIZE];
+    I2C_Status_t status;
+
+    if (p_txn->p_rx_buffer != NULL)
+        return I2C_Bus_Read(&buses[instance], p_txn->slave_addr, p_txn->p_rx_buffer, p_txn->rx_len, stop);
+
+    if (p_txn->rx_len > Ring_Buffer_Space(&i2c_devs[instance].rx_ring))
+    {
+        I2C_Bus_Stop(&buses[instance]);
+        return I2C_ERR_OVERRUN;
+    }
+
+    status = I2C_Bus_Read(&buses[instance], p_txn->slave_addr, ring_bytes, p_txn->rx_len, stop);
+    if (status == I2C_OK)
+        Ring_Buffer_Write(&i2c_devs[instance].rx_ring, ring_bytes, p_txn->rx_len);
+    return status;
+}
+
+static void Host_I2C_Wait_For_Idle(I2C_Instance_t instance)
+{
+    while (Host_I2C_Run_Next(instance));
+}
+
+static void Host_I2C_Write_Done(void *p_context, I2C_Status_t status)
+{
+    I2C_Device_t *p_dev = (I2C_Device_t *) p_context;
+
+    if (status == I2C_OK)
+        I2C_Write_Complete_Callback(p_dev);
+    else
+        I2C_Error_Callback(p_dev, status);
+}
+
+static void Host_I2C_Read_Done(void *p_context, I2C_Status_t status)
+{
+    I2C_Device_t *p_dev = (I2C_Device_t *) p_context;
+
+    if (status == I2C_OK)
+        I2C_Read_Complete_Callback(p_dev);
+    else
+        I2C_Error_Callback(p_dev, status);
+}
+
+__weak void I2C_Write_Complete_Callback(I2C_Device_t *p_i2c_dev)
+{
+    /* implemented at the driver level */
+}
+
+__weak void I2C_Read_Complete_Callback(I2C_Device_t *p_i2c_dev)
+{
+    /* implemented at the driver level */
+}
+
+__weak void I2C_Error_Callback(I2C_Device_t *p_i2c_dev, I2C_Status_t status)
+{
+    /* implemented at the driver level */
+}
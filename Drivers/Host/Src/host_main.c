@@ -0,0 +1,118 @@
+#include <stdio.h>
+
+#include "display.h"
+#include "host_port.h"
+#include "hd44780_model.h"
+
+/* Runs the display driver through a clock's worth of updates against the HD44780 model, printing the panel
+ * and the bus cost of every frame. Exits non-zero if any transfer broke the datasheet timing, so the run
+ * doubles as a regression check for the display path. */
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void Host_Begin_Frame(void);
+static void Host_End_Frame(const char *name);
+static void Host_Print_Violations(void);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+static Display_Device_t display_dev;
+
+int main(void)
+{
+    Display_Driver_t *p_display = get_display_driver();
+    full_datetime_t datetime = {
+            .time = {
+                    .hours = { .hour = 10, .hour_format = HOUR_FORMAT_12_HOUR, .am_pm = AM_PM_PM },
+                    .minutes = 59,
+                    .seconds = 58,
+            },
+            .date = {
+                    .day_of_week = DAY_OF_WEEK_SAT,
+                    .date = 17,
+                    .month = 10,
+                    .year = 26,
+                    .century = CENTURY_21ST,
+            },
+    };
+
+    Host_Init();
+
+    Host_Begin_Frame();
+    p_display->Display_Initialize(&display_dev);
+    Host_End_Frame("Display_Initialize");
+
+    Host_Begin_Frame();
+    p_display->Display_Update_Datetime(datetime);
+    Host_End_Frame("Display_Update_Datetime");
+
+    datetime.time.seconds = 59;
+    Host_Begin_Frame();
+    p_display->Display_Update_Seconds(datetime.time.seconds);
+    Host_End_Frame("Display_Update_Seconds");
+
+    datetime.time.hours.hour = 11;
+    datetime.time.minutes = 0;
+    datetime.time.seconds = 0;
+    Host_Begin_Frame();
+    p_display->Display_Update_Time_IT(datetime.time);
+    Host_End_Frame("Display_Update_Time_IT");
+
+    datetime.time.seconds = 1;
+    Host_Begin_Frame();
+    p_display->Display_Update_Seconds_IT(datetime.time.seconds);
+    Host_End_Frame("Display_Update_Seconds_IT");
+
+    Host_Begin_Frame();
+    p_display->Display_Update_Big_Time(datetime.time);
+    Host_End_Frame("Display_Update_Big_Time");
+
+    Host_Begin_Frame();
+    p_display->Display_Clear();
+    Host_End_Frame("Display_Clear");
+
+    datetime.date.day_of_week = DAY_OF_WEEK_SUN;
+    datetime.date.date = 18;
+    Host_Begin_Frame();
+    p_display->Display_Update_Datetime_IT(datetime);
+    Host_End_Frame("Display_Update_Datetime_IT");
+
+    Host_Print_Violations();
+    return HD44780_Model_Count_Violations() ? 1 : 0;
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void Host_Begin_Frame(void)
+{
+    HD44780_Model_Start_Frame(Host_Now_Ns());
+}
+
+/* Lets an _IT update run to completion, then reports the frame */
+static void Host_End_Frame(const char *name)
+{
+    const HD44780_Frame_Stats_t *p_stats;
+
+    while (display_dev.ctrl_stage == DISPLAY_CTRL_UPDATING && Host_Step_Timers())
+    {
+    }
+
+    p_stats = HD44780_Model_Get_Frame_Stats();
+    printf("%-28s %4u bytes %4u reads %5u pulses %10.1f us\n",
+           name,
+           (unsigned)p_stats->bytes_written,
+           (unsigned)p_stats->bytes_read,
+           (unsigned)p_stats->enable_pulses,
+           p_stats->bus_time_ns / 1000.0);
+    HD44780_Model_Render(stdout);
+}
+
+static void Host_Print_Violations(void)
+{
+    const HD44780_Violations_t *p_v = HD44780_Model_Get_Violations();
+
+    printf("timing violations: %u\n", (unsigned)HD44780_Model_Count_Violations());
+    printf("  power on %u, address setup %u, address hold %u, pulse width %u, cycle time %u\n",
+           (unsigned)p_v->power_on, (unsigned)p_v->address_setup, (unsigned)p_v->address_hold,
+           (unsigned)p_v->pulse_width, (unsigned)p_v->cycle_time);
+    printf("  data setup %u, data hold %u, busy %u, read delay %u, contention %u\n",
+           (unsigned)p_v->data_setup, (unsigned)p_v->data_hold, (unsigned)p_v->busy,
+           (unsigned)p_v->read_delay, (unsigned)p_v->contention);
+}
@@ -0,0 +1,362 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "host_port.h"
+#include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_tim_driver.h"
+#include "lcd1602a_display_driver.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static uint8_t Host_Get_Port_Index(GPIO_Register_Map_t *p_gpio_x);
+static int8_t Host_Get_Timer_Index(TIM_Register_Map_t *p_tim_x);
+static void Host_Set_Mode(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t mode);
+static void Host_Drive_Lcd_Pins(void);
+static int8_t Host_Find_Lcd_Signal(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num);
+static Host_Input_Source_t *Host_Find_Input_Source(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+static const Host_Lcd_Pin_t LCD_PINS[] = {
+        { HD44780_SIG_RS,   RS_GPIO_PORT,   RS_GPIO_PIN },
+        { HD44780_SIG_E,    E_GPIO_PORT,    E_GPIO_PIN },
+#ifdef LCD1602A_RW_WIRED
+        { HD44780_SIG_RW,   RW_GPIO_PORT,   RW_GPIO_PIN },
+#endif
+#ifdef LCD1602A_8_BIT_BUS
+        { HD44780_SIG_DB0,  DB0_GPIO_PORT,  DB0_GPIO_PIN },
+        { HD44780_SIG_DB1,  DB1_GPIO_PORT,  DB1_GPIO_PIN },
+        { HD44780_SIG_DB2,  DB2_GPIO_PORT,  DB2_GPIO_PIN },
+        { HD44780_SIG_DB3,  DB3_GPIO_PORT,  DB3_GPIO_PIN },
+#endif
+        { HD44780_SIG_DB4,  DB4_GPIO_PORT,  DB4_GPIO_PIN },
+        { HD44780_SIG_DB5,  DB5_GPIO_PORT,  DB5_GPIO_PIN },
+        { HD44780_SIG_DB6,  DB6_GPIO_PORT,  DB6_GPIO_PIN },
+        { HD44780_SIG_DB7,  DB7_GPIO_PORT,  DB7_GPIO_PIN },
+};
+#define NUM_LCD_PINS    (sizeof(LCD_PINS) / sizeof(LCD_PINS[0]))
+
+static const HD44780_Geometry_t PANEL_GEOMETRY = {
+        .num_rows = LCD1602A_NUM_ROWS,
+        .num_cols = LCD1602A_NUM_COLS,
+        .row_base_addr = LCD1602A_ROW_BASE_ADDRS,
+};
+
+static uint64_t now_ns;
+static uint16_t port_odr[HOST_NUM_GPIO_PORTS];
+static uint16_t port_output[HOST_NUM_GPIO_PORTS];      /* pins configured as outputs */
+static Host_Timer_t timers[HOST_NUM_TIMERS];
+static Host_Input_Source_t input_sources[HOST_NUM_INPUT_SOURCES];
+
+/* Powers the model up at virtual time 0 with every GPIO an input */
+void Host_Init(void)
+{
+    now_ns = 0;
+    memset(port_odr, 0, sizeof(port_odr));
+    memset(port_output, 0, sizeof(port_output));
+    memset(timers, 0, sizeof(timers));
+    memset(input_sources, 0, sizeof(input_sources));
+    HD44780_Model_Init(&PANEL_GEOMETRY, now_ns);
+    Host_Drive_Lcd_Pins();
+}
+
+uint64_t Host_Now_Ns(void)
+{
+    return now_ns;
+}
+
+void Host_Advance_Ns(uint64_t ns)
+{
+    now_ns += ns;
+}
+
+/* Jumps the clock to the next update event of any running timer and raises it. Returns 0 once no timer is
+ * running, so a caller can pump an _IT update to completion. */
+void Host_Set_Input_Source(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t (*p_level)(void))
+{
+    Host_Input_Source_t *p_source = Host_Find_Input_Source(p_gpio_x, pin_num);
+
+    for (uint8_t i = 0; i < HOST_NUM_INPUT_SOURCES && p_source == NULL; i++)
+    {
+        if (input_sources[i].p_level == NULL)
+            p_source = &input_sources[i];
+    }
+    if (p_source == NULL)
+        return;
+    p_source->p_gpio_x = p_gpio_x;
+    p_source->pin_num = pin_num;
+    p_source->p_level = p_level;
+}
+
+uint8_t Host_Step_Timers(void)
+{
+    Host_Timer_t *p_next = NULL;
+
+    for (uint8_t i = 0; i < HOST_NUM_TIMERS; i++)
+    {
+        if (timers[i].running && (p_next == NULL || timers[i].next_update_ns < p_next->next_update_ns))
+        {
+            p_next = &timers[i];
+        }
+    }
+
+    if (p_next == NULL)
+        return 0;
+
+    if (p_next->next_update_ns > now_ns)
+    {
+        now_ns = p_next->next_update_ns;
+    }
+    p_next->next_update_ns += p_next->period_ns;
+
+    if (p_next->p_tim_handle->p_update_callback != NULL)
+        p_next->p_tim_handle->p_update_callback();
+
+    return 1;
+}
+
+/*************** GPIO DRIVER *****************/
+void GPIO_Init(GPIO_Handle_t *p_gpio_handle)
+{
+    Host_Set_Mode(p_gpio_handle->p_gpio_x,
+                  p_gpio_handle->gpio_pin_config.gpio_pin_num,
+                  p_gpio_handle->gpio_pin_config.gpio_pin_mode);
+}
+
+void GPIO_Set_Pin_Mode(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t mode)
+{
+    Host_Set_Mode(p_gpio_x, pin_num, mode);
+}
+
+uint8_t GPIO_Read_From_Input_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num)
+{
+    int8_t signal = Host_Find_Lcd_Signal(p_gpio_x, pin_num);
+    Host_Input_Source_t *p_source = Host_Find_Input_Source(p_gpio_x, pin_num);
+    uint8_t value;
+
+    if (signal >= 0)
+        value = (HD44780_Model_Sample(now_ns) >> signal) & 1;
+    else if (p_source != NULL)
+        value = p_source->p_level() & 1;
+    else
+        value = (port_odr[Host_Get_Port_Index(p_gpio_x)] >> pin_num) & 1;
+
+    now_ns += HOST_GPIO_ACCESS_NS;
+    return value;
+}
+
+void GPIO_Write_To_Output_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t value)
+{
+    uint8_t port = Host_Get_Port_Index(p_gpio_x);
+
+    if (value == SET)
+        port_odr[port] |= (1U << pin_num);
+    else
+        port_odr[port] &= ~(1U << pin_num);
+
+    Host_Drive_Lcd_Pins();
+    now_ns += HOST_GPIO_ACCESS_NS;
+}
+
+void GPIO_Write_To_Output_Port(GPIO_Register_Map_t *p_gpio_x, uint16_t value)
+{
+    port_odr[Host_Get_Port_Index(p_gpio_x)] = value;
+    Host_Drive_Lcd_Pins();
+    now_ns += HOST_GPIO_ACCESS_NS;
+}
+
+/* BSRR semantics: set bits win over reset bits for the same pin */
+void GPIO_Write_Set_Reset(GPIO_Register_Map_t *p_gpio_x, uint32_t set_reset_mask)
+{
+    uint8_t port = Host_Get_Port_Index(p_gpio_x);
+
+    port_odr[port] &= ~(uint16_t)(set_reset_mask >> 16);
+    port_odr[port] |= (uint16_t)(set_reset_mask & 0xFFFF);
+    Host_Drive_Lcd_Pins();
+    now_ns += HOST_GPIO_ACCESS_NS;
+}
+
+/* The NVIC is not modelled; whoever pumps the host interrupts decides when they run */
+void GPIO_IRQ_Interrupt_Config(uint8_t irq_num, uint8_t enable)
+{
+}
+
+void GPIO_IRQ_Priority_Config(uint8_t irq_num, uint32_t irq_prio)
+{
+}
+
+/* No EXTI either: the caller of an EXTI handler is the edge, so there is nothing pending to clear */
+void GPIO_IRQ_Handler(uint8_t pin_num)
+{
+}
+
+/*************** TIM DRIVER *****************/
+void TIM_Init(TIM_Handle_t *p_tim_handle)
+{
+    int8_t idx = Host_Get_Timer_Index(p_tim_handle->p_tim_x);
+
+    if (idx < 0 || p_tim_handle->counter_freq_hz == 0 || p_tim_handle->period == 0)
+        return;
+
+    timers[idx].p_tim_handle = p_tim_handle;
+    timers[idx].running = 0;
+    timers[idx].period_ns = (uint64_t)p_tim_handle->period * 1000000000u / p_tim_handle->counter_freq_hz;
+}
+
+void TIM_Start(TIM_Handle_t *p_tim_handle)
+{
+    int8_t idx = Host_Get_Timer_Index(p_tim_handle->p_tim_x);
+
+    if (idx < 0 || timers[idx].p_tim_handle == NULL)
+        return;
+
+    timers[idx].running = 1;
+    timers[idx].next_update_ns = now_ns + timers[idx].period_ns;
+}
+
+void TIM_Stop(TIM_Handle_t *p_tim_handle)
+{
+    int8_t idx = Host_Get_Timer_Index(p_tim_handle->p_tim_x);
+
+    if (idx >= 0)
+        timers[idx].running = 0;
+}
+
+uint8_t TIM_Is_Running(TIM_Handle_t *p_tim_handle)
+{
+    int8_t idx = Host_Get_Timer_Index(p_tim_handle->p_tim_x);
+
+    return (idx >= 0 && timers[idx].running) ? SET : RESET;
+}
+
+/*************** TIMEBASE *****************/
+/* The virtual core never leaves HSI */
+void Timebase_Init(void)
+{
+}
+
+void Timebase_Clock_Changed(void)
+{
+}
+
+uint32_t Timebase_Get_Core_Clk_Frequency(void)
+{
+    return HSI_CLK_SPEED;
+}
+
+uint32_t Timebase_Get_Cycles(void)
+{
+    return (uint32_t)(now_ns * (HSI_CLK_SPEED / 1000000u) / 1000u);
+}
+
+void Delay_Us(uint32_t us)
+{
+    now_ns += (uint64_t)us * 1000u;
+}
+
+void Delay_Ms(uint32_t ms)
+{
+    now_ns += (uint64_t)ms * 1000000u;
+}
+
+/*************** REGISTER HELPERS *****************/
+/* As in stm32f407xx.c, for drivers built on the host against modelled registers */
+uint32_t GET_FIELD(volatile uint32_t REG, uint32_t MASK)
+{
+    uint32_t value = REG & MASK;
+    value /= MASK & ~(MASK << 1);
+    return value;
+}
+
+uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK)
+{
+    if (REG & MASK)
+        return 1;
+    return 0;
+}
+
+/*************** CRITICAL SECTIONS *****************/
+/* Host "interrupts" only ever run from the thread that pumps them, so there is nothing to mask */
+uint32_t Critical_Section_Enter(void)
+{
+    return 0;
+}
+
+void Critical_Section_Exit(uint32_t primask)
+{
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static uint8_t Host_Get_Port_Index(GPIO_Register_Map_t *p_gpio_x)
+{
+    return (uint8_t)(((uintptr_t)p_gpio_x - GPIOA_BASE_ADDR) / (GPIOB_BASE_ADDR - GPIOA_BASE_ADDR));
+}
+
+static int8_t Host_Get_Timer_Index(TIM_Register_Map_t *p_tim_x)
+{
+    switch ((uintptr_t)p_tim_x)
+    {
+    case TIM2_BASE_ADDR: return 0;
+    case TIM3_BASE_ADDR: return 1;
+    case TIM4_BASE_ADDR: return 2;
+    case TIM5_BASE_ADDR: return 3;
+    case TIM6_BASE_ADDR: return 4;
+    case TIM7_BASE_ADDR: return 5;
+    default: return -1;
+    }
+}
+
+static void Host_Set_Mode(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t mode)
+{
+    uint8_t port = Host_Get_Port_Index(p_gpio_x);
+
+    if (mode == GPIO_MODE_OUT)
+        port_output[port] |= (1U << pin_num);
+    else
+        port_output[port] &= ~(1U << pin_num);
+
+    Host_Drive_Lcd_Pins();
+    now_ns += HOST_GPIO_ACCESS_NS;
+}
+
+/* Hands the model the level of every LCD line as one snapshot. An unwired R/W is tied to ground. */
+static void Host_Drive_Lcd_Pins(void)
+{
+    uint16_t levels = 0;
+    uint16_t driven = 0;
+    uint8_t port;
+
+#ifndef LCD1602A_RW_WIRED
+    driven |= HD44780_SIG_MASK(HD44780_SIG_RW);
+#endif
+
+    for (uint8_t i = 0; i < NUM_LCD_PINS; i++)
+    {
+        port = Host_Get_Port_Index(LCD_PINS[i].p_gpio_x);
+        if ((port_odr[port] >> LCD_PINS[i].pin_num) & 1)
+            levels |= HD44780_SIG_MASK(LCD_PINS[i].signal);
+        if ((port_output[port] >> LCD_PINS[i].pin_num) & 1)
+            driven |= HD44780_SIG_MASK(LCD_PINS[i].signal);
+    }
+
+    HD44780_Model_Drive(levels, driven, now_ns);
+}
+
+static int8_t Host_Find_Lcd_Signal(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num)
+{
+    for (uint8_t i = 0; i < NUM_LCD_PINS; i++)
+    {
+        if (LCD_PINS[i].p_gpio_x == p_gpio_x && LCD_PINS[i].pin_num == pin_num)
+            return LCD_PINS[i].signal;
+    }
+    return -1;
+}
+
+static Host_Input_Source_t *Host_Find_Input_Source(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num)
+{
+    for (uint8_t i = 0; i < HOST_NUM_INPUT_SOURCES; i++)
+    {
+        if (input_sources[i].p_level != NULL && input_sources[i].p_gpio_x == p_gpio_x &&
+            input_sources[i].pin_num == pin_num)
+            return &input_sources[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,184 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "i2c_bus_model.h"
+#include "host_port.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static I2C_Status_t I2C_Bus_Start(I2C_Bus_t *p_bus, uint8_t addr, uint8_t read);
+static void I2C_Bus_Charge_Bits(I2C_Bus_t *p_bus, uint32_t bits);
+static void I2C_Bus_Count_Bits(I2C_Bus_t *p_bus, uint32_t bits);
+static I2C_Bus_Slave_t *I2C_Bus_Find_Slave(I2C_Bus_t *p_bus, uint8_t addr);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+#define I2C_BUS_BITS_PER_BYTE       9       /* eight data bits and the ACK */
+
+void I2C_Bus_Init(I2C_Bus_t *p_bus, uint32_t clock_speed)
+{
+    memset(p_bus, 0, sizeof(*p_bus));
+    I2C_Bus_Set_Speed(p_bus, clock_speed);
+}
+
+void I2C_Bus_Set_Speed(I2C_Bus_t *p_bus, uint32_t clock_speed)
+{
+    p_bus->clock_speed = (clock_speed == 0) ? I2C_SPEED_SM : clock_speed;
+}
+
+uint8_t I2C_Bus_Attach(I2C_Bus_t *p_bus, uint8_t addr, const I2C_Bus_Slave_Ops_t *p_ops, void *p_slave)
+{
+    if (p_bus->num_slaves == I2C_BUS_MAX_SLAVES || I2C_Bus_Find_Slave(p_bus, addr) != NULL)
+        return 0;
+
+    p_bus->slaves[p_bus->num_slaves].addr = addr;
+    p_bus->slaves[p_bus->num_slaves].p_ops = p_ops;
+    p_bus->slaves[p_bus->num_slaves].p_slave = p_slave;
+    p_bus->num_slaves++;
+    return 1;
+}
+
+void I2C_Bus_Reset_Stats(I2C_Bus_t *p_bus)
+{
+    memset(&p_bus->stats, 0, sizeof(p_bus->stats));
+}
+
+I2C_Status_t I2C_Bus_Write(I2C_Bus_t *p_bus, uint8_t addr, const uint8_t *p_data, uint32_t len, uint8_t stop)
+{
+    I2C_Status_t status = I2C_Bus_Start(p_bus, addr, 0);
+
+    for (uint32_t i = 0; i < len && status == I2C_OK; i++)
+    {
+        I2C_Bus_Charge_Bits(p_bus, I2C_BUS_BITS_PER_BYTE);
+        if (!I2C_Bus_Write_Event(p_bus, p_data[i]))
+            status = I2C_ERR_NACK;
+    }
+
+    if (stop || status != I2C_OK)
+        I2C_Bus_Stop(p_bus);
+    return status;
+}
+
+/* The master ACKs every byte but the last, which is how the slave knows to let go of SDA */
+I2C_Status_t I2C_Bus_Read(I2C_Bus_t *p_bus, uint8_t addr, uint8_t *p_data, uint32_t len, uint8_t stop)
+{
+    I2C_Status_t status = I2C_Bus_Start(p_bus, addr, 1);
+
+    for (uint32_t i = 0; i < len && status == I2C_OK; i++)
+    {
+        I2C_Bus_Charge_Bits(p_bus, I2C_BUS_BITS_PER_BYTE);
+        p_data[i] = I2C_Bus_Read_Event(p_bus, i + 1 < len);
+    }
+
+    if (stop || status != I2C_OK)
+        I2C_Bus_Stop(p_bus);
+    return status;
+}
+
+void I2C_Bus_Stop(I2C_Bus_t *p_bus)
+{
+    if (!p_bus->held)
+        return;
+
+    I2C_Bus_Charge_Bits(p_bus, 1);
+    I2C_Bus_Stop_Event(p_bus);
+}
+
+/* Only the slave whose address matches is told of the start; the rest would ignore the byte anyway */
+uint8_t I2C_Bus_Start_Event(I2C_Bus_t *p_bus, uint8_t addr, uint8_t read)
+{
+    I2C_Bus_Slave_t *p_slave = I2C_Bus_Find_Slave(p_bus, addr);
+
+    if (!p_bus->held)
+        p_bus->stats.transactions++;
+    p_bus->stats.starts++;
+    p_bus->held = 1;
+    p_bus->read_nacked = 0;
+    I2C_Bus_Count_Bits(p_bus, 1 + I2C_BUS_BITS_PER_BYTE);
+    p_bus->stats.bytes++;
+    p_bus->p_active = NULL;
+
+    if (p_slave == NULL || !p_slave->p_ops->Start(p_slave->p_slave, read))
+    {
+        p_bus->stats.nacks++;
+        return 0;
+    }
+
+    p_bus->p_active = p_slave;
+    return 1;
+}
+
+uint8_t I2C_Bus_Write_Event(I2C_Bus_t *p_bus, uint8_t byte)
+{
+    I2C_Bus_Count_Bits(p_bus, I2C_BUS_BITS_PER_BYTE);
+    p_bus->stats.bytes++;
+
+    if (p_bus->p_active == NULL || !p_bus->p_active->p_ops->Write_Byte(p_bus->p_active->p_slave, byte))
+    {
+        p_bus->stats.nacks++;
+        return 0;
+    }
+    return 1;
+}
+
+/* The master ACKs every byte it wants another after. Once it has NACKed, the slave lets go of SDA, so any
+ * further byte clocked out reads back as 0xFF on a real bus; here it is counted as an overread. */
+uint8_t I2C_Bus_Read_Event(I2C_Bus_t *p_bus, uint8_t ack)
+{
+    uint8_t byte = 0xFF;
+
+    I2C_Bus_Count_Bits(p_bus, I2C_BUS_BITS_PER_BYTE);
+    p_bus->stats.bytes++;
+
+    if (p_bus->read_nacked)
+        p_bus->stats.overreads++;
+    else if (p_bus->p_active != NULL)
+        byte = p_bus->p_active->p_ops->Read_Byte(p_bus->p_active->p_slave);
+
+    if (!ack)
+    {
+        p_bus->stats.read_nacks++;
+        p_bus->read_nacked = 1;
+    }
+    return byte;
+}
+
+void I2C_Bus_Stop_Event(I2C_Bus_t *p_bus)
+{
+    if (!p_bus->held)
+        return;
+
+    I2C_Bus_Count_Bits(p_bus, 1);
+    if (p_bus->p_active != NULL)
+        p_bus->p_active->p_ops->Stop(p_bus->p_active->p_slave);
+
+    p_bus->p_active = NULL;
+    p_bus->held = 0;
+    p_bus->read_nacked = 0;
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static I2C_Status_t I2C_Bus_Start(I2C_Bus_t *p_bus, uint8_t addr, uint8_t read)
+{
+    I2C_Bus_Charge_Bits(p_bus, 1 + I2C_BUS_BITS_PER_BYTE);
+    return I2C_Bus_Start_Event(p_bus, addr, read) ? I2C_OK : I2C_ERR_NACK;
+}
+
+/* The phase calls run the clock on by the bus time; the events they are built from only count it */
+static void I2C_Bus_Charge_Bits(I2C_Bus_t *p_bus, uint32_t bits)
+{
+    Host_Advance_Ns((uint64_t)bits * 1000000000u / p_bus->clock_speed);
+}
+
+static void I2C_Bus_Count_Bits(I2C_Bus_t *p_bus, uint32_t bits)
+{
+    p_bus->stats.bus_ns += (uint64_t)bits * 1000000000u / p_bus->clock_speed;
+}
+
+static I2C_Bus_Slave_t *I2C_Bus_Find_Slave(I2C_Bus_t *p_bus, uint8_t addr)
+{
+    for (uint8_t i = 0; i < p_bus->num_slaves; i++)
+    {
+        if (p_bus->slaves[i].addr == addr)
+            return &p_bus->slaves[i];
+    }
+    return NULL;
+}
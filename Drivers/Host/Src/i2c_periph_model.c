@@ -0,0 +1,738 @@
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#include "i2c_periph_model.h"
+#include "host_port.h"
+#include "stm32f407xx_i2c_driver.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void I2C_Periph_Map(uintptr_t addr, size_t len);
+static void I2C_Periph_Reset(I2C_Periph_Model_t *p_model);
+static I2C_Periph_Model_t *I2C_Periph_Find(uintptr_t addr);
+static void I2C_Periph_Fault_Handler(int sig, siginfo_t *p_info, void *p_ucontext);
+static void I2C_Periph_Step_Handler(int sig, siginfo_t *p_info, void *p_ucontext);
+static void I2C_Periph_Run_Until(uint64_t now_ns);
+
+static void I2C_Periph_Write(I2C_Periph_Model_t *p_model, uint32_t offset, uint32_t value, uint64_t at_ns);
+static void I2C_Periph_Read(I2C_Periph_Model_t *p_model, uint32_t offset, uint64_t at_ns);
+static void I2C_Periph_Write_CR1(I2C_Periph_Model_t *p_model, uint32_t value, uint64_t at_ns);
+static void I2C_Periph_Write_DR(I2C_Periph_Model_t *p_model, uint8_t byte, uint64_t at_ns);
+static uint8_t I2C_Periph_Read_DR(I2C_Periph_Model_t *p_model, uint64_t at_ns);
+static void I2C_Periph_Clear_ADDR(I2C_Periph_Model_t *p_model, uint64_t at_ns);
+static void I2C_Periph_Latch_Byte(I2C_Periph_Model_t *p_model, uint64_t at_ns);
+static uint8_t I2C_Periph_Next_Condition(I2C_Periph_Model_t *p_model, uint64_t at_ns);
+static void I2C_Periph_Process_Event(I2C_Periph_Model_t *p_model);
+static void I2C_Periph_Release_Bus(I2C_Periph_Model_t *p_model);
+static void I2C_Periph_Schedule(I2C_Periph_Model_t *p_model, I2C_Periph_Event_t event, uint64_t at_ns,
+                                uint32_t bits);
+static uint64_t I2C_Periph_Bit_Ns(I2C_Periph_Model_t *p_model);
+static void I2C_Periph_Settle(I2C_Periph_Model_t *p_model, uint64_t at_ns);
+static void I2C_Periph_Service_DMA(I2C_Periph_Model_t *p_model, uint64_t at_ns);
+static void I2C_Periph_DMA_Transferred(I2C_Periph_Model_t *p_model, I2C_Periph_DMA_t *p_dma, uint64_t at_ns);
+static void I2C_Periph_Set_Line(uint64_t *p_raised_ns, uint8_t up, uint64_t at_ns);
+static I2C_Periph_DMA_t *I2C_Periph_Find_DMA(DMA_Handle_t *p_dma_handle);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+/* Defined in the driver, in place of the vector table */
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void I2C2_EV_IRQHandler(void);
+void I2C2_ER_IRQHandler(void);
+void I2C3_EV_IRQHandler(void);
+void I2C3_ER_IRQHandler(void);
+
+#define I2C_PERIPH_PAGE_SIZE        0x1000u
+#define I2C_PERIPH_WINDOW_ADDR      (I2C1_BASE_ADDR & ~(I2C_PERIPH_PAGE_SIZE - 1))
+#define I2C_PERIPH_BITS_PER_BYTE    9       /* eight data bits and the ACK */
+#define I2C_PERIPH_DEFAULT_BIT_NS   10000   /* 100kHz, until CCR and CR2.FREQ are programmed */
+#define X86_EFLAGS_TF               0x100   /* trap after the next instruction */
+#define X86_PF_WRITE                0x2     /* page fault error code: the access was a write */
+
+#define I2C_PERIPH_SR1_EVENTS       (I2C_SR1_SB_MASK | I2C_SR1_ADDR_MASK | I2C_SR1_BTF_MASK | I2C_SR1_ADD10_MASK \
+                                     | I2C_SR1_STOPF_MASK)
+#define I2C_PERIPH_SR1_BUFFER       (I2C_SR1_TXE_MASK | I2C_SR1_RXNE_MASK)
+#define I2C_PERIPH_SR1_ERRORS       (I2C_SR1_BERR_MASK | I2C_SR1_ARLO_MASK | I2C_SR1_AF_MASK | I2C_SR1_OVR_MASK \
+                                     | I2C_SR1_PEC_ERR_MASK | I2C_SR1_TIMEOUT_MASK | I2C_SR1_SMB_ALERT_MASK)
+#define I2C_PERIPH_CR2_WRITABLE     (I2C_CR2_FREQ_MASK | I2C_CR2_ITERREN_MASK | I2C_CR2_ITEVTEN_MASK \
+                                     | I2C_CR2_ITBUFEN_MASK | I2C_CR2_DMAEN_MASK | I2C_CR2_LAST_MASK)
+
+typedef struct
+{
+    uintptr_t                       base_addr;
+    void                            (*p_ev_handler)(void);
+    void                            (*p_er_handler)(void);
+} I2C_Periph_Vectors_t;
+
+static const I2C_Periph_Vectors_t VECTORS[I2C_NUM_INSTANCES] = {
+        [I2C_INSTANCE_1] = { I2C1_BASE_ADDR, I2C1_EV_IRQHandler, I2C1_ER_IRQHandler },
+        [I2C_INSTANCE_2] = { I2C2_BASE_ADDR, I2C2_EV_IRQHandler, I2C2_ER_IRQHandler },
+        [I2C_INSTANCE_3] = { I2C3_BASE_ADDR, I2C3_EV_IRQHandler, I2C3_ER_IRQHandler },
+};
+
+static I2C_Periph_Model_t models[I2C_NUM_INSTANCES];
+static uint64_t irq_latency_ns;
+static uint8_t in_isr;
+static uint8_t mapped;
+
+/* The access being single stepped */
+static I2C_Periph_Model_t *p_trap_model;
+static uint32_t trap_offset;
+static uint8_t trap_write;
+
+void I2C_Periph_Model_Init(void)
+{
+    struct sigaction action;
+
+    if (!mapped)
+    {
+        /* APB1 through AHB1 takes in RCC and the DMA controllers; the core block holds NVIC and DWT */
+        I2C_Periph_Map(PERIPH_BASE, AHB1_PERIPH_BASE + 0x10000u - PERIPH_BASE);
+        I2C_Periph_Map(0xE0000000u, 0x100000u);
+
+        memset(&action, 0, sizeof(action));
+        action.sa_flags = SA_SIGINFO;
+        action.sa_sigaction = I2C_Periph_Fault_Handler;
+        sigaction(SIGSEGV, &action, NULL);
+        action.sa_sigaction = I2C_Periph_Step_Handler;
+        sigaction(SIGTRAP, &action, NULL);
+        mapped = 1;
+    }
+
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        I2C_Periph_Reset(&models[i]);
+        models[i].p_bus = NULL;
+        memset(&models[i].stats, 0, sizeof(models[i].stats));
+    }
+    irq_latency_ns = 0;
+    in_isr = 0;
+    mprotect((void *)I2C_PERIPH_WINDOW_ADDR, I2C_PERIPH_PAGE_SIZE, PROT_NONE);
+}
+
+void I2C_Periph_Model_Attach_Bus(I2C_Instance_t instance, I2C_Bus_t *p_bus)
+{
+    models[instance].p_bus = p_bus;
+}
+
+I2C_Periph_Model_t *I2C_Periph_Model_Get(I2C_Instance_t instance)
+{
+    return &models[instance];
+}
+
+void I2C_Periph_Model_Reset_Stats(I2C_Instance_t instance)
+{
+    memset(&models[instance].stats, 0, sizeof(models[instance].stats));
+}
+
+void I2C_Periph_Model_Set_Irq_Latency(uint64_t latency_ns)
+{
+    irq_latency_ns = latency_ns;
+}
+
+/* On a tie the interrupt goes first, the way a flag raised by one event is serviced before the next */
+uint8_t I2C_Periph_Model_Step(void)
+{
+    I2C_Periph_Model_t *p_model;
+    uint64_t next_ns = UINT64_MAX;
+    int8_t next_instance = -1;
+    uint8_t next_kind = 0;      /* 0 bus event, 1 error line, 2 event line, 3 DMA */
+    uint64_t due_ns;
+    DMA_Handle_t *p_dma_handle;
+
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        p_model = &models[i];
+        uint64_t raised[3] = { p_model->er_raised_ns, p_model->ev_raised_ns,
+                               (p_model->p_dma_irq != NULL) ? p_model->dma_raised_ns : I2C_PERIPH_LINE_LOW };
+
+        for (uint8_t kind = 0; kind < 3; kind++)
+        {
+            if (raised[kind] == I2C_PERIPH_LINE_LOW)
+                continue;
+            due_ns = raised[kind] + irq_latency_ns;
+            if (due_ns < next_ns || (due_ns == next_ns && next_kind == 0))
+            {
+                next_ns = due_ns;
+                next_instance = i;
+                next_kind = kind + 1;
+            }
+        }
+        if (p_model->event != I2C_PERIPH_EVT_NONE && p_model->event_ns < next_ns)
+        {
+            next_ns = p_model->event_ns;
+            next_instance = i;
+            next_kind = 0;
+        }
+    }
+
+    if (next_instance < 0)
+        return 0;
+
+    if (next_ns > Host_Now_Ns())
+        Host_Advance_Ns(next_ns - Host_Now_Ns());
+
+    p_model = &models[next_instance];
+    in_isr = (next_kind != 0);
+    switch (next_kind)
+    {
+    case 0:
+        I2C_Periph_Run_Until(Host_Now_Ns());
+        break;
+    case 1:
+        p_model->stats.er_irqs++;
+        VECTORS[next_instance].p_er_handler();
+        break;
+    case 2:
+        p_model->stats.ev_irqs++;
+        VECTORS[next_instance].p_ev_handler();
+        break;
+    case 3:
+        p_model->stats.dma_irqs++;
+        p_dma_handle = p_model->p_dma_irq;
+        p_model->p_dma_irq = NULL;
+        p_dma_handle->p_complete_callback();
+        break;
+    }
+    in_isr = 0;
+    return 1;
+}
+
+/*************** DMA DRIVER *****************/
+/* Only the two I2C streams are modelled, and the requests come from the peripheral model itself */
+void DMA_Init(DMA_Handle_t *p_dma_handle)
+{
+}
+
+void DMA_Start(DMA_Handle_t *p_dma_handle, volatile uint32_t *p_periph_reg, uint8_t *p_mem, uint16_t len)
+{
+    I2C_Periph_Model_t *p_model = I2C_Periph_Find((uintptr_t)p_periph_reg);
+    I2C_Periph_DMA_t *p_dma;
+
+    if (p_model == NULL)
+        return;
+
+    p_dma = (p_dma_handle->direction == DMA_DIR_PERIPH_TO_MEM) ? &p_model->dma_rx : &p_model->dma_tx;
+    p_dma->p_handle = p_dma_handle;
+    p_dma->p_mem = p_mem;
+    p_dma->remaining = len;
+    p_dma->active = (len > 0);
+}
+
+void DMA_Stop(DMA_Handle_t *p_dma_handle)
+{
+    I2C_Periph_DMA_t *p_dma = I2C_Periph_Find_DMA(p_dma_handle);
+
+    if (p_dma != NULL)
+        p_dma->active = 0;
+}
+
+uint16_t DMA_Get_Remaining(DMA_Handle_t *p_dma_handle)
+{
+    I2C_Periph_DMA_t *p_dma = I2C_Periph_Find_DMA(p_dma_handle);
+
+    return (p_dma != NULL) ? p_dma->remaining : 0;
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void I2C_Periph_Map(uintptr_t addr, size_t len)
+{
+    mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+}
+
+/* Reset values, as after SWRST or power up */
+static void I2C_Periph_Reset(I2C_Periph_Model_t *p_model)
+{
+    memset(&p_model->regs, 0, sizeof(p_model->regs));
+    p_model->regs.TRISE = 0x0002;
+    p_model->event = I2C_PERIPH_EVT_NONE;
+    p_model->sr1_read = 0;
+    p_model->rx_held = 0;
+    p_model->rx_nacked = 0;
+    p_model->dma_rx.active = 0;
+    p_model->dma_tx.active = 0;
+    p_model->p_dma_irq = NULL;
+    p_model->ev_raised_ns = I2C_PERIPH_LINE_LOW;
+    p_model->er_raised_ns = I2C_PERIPH_LINE_LOW;
+    p_model->dma_raised_ns = I2C_PERIPH_LINE_LOW;
+}
+
+static I2C_Periph_Model_t *I2C_Periph_Find(uintptr_t addr)
+{
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        if (addr >= VECTORS[i].base_addr && addr < VECTORS[i].base_addr + sizeof(I2C_Register_Map_t))
+            return &models[i];
+    }
+    return NULL;
+}
+
+/* First half of an access: the model catches up to now, the registers are published into the window, and
+ * the faulting instruction is let run once with the page open */
+static void I2C_Periph_Fault_Handler(int sig, siginfo_t *p_info, void *p_ucontext)
+{
+    ucontext_t *p_uc = (ucontext_t *)p_ucontext;
+    uintptr_t addr = (uintptr_t)p_info->si_addr;
+
+    if (addr < I2C_PERIPH_WINDOW_ADDR || addr >= I2C_PERIPH_WINDOW_ADDR + I2C_PERIPH_PAGE_SIZE)
+    {
+        /* A real fault; let it happen again without us */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    p_trap_model = I2C_Periph_Find(addr);
+    trap_write = (p_uc->uc_mcontext.gregs[REG_ERR] & X86_PF_WRITE) != 0;
+
+    Host_Advance_Ns(I2C_PERIPH_REG_ACCESS_NS);
+    I2C_Periph_Run_Until(Host_Now_Ns());
+    mprotect((void *)I2C_PERIPH_WINDOW_ADDR, I2C_PERIPH_PAGE_SIZE, PROT_READ | PROT_WRITE);
+
+    if (p_trap_model != NULL)
+    {
+        trap_offset = (addr - VECTORS[p_trap_model - models].base_addr) & ~3u;
+        p_trap_model->stats.reg_accesses++;
+        if (in_isr)
+            p_trap_model->stats.isr_reg_accesses++;
+        *(I2C_Register_Map_t *)VECTORS[p_trap_model - models].base_addr = p_trap_model->regs;
+    }
+    p_uc->uc_mcontext.gregs[REG_EFL] |= X86_EFLAGS_TF;
+}
+
+/* Second half: the access has happened. A store is taken from the window, a load has its side effects. */
+static void I2C_Periph_Step_Handler(int sig, siginfo_t *p_info, void *p_ucontext)
+{
+    ucontext_t *p_uc = (ucontext_t *)p_ucontext;
+    volatile uint32_t *p_window;
+
+    p_uc->uc_mcontext.gregs[REG_EFL] &= ~X86_EFLAGS_TF;
+
+    if (p_trap_model != NULL)
+    {
+        p_window = (volatile uint32_t *)(VECTORS[p_trap_model - models].base_addr + trap_offset);
+        if (trap_write)
+            I2C_Periph_Write(p_trap_model, trap_offset, *p_window, Host_Now_Ns());
+        else
+            I2C_Periph_Read(p_trap_model, trap_offset, Host_Now_Ns());
+    }
+    mprotect((void *)I2C_PERIPH_WINDOW_ADDR, I2C_PERIPH_PAGE_SIZE, PROT_NONE);
+}
+
+/* Events are processed at their own time, however late the model gets round to them */
+static void I2C_Periph_Run_Until(uint64_t now_ns)
+{
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        while (models[i].event != I2C_PERIPH_EVT_NONE && models[i].event_ns <= now_ns)
+        {
+            I2C_Periph_Process_Event(&models[i]);
+        }
+    }
+}
+
+static void I2C_Periph_Write(I2C_Periph_Model_t *p_model, uint32_t offset, uint32_t value, uint64_t at_ns)
+{
+    switch (offset)
+    {
+    case offsetof(I2C_Register_Map_t, CR1):
+        I2C_Periph_Write_CR1(p_model, value, at_ns);
+        break;
+    case offsetof(I2C_Register_Map_t, CR2):
+        p_model->regs.CR2 = value & I2C_PERIPH_CR2_WRITABLE;
+        break;
+    case offsetof(I2C_Register_Map_t, DR):
+        I2C_Periph_Write_DR(p_model, (uint8_t)value, at_ns);
+        break;
+    case offsetof(I2C_Register_Map_t, SR1):
+        /* The error flags are rc_w0; everything else in SR1 is read only */
+        p_model->regs.SR1 &= value | ~I2C_PERIPH_SR1_ERRORS;
+        break;
+    case offsetof(I2C_Register_Map_t, SR2):
+        break;
+    case offsetof(I2C_Register_Map_t, OAR1):
+        p_model->regs.OAR1 = value;
+        break;
+    case offsetof(I2C_Register_Map_t, OAR2):
+        p_model->regs.OAR2 = value;
+        break;
+    case offsetof(I2C_Register_Map_t, CCR):
+        /* Only takes while the peripheral is disabled */
+        if (!(p_model->regs.CR1 & I2C_CR1_PE_MASK))
+            p_model->regs.CCR = value;
+        break;
+    case offsetof(I2C_Register_Map_t, TRISE):
+        if (!(p_model->regs.CR1 & I2C_CR1_PE_MASK))
+            p_model->regs.TRISE = value & I2C_TRISE_TRISE_MASK;
+        break;
+    case offsetof(I2C_Register_Map_t, FLTR):
+        p_model->regs.FLTR = value;
+        break;
+    }
+    I2C_Periph_Settle(p_model, at_ns);
+}
+
+static void I2C_Periph_Read(I2C_Periph_Model_t *p_model, uint32_t offset, uint64_t at_ns)
+{
+    switch (offset)
+    {
+    case offsetof(I2C_Register_Map_t, SR1):
+        p_model->sr1_read = 1;
+        break;
+    case offsetof(I2C_Register_Map_t, SR2):
+        if ((p_model->regs.SR1 & I2C_SR1_ADDR_MASK) && p_model->sr1_read)
+            I2C_Periph_Clear_ADDR(p_model, at_ns);
+        break;
+    case offsetof(I2C_Register_Map_t, DR):
+        I2C_Periph_Read_DR(p_model, at_ns);
+        break;
+    }
+    I2C_Periph_Settle(p_model, at_ns);
+}
+
+static void I2C_Periph_Write_CR1(I2C_Periph_Model_t *p_model, uint32_t value, uint64_t at_ns)
+{
+    uint32_t old = p_model->regs.CR1;
+
+    if (value & I2C_CR1_SWRST_MASK)
+    {
+        I2C_Periph_Release_Bus(p_model);
+        I2C_Periph_Reset(p_model);
+        p_model->regs.CR1 = I2C_CR1_SWRST_MASK;
+        return;
+    }
+
+    if (!(value & I2C_CR1_PE_MASK))
+    {
+        /* Disabling the peripheral lets go of the lines and clears the flags, ACK, START and STOP */
+        if (old & I2C_CR1_PE_MASK)
+        {
+            I2C_Periph_Release_Bus(p_model);
+            p_model->regs.SR1 = 0;
+            p_model->regs.SR2 = 0;
+            p_model->event = I2C_PERIPH_EVT_NONE;
+            p_model->rx_held = 0;
+        }
+        p_model->regs.CR1 = value & ~(I2C_CR1_ACK_MASK | I2C_CR1_START_MASK | I2C_CR1_STOP_MASK);
+        return;
+    }
+
+    p_model->regs.CR1 = value;
+    if (((value & ~old) & (I2C_CR1_START_MASK | I2C_CR1_STOP_MASK))
+            && p_model->event == I2C_PERIPH_EVT_NONE && !p_model->rx_held)
+    {
+        /* Nothing on the bus to wait for */
+        I2C_Periph_Next_Condition(p_model, at_ns);
+    }
+}
+
+static void I2C_Periph_Write_DR(I2C_Periph_Model_t *p_model, uint8_t byte, uint64_t at_ns)
+{
+    I2C_Register_Map_t *p_regs = &p_model->regs;
+
+    p_regs->DR = byte;
+
+    if (p_regs->SR1 & I2C_SR1_SB_MASK)
+    {
+        /* EV5: SR1 read, then the address into DR */
+        if (!p_model->sr1_read)
+            return;
+        p_model->sr1_read = 0;
+        p_regs->SR1 &= ~I2C_SR1_SB_MASK;
+        p_model->shift_byte = byte;
+        I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_ADDR, at_ns, I2C_PERIPH_BITS_PER_BYTE);
+        return;
+    }
+
+    if (!(p_regs->SR2 & I2C_SR2_MSL_MASK) || !(p_regs->SR2 & I2C_SR2_TRA_MASK) || (p_regs->SR1 & I2C_SR1_ADDR_MASK))
+        return;
+
+    if ((p_regs->SR1 & I2C_SR1_BTF_MASK) && p_model->sr1_read)
+    {
+        p_model->sr1_read = 0;
+        p_regs->SR1 &= ~I2C_SR1_BTF_MASK;
+    }
+
+    if (p_model->event == I2C_PERIPH_EVT_NONE)
+    {
+        /* Shift register free: the byte goes straight through and DR is empty again */
+        p_model->shift_byte = byte;
+        p_regs->SR1 |= I2C_SR1_TXE_MASK;
+        I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_BYTE_SENT, at_ns, I2C_PERIPH_BITS_PER_BYTE);
+    }
+    else
+    {
+        p_regs->SR1 &= ~I2C_SR1_TXE_MASK;
+    }
+}
+
+static uint8_t I2C_Periph_Read_DR(I2C_Periph_Model_t *p_model, uint64_t at_ns)
+{
+    uint8_t byte = (uint8_t)p_model->regs.DR;
+
+    if (!(p_model->regs.SR1 & I2C_SR1_RXNE_MASK))
+        return byte;
+
+    p_model->regs.SR1 &= ~I2C_SR1_RXNE_MASK;
+    if (p_model->rx_held)
+    {
+        /* The stretched byte moves up and SCL is let go */
+        p_model->sr1_read = 0;
+        p_model->regs.SR1 &= ~I2C_SR1_BTF_MASK;
+        I2C_Periph_Latch_Byte(p_model, at_ns);
+    }
+    return byte;
+}
+
+/* EV6: SR1 then SR2 read. A transmitter asks for its first byte; a receiver starts clocking one in. */
+static void I2C_Periph_Clear_ADDR(I2C_Periph_Model_t *p_model, uint64_t at_ns)
+{
+    p_model->sr1_read = 0;
+    p_model->regs.SR1 &= ~I2C_SR1_ADDR_MASK;
+
+    if (p_model->regs.SR2 & I2C_SR2_TRA_MASK)
+        p_model->regs.SR1 |= I2C_SR1_TXE_MASK;
+    else
+        I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_BYTE_RECEIVED, at_ns, I2C_PERIPH_BITS_PER_BYTE);
+}
+
+/* A received byte moves into DR and its ACK goes out. With LAST set under DMA the byte the stream ends on is
+ * NACKed whatever CR1.ACK says. */
+static void I2C_Periph_Latch_Byte(I2C_Periph_Model_t *p_model, uint64_t at_ns)
+{
+    I2C_Register_Map_t *p_regs = &p_model->regs;
+    uint8_t ack = (p_regs->CR1 & I2C_CR1_ACK_MASK) != 0;
+
+    if ((p_regs->CR2 & I2C_CR2_DMAEN_MASK) && (p_regs->CR2 & I2C_CR2_LAST_MASK)
+            && p_model->dma_rx.active && p_model->dma_rx.remaining <= 1)
+    {
+        ack = 0;
+    }
+
+    p_regs->DR = (p_model->p_bus != NULL) ? I2C_Bus_Read_Event(p_model->p_bus, ack) : 0xFF;
+    p_regs->SR1 |= I2C_SR1_RXNE_MASK;
+    p_model->rx_held = 0;
+    p_model->rx_nacked = !ack;
+
+    if (!I2C_Periph_Next_Condition(p_model, at_ns) && ack)
+        I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_BYTE_RECEIVED, at_ns, I2C_PERIPH_BITS_PER_BYTE);
+}
+
+/* A stop or start asked for while a byte was on the bus goes out once it is done. Stop wins if both are. */
+static uint8_t I2C_Periph_Next_Condition(I2C_Periph_Model_t *p_model, uint64_t at_ns)
+{
+    if ((p_model->regs.CR1 & I2C_CR1_STOP_MASK) && (p_model->regs.SR2 & I2C_SR2_MSL_MASK))
+    {
+        I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_STOP, at_ns, 1);
+        return 1;
+    }
+    if (p_model->regs.CR1 & I2C_CR1_START_MASK)
+    {
+        I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_START, at_ns, 1);
+        return 1;
+    }
+    /* Not a master, so there is no stop to send */
+    p_model->regs.CR1 &= ~I2C_CR1_STOP_MASK;
+    return 0;
+}
+
+static void I2C_Periph_Process_Event(I2C_Periph_Model_t *p_model)
+{
+    I2C_Register_Map_t *p_regs = &p_model->regs;
+    uint64_t at_ns = p_model->event_ns;
+    I2C_Periph_Event_t event = p_model->event;
+    uint8_t ack;
+
+    p_model->event = I2C_PERIPH_EVT_NONE;
+
+    switch (event)
+    {
+    case I2C_PERIPH_EVT_START:
+        p_regs->CR1 &= ~I2C_CR1_START_MASK;
+        p_regs->SR1 &= ~(I2C_SR1_TXE_MASK | I2C_SR1_BTF_MASK);
+        p_regs->SR1 |= I2C_SR1_SB_MASK;
+        p_regs->SR2 |= I2C_SR2_MSL_MASK | I2C_SR2_BUSY_MASK;
+        p_model->sr1_read = 0;
+        p_model->rx_nacked = 0;
+        if (p_model->p_bus != NULL)
+            I2C_Bus_Set_Speed(p_model->p_bus, (uint32_t)(1000000000u / I2C_Periph_Bit_Ns(p_model)));
+        break;
+
+    case I2C_PERIPH_EVT_ADDR:
+        ack = (p_model->p_bus != NULL)
+                && I2C_Bus_Start_Event(p_model->p_bus, p_model->shift_byte >> 1, p_model->shift_byte & 1);
+        if (ack)
+        {
+            p_regs->SR1 |= I2C_SR1_ADDR_MASK;
+            if (p_model->shift_byte & 1)
+                p_regs->SR2 &= ~I2C_SR2_TRA_MASK;
+            else
+                p_regs->SR2 |= I2C_SR2_TRA_MASK;
+        }
+        else
+        {
+            p_regs->SR1 |= I2C_SR1_AF_MASK;
+            I2C_Periph_Next_Condition(p_model, at_ns);
+        }
+        break;
+
+    case I2C_PERIPH_EVT_BYTE_SENT:
+        ack = (p_model->p_bus != NULL) && I2C_Bus_Write_Event(p_model->p_bus, p_model->shift_byte);
+        if (!ack)
+        {
+            /* Nothing more goes out after a NACK */
+            p_regs->SR1 |= I2C_SR1_AF_MASK;
+            I2C_Periph_Next_Condition(p_model, at_ns);
+        }
+        else if (I2C_Periph_Next_Condition(p_model, at_ns))
+        {
+        }
+        else if (!(p_regs->SR1 & I2C_SR1_TXE_MASK))
+        {
+            p_model->shift_byte = (uint8_t)p_regs->DR;
+            p_regs->SR1 |= I2C_SR1_TXE_MASK;
+            I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_BYTE_SENT, at_ns, I2C_PERIPH_BITS_PER_BYTE);
+        }
+        else
+        {
+            /* DR is still empty: SCL is stretched until the next byte, a start or a stop */
+            p_regs->SR1 |= I2C_SR1_BTF_MASK;
+        }
+        break;
+
+    case I2C_PERIPH_EVT_BYTE_RECEIVED:
+        if (p_regs->SR1 & I2C_SR1_RXNE_MASK)
+        {
+            p_regs->SR1 |= I2C_SR1_BTF_MASK;
+            p_model->rx_held = 1;
+            p_model->stats.stretches++;
+        }
+        else
+        {
+            I2C_Periph_Latch_Byte(p_model, at_ns);
+        }
+        break;
+
+    case I2C_PERIPH_EVT_STOP:
+        if (p_model->p_bus != NULL)
+            I2C_Bus_Stop_Event(p_model->p_bus);
+        p_regs->CR1 &= ~I2C_CR1_STOP_MASK;
+        p_regs->SR1 &= ~(I2C_SR1_TXE_MASK | I2C_SR1_BTF_MASK);
+        p_regs->SR2 &= ~(I2C_SR2_MSL_MASK | I2C_SR2_BUSY_MASK | I2C_SR2_TRA_MASK);
+        p_model->rx_nacked = 0;
+        if (p_regs->CR1 & I2C_CR1_START_MASK)
+            I2C_Periph_Schedule(p_model, I2C_PERIPH_EVT_START, at_ns, 1);
+        break;
+
+    case I2C_PERIPH_EVT_NONE:
+        break;
+    }
+    I2C_Periph_Settle(p_model, at_ns);
+}
+
+/* A disabled or reset peripheral just lets go of SCL and SDA. The slaves are told with a stop, which is as
+ * close as the bus model gets. */
+static void I2C_Periph_Release_Bus(I2C_Periph_Model_t *p_model)
+{
+    if (p_model->p_bus != NULL)
+        I2C_Bus_Stop_Event(p_model->p_bus);
+}
+
+static void I2C_Periph_Schedule(I2C_Periph_Model_t *p_model, I2C_Periph_Event_t event, uint64_t at_ns,
+                                uint32_t bits)
+{
+    p_model->event = event;
+    p_model->event_ns = at_ns + bits * I2C_Periph_Bit_Ns(p_model);
+}
+
+/* One SCL period as CCR and CR2.FREQ program it */
+static uint64_t I2C_Periph_Bit_Ns(I2C_Periph_Model_t *p_model)
+{
+    uint32_t freq_mhz = p_model->regs.CR2 & I2C_CR2_FREQ_MASK;
+    uint32_t ccr = p_model->regs.CCR & I2C_CCR_CCR_MASK;
+    uint32_t pclk_per_bit;
+
+    if (freq_mhz == 0 || ccr == 0)
+        return I2C_PERIPH_DEFAULT_BIT_NS;
+
+    if (!(p_model->regs.CCR & I2C_CCR_FS_MASK))
+        pclk_per_bit = 2 * ccr;
+    else if (p_model->regs.CCR & I2C_CCR_DUTY_MASK)
+        pclk_per_bit = 25 * ccr;
+    else
+        pclk_per_bit = 3 * ccr;
+
+    return (uint64_t)pclk_per_bit * 1000u / freq_mhz;
+}
+
+/* Whatever changed, the DMA requests are served and the interrupt lines brought up to date */
+static void I2C_Periph_Settle(I2C_Periph_Model_t *p_model, uint64_t at_ns)
+{
+    uint32_t sr1;
+    uint32_t cr2;
+
+    I2C_Periph_Service_DMA(p_model, at_ns);
+
+    sr1 = p_model->regs.SR1;
+    cr2 = p_model->regs.CR2;
+    I2C_Periph_Set_Line(&p_model->ev_raised_ns, (cr2 & I2C_CR2_ITEVTEN_MASK)
+            && ((sr1 & I2C_PERIPH_SR1_EVENTS) || ((cr2 & I2C_CR2_ITBUFEN_MASK) && (sr1 & I2C_PERIPH_SR1_BUFFER))),
+            at_ns);
+    I2C_Periph_Set_Line(&p_model->er_raised_ns, (cr2 & I2C_CR2_ITERREN_MASK) && (sr1 & I2C_PERIPH_SR1_ERRORS),
+            at_ns);
+}
+
+static void I2C_Periph_Service_DMA(I2C_Periph_Model_t *p_model, uint64_t at_ns)
+{
+    I2C_Register_Map_t *p_regs = &p_model->regs;
+
+    if (!(p_regs->CR2 & I2C_CR2_DMAEN_MASK))
+        return;
+
+    while (p_model->dma_tx.active && (p_regs->SR1 & I2C_SR1_TXE_MASK) && (p_regs->SR2 & I2C_SR2_TRA_MASK))
+    {
+        I2C_Periph_Write_DR(p_model, *p_model->dma_tx.p_mem++, at_ns);
+        I2C_Periph_DMA_Transferred(p_model, &p_model->dma_tx, at_ns);
+    }
+
+    while (p_model->dma_rx.active && (p_regs->SR1 & I2C_SR1_RXNE_MASK))
+    {
+        *p_model->dma_rx.p_mem++ = I2C_Periph_Read_DR(p_model, at_ns);
+        I2C_Periph_DMA_Transferred(p_model, &p_model->dma_rx, at_ns);
+    }
+}
+
+static void I2C_Periph_DMA_Transferred(I2C_Periph_Model_t *p_model, I2C_Periph_DMA_t *p_dma, uint64_t at_ns)
+{
+    if (--p_dma->remaining > 0)
+        return;
+
+    p_dma->active = 0;
+    if (p_dma->p_handle->p_complete_callback != NULL)
+    {
+        p_model->p_dma_irq = p_dma->p_handle;
+        p_model->dma_raised_ns = at_ns;
+    }
+}
+
+static void I2C_Periph_Set_Line(uint64_t *p_raised_ns, uint8_t up, uint64_t at_ns)
+{
+    if (!up)
+        *p_raised_ns = I2C_PERIPH_LINE_LOW;
+    else if (*p_raised_ns == I2C_PERIPH_LINE_LOW)
+        *p_raised_ns = at_ns;
+}
+
+static I2C_Periph_DMA_t *I2C_Periph_Find_DMA(DMA_Handle_t *p_dma_handle)
+{
+    for (uint8_t i = 0; i < I2C_NUM_INSTANCES; i++)
+    {
+        if (models[i].dma_rx.p_handle == p_dma_handle)
+            return &models[i].dma_rx;
+        if (models[i].dma_tx.p_handle == p_dma_handle)
+            return &models[i].dma_tx;
+    }
+    return NULL;
+}
@@ -36,6 +36,20 @@ uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK);
 
 /* General STM32F407 settings */
 #define HSI_CLK_SPEED            16000000u
+#define HSE_CLK_SPEED            8000000u           /* 8MHz crystal fitted to the STM32F4 Discovery board */
+
+/* Core timebase, driven by the DWT cycle counter. The core clock it counts is HSI from reset, and is read back
+ * from RCC by Timebase_Init() and by Timebase_Clock_Changed(), which must follow any change to the clock tree. */
+void Timebase_Init(void);
+void Timebase_Clock_Changed(void);
+uint32_t Timebase_Get_Core_Clk_Frequency(void);
+uint32_t Timebase_Get_Cycles(void);
+void Delay_Us(uint32_t us);
+void Delay_Ms(uint32_t ms);
+
+/* Masks every configurable interrupt through PRIMASK. Exit restores the mask Enter returned, so sections nest. */
+uint32_t Critical_Section_Enter(void);
+void Critical_Section_Exit(uint32_t primask);
 
 /*************** MEMORY ADDRESSES *****************/
 /* Major memory segment addresses */
@@ -58,6 +72,13 @@ uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK);
 
 #define NVIC_IPR_0                  ((volatile uint32_t *)0xE000E400)
 
+/* Debug exception and monitor control, Data Watchpoint and Trace unit. The DWT cycle counter is the core timebase. */
+#define CORE_DEMCR                  ((volatile uint32_t *)0xE000EDFC)
+#define DWT_CTRL                    ((volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT                  ((volatile uint32_t *)0xE0001004)
+#define CORE_DEMCR_TRCENA_MASK      ( 1 << 24 )
+#define DWT_CTRL_CYCCNTENA_MASK     ( 1 << 0 )
+
 /* Peripheral bus base addresses */
 #define PERIPH_BASE                 0x40000000u
 #define APB1_PERIPH_BASE            PERIPH_BASE
@@ -66,6 +87,12 @@ uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK);
 #define AHB2_PERIPH_BASE            0x50000000u
 
 /* Relevant APB1 peripherals */
+#define TIM2_BASE_ADDR              ( APB1_PERIPH_BASE + 0x0000 )
+#define TIM3_BASE_ADDR              ( APB1_PERIPH_BASE + 0x0400 )
+#define TIM4_BASE_ADDR              ( APB1_PERIPH_BASE + 0x0800 )
+#define TIM5_BASE_ADDR              ( APB1_PERIPH_BASE + 0x0C00 )
+#define TIM6_BASE_ADDR              ( APB1_PERIPH_BASE + 0x1000 )
+#define TIM7_BASE_ADDR              ( APB1_PERIPH_BASE + 0x1400 )
 #define I2C1_BASE_ADDR              ( APB1_PERIPH_BASE + 0x5400 )
 #define I2C2_BASE_ADDR              ( APB1_PERIPH_BASE + 0x5800 )
 #define I2C3_BASE_ADDR              ( APB1_PERIPH_BASE + 0x5C00 )
@@ -81,6 +108,8 @@ uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK);
 #define GPIOH_BASE_ADDR             ( AHB1_PERIPH_BASE + 0x1C00 )
 #define GPIOI_BASE_ADDR             ( AHB1_PERIPH_BASE + 0x2000 )
 #define RCC_BASE_ADDR               ( AHB1_PERIPH_BASE + 0x3800 )
+#define DMA1_BASE_ADDR              ( AHB1_PERIPH_BASE + 0x6000 )
+#define DMA2_BASE_ADDR              ( AHB1_PERIPH_BASE + 0x6400 )
 
 /* Miscellaneous peripherals */
 #define EXTI_BASE_ADDR              ( APB2_PERIPH_BASE + 0x3C00 )
@@ -95,6 +124,24 @@ uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK);
 #define IRQ_NO_EXTI5_9              23
 #define IRQ_NO_EXTI10_15            40
 
+/* Vector table position for the general purpose and basic timers */
+#define IRQ_NO_TIM2                 28
+#define IRQ_NO_TIM3                 29
+#define IRQ_NO_TIM4                 30
+#define IRQ_NO_TIM5                 50
+#define IRQ_NO_TIM6_DAC             54
+#define IRQ_NO_TIM7                 55
+
+/* Vector table position for the DMA1 streams */
+#define IRQ_NO_DMA1_STREAM0         11
+#define IRQ_NO_DMA1_STREAM1         12
+#define IRQ_NO_DMA1_STREAM2         13
+#define IRQ_NO_DMA1_STREAM3         14
+#define IRQ_NO_DMA1_STREAM4         15
+#define IRQ_NO_DMA1_STREAM5         16
+#define IRQ_NO_DMA1_STREAM6         17
+#define IRQ_NO_DMA1_STREAM7         47
+
 /*************** REGISTER DEFINITIONS *****************/
 typedef struct
 {
@@ -183,6 +230,42 @@ typedef struct
     volatile uint32_t FLTR;          /* FLTR register */
 } I2C_Register_Map_t;
 
+/* Register layout shared by TIM2-TIM5; the basic timers TIM6/TIM7 implement the subset up to ARR */
+typedef struct
+{
+    volatile uint32_t CR1;           /* Control register 1 */
+    volatile uint32_t CR2;           /* Control register 2 */
+    volatile uint32_t SMCR;          /* Slave mode control */
+    volatile uint32_t DIER;          /* DMA/interrupt enable */
+    volatile uint32_t SR;            /* Status register */
+    volatile uint32_t EGR;           /* Event generation */
+    volatile uint32_t CCMR1;         /* Capture/compare mode 1 */
+    volatile uint32_t CCMR2;         /* Capture/compare mode 2 */
+    volatile uint32_t CCER;          /* Capture/compare enable */
+    volatile uint32_t CNT;           /* Counter */
+    volatile uint32_t PSC;           /* Prescaler */
+    volatile uint32_t ARR;           /* Auto-reload */
+} TIM_Register_Map_t;
+
+typedef struct
+{
+    volatile uint32_t CR;            /* Stream configuration */
+    volatile uint32_t NDTR;          /* Number of data items left to transfer */
+    volatile uint32_t PAR;           /* Peripheral address */
+    volatile uint32_t M0AR;          /* Memory 0 address */
+    volatile uint32_t M1AR;          /* Memory 1 address (double buffer mode) */
+    volatile uint32_t FCR;           /* FIFO control */
+} DMA_Stream_Register_Map_t;
+
+typedef struct
+{
+    volatile uint32_t LISR;          /* Low interrupt status, streams 0-3 */
+    volatile uint32_t HISR;          /* High interrupt status, streams 4-7 */
+    volatile uint32_t LIFCR;         /* Low interrupt flag clear */
+    volatile uint32_t HIFCR;         /* High interrupt flag clear */
+    DMA_Stream_Register_Map_t STREAM[8];
+} DMA_Register_Map_t;
+
 /*************** PERIPHERAL POINTERS *****************/
 #define GPIOA           ( (GPIO_Register_Map_t*) GPIOA_BASE_ADDR )
 #define GPIOB           ( (GPIO_Register_Map_t*) GPIOB_BASE_ADDR )
@@ -202,6 +285,16 @@ typedef struct
 #define I2C2            ( (I2C_Register_Map_t*) I2C2_BASE_ADDR )
 #define I2C3            ( (I2C_Register_Map_t*) I2C3_BASE_ADDR )
 
+#define TIM2            ( (TIM_Register_Map_t*) TIM2_BASE_ADDR )
+#define TIM3            ( (TIM_Register_Map_t*) TIM3_BASE_ADDR )
+#define TIM4            ( (TIM_Register_Map_t*) TIM4_BASE_ADDR )
+#define TIM5            ( (TIM_Register_Map_t*) TIM5_BASE_ADDR )
+#define TIM6            ( (TIM_Register_Map_t*) TIM6_BASE_ADDR )
+#define TIM7            ( (TIM_Register_Map_t*) TIM7_BASE_ADDR )
+
+#define DMA1            ( (DMA_Register_Map_t*) DMA1_BASE_ADDR )
+#define DMA2            ( (DMA_Register_Map_t*) DMA2_BASE_ADDR )
+
 /*************** CLOCK ENABLE/DISABLE/RESET MACROS *****************/
 /* Enable GPIO clocks */
 #define GPIOA_PCLK_EN()         ( RCC->AHB1ENR |= ( 1 << 0 ) )
@@ -236,6 +329,18 @@ typedef struct
 #define I2C2_PCLK_RST()         ( RCC->APB1RSTR |= ( 1 << 22 ) )
 #define I2C3_PCLK_RST()         ( RCC->APB1RSTR |= ( 1 << 23 ) )
 
+/* Enable TIM clocks */
+#define TIM2_PCLK_EN()          ( RCC->APB1ENR |= ( 1 << 0 ) )
+#define TIM3_PCLK_EN()          ( RCC->APB1ENR |= ( 1 << 1 ) )
+#define TIM4_PCLK_EN()          ( RCC->APB1ENR |= ( 1 << 2 ) )
+#define TIM5_PCLK_EN()          ( RCC->APB1ENR |= ( 1 << 3 ) )
+#define TIM6_PCLK_EN()          ( RCC->APB1ENR |= ( 1 << 4 ) )
+#define TIM7_PCLK_EN()          ( RCC->APB1ENR |= ( 1 << 5 ) )
+
+/* Enable DMA clocks */
+#define DMA1_PCLK_EN()          ( RCC->AHB1ENR |= ( 1 << 21 ) )
+#define DMA2_PCLK_EN()          ( RCC->AHB1ENR |= ( 1 << 22 ) )
+
 #define SYSCFG_PCLK_EN()        ( RCC->APB2ENR |= ( 1 << 14 ) )
 
 /* Macros to reset GPIO peripherals */
@@ -251,8 +356,10 @@ typedef struct
 
 
 /* Includes for protocol-specific header files */
+#include "stm32f407xx_dma_driver.h"
 #include "stm32f407xx_i2c_driver.h"
 #include "stm32f407xx_rcc_driver.h"
 #include "stm32f407xx_gpio_driver.h"
+#include "stm32f407xx_tim_driver.h"
 
 #endif /* STM32F407XX_H_ */
@@ -0,0 +1,80 @@
+#ifndef INC_STM32F407XX_DMA_DRIVER_H_
+#define INC_STM32F407XX_DMA_DRIVER_H_
+
+#include "stm32f407xx.h"
+#include <stdint.h>
+
+/* One handle per DMA stream. Transfers are single-shot, byte wide, and run between a fixed peripheral
+ * register and an incrementing memory buffer in direct mode (no FIFO). Only the DMA1 stream interrupts
+ * are routed here; DMA1 carries the I2C requests. */
+typedef struct
+{
+    DMA_Register_Map_t      *p_dma_x;
+    uint8_t                 stream_num;             /* 0-7 */
+    uint8_t                 channel;                /* request channel on that stream, 0-7 */
+    uint8_t                 direction;              /* DMA_DIR_PERIPH_TO_MEM or DMA_DIR_MEM_TO_PERIPH */
+    uint8_t                 priority;               /* DMA_PRIORITY_LOW through DMA_PRIORITY_VERY_HIGH */
+    uint8_t                 irq_priority;
+    void                    (*p_complete_callback)(void);       /* optional; enables the TC interrupt */
+    void                    (*p_error_callback)(void);          /* optional; enables the TE/DME interrupts */
+} DMA_Handle_t;
+
+#define DMA_NUM_STREAMS                     8
+
+#define DMA_DIR_PERIPH_TO_MEM               0
+#define DMA_DIR_MEM_TO_PERIPH               1
+
+#define DMA_PRIORITY_LOW                    0
+#define DMA_PRIORITY_MEDIUM                 1
+#define DMA_PRIORITY_HIGH                   2
+#define DMA_PRIORITY_VERY_HIGH              3
+
+/*************** RELEVANT BIT POSITIONS FOR DMA PERIPHERAL REGISTERS *****************/
+/*************** DMA_SxCR bit positions and masks - Stream configuration register *****************/
+#define DMA_SxCR_EN_POS                     0   /* Stream enable; reads back 0 once the stream has stopped */
+#define DMA_SxCR_DMEIE_POS                  1   /* Direct mode error interrupt enable */
+#define DMA_SxCR_TEIE_POS                   2   /* Transfer error interrupt enable */
+#define DMA_SxCR_HTIE_POS                   3   /* Half transfer interrupt enable */
+#define DMA_SxCR_TCIE_POS                   4   /* Transfer complete interrupt enable */
+#define DMA_SxCR_DIR_POS                    6   /* Direction; 2 bits, 00 peripheral to memory, 01 memory to peripheral */
+#define DMA_SxCR_MINC_POS                   10  /* Memory address increment */
+#define DMA_SxCR_PL_POS                     16  /* Priority level; 2 bits */
+#define DMA_SxCR_CHSEL_POS                  25  /* Channel selection; 3 bits */
+
+typedef enum
+{
+    DMA_SxCR_EN_MASK                        = (0x1U << DMA_SxCR_EN_POS),
+    DMA_SxCR_DMEIE_MASK                     = (0x1U << DMA_SxCR_DMEIE_POS),
+    DMA_SxCR_TEIE_MASK                      = (0x1U << DMA_SxCR_TEIE_POS),
+    DMA_SxCR_HTIE_MASK                      = (0x1U << DMA_SxCR_HTIE_POS),
+    DMA_SxCR_TCIE_MASK                      = (0x1U << DMA_SxCR_TCIE_POS),
+    DMA_SxCR_DIR_MASK                       = (0x3U << DMA_SxCR_DIR_POS),
+    DMA_SxCR_MINC_MASK                      = (0x1U << DMA_SxCR_MINC_POS),
+    DMA_SxCR_PL_MASK                        = (0x3U << DMA_SxCR_PL_POS),
+    DMA_SxCR_CHSEL_MASK                     = (0x7U << DMA_SxCR_CHSEL_POS)
+} DMA_SxCR_Mask_t;
+
+/*************** DMA_LISR/HISR flags - one 6-bit group per stream *****************/
+/* Streams 0-3 live in LISR/LIFCR and streams 4-7 in HISR/HIFCR, at bit offsets 0, 6, 16 and 22 */
+#define DMA_ISR_FEIF_POS                    0   /* FIFO error */
+#define DMA_ISR_DMEIF_POS                   2   /* Direct mode error */
+#define DMA_ISR_TEIF_POS                    3   /* Transfer error */
+#define DMA_ISR_HTIF_POS                    4   /* Half transfer */
+#define DMA_ISR_TCIF_POS                    5   /* Transfer complete */
+
+typedef enum
+{
+    DMA_ISR_FEIF_MASK                       = (0x1U << DMA_ISR_FEIF_POS),
+    DMA_ISR_DMEIF_MASK                      = (0x1U << DMA_ISR_DMEIF_POS),
+    DMA_ISR_TEIF_MASK                       = (0x1U << DMA_ISR_TEIF_POS),
+    DMA_ISR_HTIF_MASK                       = (0x1U << DMA_ISR_HTIF_POS),
+    DMA_ISR_TCIF_MASK                       = (0x1U << DMA_ISR_TCIF_POS),
+    DMA_ISR_ALL_MASK                        = (0x3DU)
+} DMA_ISR_Mask_t;
+
+void DMA_Init(DMA_Handle_t *p_dma_handle);
+void DMA_Start(DMA_Handle_t *p_dma_handle, volatile uint32_t *p_periph_reg, uint8_t *p_mem, uint16_t len);
+void DMA_Stop(DMA_Handle_t *p_dma_handle);
+uint16_t DMA_Get_Remaining(DMA_Handle_t *p_dma_handle);
+
+#endif /* INC_STM32F407XX_DMA_DRIVER_H_ */
@@ -75,12 +75,14 @@ typedef enum
 void GPIO_Init(GPIO_Handle_t *p_gpio_handle);
 void GPIO_Cleanup(GPIO_Register_Map_t *p_gpio_x);
 void GPIO_Peri_Clk_Ctrl(GPIO_Register_Map_t *p_gpio_x, uint8_t enable);
+void GPIO_Set_Pin_Mode(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t mode);
 uint8_t GPIO_Read_From_Input_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num);
 uint16_t GPIO_Read_From_Input_Port(GPIO_Register_Map_t *p_gpio_x);
 
 /* WRITE FUNCTIONALITY */
 void GPIO_Write_To_Output_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t value);
 void GPIO_Write_To_Output_Port(GPIO_Register_Map_t *p_gpio_x, uint16_t value);
+void GPIO_Write_Set_Reset(GPIO_Register_Map_t *p_gpio_x, uint32_t set_reset_mask);
 void GPIO_Toggle_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num);
 
 /* INTERRUPT MANAGEMENT */
@@ -2,23 +2,71 @@
 #define STM32F407XX_I2C_DRIVER_H_
 
 #include "stm32f407xx.h"
+#include "stm32f407xx_dma_driver.h"
 #include "i2c.h"
 
-#define I2C_REG                             I2C1
 #define I2C_OWN_ADDR                        12
-/* Using I2C1 peripheral SDA over GPIOB, pin 7 */
-#define SDA_GPIO                            GPIOB
-#define SDA_PIN_NUM                         GPIO_PIN_7
-#define SDA_ALT_FUN                         4
-/* Using I2C1 peripheral SCL over GPIOB, pin 6 */
-#define SCL_GPIO                            GPIOB
-#define SCL_PIN_NUM                         GPIO_PIN_6
-#define SDA_ALT_FUN                         4
+/* I2C1: SCL on PB6, SDA on PB7. RX on DMA1 stream 0, TX on DMA1 stream 6, both channel 1 */
+#define I2C1_SCL_GPIO                       GPIOB
+#define I2C1_SCL_PIN_NUM                    GPIO_PIN_6
+#define I2C1_SDA_GPIO                       GPIOB
+#define I2C1_SDA_PIN_NUM                    GPIO_PIN_7
+#define I2C1_ALT_FUN                        4
+#define I2C1_DMA_RX_STREAM                  0
+#define I2C1_DMA_TX_STREAM                  6
+#define I2C1_DMA_CHANNEL                    1
+/* I2C2: SCL on PB10, SDA on PB11. RX on DMA1 stream 3, TX on DMA1 stream 7, both channel 7 */
+#define I2C2_SCL_GPIO                       GPIOB
+#define I2C2_SCL_PIN_NUM                    GPIO_PIN_10
+#define I2C2_SDA_GPIO                       GPIOB
+#define I2C2_SDA_PIN_NUM                    GPIO_PIN_11
+#define I2C2_ALT_FUN                        4
+#define I2C2_DMA_RX_STREAM                  3
+#define I2C2_DMA_TX_STREAM                  7
+#define I2C2_DMA_CHANNEL                    7
+/* I2C3: SCL on PA8, SDA on PC9. RX on DMA1 stream 2, TX on DMA1 stream 4, both channel 3 */
+#define I2C3_SCL_GPIO                       GPIOA
+#define I2C3_SCL_PIN_NUM                    GPIO_PIN_8
+#define I2C3_SDA_GPIO                       GPIOC
+#define I2C3_SDA_PIN_NUM                    GPIO_PIN_9
+#define I2C3_ALT_FUN                        4
+#define I2C3_DMA_RX_STREAM                  2
+#define I2C3_DMA_TX_STREAM                  4
+#define I2C3_DMA_CHANNEL                    3
+/* All three share DMA1; the streams above are picked so that no two instances collide */
+#define I2C_DMA                             DMA1
+#define I2C_DMA_IRQ_PRIORITY                1   /* same level as the I2C event interrupt, so neither preempts the other */
+#define I2C_ER_IRQ_PRIORITY                 1   /* likewise for the error interrupt */
+
+#define I2C_TIMEOUT_US                      10000   /* longest any single blocking wait may take */
+#define I2C_RECOVERY_HALF_PERIOD_US         5       /* SCL half period while clocking out a stuck slave, ~100kHz */
+#define I2C_START_WAIT_BITS                 4       /* a stop and a start behind the last byte written, with margin */
+
+/* Fixed wiring of one I2C peripheral. The DMA callbacks are bound to the instance, since the DMA driver's
+ * carry no context. */
+typedef struct
+{
+    I2C_Register_Map_t                      *p_i2c_x;
+    GPIO_Register_Map_t                     *p_scl_gpio;
+    uint8_t                                 scl_pin_num;
+    GPIO_Register_Map_t                     *p_sda_gpio;
+    uint8_t                                 sda_pin_num;
+    uint8_t                                 alt_fun;
+    uint8_t                                 er_irq_num;
+    uint8_t                                 dma_rx_stream;
+    uint8_t                                 dma_tx_stream;
+    uint8_t                                 dma_channel;
+    void                                    (*p_dma_rx_complete)(void);
+    void                                    (*p_dma_error)(void);
+} I2C_Config_t;
 
 typedef struct
 {
     I2C_Register_Map_t                      *p_i2c_x;
+    const I2C_Config_t                      *p_config;
     I2C_Device_t                            i2c_dev;
+    DMA_Handle_t                            dma_rx_handle;
+    DMA_Handle_t                            dma_tx_handle;
 } I2C_Handle_t;
 
 #define I2C1_EV_NVIC_POS                    31
@@ -28,10 +76,6 @@ typedef struct
 #define I2C3_EV_NVIC_POS                    72
 #define I2C3_ER_NVIC_POS                    73
 
-/* 2:1 or 16:9 for Tlow:Thigh clock signal (only applicable to fast mode) */
-#define I2C_FM_DUTY_2                       0
-#define I2C_FM_DUTY_16_9                    1
-
 #define I2C_SR1_CHECK                       0
 #define I2C_SR2_CHECK                       1
 
@@ -71,7 +115,7 @@ typedef enum
 } I2C_CR1_Mask_t;
 
 /*************** I2C_CR2 bit positions and masks - General control register *****************/
-#define I2C_CR2_FREQ_POS                    0   /* APB1 clock frequency value in MHz (6 bits, 0-5) */
+#define I2C_CR2_FREQ_POS                    0   /* APB1 clock frequency value in MHz (6 bits, 0-5), 2 to 42 */
 #define I2C_CR2_ITERREN_POS                 8   /* Error interrupt enable */
 #define I2C_CR2_ITEVTEN_POS                 9   /* Event interrupt enable */
 #define I2C_CR2_ITBUFEN_POS                 10  /* Buffer interrupt enable; causes TxE and RxNE to generate interrupts */
@@ -80,7 +124,7 @@ typedef enum
 
 typedef enum
 {
-    I2C_CR2_FREQ_MASK                       = (0x1FU << I2C_CR2_FREQ_POS),
+    I2C_CR2_FREQ_MASK                       = (0x3FU << I2C_CR2_FREQ_POS),
     I2C_CR2_ITERREN_MASK                    = (0x1U << I2C_CR2_ITERREN_POS),
     I2C_CR2_ITEVTEN_MASK                    = (0x1U << I2C_CR2_ITEVTEN_POS),
     I2C_CR2_ITBUFEN_MASK                    = (0x1U << I2C_CR2_ITBUFEN_POS),
@@ -185,7 +229,7 @@ typedef enum
 
 typedef enum
 {
-    I2C_TRISE_TRISE_MASK                    = (0x1FU << I2C_TRISE_TRISE_POS),
+    I2C_TRISE_TRISE_MASK                    = (0x3FU << I2C_TRISE_TRISE_POS),
 } I2C_TRISE_Mask_t;
 
 #endif /* STM32F407XX_I2C_DRIVER_H_ */
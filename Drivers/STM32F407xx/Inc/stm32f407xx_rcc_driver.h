@@ -9,6 +9,12 @@
 #define RCC_CFGR_PPRE1          10  /* APB1 prescaler; division from AHB clock to APB1 clock */
 #define RCC_CFGR_PPRE2          13  /* APB2 prescaler; division from AHB clock to APB2 clock */
 
+/* RCC_PLLCFGR - PLL configuration register; f(PLL) = f(source) / M * N / P */
+#define RCC_PLLCFGR_PLLM        0   /* Input division factor; 6 bits 0:5 */
+#define RCC_PLLCFGR_PLLN        6   /* VCO multiplication factor; 9 bits 6:14 */
+#define RCC_PLLCFGR_PLLP        16  /* Main output division factor; 2 bits 16:17, 00 = 2 up to 11 = 8 */
+#define RCC_PLLCFGR_PLLSRC      22  /* PLL source; 0 for HSI, 1 for HSE */
+
 typedef enum
 {
     SYS_CLK_HSI,
@@ -20,5 +26,6 @@ typedef enum
 uint32_t RCC_Get_Sys_Clk_Frequency();
 uint32_t RCC_Get_AHB_Prescaler();
 uint32_t RCC_Get_APB_Prescaler();
+uint32_t RCC_Get_APB1_Clk_Frequency();
 
 #endif /* INC_STM32F407XX_RCC_DRIVER_H_ */
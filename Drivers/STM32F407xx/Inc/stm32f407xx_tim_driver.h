@@ -0,0 +1,40 @@
+#ifndef INC_STM32F407XX_TIM_DRIVER_H_
+#define INC_STM32F407XX_TIM_DRIVER_H_
+
+#include "stm32f407xx.h"
+#include <stdint.h>
+
+/* Only the update (overflow) event is used: the timers here are periodic tick sources. */
+typedef struct
+{
+    TIM_Register_Map_t      *p_tim_x;
+    uint32_t                counter_freq_hz;        /* rate the counter ticks at after the prescaler */
+    uint32_t                period;                 /* counter ticks between update events */
+    uint8_t                 irq_priority;
+    void                    (*p_update_callback)(void);
+} TIM_Handle_t;
+
+/*************** RELEVANT BIT POSITIONS FOR TIM PERIPHERAL REGISTERS *****************/
+#define TIM_CR1_CEN_POS                     0   /* Counter enable */
+#define TIM_CR1_URS_POS                     2   /* Only counter overflow generates an update interrupt */
+#define TIM_CR1_ARPE_POS                    7   /* Auto-reload preload enable */
+#define TIM_DIER_UIE_POS                    0   /* Update interrupt enable */
+#define TIM_SR_UIF_POS                      0   /* Update interrupt flag */
+#define TIM_EGR_UG_POS                      0   /* Update generation; reloads prescaler and counter */
+
+typedef enum
+{
+    TIM_CR1_CEN_MASK                        = (0x1U << TIM_CR1_CEN_POS),
+    TIM_CR1_URS_MASK                        = (0x1U << TIM_CR1_URS_POS),
+    TIM_CR1_ARPE_MASK                       = (0x1U << TIM_CR1_ARPE_POS),
+    TIM_DIER_UIE_MASK                       = (0x1U << TIM_DIER_UIE_POS),
+    TIM_SR_UIF_MASK                         = (0x1U << TIM_SR_UIF_POS),
+    TIM_EGR_UG_MASK                         = (0x1U << TIM_EGR_UG_POS)
+} TIM_Mask_t;
+
+void TIM_Init(TIM_Handle_t *p_tim_handle);
+void TIM_Start(TIM_Handle_t *p_tim_handle);
+void TIM_Stop(TIM_Handle_t *p_tim_handle);
+uint8_t TIM_Is_Running(TIM_Handle_t *p_tim_handle);
+
+#endif /* INC_STM32F407XX_TIM_DRIVER_H_ */
@@ -14,7 +14,71 @@ uint8_t GET_BIT(volatile uint32_t REG, uint32_t MASK)
     return 0;
 }
 
+/* HCLK, which clocks the core and so CYCCNT */
+static uint32_t core_clk_frequency = HSI_CLK_SPEED;
+
 void delay(void)
 {
     for(uint32_t i = 0 ; i < 500000 ; i ++);
 }
+
+void Timebase_Init(void)
+{
+    /* DWT is only clocked while trace is enabled */
+    *CORE_DEMCR |= CORE_DEMCR_TRCENA_MASK;
+    *DWT_CYCCNT = 0;
+    *DWT_CTRL |= DWT_CTRL_CYCCNTENA_MASK;
+    Timebase_Clock_Changed();
+}
+
+void Timebase_Clock_Changed(void)
+{
+    core_clk_frequency = RCC_Get_Sys_Clk_Frequency() / RCC_Get_AHB_Prescaler();
+}
+
+uint32_t Timebase_Get_Core_Clk_Frequency(void)
+{
+    return core_clk_frequency;
+}
+
+uint32_t Timebase_Get_Cycles(void)
+{
+    return *DWT_CYCCNT;
+}
+
+/* Busy-waits for at least the requested time. Unsigned subtraction keeps this correct across a
+ * CYCCNT wrap, which happens every 268s at 16MHz and every 25s at 168MHz. */
+void Delay_Us(uint32_t us)
+{
+    if (!(*DWT_CTRL & DWT_CTRL_CYCCNTENA_MASK))
+    {
+        Timebase_Init();
+    }
+
+    uint32_t start = *DWT_CYCCNT;
+    uint32_t cycles = us * (core_clk_frequency / 1000000u);
+    while ((*DWT_CYCCNT - start) < cycles);
+}
+
+void Delay_Ms(uint32_t ms)
+{
+    while (ms > 0)
+    {
+        Delay_Us(1000);
+        ms--;
+    }
+}
+
+uint32_t Critical_Section_Enter(void)
+{
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" ::: "memory");
+    return primask;
+}
+
+void Critical_Section_Exit(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
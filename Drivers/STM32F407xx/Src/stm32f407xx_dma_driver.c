@@ -0,0 +1,183 @@
+#include <stddef.h>
+
+#include "stm32f407xx.h"
+#include "stm32f407xx_dma_driver.h"
+#include "stm32f407xx_gpio_driver.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static uint8_t DMA_Get_IRQ_Number(uint8_t stream_num);
+static uint8_t DMA_Get_Flag_Offset(uint8_t stream_num);
+static uint32_t DMA_Read_Flags(DMA_Handle_t *p_dma_handle);
+static void DMA_Clear_Flags(DMA_Handle_t *p_dma_handle, uint32_t flags);
+static void DMA_IRQ_Handling(uint8_t stream_num);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+/* DMA1 handles registered through DMA_Init(), looked up by the stream ISRs */
+static DMA_Handle_t *p_dma_handles[DMA_NUM_STREAMS];
+
+void DMA_Init(DMA_Handle_t *p_dma_handle)
+{
+    DMA_Stream_Register_Map_t *p_stream = &p_dma_handle->p_dma_x->STREAM[p_dma_handle->stream_num];
+    uint32_t cr = 0;
+    uint8_t irq_num;
+
+    if (p_dma_handle->p_dma_x == DMA1)
+        DMA1_PCLK_EN();
+    else
+        DMA2_PCLK_EN();
+
+    /* The configuration registers are only writable while the stream is off */
+    DMA_Stop(p_dma_handle);
+
+    cr |= (p_dma_handle->channel << DMA_SxCR_CHSEL_POS) & DMA_SxCR_CHSEL_MASK;
+    cr |= (p_dma_handle->priority << DMA_SxCR_PL_POS) & DMA_SxCR_PL_MASK;
+    cr |= (p_dma_handle->direction << DMA_SxCR_DIR_POS) & DMA_SxCR_DIR_MASK;
+    cr |= DMA_SxCR_MINC_MASK;
+    if (p_dma_handle->p_complete_callback != NULL)
+        cr |= DMA_SxCR_TCIE_MASK;
+    if (p_dma_handle->p_error_callback != NULL)
+        cr |= DMA_SxCR_TEIE_MASK | DMA_SxCR_DMEIE_MASK;
+
+    p_stream->CR = cr;
+    p_stream->FCR = 0;                  /* direct mode */
+
+    if (p_dma_handle->p_dma_x != DMA1 || (cr & (DMA_SxCR_TCIE_MASK | DMA_SxCR_TEIE_MASK)) == 0)
+        return;
+
+    p_dma_handles[p_dma_handle->stream_num] = p_dma_handle;
+    irq_num = DMA_Get_IRQ_Number(p_dma_handle->stream_num);
+    GPIO_IRQ_Priority_Config(irq_num, p_dma_handle->irq_priority);
+    GPIO_IRQ_Interrupt_Config(irq_num, ENABLE);
+}
+
+/* Arms the stream for one transfer of len bytes. The peripheral's own DMA request paces it from here. */
+void DMA_Start(DMA_Handle_t *p_dma_handle, volatile uint32_t *p_periph_reg, uint8_t *p_mem, uint16_t len)
+{
+    DMA_Stream_Register_Map_t *p_stream = &p_dma_handle->p_dma_x->STREAM[p_dma_handle->stream_num];
+
+    /* A stale TCIF from the last transfer would stop the stream from enabling */
+    DMA_Clear_Flags(p_dma_handle, DMA_ISR_ALL_MASK);
+    p_stream->PAR = (uint32_t) p_periph_reg;
+    p_stream->M0AR = (uint32_t) p_mem;
+    p_stream->NDTR = len;
+    p_stream->CR |= DMA_SxCR_EN_MASK;
+}
+
+void DMA_Stop(DMA_Handle_t *p_dma_handle)
+{
+    DMA_Stream_Register_Map_t *p_stream = &p_dma_handle->p_dma_x->STREAM[p_dma_handle->stream_num];
+
+    p_stream->CR &= ~DMA_SxCR_EN_MASK;
+    /* EN stays set until the current data item has been moved */
+    while (p_stream->CR & DMA_SxCR_EN_MASK);
+    DMA_Clear_Flags(p_dma_handle, DMA_ISR_ALL_MASK);
+}
+
+uint16_t DMA_Get_Remaining(DMA_Handle_t *p_dma_handle)
+{
+    return (uint16_t) p_dma_handle->p_dma_x->STREAM[p_dma_handle->stream_num].NDTR;
+}
+
+void DMA1_Stream0_IRQHandler(void)
+{
+    DMA_IRQ_Handling(0);
+}
+
+void DMA1_Stream1_IRQHandler(void)
+{
+    DMA_IRQ_Handling(1);
+}
+
+void DMA1_Stream2_IRQHandler(void)
+{
+    DMA_IRQ_Handling(2);
+}
+
+void DMA1_Stream3_IRQHandler(void)
+{
+    DMA_IRQ_Handling(3);
+}
+
+void DMA1_Stream4_IRQHandler(void)
+{
+    DMA_IRQ_Handling(4);
+}
+
+void DMA1_Stream5_IRQHandler(void)
+{
+    DMA_IRQ_Handling(5);
+}
+
+void DMA1_Stream6_IRQHandler(void)
+{
+    DMA_IRQ_Handling(6);
+}
+
+void DMA1_Stream7_IRQHandler(void)
+{
+    DMA_IRQ_Handling(7);
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void DMA_IRQ_Handling(uint8_t stream_num)
+{
+    DMA_Handle_t *p_dma_handle = p_dma_handles[stream_num];
+    uint32_t flags;
+
+    if (p_dma_handle == NULL)
+        return;
+
+    flags = DMA_Read_Flags(p_dma_handle);
+    DMA_Clear_Flags(p_dma_handle, flags);
+
+    if ((flags & (DMA_ISR_TEIF_MASK | DMA_ISR_DMEIF_MASK)) && p_dma_handle->p_error_callback != NULL)
+    {
+        p_dma_handle->p_error_callback();
+        return;
+    }
+
+    if ((flags & DMA_ISR_TCIF_MASK) && p_dma_handle->p_complete_callback != NULL)
+        p_dma_handle->p_complete_callback();
+}
+
+static uint8_t DMA_Get_IRQ_Number(uint8_t stream_num)
+{
+    switch (stream_num)
+    {
+    case 0: return IRQ_NO_DMA1_STREAM0;
+    case 1: return IRQ_NO_DMA1_STREAM1;
+    case 2: return IRQ_NO_DMA1_STREAM2;
+    case 3: return IRQ_NO_DMA1_STREAM3;
+    case 4: return IRQ_NO_DMA1_STREAM4;
+    case 5: return IRQ_NO_DMA1_STREAM5;
+    case 6: return IRQ_NO_DMA1_STREAM6;
+    default: return IRQ_NO_DMA1_STREAM7;
+    }
+}
+
+static uint8_t DMA_Get_Flag_Offset(uint8_t stream_num)
+{
+    static const uint8_t FLAG_OFFSETS[4] = { 0, 6, 16, 22 };
+
+    return FLAG_OFFSETS[stream_num % 4];
+}
+
+static uint32_t DMA_Read_Flags(DMA_Handle_t *p_dma_handle)
+{
+    uint8_t stream_num = p_dma_handle->stream_num;
+    uint32_t isr = (stream_num < 4) ? p_dma_handle->p_dma_x->LISR : p_dma_handle->p_dma_x->HISR;
+
+    return (isr >> DMA_Get_Flag_Offset(stream_num)) & DMA_ISR_ALL_MASK;
+}
+
+static void DMA_Clear_Flags(DMA_Handle_t *p_dma_handle, uint32_t flags)
+{
+    uint8_t stream_num = p_dma_handle->stream_num;
+    uint32_t clear_mask = (flags & DMA_ISR_ALL_MASK) << DMA_Get_Flag_Offset(stream_num);
+
+    /* Write-1-to-clear; zeros leave the other streams' flags alone */
+    if (stream_num < 4)
+        p_dma_handle->p_dma_x->LIFCR = clear_mask;
+    else
+        p_dma_handle->p_dma_x->HIFCR = clear_mask;
+}
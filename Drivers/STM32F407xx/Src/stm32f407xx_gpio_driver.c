@@ -162,10 +162,20 @@ void GPIO_Peri_Clk_Ctrl(GPIO_Register_Map_t *p_gpio_x, uint8_t enable)
     }
 }
 
+/* Changes only the MODER field of one pin, e.g. to turn a bidirectional bus around. Interrupt modes are not
+ * accepted here, those require the full GPIO_Init. */
+void GPIO_Set_Pin_Mode(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num, uint8_t mode)
+{
+    if (mode > GPIO_MODE_ANALOG)
+        return;
+
+    SET_FIELD(&p_gpio_x->MODER, (0b11 << (2 * pin_num)), mode);
+}
+
 /* Functions for reading GPIO values */
 uint8_t GPIO_Read_From_Input_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num)
 {
-    return GET_BIT(p_gpio_x->IDR, (pin_num << 0x1));
+    return GET_BIT(p_gpio_x->IDR, (0x1 << pin_num));
 }
 
 uint16_t GPIO_Read_From_Input_Port(GPIO_Register_Map_t *p_gpio_x)
@@ -191,6 +201,13 @@ void GPIO_Write_To_Output_Port(GPIO_Register_Map_t *p_gpio_x, uint16_t value)
     p_gpio_x->ODR = value;
 }
 
+/* Sets the pins in bits 0-15 and resets the pins in bits 16-31 with one BSRR store. Unlike the ODR writes
+ * above there is no read-modify-write, so pins not named in the mask are never disturbed. */
+void GPIO_Write_Set_Reset(GPIO_Register_Map_t *p_gpio_x, uint32_t set_reset_mask)
+{
+    p_gpio_x->BSRR = set_reset_mask;
+}
+
 void GPIO_Toggle_Pin(GPIO_Register_Map_t *p_gpio_x, uint8_t pin_num)
 {
     p_gpio_x->ODR ^= (1 << pin_num);
@@ -1,73 +1,266 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "stm32f407xx_i2c_driver.h"
 #include "stm32f407xx_rcc_driver.h"
 #include "stm32f407xx_gpio_driver.h"
 
 /*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
-static void I2C_Init(void);
-static void I2C_Master_Send(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
-static void I2C_Master_Send_IT(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
-static void I2C_Master_Receive(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr , uint8_t repeat_start);
-static void I2C_Master_Receive_IT(uint32_t len, uint8_t slave_addr , uint8_t repeat_start);
-static void I2C_DeInit(void);
-
-static void I2C_Handle_SB(void);
-static void I2C_Handle_ADDR(void);
-static void I2C_Handle_TXE(void);
-static void I2C_Handle_RXNE(void);
-
-static void I2C1_GPIO_Pin_Init(void);
+static I2C_Status_t I2C_Init(I2C_Handle_t *p_i2c_handle, I2C_Instance_t instance);
+static I2C_Status_t I2C_Master_Send(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t len,
+                                    uint8_t slave_addr, uint8_t repeat_start);
+static void I2C_Master_Send_IT(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,
+                               uint8_t repeat_start);
+static I2C_Status_t I2C_Master_Receive(I2C_Handle_t *p_i2c_handle, uint8_t *p_rx_buffer, uint32_t len,
+                                       uint8_t slave_addr , uint8_t repeat_start);
+static void I2C_Master_Receive_IT(I2C_Handle_t *p_i2c_handle, uint32_t len, uint8_t slave_addr ,
+                                  uint8_t repeat_start);
+static void I2C_Master_Send_DMA(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,
+                                uint8_t repeat_start);
+static void I2C_Master_Receive_DMA(I2C_Handle_t *p_i2c_handle, uint8_t *p_rx_buffer, uint32_t len,
+                                   uint8_t slave_addr, uint8_t repeat_start);
+static void I2C_Master_Write_Read_IT(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t tx_len,
+                                     uint32_t rx_len, uint8_t slave_addr);
+static uint8_t I2C_Queue_Transaction(I2C_Handle_t *p_i2c_handle, const I2C_Transaction_t *p_txn);
+static I2C_Status_t I2C_Set_Speed(I2C_Handle_t *p_i2c_handle, uint32_t clock_speed, uint8_t fm_duty_cycle);
+static I2C_Status_t I2C_Clock_Changed(I2C_Handle_t *p_i2c_handle);
+static void I2C_Check_Timeout(I2C_Handle_t *p_i2c_handle);
+static I2C_Status_t I2C_Recover_Bus(I2C_Handle_t *p_i2c_handle);
+static void I2C_Run_Pending_Recovery(I2C_Handle_t *p_i2c_handle);
+static void I2C_Get_Stats(I2C_Handle_t *p_i2c_handle, I2C_Stats_t *p_stats);
+static void I2C_Reset_Stats(I2C_Handle_t *p_i2c_handle);
+static void I2C_DeInit(I2C_Handle_t *p_i2c_handle);
+
+static uint8_t I2C_Enqueue(I2C_Handle_t *p_i2c_handle, const I2C_Transaction_t *p_txn);
+static uint8_t I2C_Enqueue_Ring_Write(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, const I2C_Transaction_t *p_txn);
+static void I2C_Refuse_Transaction(const I2C_Transaction_t *p_txn);
+static void I2C_Start_Transaction(I2C_Handle_t *p_i2c_handle, I2C_Transaction_t *p_txn);
+static void I2C_Start_Write_Phase(I2C_Handle_t *p_i2c_handle, I2C_Transaction_t *p_txn);
+static void I2C_Start_Read_Phase(I2C_Handle_t *p_i2c_handle, I2C_Transaction_t *p_txn);
+static void I2C_Issue_Start(I2C_Handle_t *p_i2c_handle);
+static void I2C_Phase_Complete(I2C_Handle_t *p_i2c_handle);
+static void I2C_Retire_Transaction(I2C_Handle_t *p_i2c_handle, I2C_Status_t status);
+static void I2C_Abort_Transaction(I2C_Handle_t *p_i2c_handle, I2C_Status_t status);
+static void I2C_Write_Done(void *p_context, I2C_Status_t status);
+static void I2C_Read_Done(void *p_context, I2C_Status_t status);
+static void I2C_Wait_For_Idle(I2C_Handle_t *p_i2c_handle);
+
+static I2C_Status_t I2C_Wait_For_Flag(I2C_Handle_t *p_i2c_handle, uint8_t flag_num, uint8_t sr_1_or_2);
+static I2C_Status_t I2C_Get_Error_Status(uint32_t sr1);
+static void I2C_Clear_Error_Flags(I2C_Handle_t *p_i2c_handle);
+static I2C_Status_t I2C_End_Blocking(I2C_Handle_t *p_i2c_handle, I2C_Status_t status);
+static uint8_t I2C_Deadline_Passed(uint32_t start_cycles, uint32_t budget_cycles);
+static void I2C_Reset_Peripheral(I2C_Handle_t *p_i2c_handle);
+
+static void I2C_Handle_SB(I2C_Handle_t *p_i2c_handle);
+static void I2C_Handle_ADDR(I2C_Handle_t *p_i2c_handle);
+static void I2C_Handle_TXE(I2C_Handle_t *p_i2c_handle);
+static void I2C_Handle_RXNE(I2C_Handle_t *p_i2c_handle);
+static uint8_t I2C_RX_Ring_Write(I2C_Handle_t *p_i2c_handle, uint8_t byte);
+static void I2C_Handle_BTF_DMA(I2C_Handle_t *p_i2c_handle);
+static void I2C_DMA_RX_Complete(I2C_Handle_t *p_i2c_handle);
+static void I2C_DMA_Error(I2C_Handle_t *p_i2c_handle);
+static void I2C_Finish_DMA(I2C_Handle_t *p_i2c_handle);
+static void I2C_EV_IRQ_Handling(I2C_Handle_t *p_i2c_handle);
+static void I2C_ER_IRQ_Handling(I2C_Handle_t *p_i2c_handle);
+static void I2C1_DMA_RX_Complete(void);
+static void I2C2_DMA_RX_Complete(void);
+static void I2C3_DMA_RX_Complete(void);
+static void I2C1_DMA_Error(void);
+static void I2C2_DMA_Error(void);
+static void I2C3_DMA_Error(void);
+
+static void I2C_GPIO_Pin_Init(I2C_Handle_t *p_i2c_handle);
 static void I2C_Clk_Ctrl(I2C_Register_Map_t *p_i2c_x, uint8_t enable);
+static void I2C_DMA_Init(I2C_Handle_t *p_i2c_handle);
 static void I2C_Generate_Start_Condition(I2C_Handle_t *p_i2c_handle);
 static void I2C_Generate_Stop_Condition(I2C_Handle_t *p_i2c_handle);
-static void I2C_Enable_Interrupts(void);
-static void I2C_Set_Interrupt_Priority(uint8_t priority);
+static void I2C_Enable_Interrupts(I2C_Handle_t *p_i2c_handle);
+static void I2C_Set_Interrupt_Priority(I2C_Handle_t *p_i2c_handle, uint8_t priority);
 static uint8_t I2C_Check_Status_Flag(I2C_Handle_t *p_i2c_handle, uint8_t flag_num, uint8_t sr_1_or_2);
 static void I2C_Write_Address_Byte(I2C_Handle_t *p_i2c_handle, uint8_t slave_addr, uint8_t read_or_write);
 static void I2C_Ack_Control(I2C_Register_Map_t *p_i2c_x, uint8_t enable);
-static void I2C_Configure_Clock_Registers(I2C_Handle_t *p_i2c_handle);
-static void I2C_Set_CR2_Freq(I2C_Register_Map_t *p_i2c_x, uint32_t sys_clk_freq);
-static void I2C_Set_CCR(I2C_Handle_t *p_i2c_handle, uint32_t sys_clk_freq);
-static void I2C_Configure_TRISE(I2C_Handle_t *p_i2c_handle, uint32_t sys_clk_freq);
+static I2C_Status_t I2C_Configure_Clock_Registers(I2C_Handle_t *p_i2c_handle);
+static uint8_t I2C_Set_CR2_Freq(I2C_Register_Map_t *p_i2c_x, uint32_t apb1_clk_freq);
+static void I2C_Set_CCR(I2C_Handle_t *p_i2c_handle, uint32_t apb1_clk_freq);
+static void I2C_Configure_TRISE(I2C_Handle_t *p_i2c_handle, uint32_t apb1_clk_freq);
 static void I2C_Set_Own_Address(I2C_Handle_t *p_i2c_handle);
 /*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
 
 /*************** LOCAL I2C DRIVER VARIABLES START *****************/
-static I2C_Handle_t p_i2c_handle;
-
-static uint8_t p_tx_ring_buffer[TX_RING_BUFFER_SIZE];
-static uint8_t p_rx_ring_buffer[RX_RING_BUFFER_SIZE];
-
-/* Implements the I2C interface defined in Inc/i2c.h for a STM32F407 I2C peripheral */
-static I2C_Interface_t i2c_driver = {
-        .Initialize             = I2C_Init,
-        .Write_Bytes            = I2C_Master_Send,
-        .Write_Bytes_IT         = I2C_Master_Send_IT,
-        .Read_Bytes             = I2C_Master_Receive,
-        .Read_Bytes_IT          = I2C_Master_Receive_IT,
-        .Deinitialize           = I2C_DeInit,
+static I2C_Handle_t i2c_handles[I2C_NUM_INSTANCES];
+
+static uint8_t tx_ring_storage[I2C_NUM_INSTANCES][TX_RING_BUFFER_SIZE];
+static uint8_t rx_ring_storage[I2C_NUM_INSTANCES][RX_RING_BUFFER_SIZE];
+
+static const I2C_Config_t i2c_configs[I2C_NUM_INSTANCES] = {
+        [I2C_INSTANCE_1] = {
+                .p_i2c_x                = I2C1,
+                .p_scl_gpio             = I2C1_SCL_GPIO,
+                .scl_pin_num            = I2C1_SCL_PIN_NUM,
+                .p_sda_gpio             = I2C1_SDA_GPIO,
+                .sda_pin_num            = I2C1_SDA_PIN_NUM,
+                .alt_fun                = I2C1_ALT_FUN,
+                .er_irq_num             = I2C1_ER_NVIC_POS,
+                .dma_rx_stream          = I2C1_DMA_RX_STREAM,
+                .dma_tx_stream          = I2C1_DMA_TX_STREAM,
+                .dma_channel            = I2C1_DMA_CHANNEL,
+                .p_dma_rx_complete      = I2C1_DMA_RX_Complete,
+                .p_dma_error            = I2C1_DMA_Error,
+        },
+        [I2C_INSTANCE_2] = {
+                .p_i2c_x                = I2C2,
+                .p_scl_gpio             = I2C2_SCL_GPIO,
+                .scl_pin_num            = I2C2_SCL_PIN_NUM,
+                .p_sda_gpio             = I2C2_SDA_GPIO,
+                .sda_pin_num            = I2C2_SDA_PIN_NUM,
+                .alt_fun                = I2C2_ALT_FUN,
+                .er_irq_num             = I2C2_ER_NVIC_POS,
+                .dma_rx_stream          = I2C2_DMA_RX_STREAM,
+                .dma_tx_stream          = I2C2_DMA_TX_STREAM,
+                .dma_channel            = I2C2_DMA_CHANNEL,
+                .p_dma_rx_complete      = I2C2_DMA_RX_Complete,
+                .p_dma_error            = I2C2_DMA_Error,
+        },
+        [I2C_INSTANCE_3] = {
+                .p_i2c_x                = I2C3,
+                .p_scl_gpio             = I2C3_SCL_GPIO,
+                .scl_pin_num            = I2C3_SCL_PIN_NUM,
+                .p_sda_gpio             = I2C3_SDA_GPIO,
+                .sda_pin_num            = I2C3_SDA_PIN_NUM,
+                .alt_fun                = I2C3_ALT_FUN,
+                .er_irq_num             = I2C3_ER_NVIC_POS,
+                .dma_rx_stream          = I2C3_DMA_RX_STREAM,
+                .dma_tx_stream          = I2C3_DMA_TX_STREAM,
+                .dma_channel            = I2C3_DMA_CHANNEL,
+                .p_dma_rx_complete      = I2C3_DMA_RX_Complete,
+                .p_dma_error            = I2C3_DMA_Error,
+        },
 };
 
-I2C_Interface_t *get_i2c_interface(void)
+/* The interface in Inc/i2c.h takes no handle, so every instance gets its own table of thin functions bound to
+ * its handle. Each implements the I2C interface for one STM32F407 I2C peripheral. */
+#define I2C_DEFINE_INTERFACE(n)                                                                                 \
+    static I2C_Status_t I2C##n##_Init(void)                                                                     \
+    {                                                                                                           \
+        return I2C_Init(&i2c_handles[I2C_INSTANCE_##n], I2C_INSTANCE_##n);                                             \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Master_Send(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,            \
+                                             uint8_t repeat_start)                                              \
+    {                                                                                                           \
+        return I2C_Master_Send(&i2c_handles[I2C_INSTANCE_##n], p_tx_buffer, len, slave_addr, repeat_start);     \
+    }                                                                                                           \
+    static void I2C##n##_Master_Send_IT(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,                 \
+                                        uint8_t repeat_start)                                                   \
+    {                                                                                                           \
+        I2C_Master_Send_IT(&i2c_handles[I2C_INSTANCE_##n], p_tx_buffer, len, slave_addr, repeat_start);         \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Master_Receive(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr,         \
+                                                uint8_t repeat_start)                                           \
+    {                                                                                                           \
+        return I2C_Master_Receive(&i2c_handles[I2C_INSTANCE_##n], p_rx_buffer, len, slave_addr, repeat_start);  \
+    }                                                                                                           \
+    static void I2C##n##_Master_Receive_IT(uint32_t len, uint8_t slave_addr, uint8_t repeat_start)              \
+    {                                                                                                           \
+        I2C_Master_Receive_IT(&i2c_handles[I2C_INSTANCE_##n], len, slave_addr, repeat_start);                   \
+    }                                                                                                           \
+    static void I2C##n##_Master_Send_DMA(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,                \
+                                         uint8_t repeat_start)                                                  \
+    {                                                                                                           \
+        I2C_Master_Send_DMA(&i2c_handles[I2C_INSTANCE_##n], p_tx_buffer, len, slave_addr, repeat_start);        \
+    }                                                                                                           \
+    static void I2C##n##_Master_Receive_DMA(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr,             \
+                                            uint8_t repeat_start)                                               \
+    {                                                                                                           \
+        I2C_Master_Receive_DMA(&i2c_handles[I2C_INSTANCE_##n], p_rx_buffer, len, slave_addr, repeat_start);     \
+    }                                                                                                           \
+    static void I2C##n##_Master_Write_Read_IT(uint8_t *p_tx_buffer, uint32_t tx_len, uint32_t rx_len,           \
+                                              uint8_t slave_addr)                                               \
+    {                                                                                                           \
+        I2C_Master_Write_Read_IT(&i2c_handles[I2C_INSTANCE_##n], p_tx_buffer, tx_len, rx_len, slave_addr);      \
+    }                                                                                                           \
+    static uint8_t I2C##n##_Queue_Transaction(const I2C_Transaction_t *p_txn)                                   \
+    {                                                                                                           \
+        return I2C_Queue_Transaction(&i2c_handles[I2C_INSTANCE_##n], p_txn);                                    \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Set_Speed(uint32_t clock_speed, uint8_t fm_duty_cycle)                         \
+    {                                                                                                           \
+        return I2C_Set_Speed(&i2c_handles[I2C_INSTANCE_##n], clock_speed, fm_duty_cycle);                       \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Clock_Changed(void)                                                            \
+    {                                                                                                           \
+        return I2C_Clock_Changed(&i2c_handles[I2C_INSTANCE_##n]);                                               \
+    }                                                                                                           \
+    static void I2C##n##_Check_Timeout(void)                                                                    \
+    {                                                                                                           \
+        I2C_Check_Timeout(&i2c_handles[I2C_INSTANCE_##n]);                                                      \
+    }                                                                                                           \
+    static I2C_Status_t I2C##n##_Recover_Bus(void)                                                              \
+    {                                                                                                           \
+        return I2C_Recover_Bus(&i2c_handles[I2C_INSTANCE_##n]);                                                 \
+    }                                                                                                           \
+    static void I2C##n##_Get_Stats(I2C_Stats_t *p_stats)                                                        \
+    {                                                                                                           \
+        I2C_Get_Stats(&i2c_handles[I2C_INSTANCE_##n], p_stats);                                                 \
+    }                                                                                                           \
+    static void I2C##n##_Reset_Stats(void)                                                                      \
+    {                                                                                                           \
+        I2C_Reset_Stats(&i2c_handles[I2C_INSTANCE_##n]);                                                        \
+    }                                                                                                           \
+    static void I2C##n##_DeInit(void)                                                                           \
+    {                                                                                                           \
+        I2C_DeInit(&i2c_handles[I2C_INSTANCE_##n]);                                                             \
+    }                                                                                                           \
+    static I2C_Interface_t i2c##n##_driver = {                                                                  \
+            .Initialize             = I2C##n##_Init,                                                            \
+            .Write_Bytes            = I2C##n##_Master_Send,                                                     \
+            .Write_Bytes_IT         = I2C##n##_Master_Send_IT,                                                  \
+            .Read_Bytes             = I2C##n##_Master_Receive,                                                  \
+            .Read_Bytes_IT          = I2C##n##_Master_Receive_IT,                                               \
+            .Write_Bytes_DMA        = I2C##n##_Master_Send_DMA,                                                 \
+            .Read_Bytes_DMA         = I2C##n##_Master_Receive_DMA,                                              \
+            .Write_Read_IT          = I2C##n##_Master_Write_Read_IT,                                            \
+            .Queue_Transaction      = I2C##n##_Queue_Transaction,                                               \
+            .Set_Speed              = I2C##n##_Set_Speed,                                                       \
+            .Clock_Changed          = I2C##n##_Clock_Changed,                                                   \
+            .Check_Timeout          = I2C##n##_Check_Timeout,                                                   \
+            .Recover_Bus            = I2C##n##_Recover_Bus,                                                     \
+            .Get_Stats              = I2C##n##_Get_Stats,                                                       \
+            .Reset_Stats            = I2C##n##_Reset_Stats,                                                     \
+            .Deinitialize           = I2C##n##_DeInit,                                                          \
+    };
+
+I2C_DEFINE_INTERFACE(1)
+I2C_DEFINE_INTERFACE(2)
+I2C_DEFINE_INTERFACE(3)
+
+I2C_Interface_t *get_i2c_interface(I2C_Instance_t instance)
 {
-    return &i2c_driver;
+    switch (instance)
+    {
+    case I2C_INSTANCE_1:
+        return &i2c1_driver;
+    case I2C_INSTANCE_2:
+        return &i2c2_driver;
+    case I2C_INSTANCE_3:
+        return &i2c3_driver;
+    default:
+        return NULL;
+    }
 }
 /*************** LOCAL I2C DRIVER VARIABLES END *****************/
 
 /*************** INTERFACE IMPLEMENTATION FUNCTIONS START *****************/
 // Driver functions in order defined above
-static void I2C_Init(void)
+/* Everything is set up even if APB1 is out of range, so a later Clock_Changed() only has to enable it */
+static I2C_Status_t I2C_Init(I2C_Handle_t *p_i2c_handle, I2C_Instance_t instance)
 {
+    I2C_Status_t status;
     I2C_Device_t i2c_dev = {
+            .instance = instance,
             .clock_speed = I2C_SPEED_SM,
+            .fm_duty_cycle = I2C_FM_DUTY_2,
             .own_address = I2C_OWN_ADDR,
-            .p_tx_buffer = p_tx_ring_buffer,
-            .tx_ring_buffer_write_ptr = 0,
-            .tx_ring_buffer_read_ptr = 0,
-            .p_rx_buffer = p_rx_ring_buffer,
-            .rx_ring_buffer_write_ptr = 0,
-            .rx_ring_buffer_read_ptr = 0,
             .tx_len = 0,
             .rx_len = 0,
             .rx_size = 0,
@@ -75,269 +268,943 @@ static void I2C_Init(void)
             .slave_addr = 0,
             .repeat_start = I2C_DISABLE_SR,
             .ack_ctrl = I2C_ACK_EN,
+            .txn_queue_head = 0,
+            .txn_queue_count = 0,
+            .txn_start_cycles = 0,
+            .txn_budget_cycles = 0,
+            .recovery_pending = 0,
     };
 
-    p_i2c_handle.p_i2c_x = I2C_REG;
-    p_i2c_handle.i2c_dev = i2c_dev;
-    I2C1_GPIO_Pin_Init();
-    I2C_Clk_Ctrl(p_i2c_handle.p_i2c_x, ENABLE);
-    I2C_Configure_Clock_Registers(&p_i2c_handle);
-    I2C_Set_Own_Address(&p_i2c_handle);
-    SET_BIT(I2C_REG->CR1, I2C_CR1_PE_MASK);
-    I2C_Enable_Interrupts();
-    I2C_Set_Interrupt_Priority(16);
-    I2C_Ack_Control(p_i2c_handle.p_i2c_x, p_i2c_handle.i2c_dev.ack_ctrl);
+    p_i2c_handle->p_config = &i2c_configs[instance];
+    p_i2c_handle->p_i2c_x = p_i2c_handle->p_config->p_i2c_x;
+    p_i2c_handle->i2c_dev = i2c_dev;
+    Ring_Buffer_Init(&p_i2c_handle->i2c_dev.tx_ring, tx_ring_storage[instance], TX_RING_BUFFER_SIZE);
+    Ring_Buffer_Init(&p_i2c_handle->i2c_dev.rx_ring, rx_ring_storage[instance], RX_RING_BUFFER_SIZE);
+    I2C_GPIO_Pin_Init(p_i2c_handle);
+    I2C_Clk_Ctrl(p_i2c_handle->p_i2c_x, ENABLE);
+    if (!(*DWT_CTRL & DWT_CTRL_CYCCNTENA_MASK))
+    {
+        /* Every wait is bounded by the cycle counter */
+        Timebase_Init();
+    }
+    I2C_DMA_Init(p_i2c_handle);
+    status = I2C_Configure_Clock_Registers(p_i2c_handle);
+    I2C_Set_Own_Address(p_i2c_handle);
+    if (status == I2C_OK)
+        SET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_PE_MASK);
+    I2C_Enable_Interrupts(p_i2c_handle);
+    I2C_Set_Interrupt_Priority(p_i2c_handle, 16);
+    SET_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITERREN_MASK);
+    GPIO_IRQ_Priority_Config(p_i2c_handle->p_config->er_irq_num, I2C_ER_IRQ_PRIORITY);
+    GPIO_IRQ_Interrupt_Config(p_i2c_handle->p_config->er_irq_num, ENABLE);
+    I2C_Ack_Control(p_i2c_handle->p_i2c_x, p_i2c_handle->i2c_dev.ack_ctrl);
+    return status;
 }
 
-static void I2C_Master_Send(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start)
+static I2C_Status_t I2C_Master_Send(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t len,
+                                    uint8_t slave_addr, uint8_t repeat_start)
 {
+    I2C_Status_t status;
+
+    I2C_Wait_For_Idle(p_i2c_handle);
+    /* Errors are polled here; the error interrupt belongs to the queued transfers */
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITERREN_MASK);
+
     /* Sequence diagram for master transmission is on page 849 of the board reference manual */
     /* 1) Generate start condition */
-    I2C_Generate_Start_Condition(&p_i2c_handle);
+    I2C_Generate_Start_Condition(p_i2c_handle);
 
     /* 2) EV5: Start Bit (SB) in SR1. Check SB flag in SR1 to clear EV5 */
-    while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_SB_POS, I2C_SR1_CHECK));
+    status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_SB_POS, I2C_SR1_CHECK);
+    if (status != I2C_OK)
+        return I2C_End_Blocking(p_i2c_handle, status);
 
     /* 3) EV6: ADDR bit set high (meaning address was matched, ACK received from slave) */
-    I2C_Write_Address_Byte(&p_i2c_handle, slave_addr, I2C_WRITE);
-    while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_ADDR_POS, I2C_SR1_CHECK));
+    I2C_Write_Address_Byte(p_i2c_handle, slave_addr, I2C_WRITE);
+    status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_ADDR_POS, I2C_SR1_CHECK);
+    if (status != I2C_OK)
+        return I2C_End_Blocking(p_i2c_handle, status);
 
-    if (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK));
+    /* Reading SR2 after SR1 clears ADDR */
+    I2C_Check_Status_Flag(p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
 
     while (len > 0)
     {
         /* 4) EV8_1: TxE = 1, transmit buffer is empty. Write data to DR. */
-        while(!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_TXE_POS, I2C_SR1_CHECK));
-        p_i2c_handle.p_i2c_x->DR = *p_tx_buffer;
+        status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_TXE_POS, I2C_SR1_CHECK);
+        if (status != I2C_OK)
+            return I2C_End_Blocking(p_i2c_handle, status);
+        p_i2c_handle->p_i2c_x->DR = *p_tx_buffer;
         p_tx_buffer++;
         len--;
     }
 
     /* 5) After every byte has been sent, wait for TXE=1 and BTF=1. Generate the stop condition. */
-    while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_TXE_POS, I2C_SR1_CHECK));
-    while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_BTF_POS, I2C_SR1_CHECK));
+    status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_TXE_POS, I2C_SR1_CHECK);
+    if (status == I2C_OK)
+        status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_BTF_POS, I2C_SR1_CHECK);
+    if (status != I2C_OK)
+        return I2C_End_Blocking(p_i2c_handle, status);
+
     if (repeat_start == I2C_DISABLE_SR)
     {
-        I2C_Generate_Stop_Condition(&p_i2c_handle);
+        I2C_Generate_Stop_Condition(p_i2c_handle);
     }
+    return I2C_End_Blocking(p_i2c_handle, I2C_OK);
 }
 
-static void I2C_Master_Send_IT(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start)
+static void I2C_Master_Send_IT(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,
+                               uint8_t repeat_start)
 {
-    if (p_i2c_handle.i2c_dev.control_stage == I2C_CTRL_IDLE)
-    {
-        /* Enable I2C interrupts */
-        p_i2c_handle.p_i2c_x->CR2 |= ( 1 << I2C_CR2_ITBUFEN_POS );
-        p_i2c_handle.p_i2c_x->CR2 |= ( 1 << I2C_CR2_ITEVTEN_POS );
+    I2C_Transaction_t txn = {
+            .slave_addr = slave_addr,
+            .p_tx_buffer = NULL,
+            .tx_len = len,
+            .p_rx_buffer = NULL,
+            .rx_len = 0,
+            .repeat_start = repeat_start,
+            .p_callback = I2C_Write_Done,
+            .p_context = p_i2c_handle,
+    };
 
-        /* Fill the I2C TX ring buffer with the data to be sent. */
-        I2C_TX_Ring_Buffer_Write(&p_i2c_handle.i2c_dev, p_tx_buffer, len);
-        p_i2c_handle.i2c_dev.tx_len = len;
-        p_i2c_handle.i2c_dev.slave_addr = slave_addr;
-        p_i2c_handle.i2c_dev.repeat_start = repeat_start;
-        p_i2c_handle.i2c_dev.control_stage = I2C_CTRL_BUSY_TX;
-        I2C_Generate_Start_Condition(&p_i2c_handle);
-    }
+    if (!I2C_Enqueue_Ring_Write(p_i2c_handle, p_tx_buffer, &txn))
+        I2C_Refuse_Transaction(&txn);
 }
 
-static void I2C_Master_Receive(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr , uint8_t repeat_start)
+static I2C_Status_t I2C_Master_Receive(I2C_Handle_t *p_i2c_handle, uint8_t *p_rx_buffer, uint32_t len,
+                                       uint8_t slave_addr , uint8_t repeat_start)
 {
-    I2C_Generate_Start_Condition(&p_i2c_handle);
+    I2C_Status_t status;
+
+    I2C_Wait_For_Idle(p_i2c_handle);
+    /* Errors are polled here; the error interrupt belongs to the queued transfers */
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITERREN_MASK);
+    I2C_Generate_Start_Condition(p_i2c_handle);
 
     /* 1) Wait for SB to indicate start condition created. */
-    while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_SB_POS, I2C_SR1_CHECK));
+    status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_SB_POS, I2C_SR1_CHECK);
+    if (status != I2C_OK)
+        return I2C_End_Blocking(p_i2c_handle, status);
 
     /* 2) Write slave address to DR. */
-    I2C_Write_Address_Byte(&p_i2c_handle, slave_addr, I2C_READ);
+    I2C_Write_Address_Byte(p_i2c_handle, slave_addr, I2C_READ);
 
-    /* 3) Wait for ADDR bit to go high (meaning address was matched, ACK received from slave). */
-    /* TODO: Add timeout in case of NACK for address. */
-    while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_ADDR_POS, I2C_SR1_CHECK));
-    if (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK)) {}
+    /* 3) Wait for ADDR bit to go high (meaning address was matched, ACK received from slave). A NACK for the
+     * address ends the wait with I2C_ERR_NACK. */
+    status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_ADDR_POS, I2C_SR1_CHECK);
+    if (status != I2C_OK)
+        return I2C_End_Blocking(p_i2c_handle, status);
 
     if (len == 1)
     {
-        /* If only sending 1 byte, NACK must be sent on first byte. */
-        I2C_Ack_Control(p_i2c_handle.p_i2c_x, DISABLE);
-        while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_RXNE_POS, I2C_SR1_CHECK));
-        I2C_Generate_Stop_Condition(&p_i2c_handle);
-        *p_rx_buffer = p_i2c_handle.p_i2c_x->DR;
+        /* If only receiving 1 byte, NACK must be sent on first byte, so ACK goes before ADDR is cleared. */
+        I2C_Ack_Control(p_i2c_handle->p_i2c_x, DISABLE);
+        I2C_Check_Status_Flag(p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
+        status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_RXNE_POS, I2C_SR1_CHECK);
+        if (status != I2C_OK)
+            return I2C_End_Blocking(p_i2c_handle, status);
+        I2C_Generate_Stop_Condition(p_i2c_handle);
+        *p_rx_buffer = p_i2c_handle->p_i2c_x->DR;
     }
     else
     {
+        I2C_Check_Status_Flag(p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
+
         /* 4) Wait for RxNE equal 1, meaning DR is full. */
         while (len > 0)
         {
-            while (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_RXNE_POS, I2C_SR1_CHECK));
+            status = I2C_Wait_For_Flag(p_i2c_handle, I2C_SR1_RXNE_POS, I2C_SR1_CHECK);
+            if (status != I2C_OK)
+                return I2C_End_Blocking(p_i2c_handle, status);
             if (len == 2)
             {
                 /* Last byte must be NACKed. When len = 1, ACK must be disabled. */
-                I2C_Ack_Control(p_i2c_handle.p_i2c_x, DISABLE);
-                I2C_Generate_Stop_Condition(&p_i2c_handle);
+                I2C_Ack_Control(p_i2c_handle->p_i2c_x, DISABLE);
+                I2C_Generate_Stop_Condition(p_i2c_handle);
             }
-            *p_rx_buffer = p_i2c_handle.p_i2c_x->DR;
+            *p_rx_buffer = p_i2c_handle->p_i2c_x->DR;
             p_rx_buffer++;
             len--;
         }
     }
 
-    if (p_i2c_handle.i2c_dev.ack_ctrl == I2C_ACK_EN)
+    return I2C_End_Blocking(p_i2c_handle, I2C_OK);
+}
+
+static void I2C_Master_Receive_IT(I2C_Handle_t *p_i2c_handle, uint32_t len, uint8_t slave_addr , uint8_t repeat_start)
+{
+    I2C_Transaction_t txn = {
+            .slave_addr = slave_addr,
+            .p_tx_buffer = NULL,
+            .tx_len = 0,
+            .p_rx_buffer = NULL,
+            .rx_len = len,
+            .repeat_start = repeat_start,
+            .p_callback = I2C_Read_Done,
+            .p_context = p_i2c_handle,
+    };
+
+    if (!I2C_Queue_Transaction(p_i2c_handle, &txn))
+        I2C_Refuse_Transaction(&txn);
+}
+
+/* Only SB, ADDR and the closing BTF interrupt; DMA feeds DR on each TXE */
+static void I2C_Master_Send_DMA(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr,
+                                uint8_t repeat_start)
+{
+    I2C_Transaction_t txn = {
+            .slave_addr = slave_addr,
+            .p_tx_buffer = p_tx_buffer,
+            .tx_len = len,
+            .p_rx_buffer = NULL,
+            .rx_len = 0,
+            .repeat_start = repeat_start,
+            .p_callback = I2C_Write_Done,
+            .p_context = p_i2c_handle,
+    };
+
+    if (!I2C_Queue_Transaction(p_i2c_handle, &txn))
+        I2C_Refuse_Transaction(&txn);
+}
+
+/* Only SB, ADDR and the DMA transfer complete interrupt; DMA empties DR on each RXNE */
+static void I2C_Master_Receive_DMA(I2C_Handle_t *p_i2c_handle, uint8_t *p_rx_buffer, uint32_t len,
+                                   uint8_t slave_addr, uint8_t repeat_start)
+{
+    I2C_Transaction_t txn = {
+            .slave_addr = slave_addr,
+            .p_tx_buffer = NULL,
+            .tx_len = 0,
+            .p_rx_buffer = p_rx_buffer,
+            .rx_len = len,
+            .repeat_start = repeat_start,
+            .p_callback = I2C_Read_Done,
+            .p_context = p_i2c_handle,
+    };
+
+    if (!I2C_Queue_Transaction(p_i2c_handle, &txn))
+        I2C_Refuse_Transaction(&txn);
+}
+
+/* Writes tx_len bytes, then reads rx_len back into the RX ring behind a repeated start, as one queued
+ * transaction. Only I2C_Read_Complete_Callback fires, once the read is done. */
+static void I2C_Master_Write_Read_IT(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, uint32_t tx_len,
+                                     uint32_t rx_len, uint8_t slave_addr)
+{
+    I2C_Transaction_t txn = {
+            .slave_addr = slave_addr,
+            .p_tx_buffer = NULL,
+            .tx_len = tx_len,
+            .p_rx_buffer = NULL,
+            .rx_len = rx_len,
+            .repeat_start = I2C_DISABLE_SR,
+            .p_callback = I2C_Read_Done,
+            .p_context = p_i2c_handle,
+    };
+
+    if (!I2C_Enqueue_Ring_Write(p_i2c_handle, p_tx_buffer, &txn))
+        I2C_Refuse_Transaction(&txn);
+}
+
+static uint8_t I2C_Queue_Transaction(I2C_Handle_t *p_i2c_handle, const I2C_Transaction_t *p_txn)
+{
+    uint32_t primask = Critical_Section_Enter();
+    uint8_t queued = I2C_Enqueue(p_i2c_handle, p_txn);
+
+    Critical_Section_Exit(primask);
+    return queued;
+}
+
+static I2C_Status_t I2C_Set_Speed(I2C_Handle_t *p_i2c_handle, uint32_t clock_speed, uint8_t fm_duty_cycle)
+{
+    if (clock_speed == 0)
+        clock_speed = I2C_SPEED_SM;
+    else if (clock_speed > I2C_SPEED_FM)
+        clock_speed = I2C_SPEED_FM;
+
+    I2C_Wait_For_Idle(p_i2c_handle);
+    p_i2c_handle->i2c_dev.clock_speed = clock_speed;
+    p_i2c_handle->i2c_dev.fm_duty_cycle = fm_duty_cycle;
+    return I2C_Clock_Changed(p_i2c_handle);
+}
+
+/* With APB1 out of range the peripheral is left disabled, until a call with the clock back in range */
+static I2C_Status_t I2C_Clock_Changed(I2C_Handle_t *p_i2c_handle)
+{
+    uint32_t start_cycles;
+    I2C_Status_t status;
+
+    /* Every deadline from here on is counted in cycles of the new core clock */
+    Timebase_Clock_Changed();
+    I2C_Wait_For_Idle(p_i2c_handle);
+    /* Let a stop still in progress finish, since CCR and TRISE can only be written with PE clear */
+    start_cycles = Timebase_Get_Cycles();
+    while (GET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_STOP_MASK)
+            && !I2C_Deadline_Passed(start_cycles, I2C_TIMEOUT_US * (Timebase_Get_Core_Clk_Frequency() / 1000000u)));
+
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_PE_MASK);
+    status = I2C_Configure_Clock_Registers(p_i2c_handle);
+    if (status != I2C_OK)
+        return status;
+    SET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_PE_MASK);
+    /* Clearing PE clears ACK too */
+    I2C_Ack_Control(p_i2c_handle->p_i2c_x, p_i2c_handle->i2c_dev.ack_ctrl);
+    return I2C_OK;
+}
+
+static void I2C_Check_Timeout(I2C_Handle_t *p_i2c_handle)
+{
+    uint32_t primask = Critical_Section_Enter();
+
+    if (p_i2c_handle->i2c_dev.control_stage != I2C_CTRL_IDLE
+            && I2C_Deadline_Passed(p_i2c_handle->i2c_dev.txn_start_cycles, p_i2c_handle->i2c_dev.txn_budget_cycles))
     {
-        I2C_Ack_Control(p_i2c_handle.p_i2c_x, ENABLE);
+        I2C_Abort_Transaction(p_i2c_handle, I2C_ERR_TIMEOUT);
     }
+    Critical_Section_Exit(primask);
+
+    I2C_Run_Pending_Recovery(p_i2c_handle);
+}
 
-    if ( repeat_start == I2C_DISABLE_SR )
+/* A slave reset or glitched mid-read keeps driving SDA low while it waits for clocks that never come, and the
+ * peripheral then sees the bus as permanently busy. Up to nine clocks finish off its byte, after which a stop
+ * is sent by hand. The peripheral is reset as well, since BUSY can stay stuck after such a glitch. */
+static I2C_Status_t I2C_Recover_Bus(I2C_Handle_t *p_i2c_handle)
+{
+    const I2C_Config_t *p_config = p_i2c_handle->p_config;
+    uint8_t sda_released;
+
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_PE_MASK);
+    GPIO_Write_To_Output_Pin(p_config->p_sda_gpio, p_config->sda_pin_num, HIGH);
+    GPIO_Write_To_Output_Pin(p_config->p_scl_gpio, p_config->scl_pin_num, HIGH);
+    GPIO_Set_Pin_Mode(p_config->p_sda_gpio, p_config->sda_pin_num, GPIO_MODE_OUT);
+    GPIO_Set_Pin_Mode(p_config->p_scl_gpio, p_config->scl_pin_num, GPIO_MODE_OUT);
+    Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
+
+    for (uint8_t i = 0; i < 9 && !GPIO_Read_From_Input_Pin(p_config->p_sda_gpio, p_config->sda_pin_num); i++)
     {
-        I2C_Generate_Stop_Condition(&p_i2c_handle);
+        GPIO_Write_To_Output_Pin(p_config->p_scl_gpio, p_config->scl_pin_num, LOW);
+        Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
+        GPIO_Write_To_Output_Pin(p_config->p_scl_gpio, p_config->scl_pin_num, HIGH);
+        Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
     }
+
+    /* Stop condition: SDA rises while SCL is high */
+    GPIO_Write_To_Output_Pin(p_config->p_scl_gpio, p_config->scl_pin_num, LOW);
+    Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
+    GPIO_Write_To_Output_Pin(p_config->p_sda_gpio, p_config->sda_pin_num, LOW);
+    Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
+    GPIO_Write_To_Output_Pin(p_config->p_scl_gpio, p_config->scl_pin_num, HIGH);
+    Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
+    GPIO_Write_To_Output_Pin(p_config->p_sda_gpio, p_config->sda_pin_num, HIGH);
+    Delay_Us(I2C_RECOVERY_HALF_PERIOD_US);
+    sda_released = GPIO_Read_From_Input_Pin(p_config->p_sda_gpio, p_config->sda_pin_num);
+
+    GPIO_Set_Pin_Mode(p_config->p_sda_gpio, p_config->sda_pin_num, GPIO_MODE_ALT);
+    GPIO_Set_Pin_Mode(p_config->p_scl_gpio, p_config->scl_pin_num, GPIO_MODE_ALT);
+    I2C_Reset_Peripheral(p_i2c_handle);
+
+    return sda_released ? I2C_OK : I2C_ERR_BUS;
 }
 
-static void I2C_Master_Receive_IT(uint32_t len, uint8_t slave_addr , uint8_t repeat_start)
+/* The recovery's bit-banged clocks take around 100us, too long for an interrupt or with interrupts masked, so
+ * an abort only asks for it. It runs here with interrupts enabled; nothing is started on the bus meanwhile,
+ * and whatever queued up behind the failed transaction goes out once it is done. */
+static void I2C_Run_Pending_Recovery(I2C_Handle_t *p_i2c_handle)
 {
-    if (p_i2c_handle.i2c_dev.control_stage == I2C_CTRL_IDLE)
-    {
-        /* Set the interrupt enable bits for events and buffer events. */
-        p_i2c_handle.p_i2c_x->CR2 |= ( 1 << I2C_CR2_ITBUFEN_POS );
-        p_i2c_handle.p_i2c_x->CR2 |= ( 1 << I2C_CR2_ITEVTEN_POS );
+    I2C_Device_t *p_dev = &p_i2c_handle->i2c_dev;
+    uint32_t primask;
 
-        p_i2c_handle.i2c_dev.rx_len = len;
-        p_i2c_handle.i2c_dev.rx_size = len;
-        p_i2c_handle.i2c_dev.slave_addr = slave_addr;
-        p_i2c_handle.i2c_dev.repeat_start = repeat_start;
-        p_i2c_handle.i2c_dev.control_stage = I2C_CTRL_BUSY_RX;
-        I2C_Generate_Start_Condition(&p_i2c_handle);
-    }
+    if (!p_dev->recovery_pending)
+        return;
+
+    I2C_Recover_Bus(p_i2c_handle);
+
+    primask = Critical_Section_Enter();
+    p_dev->recovery_pending = 0;
+    if (p_dev->control_stage == I2C_CTRL_IDLE && p_dev->txn_queue_count > 0)
+        I2C_Start_Transaction(p_i2c_handle, &p_dev->txn_queue[p_dev->txn_queue_head]);
+    Critical_Section_Exit(primask);
+}
+
+static void I2C_Get_Stats(I2C_Handle_t *p_i2c_handle, I2C_Stats_t *p_stats)
+{
+    uint32_t primask = Critical_Section_Enter();
+
+    *p_stats = p_i2c_handle->i2c_dev.stats;
+    Critical_Section_Exit(primask);
+}
+
+static void I2C_Reset_Stats(I2C_Handle_t *p_i2c_handle)
+{
+    uint32_t primask = Critical_Section_Enter();
+
+    memset(&p_i2c_handle->i2c_dev.stats, 0, sizeof(p_i2c_handle->i2c_dev.stats));
+    Critical_Section_Exit(primask);
 }
 
-static void I2C_DeInit(void)
+static void I2C_DeInit(I2C_Handle_t *p_i2c_handle)
 {
     /* TODO: Implement I2C deinitialization. */
 }
 /*************** INTERFACE IMPLEMENTATION FUNCTIONS END *****************/
 
+/*************** TRANSACTION QUEUE START *****************/
+/* Called with interrupts masked. Puts the transaction straight on the bus if nothing is ahead of it. */
+static uint8_t I2C_Enqueue(I2C_Handle_t *p_i2c_handle, const I2C_Transaction_t *p_txn)
+{
+    I2C_Device_t *p_dev = &p_i2c_handle->i2c_dev;
+
+    if (p_dev->txn_queue_count == I2C_QUEUE_SIZE || (p_txn->tx_len == 0 && p_txn->rx_len == 0))
+        return 0;
+
+    p_dev->txn_queue[(p_dev->txn_queue_head + p_dev->txn_queue_count) % I2C_QUEUE_SIZE] = *p_txn;
+    p_dev->txn_queue_count++;
+
+    if (p_dev->control_stage == I2C_CTRL_IDLE && !p_dev->recovery_pending)
+        I2C_Start_Transaction(p_i2c_handle, &p_dev->txn_queue[p_dev->txn_queue_head]);
+
+    return 1;
+}
+
+/* The bytes wait in the TX ring behind those of any ring write already queued, so they are only copied in
+ * once the transaction is sure of a place in the queue and the ring has room for all of them */
+static uint8_t I2C_Enqueue_Ring_Write(I2C_Handle_t *p_i2c_handle, uint8_t *p_tx_buffer, const I2C_Transaction_t *p_txn)
+{
+    uint32_t primask = Critical_Section_Enter();
+    uint8_t queued = 0;
+
+    if (p_i2c_handle->i2c_dev.txn_queue_count < I2C_QUEUE_SIZE
+            && Ring_Buffer_Write(&p_i2c_handle->i2c_dev.tx_ring, p_tx_buffer, p_txn->tx_len))
+    {
+        queued = I2C_Enqueue(p_i2c_handle, p_txn);
+    }
+    Critical_Section_Exit(primask);
+    return queued;
+}
+
+/* An _IT or _DMA call that found no room still gets its answer, straight away rather than from an interrupt */
+static void I2C_Refuse_Transaction(const I2C_Transaction_t *p_txn)
+{
+    p_txn->p_callback(p_txn->p_context, I2C_ERR_BUSY);
+}
+
+static void I2C_Start_Transaction(I2C_Handle_t *p_i2c_handle, I2C_Transaction_t *p_txn)
+{
+    /* The deadline allows nine bit times per byte, plus the address bytes, on top of the fixed timeout */
+    uint32_t byte_time_us = 9000000u / p_i2c_handle->i2c_dev.clock_speed + 1;
+    uint32_t budget_us = I2C_TIMEOUT_US + (p_txn->tx_len + p_txn->rx_len + 2) * byte_time_us;
+
+    p_i2c_handle->i2c_dev.txn_start_cycles = Timebase_Get_Cycles();
+    p_i2c_handle->i2c_dev.txn_budget_cycles = budget_us * (Timebase_Get_Core_Clk_Frequency() / 1000000u);
+
+    if (p_txn->tx_len > 0)
+        I2C_Start_Write_Phase(p_i2c_handle, p_txn);
+    else
+        I2C_Start_Read_Phase(p_i2c_handle, p_txn);
+}
+
+static void I2C_Start_Write_Phase(I2C_Handle_t *p_i2c_handle, I2C_Transaction_t *p_txn)
+{
+    p_i2c_handle->i2c_dev.tx_len = p_txn->tx_len;
+    p_i2c_handle->i2c_dev.slave_addr = p_txn->slave_addr;
+    /* A read phase follows the write behind a repeated start rather than a stop */
+    p_i2c_handle->i2c_dev.repeat_start = (p_txn->rx_len > 0) ? I2C_ENABLE_SR : p_txn->repeat_start;
+
+    if (p_txn->p_tx_buffer != NULL)
+    {
+        p_i2c_handle->i2c_dev.control_stage = I2C_CTRL_BUSY_TX_DMA;
+
+        /* Armed before the start condition; DMAEN goes on with the start, and the first request comes once
+         * ADDR is cleared */
+        DMA_Start(&p_i2c_handle->dma_tx_handle, &p_i2c_handle->p_i2c_x->DR, p_txn->p_tx_buffer, p_txn->tx_len);
+        CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+    }
+    else
+    {
+        p_i2c_handle->i2c_dev.control_stage = I2C_CTRL_BUSY_TX;
+        SET_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+    }
+    I2C_Issue_Start(p_i2c_handle);
+}
+
+static void I2C_Start_Read_Phase(I2C_Handle_t *p_i2c_handle, I2C_Transaction_t *p_txn)
+{
+    p_i2c_handle->i2c_dev.rx_len = p_txn->rx_len;
+    p_i2c_handle->i2c_dev.rx_size = p_txn->rx_len;
+    p_i2c_handle->i2c_dev.slave_addr = p_txn->slave_addr;
+    p_i2c_handle->i2c_dev.repeat_start = p_txn->repeat_start;
+
+    if (p_txn->p_rx_buffer != NULL)
+    {
+        p_i2c_handle->i2c_dev.control_stage = I2C_CTRL_BUSY_RX_DMA;
+
+        DMA_Start(&p_i2c_handle->dma_rx_handle, &p_i2c_handle->p_i2c_x->DR, p_txn->p_rx_buffer, p_txn->rx_len);
+        if (p_txn->rx_len > 1)
+        {
+            /* LAST makes the peripheral NACK the byte after the DMA's last-but-one EOT, i.e. the final byte.
+             * A single byte is NACKed through the ACK bit in the ADDR handler instead. */
+            SET_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_LAST_MASK);
+        }
+        CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+    }
+    else
+    {
+        p_i2c_handle->i2c_dev.control_stage = I2C_CTRL_BUSY_RX;
+        SET_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+    }
+    I2C_Issue_Start(p_i2c_handle);
+}
+
+/* Starts the phase already set up in control_stage, arming the event interrupt for its SB and, for a DMA phase,
+ * the DMA requests. A write that has just finished leaves TXE and BTF set until the repeated start, or the
+ * stop and start, behind it go out, and the event interrupt would be pending that whole time, as would a TX
+ * stream's request. SB is then due within I2C_START_WAIT_BITS SCL periods and is waited for here, with both
+ * held off. A bus that does not get there has stalled, and the transaction is aborted as on any other timeout. */
+static void I2C_Issue_Start(I2C_Handle_t *p_i2c_handle)
+{
+    I2C_Ctrl_Stage_t stage = p_i2c_handle->i2c_dev.control_stage;
+    uint32_t arm = I2C_CR2_ITEVTEN_MASK;
+    uint32_t budget_cycles;
+    uint32_t start_cycles;
+
+    if (stage == I2C_CTRL_BUSY_TX_DMA || stage == I2C_CTRL_BUSY_RX_DMA)
+        arm |= I2C_CR2_DMAEN_MASK;
+
+    if (!(p_i2c_handle->p_i2c_x->SR1 & (I2C_SR1_TXE_MASK | I2C_SR1_BTF_MASK)))
+    {
+        SET_BIT(p_i2c_handle->p_i2c_x->CR2, arm);
+        I2C_Generate_Start_Condition(p_i2c_handle);
+        return;
+    }
+
+    budget_cycles = (I2C_START_WAIT_BITS * 1000000u / p_i2c_handle->i2c_dev.clock_speed + 1)
+                    * (Timebase_Get_Core_Clk_Frequency() / 1000000u);
+    start_cycles = Timebase_Get_Cycles();
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITEVTEN_MASK);
+    I2C_Generate_Start_Condition(p_i2c_handle);
+    while (!GET_BIT(p_i2c_handle->p_i2c_x->SR1, I2C_SR1_SB_MASK))
+    {
+        if (I2C_Deadline_Passed(start_cycles, budget_cycles))
+        {
+            I2C_Abort_Transaction(p_i2c_handle, I2C_ERR_TIMEOUT);
+            return;
+        }
+    }
+    SET_BIT(p_i2c_handle->p_i2c_x->CR2, arm);
+}
+
+/* End of a write or read phase, in the event or DMA interrupt. A write with a read behind it carries straight
+ * on; otherwise the transaction is retired and the next one started before its callback runs, so the bus is
+ * already busy again by the time the application hears about it. */
+static void I2C_Phase_Complete(I2C_Handle_t *p_i2c_handle)
+{
+    I2C_Device_t *p_dev = &p_i2c_handle->i2c_dev;
+    I2C_Transaction_t *p_txn = &p_dev->txn_queue[p_dev->txn_queue_head];
+    I2C_Ctrl_Stage_t stage = p_dev->control_stage;
+
+    if ((stage == I2C_CTRL_BUSY_TX || stage == I2C_CTRL_BUSY_TX_DMA) && p_txn->rx_len > 0)
+    {
+        I2C_Start_Read_Phase(p_i2c_handle, p_txn);
+        return;
+    }
+
+    I2C_Retire_Transaction(p_i2c_handle, I2C_OK);
+}
+
+static void I2C_Retire_Transaction(I2C_Handle_t *p_i2c_handle, I2C_Status_t status)
+{
+    I2C_Device_t *p_dev = &p_i2c_handle->i2c_dev;
+    I2C_Transaction_t *p_txn = &p_dev->txn_queue[p_dev->txn_queue_head];
+    void (*p_callback)(void *p_context, I2C_Status_t status) = p_txn->p_callback;
+    void *p_context = p_txn->p_context;
+    uint32_t latency_us = (Timebase_Get_Cycles() - p_dev->txn_start_cycles) / (Timebase_Get_Core_Clk_Frequency() / 1000000u);
+
+    /* Timed before the next transaction restarts the clock */
+    I2C_Stats_Record(&p_dev->stats, p_txn, status, latency_us);
+
+    p_dev->txn_queue_head = (p_dev->txn_queue_head + 1) % I2C_QUEUE_SIZE;
+    p_dev->txn_queue_count--;
+    p_dev->control_stage = I2C_CTRL_IDLE;
+
+    if (p_dev->txn_queue_count > 0 && !p_dev->recovery_pending)
+        I2C_Start_Transaction(p_i2c_handle, &p_dev->txn_queue[p_dev->txn_queue_head]);
+
+    if (p_callback != NULL)
+        p_callback(p_context, status);
+}
+
+/* Takes the failed transaction off the bus and hands the status to its owner. Called from the error, DMA and
+ * event interrupts, or with interrupts masked, so a bus recovery is left to I2C_Run_Pending_Recovery(). */
+static void I2C_Abort_Transaction(I2C_Handle_t *p_i2c_handle, I2C_Status_t status)
+{
+    I2C_Ctrl_Stage_t stage = p_i2c_handle->i2c_dev.control_stage;
+    uint32_t unsent;
+
+    if (stage == I2C_CTRL_BUSY_TX_DMA)
+        DMA_Stop(&p_i2c_handle->dma_tx_handle);
+    else if (stage == I2C_CTRL_BUSY_RX_DMA)
+        DMA_Stop(&p_i2c_handle->dma_rx_handle);
+    I2C_Finish_DMA(p_i2c_handle);
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+
+    if (status == I2C_ERR_BUS || status == I2C_ERR_TIMEOUT)
+    {
+        /* The peripheral is held off until I2C_Run_Pending_Recovery() has clocked the bus free */
+        CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITEVTEN_MASK);
+        CLEAR_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_PE_MASK);
+        p_i2c_handle->i2c_dev.recovery_pending = 1;
+    }
+    else if (status != I2C_ERR_ARB_LOST)
+    {
+        /* After a NACK or overrun the peripheral still owns the bus; losing arbitration already gave it up */
+        I2C_Generate_Stop_Condition(p_i2c_handle);
+    }
+    I2C_Ack_Control(p_i2c_handle->p_i2c_x, p_i2c_handle->i2c_dev.ack_ctrl);
+
+    if (stage == I2C_CTRL_BUSY_TX)
+    {
+        /* The rest of a ring-based write must not go out at the front of the next one */
+        unsent = Ring_Buffer_Count(&p_i2c_handle->i2c_dev.tx_ring);
+        if (unsent > p_i2c_handle->i2c_dev.tx_len)
+            unsent = p_i2c_handle->i2c_dev.tx_len;
+        Ring_Buffer_Commit(&p_i2c_handle->i2c_dev.tx_ring, unsent);
+    }
+    p_i2c_handle->i2c_dev.tx_len = 0;
+    p_i2c_handle->i2c_dev.rx_len = 0;
+
+    if (stage != I2C_CTRL_IDLE)
+        I2C_Retire_Transaction(p_i2c_handle, status);
+}
+
+/* Completions for the single-phase interface calls, which report through the device level callbacks. The
+ * context is the handle the call was made on. */
+static void I2C_Write_Done(void *p_context, I2C_Status_t status)
+{
+    I2C_Handle_t *p_i2c_handle = (I2C_Handle_t *) p_context;
+
+    if (status == I2C_OK)
+        I2C_Write_Complete_Callback(&p_i2c_handle->i2c_dev);
+    else
+        I2C_Error_Callback(&p_i2c_handle->i2c_dev, status);
+}
+
+static void I2C_Read_Done(void *p_context, I2C_Status_t status)
+{
+    I2C_Handle_t *p_i2c_handle = (I2C_Handle_t *) p_context;
+
+    if (status == I2C_OK)
+        I2C_Read_Complete_Callback(&p_i2c_handle->i2c_dev);
+    else
+        I2C_Error_Callback(&p_i2c_handle->i2c_dev, status);
+}
+
+/* The blocking transfers drive the same registers, so anything queued goes out first. Each transaction ahead
+ * is bounded by its own deadline. */
+static void I2C_Wait_For_Idle(I2C_Handle_t *p_i2c_handle)
+{
+    do
+    {
+        /* Also runs a pending recovery, which may start the queue up again */
+        I2C_Check_Timeout(p_i2c_handle);
+    } while (p_i2c_handle->i2c_dev.control_stage != I2C_CTRL_IDLE);
+}
+/*************** TRANSACTION QUEUE END *****************/
+
 /*************** INTERRUPT HANDLERS START *****************/
-/* Overrides STM32F407 I2C interrupt, which is defined in the interrupt vector table.
- * Decodes the event type, routes to appropriate handler */
+/* Override the STM32F407 I2C interrupts, which are defined in the interrupt vector table */
 void I2C1_EV_IRQHandler(void)
 {
-    if ( GET_BIT(I2C_REG->SR1, I2C_SR1_SB_MASK) )
+    I2C_EV_IRQ_Handling(&i2c_handles[I2C_INSTANCE_1]);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+    I2C_ER_IRQ_Handling(&i2c_handles[I2C_INSTANCE_1]);
+}
+
+void I2C2_EV_IRQHandler(void)
+{
+    I2C_EV_IRQ_Handling(&i2c_handles[I2C_INSTANCE_2]);
+}
+
+void I2C2_ER_IRQHandler(void)
+{
+    I2C_ER_IRQ_Handling(&i2c_handles[I2C_INSTANCE_2]);
+}
+
+void I2C3_EV_IRQHandler(void)
+{
+    I2C_EV_IRQ_Handling(&i2c_handles[I2C_INSTANCE_3]);
+}
+
+void I2C3_ER_IRQHandler(void)
+{
+    I2C_ER_IRQ_Handling(&i2c_handles[I2C_INSTANCE_3]);
+}
+
+/* The DMA driver's callbacks carry no context, so each instance has its own pair */
+static void I2C1_DMA_RX_Complete(void)
+{
+    I2C_DMA_RX_Complete(&i2c_handles[I2C_INSTANCE_1]);
+}
+
+static void I2C2_DMA_RX_Complete(void)
+{
+    I2C_DMA_RX_Complete(&i2c_handles[I2C_INSTANCE_2]);
+}
+
+static void I2C3_DMA_RX_Complete(void)
+{
+    I2C_DMA_RX_Complete(&i2c_handles[I2C_INSTANCE_3]);
+}
+
+static void I2C1_DMA_Error(void)
+{
+    I2C_DMA_Error(&i2c_handles[I2C_INSTANCE_1]);
+}
+
+static void I2C2_DMA_Error(void)
+{
+    I2C_DMA_Error(&i2c_handles[I2C_INSTANCE_2]);
+}
+
+static void I2C3_DMA_Error(void)
+{
+    I2C_DMA_Error(&i2c_handles[I2C_INSTANCE_3]);
+}
+
+/* Decodes the event type, routes to appropriate handler */
+static void I2C_EV_IRQ_Handling(I2C_Handle_t *p_i2c_handle)
+{
+    p_i2c_handle->i2c_dev.stats.ev_irqs++;
+
+    if ( GET_BIT(p_i2c_handle->p_i2c_x->SR1, I2C_SR1_SB_MASK) )
     {
         /* Handle EV5 - SB is set */
-        I2C_Handle_SB();
+        I2C_Handle_SB(p_i2c_handle);
         return;
     }
-    else if ( GET_BIT(I2C_REG->SR1, I2C_SR1_ADDR_MASK) )
+    else if ( GET_BIT(p_i2c_handle->p_i2c_x->SR1, I2C_SR1_ADDR_MASK) )
     {
         /* Handle EV6 - ADDR is set */
-        I2C_Handle_ADDR();
+        I2C_Handle_ADDR(p_i2c_handle);
         return;
     }
-    else if ( GET_BIT(I2C_REG->SR1, I2C_SR1_TXE_MASK) )
+    else if (p_i2c_handle->i2c_dev.control_stage == I2C_CTRL_BUSY_TX_DMA)
     {
-        /* Handle EV8_1, EV8_2 and EV8 - both shift register and DR empty */
-        I2C_Handle_TXE();
+        /* TXE is left to the DMA; only the final BTF matters here */
+        if ( GET_BIT(p_i2c_handle->p_i2c_x->SR1, I2C_SR1_BTF_MASK) )
+        {
+            I2C_Handle_BTF_DMA(p_i2c_handle);
+        }
         return;
     }
-    else if ( GET_BIT(I2C_REG->SR1, I2C_SR1_RXNE_MASK) )
+    else if (p_i2c_handle->i2c_dev.control_stage == I2C_CTRL_BUSY_RX_DMA)
     {
-        I2C_Handle_RXNE();
+        /* RXNE is left to the DMA; the transfer ends in its transfer complete interrupt */
         return;
     }
+    else if (p_i2c_handle->i2c_dev.control_stage == I2C_CTRL_BUSY_RX)
+    {
+        /* Only RXNE is ours; the write phase's TXE and BTF are gone by the time SB arms this interrupt */
+        if ( GET_BIT(p_i2c_handle->p_i2c_x->SR1, I2C_SR1_RXNE_MASK) )
+        {
+            I2C_Handle_RXNE(p_i2c_handle);
+        }
+        return;
+    }
+    else if ( GET_BIT(p_i2c_handle->p_i2c_x->SR1, I2C_SR1_TXE_MASK) )
+    {
+        /* Handle EV8_1, EV8_2 and EV8 - both shift register and DR empty */
+        I2C_Handle_TXE(p_i2c_handle);
+        return;
+    }
+}
+
+/* Every error ends the transaction on the bus */
+static void I2C_ER_IRQ_Handling(I2C_Handle_t *p_i2c_handle)
+{
+    I2C_Status_t status = I2C_Get_Error_Status(p_i2c_handle->p_i2c_x->SR1);
+
+    p_i2c_handle->i2c_dev.stats.er_irqs++;
+    if (status == I2C_OK)
+        return;
+
+    I2C_Clear_Error_Flags(p_i2c_handle);
+    I2C_Abort_Transaction(p_i2c_handle, status);
 }
 
-static void I2C_Handle_SB(void)
+static void I2C_Handle_SB(I2C_Handle_t *p_i2c_handle)
 {
-    if (p_i2c_handle.i2c_dev.control_stage == I2C_CTRL_BUSY_TX)
+    I2C_Ctrl_Stage_t stage = p_i2c_handle->i2c_dev.control_stage;
+
+    if (stage == I2C_CTRL_BUSY_TX || stage == I2C_CTRL_BUSY_TX_DMA)
     {
-        I2C_Write_Address_Byte(&p_i2c_handle, p_i2c_handle.i2c_dev.slave_addr, I2C_WRITE);
+        I2C_Write_Address_Byte(p_i2c_handle, p_i2c_handle->i2c_dev.slave_addr, I2C_WRITE);
     }
-    else if (p_i2c_handle.i2c_dev.control_stage == I2C_CTRL_BUSY_RX)
+    else if (stage == I2C_CTRL_BUSY_RX || stage == I2C_CTRL_BUSY_RX_DMA)
     {
-        I2C_Write_Address_Byte(&p_i2c_handle, p_i2c_handle.i2c_dev.slave_addr, I2C_READ);
+        I2C_Write_Address_Byte(p_i2c_handle, p_i2c_handle->i2c_dev.slave_addr, I2C_READ);
     }
 }
 
-static void I2C_Handle_ADDR(void)
+static void I2C_Handle_ADDR(I2C_Handle_t *p_i2c_handle)
 {
-    if (p_i2c_handle.i2c_dev.control_stage == I2C_CTRL_BUSY_TX)
+    I2C_Ctrl_Stage_t stage = p_i2c_handle->i2c_dev.control_stage;
+
+    if (stage == I2C_CTRL_BUSY_TX || stage == I2C_CTRL_BUSY_TX_DMA)
     {
-        I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
+        I2C_Check_Status_Flag(p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
     }
-    else if (p_i2c_handle.i2c_dev.control_stage == I2C_CTRL_BUSY_RX)
+    else if (stage == I2C_CTRL_BUSY_RX || stage == I2C_CTRL_BUSY_RX_DMA)
     {
-        if (p_i2c_handle.i2c_dev.rx_size == 1)
+        if (p_i2c_handle->i2c_dev.rx_size == 1)
         {
             /* ACKing must be disabled on peripheral before last byte */
-            I2C_Ack_Control(p_i2c_handle.p_i2c_x, DISABLE);
+            I2C_Ack_Control(p_i2c_handle->p_i2c_x, DISABLE);
         }
         /* Clear ADDR flag by reading SR2 */
-        I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
+        I2C_Check_Status_Flag(p_i2c_handle, I2C_SR2_TRA_POS, I2C_SR2_CHECK);
+
+        if (stage == I2C_CTRL_BUSY_RX_DMA && p_i2c_handle->i2c_dev.rx_size == 1
+                && p_i2c_handle->i2c_dev.repeat_start == I2C_DISABLE_SR)
+        {
+            /* A single byte has no DMA EOT ahead of it, so its stop is requested now, before it arrives */
+            I2C_Generate_Stop_Condition(p_i2c_handle);
+        }
     }
 }
 
-static void I2C_Handle_TXE(void)
+static void I2C_Handle_TXE(I2C_Handle_t *p_i2c_handle)
 {
-    if (p_i2c_handle.i2c_dev.tx_len <= 0)
+    uint8_t byte;
+
+    if (p_i2c_handle->i2c_dev.tx_len <= 0)
     {
         /* If BTF isn't set, transmission isn't done, wait for BTF before stop */
-        if (!I2C_Check_Status_Flag(&p_i2c_handle, I2C_SR1_BTF_POS, I2C_SR1_CHECK))
+        if (!I2C_Check_Status_Flag(p_i2c_handle, I2C_SR1_BTF_POS, I2C_SR1_CHECK))
         {
             /* Disable buffer interrupts until BTF, since TXE will trigger repeatedly */
-            CLEAR_BIT(p_i2c_handle.p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+            CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
             return;
         }
         /* Depending on handle SR field, either generate stop condition or not */
-        if (p_i2c_handle.i2c_dev.repeat_start == I2C_DISABLE_SR)
+        if (p_i2c_handle->i2c_dev.repeat_start == I2C_DISABLE_SR)
         {
-            I2C_Generate_Stop_Condition(&p_i2c_handle);
+            I2C_Generate_Stop_Condition(p_i2c_handle);
         }
-        p_i2c_handle.p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITBUFEN_POS );
-        p_i2c_handle.p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITEVTEN_POS );
-        p_i2c_handle.i2c_dev.control_stage = I2C_CTRL_IDLE;
-        I2C_Write_Complete_Callback(&(p_i2c_handle.i2c_dev));
+        p_i2c_handle->p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITBUFEN_POS );
+        p_i2c_handle->p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITEVTEN_POS );
+        I2C_Phase_Complete(p_i2c_handle);
         return;
     }
 
     /* DR is empty, shift register may or may not be empty. Either way, write next byte into DR */
-    p_i2c_handle.p_i2c_x->DR = *I2C_TX_Ring_Buffer_Read(&p_i2c_handle.i2c_dev, 1);
-    p_i2c_handle.i2c_dev.tx_len--;
+    Ring_Buffer_Read(&p_i2c_handle->i2c_dev.tx_ring, &byte, 1);
+    p_i2c_handle->p_i2c_x->DR = byte;
+    p_i2c_handle->i2c_dev.tx_len--;
+    if (p_i2c_handle->i2c_dev.tx_len == 0)
+    {
+        /* Nothing left to load, so the next event worth taking is BTF */
+        CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITBUFEN_MASK);
+    }
 }
 
-static void I2C_Handle_RXNE(void)
+static void I2C_Handle_RXNE(I2C_Handle_t *p_i2c_handle)
 {
     uint8_t temp;
 
-    if (p_i2c_handle.i2c_dev.rx_size == 1)
+    if (p_i2c_handle->i2c_dev.rx_size == 1)
     {
         /* NACK must be sent on first byte for a 1-byte reception. */
-        temp = p_i2c_handle.p_i2c_x->DR;
-        I2C_RX_Ring_Buffer_Write(&p_i2c_handle.i2c_dev, &temp, 1);
-        p_i2c_handle.i2c_dev.rx_len--;
+        temp = p_i2c_handle->p_i2c_x->DR;
+        if (!I2C_RX_Ring_Write(p_i2c_handle, temp))
+            return;
+        p_i2c_handle->i2c_dev.rx_len--;
     }
     else
     {
-        if (p_i2c_handle.i2c_dev.rx_len == 2)
+        if (p_i2c_handle->i2c_dev.rx_len == 2)
         {
             /* Last byte must be NACK'd, so ACK must be disabled when len = 2. */
-            I2C_Ack_Control(p_i2c_handle.p_i2c_x, DISABLE);
+            I2C_Ack_Control(p_i2c_handle->p_i2c_x, DISABLE);
         }
-        temp = p_i2c_handle.p_i2c_x->DR;
-        I2C_RX_Ring_Buffer_Write(&p_i2c_handle.i2c_dev, &temp, 1);
-        p_i2c_handle.i2c_dev.rx_len--;
+        temp = p_i2c_handle->p_i2c_x->DR;
+        if (!I2C_RX_Ring_Write(p_i2c_handle, temp))
+            return;
+        p_i2c_handle->i2c_dev.rx_len--;
     }
 
-    if (p_i2c_handle.i2c_dev.rx_len == 0)
+    if (p_i2c_handle->i2c_dev.rx_len == 0)
     {
-        if (p_i2c_handle.i2c_dev.repeat_start == I2C_DISABLE_SR)
+        if (p_i2c_handle->i2c_dev.repeat_start == I2C_DISABLE_SR)
         {
-            I2C_Generate_Stop_Condition(&p_i2c_handle);
+            I2C_Generate_Stop_Condition(p_i2c_handle);
         }
-        p_i2c_handle.p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITBUFEN_POS );
-        p_i2c_handle.p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITEVTEN_POS );
-        I2C_Ack_Control(p_i2c_handle.p_i2c_x, ENABLE);
-        p_i2c_handle.i2c_dev.control_stage = I2C_CTRL_IDLE;
-        I2C_Read_Complete_Callback(&p_i2c_handle.i2c_dev);
+        p_i2c_handle->p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITBUFEN_POS );
+        p_i2c_handle->p_i2c_x->CR2 &= ~( 1 << I2C_CR2_ITEVTEN_POS );
+        I2C_Ack_Control(p_i2c_handle->p_i2c_x, ENABLE);
+        I2C_Phase_Complete(p_i2c_handle);
+    }
+}
+
+/* A full RX ring means the application stopped consuming it; the byte is lost and the read fails */
+static uint8_t I2C_RX_Ring_Write(I2C_Handle_t *p_i2c_handle, uint8_t byte)
+{
+    if (!Ring_Buffer_Write(&p_i2c_handle->i2c_dev.rx_ring, &byte, 1))
+    {
+        I2C_Abort_Transaction(p_i2c_handle, I2C_ERR_OVERRUN);
+        return 0;
     }
+    return 1;
+}
+
+/* BTF with the stream drained means the last byte has left the shift register */
+static void I2C_Handle_BTF_DMA(I2C_Handle_t *p_i2c_handle)
+{
+    if (DMA_Get_Remaining(&p_i2c_handle->dma_tx_handle) != 0)
+    {
+        /* The stream has not caught up yet; its next DR write clears BTF */
+        return;
+    }
+
+    if (p_i2c_handle->i2c_dev.repeat_start == I2C_DISABLE_SR)
+    {
+        I2C_Generate_Stop_Condition(p_i2c_handle);
+    }
+    p_i2c_handle->i2c_dev.tx_len = 0;
+    I2C_Finish_DMA(p_i2c_handle);
+    I2C_Phase_Complete(p_i2c_handle);
+}
+
+/* RX stream transfer complete: every byte is already in the caller's buffer */
+static void I2C_DMA_RX_Complete(I2C_Handle_t *p_i2c_handle)
+{
+    p_i2c_handle->i2c_dev.stats.dma_irqs++;
+    if (p_i2c_handle->i2c_dev.rx_size > 1 && p_i2c_handle->i2c_dev.repeat_start == I2C_DISABLE_SR)
+    {
+        I2C_Generate_Stop_Condition(p_i2c_handle);
+    }
+    p_i2c_handle->i2c_dev.rx_len = 0;
+    I2C_Finish_DMA(p_i2c_handle);
+    if (p_i2c_handle->i2c_dev.ack_ctrl == I2C_ACK_EN)
+    {
+        I2C_Ack_Control(p_i2c_handle->p_i2c_x, ENABLE);
+    }
+    I2C_Phase_Complete(p_i2c_handle);
+}
+
+static void I2C_DMA_Error(I2C_Handle_t *p_i2c_handle)
+{
+    p_i2c_handle->i2c_dev.stats.dma_irqs++;
+    I2C_Abort_Transaction(p_i2c_handle, I2C_ERR_DMA);
+}
+
+/* Hands DR back to the CPU so the _IT transfers see no DMA requests */
+static void I2C_Finish_DMA(I2C_Handle_t *p_i2c_handle)
+{
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_DMAEN_MASK | I2C_CR2_LAST_MASK | I2C_CR2_ITEVTEN_MASK);
 }
 
 __weak void I2C_Write_Complete_Callback(I2C_Device_t *p_i2c_dev)
@@ -350,41 +1217,48 @@ __weak void I2C_Read_Complete_Callback(I2C_Device_t *p_i2c_dev)
     /* implemented at the driver level */
 }
 
+__weak void I2C_Error_Callback(I2C_Device_t *p_i2c_dev, I2C_Status_t status)
+{
+    /* implemented at the driver level */
+}
+
 /* Utility functions */
-static void I2C1_GPIO_Pin_Init(void)
+static void I2C_GPIO_Pin_Init(I2C_Handle_t *p_i2c_handle)
 {
-    /* Configure GPIOs for I2C1 peripheral - PB6 = SCL, PB7 = SDA */
-    GPIO_Pin_Config_t pb6_scl_config = {
-            .gpio_pin_num               = SCL_PIN_NUM,
+    const I2C_Config_t *p_config = p_i2c_handle->p_config;
+
+    /* Both lines are open-drain, with the pull-ups on the bus */
+    GPIO_Pin_Config_t scl_config = {
+            .gpio_pin_num               = p_config->scl_pin_num,
             .gpio_pin_mode              = GPIO_MODE_ALT,
             .gpio_pin_speed             = GPIO_SPEED_MED,
             .gpio_pin_pu_pd_ctrl        = GPIO_PUPD_NONE,
             .gpio_pin_op_type           = GPIO_OUT_OD,
-            .gpio_pin_alt_fun_mode      = SDA_ALT_FUN
+            .gpio_pin_alt_fun_mode      = p_config->alt_fun
     };
 
-    GPIO_Handle_t pb6_scl_handle = {
-            .p_gpio_x                   = SCL_GPIO,
-            .gpio_pin_config            = pb6_scl_config
+    GPIO_Handle_t scl_handle = {
+            .p_gpio_x                   = p_config->p_scl_gpio,
+            .gpio_pin_config            = scl_config
     };
 
-    GPIO_Init(&pb6_scl_handle);
+    GPIO_Init(&scl_handle);
 
-    GPIO_Pin_Config_t pb7_sda_config = {
-            .gpio_pin_num               = SDA_PIN_NUM,
+    GPIO_Pin_Config_t sda_config = {
+            .gpio_pin_num               = p_config->sda_pin_num,
             .gpio_pin_mode              = GPIO_MODE_ALT,
             .gpio_pin_speed             = GPIO_SPEED_MED,
             .gpio_pin_pu_pd_ctrl        = GPIO_PUPD_NONE,
             .gpio_pin_op_type           = GPIO_OUT_OD,
-            .gpio_pin_alt_fun_mode      = SDA_ALT_FUN
+            .gpio_pin_alt_fun_mode      = p_config->alt_fun
     };
 
-    GPIO_Handle_t pb7_sda_handle = {
-            .p_gpio_x                   = SDA_GPIO,
-            .gpio_pin_config            = pb7_sda_config
+    GPIO_Handle_t sda_handle = {
+            .p_gpio_x                   = p_config->p_sda_gpio,
+            .gpio_pin_config            = sda_config
     };
 
-    GPIO_Init(&pb7_sda_handle);
+    GPIO_Init(&sda_handle);
 }
 
 static void I2C_Clk_Ctrl(I2C_Register_Map_t *p_i2c_x, uint8_t enable)
@@ -421,6 +1295,37 @@ static void I2C_Clk_Ctrl(I2C_Register_Map_t *p_i2c_x, uint8_t enable)
     }
 }
 
+static void I2C_DMA_Init(I2C_Handle_t *p_i2c_handle)
+{
+    DMA_Handle_t dma_rx_handle = {
+            .p_dma_x                    = I2C_DMA,
+            .stream_num                 = p_i2c_handle->p_config->dma_rx_stream,
+            .channel                    = p_i2c_handle->p_config->dma_channel,
+            .direction                  = DMA_DIR_PERIPH_TO_MEM,
+            .priority                   = DMA_PRIORITY_HIGH,
+            .irq_priority               = I2C_DMA_IRQ_PRIORITY,
+            .p_complete_callback        = p_i2c_handle->p_config->p_dma_rx_complete,
+            .p_error_callback           = p_i2c_handle->p_config->p_dma_error
+    };
+
+    /* No TX complete interrupt: the stream finishes a byte ahead of the bus, and BTF marks the real end */
+    DMA_Handle_t dma_tx_handle = {
+            .p_dma_x                    = I2C_DMA,
+            .stream_num                 = p_i2c_handle->p_config->dma_tx_stream,
+            .channel                    = p_i2c_handle->p_config->dma_channel,
+            .direction                  = DMA_DIR_MEM_TO_PERIPH,
+            .priority                   = DMA_PRIORITY_HIGH,
+            .irq_priority               = I2C_DMA_IRQ_PRIORITY,
+            .p_complete_callback        = NULL,
+            .p_error_callback           = p_i2c_handle->p_config->p_dma_error
+    };
+
+    p_i2c_handle->dma_rx_handle = dma_rx_handle;
+    p_i2c_handle->dma_tx_handle = dma_tx_handle;
+    DMA_Init(&p_i2c_handle->dma_rx_handle);
+    DMA_Init(&p_i2c_handle->dma_tx_handle);
+}
+
 static void I2C_Generate_Start_Condition(I2C_Handle_t *p_i2c_handle)
 {
     SET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_START_MASK);
@@ -432,13 +1337,13 @@ static void I2C_Generate_Stop_Condition(I2C_Handle_t *p_i2c_handle)
     SET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_STOP_MASK);
 }
 
-static void I2C_Enable_Interrupts(void)
+static void I2C_Enable_Interrupts(I2C_Handle_t *p_i2c_handle)
 {
     /* Determine which ISER register (0-7) will be used. */
     uint8_t iser_num;
     uint8_t bit_pos;
 
-    switch ((uint32_t) p_i2c_handle.p_i2c_x)
+    switch ((uint32_t) p_i2c_handle->p_i2c_x)
     {
     case I2C1_BASE_ADDR:
         iser_num = I2C1_EV_NVIC_POS / 32;
@@ -471,13 +1376,13 @@ static void I2C_Enable_Interrupts(void)
     }
 }
 
-static void I2C_Set_Interrupt_Priority(uint8_t priority)
+static void I2C_Set_Interrupt_Priority(I2C_Handle_t *p_i2c_handle, uint8_t priority)
 {
     uint8_t ipr_num;
     uint8_t byte_offset;
     uint8_t bit_offset;
 
-    switch ((uint32_t) p_i2c_handle.p_i2c_x)
+    switch ((uint32_t) p_i2c_handle->p_i2c_x)
     {
     case I2C1_BASE_ADDR:
         ipr_num = I2C1_EV_NVIC_POS / 4;
@@ -541,60 +1446,67 @@ static void I2C_Ack_Control(I2C_Register_Map_t *p_i2c_x, uint8_t enable)
     }
 }
 
-static void I2C_Configure_Clock_Registers(I2C_Handle_t *p_i2c_handle)
+static I2C_Status_t I2C_Configure_Clock_Registers(I2C_Handle_t *p_i2c_handle)
 {
-    uint32_t sys_clk_freq = RCC_Get_Sys_Clk_Frequency();
-
-    /* Set FREQ field in I2C_CR2. */
-    I2C_Set_CR2_Freq(p_i2c_handle->p_i2c_x, sys_clk_freq);
-
-    if (p_i2c_handle->i2c_dev.clock_speed <= I2C_SPEED_SM)
-    {
-        /* Cleared F/S bit means Standard Mode I2C. */
-        CLEAR_BIT(p_i2c_handle->p_i2c_x->CCR, (1 << I2C_CCR_FS_POS));
-        I2C_Set_CCR(p_i2c_handle, sys_clk_freq);
-    }
-    else
-    {
-        /* Set F/S bit means Fast Mode */
-        SET_BIT(p_i2c_handle->p_i2c_x->CCR, (1 << I2C_CCR_FS_POS));
-        I2C_Set_CCR(p_i2c_handle, sys_clk_freq);
-    }
-
-    I2C_Set_CCR(p_i2c_handle, sys_clk_freq);
-
-    I2C_Configure_TRISE(p_i2c_handle, sys_clk_freq);
+    /* Every I2C peripheral is clocked from APB1, which may be divided down from the system clock */
+    uint32_t apb1_clk_freq = RCC_Get_APB1_Clk_Frequency();
+
+    if (!I2C_Set_CR2_Freq(p_i2c_handle->p_i2c_x, apb1_clk_freq))
+        return I2C_ERR_CLOCK;
+    I2C_Set_CCR(p_i2c_handle, apb1_clk_freq);
+    I2C_Configure_TRISE(p_i2c_handle, apb1_clk_freq);
+    return I2C_OK;
 }
 
-static void I2C_Set_CR2_Freq(I2C_Register_Map_t *p_i2c_x, uint32_t sys_clk_freq)
+/* Returns 0, writing nothing, if APB1 is out of the peripheral's range */
+static uint8_t I2C_Set_CR2_Freq(I2C_Register_Map_t *p_i2c_x, uint32_t apb1_clk_freq)
 {
     /* Convert frequency from Hz to MHz */
-    sys_clk_freq /= 1000000u;
-    /* 5 bit frequency means maximum of 31 */
-    if (sys_clk_freq > 31)
-        return;
-    /* Clear first 5 bits of CR2, then apply freq value */
-    SET_FIELD(&p_i2c_x->CR2, I2C_CR2_FREQ_MASK, sys_clk_freq);
+    apb1_clk_freq /= 1000000u;
+    /* The peripheral only runs from 2MHz up to the 42MHz APB1 maximum */
+    if (apb1_clk_freq < 2 || apb1_clk_freq > 42)
+        return 0;
+    SET_FIELD(&p_i2c_x->CR2, I2C_CR2_FREQ_MASK, apb1_clk_freq);
+    return 1;
 }
 
-static void I2C_Set_CCR(I2C_Handle_t *p_i2c_handle, uint32_t sys_clk_freq)
+/* Rounds the divider up, so SCL never runs faster than the requested speed */
+static void I2C_Set_CCR(I2C_Handle_t *p_i2c_handle, uint32_t apb1_clk_freq)
 {
-    /* All I2C peripherals on APB1 - calculate APB1 frequency */
+    uint32_t clock_speed = p_i2c_handle->i2c_dev.clock_speed;
+    uint32_t ccr_reg = 0;
     uint32_t ccr;
-    uint32_t ahb_prescaler = RCC_Get_AHB_Prescaler();
-    uint32_t apb1_prescaler = RCC_Get_APB_Prescaler();
-    uint32_t apb1_clk = sys_clk_freq / ahb_prescaler / apb1_prescaler;
 
-    if (p_i2c_handle->i2c_dev.clock_speed <= I2C_SPEED_SM)
-        ccr = apb1_clk / (I2C_SPEED_SM * 2);
+    if (clock_speed <= I2C_SPEED_SM)
+    {
+        /* Thigh = Tlow = CCR * Tpclk1; standard mode needs at least 4 */
+        ccr = (apb1_clk_freq + (clock_speed * 2) - 1) / (clock_speed * 2);
+        if (ccr < 4)
+            ccr = 4;
+    }
     else
-        ccr = apb1_clk / (I2C_SPEED_FM * 3);
+    {
+        ccr_reg |= I2C_CCR_FS_MASK;
+        if (p_i2c_handle->i2c_dev.fm_duty_cycle == I2C_FM_DUTY_16_9)
+        {
+            /* Thigh = 9 * CCR * Tpclk1, Tlow = 16 * CCR * Tpclk1 */
+            ccr_reg |= I2C_CCR_DUTY_MASK;
+            ccr = (apb1_clk_freq + (clock_speed * 25) - 1) / (clock_speed * 25);
+        }
+        else
+        {
+            /* Thigh = CCR * Tpclk1, Tlow = 2 * CCR * Tpclk1 */
+            ccr = (apb1_clk_freq + (clock_speed * 3) - 1) / (clock_speed * 3);
+        }
+        if (ccr < 1)
+            ccr = 1;
+    }
 
-    /* Clear bottom 12 bits, then set bottom 12 to calculated CCR */
-    SET_FIELD(&p_i2c_handle->p_i2c_x->CCR, I2C_CCR_CCR_MASK, ccr);
+    /* Mode, duty and divider are written together; CCR is only writable while PE is clear */
+    p_i2c_handle->p_i2c_x->CCR = ccr_reg | ((ccr << I2C_CCR_CCR_POS) & I2C_CCR_CCR_MASK);
 }
 
-static void I2C_Configure_TRISE(I2C_Handle_t *p_i2c_handle, uint32_t sys_clk_freq)
+static void I2C_Configure_TRISE(I2C_Handle_t *p_i2c_handle, uint32_t apb1_clk_freq)
 {
     uint8_t trise;
 
@@ -602,15 +1514,15 @@ static void I2C_Configure_TRISE(I2C_Handle_t *p_i2c_handle, uint32_t sys_clk_fre
     {
         /* Mode is standard - TRISE is (max rise time * apb1 clock) + 1 */
         /* Max rise time is 1000ns = 1e-6, simplifies to (apb1 clock / 1e6) + 1 */
-        trise = (sys_clk_freq / 1000000u) + 1;
+        trise = (apb1_clk_freq / 1000000u) + 1;
     }
     else
     {
         /* Mode is fast - max rise time is 300ns - simplifies to (apb1 clock * 3 / 1e7) + 1 */
-        trise = ( (sys_clk_freq * 3) / 10000000u ) + 1;
+        trise = ( (apb1_clk_freq / 1000000u) * 3 / 10u ) + 1;
     }
 
-    /* Clear bottom 5 bits of I2C_TRISE register, then set to calculated value */
+    /* Clear bottom 6 bits of I2C_TRISE register, then set to calculated value */
     SET_FIELD(&p_i2c_handle->p_i2c_x->TRISE, I2C_TRISE_TRISE_MASK, trise);
 }
 
@@ -623,4 +1535,87 @@ static void I2C_Set_Own_Address(I2C_Handle_t *p_i2c_handle)
     /* 14th bit must be kept high (unsure why) */
     SET_BIT(p_i2c_handle->p_i2c_x->OAR1, (1 << 14));
 }
+/* Spins on one status flag for at most I2C_TIMEOUT_US. Any bus error ends the wait early, since the flag
+ * will never come. */
+static I2C_Status_t I2C_Wait_For_Flag(I2C_Handle_t *p_i2c_handle, uint8_t flag_num, uint8_t sr_1_or_2)
+{
+    uint32_t start_cycles = Timebase_Get_Cycles();
+    I2C_Status_t status;
+
+    while (!I2C_Check_Status_Flag(p_i2c_handle, flag_num, sr_1_or_2))
+    {
+        status = I2C_Get_Error_Status(p_i2c_handle->p_i2c_x->SR1);
+        if (status != I2C_OK)
+            return status;
+        if (I2C_Deadline_Passed(start_cycles, I2C_TIMEOUT_US * (Timebase_Get_Core_Clk_Frequency() / 1000000u)))
+            return I2C_ERR_TIMEOUT;
+    }
+    return I2C_OK;
+}
+
+static I2C_Status_t I2C_Get_Error_Status(uint32_t sr1)
+{
+    if (sr1 & I2C_SR1_AF_MASK)
+        return I2C_ERR_NACK;
+    if (sr1 & I2C_SR1_BERR_MASK)
+        return I2C_ERR_BUS;
+    if (sr1 & I2C_SR1_ARLO_MASK)
+        return I2C_ERR_ARB_LOST;
+    if (sr1 & I2C_SR1_OVR_MASK)
+        return I2C_ERR_OVERRUN;
+    if (sr1 & I2C_SR1_TIMEOUT_MASK)
+        return I2C_ERR_TIMEOUT;
+    return I2C_OK;
+}
+
+/* The error flags are cleared by writing 0; writing 1 leaves the other SR1 bits alone */
+static void I2C_Clear_Error_Flags(I2C_Handle_t *p_i2c_handle)
+{
+    p_i2c_handle->p_i2c_x->SR1 = ~(uint32_t)(I2C_SR1_AF_MASK | I2C_SR1_BERR_MASK | I2C_SR1_ARLO_MASK
+                                            | I2C_SR1_OVR_MASK | I2C_SR1_TIMEOUT_MASK);
+}
+
+/* Common exit of the blocking transfers. A failure releases the bus the same way the error interrupt would. */
+static I2C_Status_t I2C_End_Blocking(I2C_Handle_t *p_i2c_handle, I2C_Status_t status)
+{
+    I2C_Stats_Record_Blocking(&p_i2c_handle->i2c_dev.stats, status);
+
+    if (status != I2C_OK)
+    {
+        I2C_Clear_Error_Flags(p_i2c_handle);
+        if (status == I2C_ERR_BUS || status == I2C_ERR_TIMEOUT)
+            I2C_Recover_Bus(p_i2c_handle);
+        else if (status != I2C_ERR_ARB_LOST)
+            I2C_Generate_Stop_Condition(p_i2c_handle);
+    }
+
+    if (p_i2c_handle->i2c_dev.ack_ctrl == I2C_ACK_EN)
+    {
+        I2C_Ack_Control(p_i2c_handle->p_i2c_x, ENABLE);
+    }
+    SET_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITERREN_MASK);
+    return status;
+}
+
+/* Unsigned subtraction keeps this right across a cycle counter wrap */
+static uint8_t I2C_Deadline_Passed(uint32_t start_cycles, uint32_t budget_cycles)
+{
+    return (Timebase_Get_Cycles() - start_cycles) >= budget_cycles;
+}
+
+/* SWRST clears every register, so the configuration from I2C_Init is put back */
+static void I2C_Reset_Peripheral(I2C_Handle_t *p_i2c_handle)
+{
+    I2C_Status_t status;
+
+    SET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_SWRST_MASK);
+    CLEAR_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_SWRST_MASK);
+    status = I2C_Configure_Clock_Registers(p_i2c_handle);
+    I2C_Set_Own_Address(p_i2c_handle);
+    SET_BIT(p_i2c_handle->p_i2c_x->CR2, I2C_CR2_ITERREN_MASK);
+    if (status != I2C_OK)
+        return;
+    SET_BIT(p_i2c_handle->p_i2c_x->CR1, I2C_CR1_PE_MASK);
+    I2C_Ack_Control(p_i2c_handle->p_i2c_x, p_i2c_handle->i2c_dev.ack_ctrl);
+}
 /*************** PRIVATE IMPLEMENTATION FUNCTIONS END *****************/
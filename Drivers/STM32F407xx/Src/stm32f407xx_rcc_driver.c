@@ -3,18 +3,20 @@
 
 static uint32_t Translate_APB_Prescaler(uint8_t bit_value);
 static uint32_t Translate_AHB_Prescaler(uint8_t bit_value);
+static uint32_t RCC_Get_PLL_Clk_Frequency(void);
 
 uint32_t RCC_Get_Sys_Clk_Frequency()
 {
-    System_Clock_t sys_clk = RCC->CFGR &= (0b11 << RCC_CFGR_SWS);
+    /* SWS reports the clock actually in use, which lags SW while a switch is in progress */
+    System_Clock_t sys_clk = (RCC->CFGR >> RCC_CFGR_SWS) & 0b11;
     switch (sys_clk)
     {
         case SYS_CLK_HSI:
             return HSI_CLK_SPEED;
         case SYS_CLK_HSE:
-            return 0;
+            return HSE_CLK_SPEED;
         case SYS_CLK_PLL:
-            return 0;
+            return RCC_Get_PLL_Clk_Frequency();
         default:
             return 0;
     }
@@ -32,6 +34,27 @@ uint32_t RCC_Get_APB_Prescaler()
     return Translate_APB_Prescaler(apb_prescaler_bit_val);
 }
 
+/* PCLK1, which clocks every I2C peripheral */
+uint32_t RCC_Get_APB1_Clk_Frequency()
+{
+    return RCC_Get_Sys_Clk_Frequency() / RCC_Get_AHB_Prescaler() / RCC_Get_APB_Prescaler();
+}
+
+static uint32_t RCC_Get_PLL_Clk_Frequency(void)
+{
+    uint32_t pllcfgr = RCC->PLLCFG;
+    uint32_t pll_src_freq = (pllcfgr & (1 << RCC_PLLCFGR_PLLSRC)) ? HSE_CLK_SPEED : HSI_CLK_SPEED;
+    uint32_t pllm = (pllcfgr >> RCC_PLLCFGR_PLLM) & 0x3F;
+    uint32_t plln = (pllcfgr >> RCC_PLLCFGR_PLLN) & 0x1FF;
+    uint32_t pllp = (((pllcfgr >> RCC_PLLCFGR_PLLP) & 0b11) + 1) * 2;
+
+    if (pllm == 0)
+        return 0;
+
+    /* Dividing by M first keeps the VCO product inside 32 bits */
+    return (pll_src_freq / pllm) * plln / pllp;
+}
+
 static uint32_t Translate_AHB_Prescaler(uint8_t bit_value)
 {
     /* AHB PRESCALER */
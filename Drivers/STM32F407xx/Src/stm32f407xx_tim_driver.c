@@ -0,0 +1,161 @@
+#include <stddef.h>
+
+#include "stm32f407xx_tim_driver.h"
+#include "stm32f407xx_rcc_driver.h"
+#include "stm32f407xx_gpio_driver.h"
+
+#define TIM_NUM_INSTANCES       6       /* TIM2 through TIM7 */
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static int8_t TIM_Get_Instance_Index(TIM_Register_Map_t *p_tim_x);
+static uint8_t TIM_Get_IRQ_Number(TIM_Register_Map_t *p_tim_x);
+static void TIM_Clk_Enable(TIM_Register_Map_t *p_tim_x);
+static uint32_t TIM_Get_Kernel_Clk_Frequency(void);
+static void TIM_IRQ_Handling(uint8_t instance_idx);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+/* Handles registered through TIM_Init(), looked up by the ISRs to find the update callback */
+static TIM_Handle_t *p_tim_handles[TIM_NUM_INSTANCES];
+
+void TIM_Init(TIM_Handle_t *p_tim_handle)
+{
+    TIM_Register_Map_t *p_tim_x = p_tim_handle->p_tim_x;
+    int8_t instance_idx = TIM_Get_Instance_Index(p_tim_x);
+    uint8_t irq_num;
+
+    if (instance_idx < 0 || p_tim_handle->counter_freq_hz == 0 || p_tim_handle->period == 0)
+        return;
+
+    p_tim_handles[instance_idx] = p_tim_handle;
+    TIM_Clk_Enable(p_tim_x);
+
+    p_tim_x->CR1 = 0;
+    p_tim_x->PSC = (TIM_Get_Kernel_Clk_Frequency() / p_tim_handle->counter_freq_hz) - 1;
+    p_tim_x->ARR = p_tim_handle->period - 1;
+
+    /* Latch PSC/ARR now; URS keeps this software update from raising an interrupt */
+    p_tim_x->CR1 |= TIM_CR1_URS_MASK | TIM_CR1_ARPE_MASK;
+    p_tim_x->EGR = TIM_EGR_UG_MASK;
+    p_tim_x->SR = ~TIM_SR_UIF_MASK;
+
+    p_tim_x->DIER |= TIM_DIER_UIE_MASK;
+
+    irq_num = TIM_Get_IRQ_Number(p_tim_x);
+    GPIO_IRQ_Priority_Config(irq_num, p_tim_handle->irq_priority);
+    GPIO_IRQ_Interrupt_Config(irq_num, ENABLE);
+}
+
+void TIM_Start(TIM_Handle_t *p_tim_handle)
+{
+    /* Restart the period so the first update lands a full period from now */
+    p_tim_handle->p_tim_x->CNT = 0;
+    p_tim_handle->p_tim_x->CR1 |= TIM_CR1_CEN_MASK;
+}
+
+void TIM_Stop(TIM_Handle_t *p_tim_handle)
+{
+    p_tim_handle->p_tim_x->CR1 &= ~TIM_CR1_CEN_MASK;
+    p_tim_handle->p_tim_x->SR = ~TIM_SR_UIF_MASK;
+}
+
+uint8_t TIM_Is_Running(TIM_Handle_t *p_tim_handle)
+{
+    return (p_tim_handle->p_tim_x->CR1 & TIM_CR1_CEN_MASK) ? SET : RESET;
+}
+
+void TIM2_IRQHandler(void)
+{
+    TIM_IRQ_Handling(0);
+}
+
+void TIM3_IRQHandler(void)
+{
+    TIM_IRQ_Handling(1);
+}
+
+void TIM4_IRQHandler(void)
+{
+    TIM_IRQ_Handling(2);
+}
+
+void TIM5_IRQHandler(void)
+{
+    TIM_IRQ_Handling(3);
+}
+
+void TIM6_DAC_IRQHandler(void)
+{
+    TIM_IRQ_Handling(4);
+}
+
+void TIM7_IRQHandler(void)
+{
+    TIM_IRQ_Handling(5);
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void TIM_IRQ_Handling(uint8_t instance_idx)
+{
+    TIM_Handle_t *p_tim_handle = p_tim_handles[instance_idx];
+
+    if (p_tim_handle == NULL)
+        return;
+
+    if ( GET_BIT(p_tim_handle->p_tim_x->SR, TIM_SR_UIF_MASK) )
+    {
+        /* rc_w0; writing the other bits as 1 leaves them untouched */
+        p_tim_handle->p_tim_x->SR = ~TIM_SR_UIF_MASK;
+
+        if (p_tim_handle->p_update_callback != NULL)
+            p_tim_handle->p_update_callback();
+    }
+}
+
+static int8_t TIM_Get_Instance_Index(TIM_Register_Map_t *p_tim_x)
+{
+    switch ((uint32_t) p_tim_x)
+    {
+    case TIM2_BASE_ADDR: return 0;
+    case TIM3_BASE_ADDR: return 1;
+    case TIM4_BASE_ADDR: return 2;
+    case TIM5_BASE_ADDR: return 3;
+    case TIM6_BASE_ADDR: return 4;
+    case TIM7_BASE_ADDR: return 5;
+    default: return -1;
+    }
+}
+
+static uint8_t TIM_Get_IRQ_Number(TIM_Register_Map_t *p_tim_x)
+{
+    switch ((uint32_t) p_tim_x)
+    {
+    case TIM2_BASE_ADDR: return IRQ_NO_TIM2;
+    case TIM3_BASE_ADDR: return IRQ_NO_TIM3;
+    case TIM4_BASE_ADDR: return IRQ_NO_TIM4;
+    case TIM5_BASE_ADDR: return IRQ_NO_TIM5;
+    case TIM6_BASE_ADDR: return IRQ_NO_TIM6_DAC;
+    default: return IRQ_NO_TIM7;
+    }
+}
+
+static void TIM_Clk_Enable(TIM_Register_Map_t *p_tim_x)
+{
+    switch ((uint32_t) p_tim_x)
+    {
+    case TIM2_BASE_ADDR: TIM2_PCLK_EN(); break;
+    case TIM3_BASE_ADDR: TIM3_PCLK_EN(); break;
+    case TIM4_BASE_ADDR: TIM4_PCLK_EN(); break;
+    case TIM5_BASE_ADDR: TIM5_PCLK_EN(); break;
+    case TIM6_BASE_ADDR: TIM6_PCLK_EN(); break;
+    case TIM7_BASE_ADDR: TIM7_PCLK_EN(); break;
+    }
+}
+
+static uint32_t TIM_Get_Kernel_Clk_Frequency(void)
+{
+    uint32_t apb1_prescaler = RCC_Get_APB_Prescaler();
+    uint32_t apb1_clk = Timebase_Get_Core_Clk_Frequency() / apb1_prescaler;
+
+    /* The APB1 timers run at twice PCLK1 whenever PCLK1 is divided down from HCLK */
+    return (apb1_prescaler == 1) ? apb1_clk : (2 * apb1_clk);
+}
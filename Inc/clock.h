@@ -13,6 +13,12 @@ typedef enum
     CLOCK_CTRL_ERROR
 } Clock_Ctrl_Stage_t;
 
+typedef enum
+{
+    CLOCK_ALARM_1,
+    CLOCK_ALARM_2
+} Clock_Alarm_t;
+
 
 typedef struct
 {
@@ -72,6 +78,13 @@ typedef struct
     void                    (*Set_Full_Date_IT)(full_date_t full_date);
     void                    (*Set_Full_Time_IT)(full_time_t full_time);
     void                    (*Set_Full_Datetime_IT)(full_datetime_t full_datetime);
+
+    /* Setting an alarm arms it and clears any match it had left. A match mode the alarm cannot do leaves it as
+     * it was and sets ctrl_stage to CLOCK_CTRL_ERROR. Clearing an alarm disarms it. */
+    void                    (*Set_Alarm)(Clock_Alarm_t alarm, alarm_t alarm_time);
+    void                    (*Set_Alarm_IT)(Clock_Alarm_t alarm, alarm_t alarm_time);
+    alarm_t                 (*Get_Alarm)(Clock_Alarm_t alarm);
+    void                    (*Clear_Alarm)(Clock_Alarm_t alarm);
 } Clock_Driver_t;
 
 Clock_Driver_t *get_clock_driver(void);
@@ -100,6 +113,17 @@ void Clock_Set_Years_Complete_Callback(Clock_Device_t *clock_dev);
 void Clock_Set_Full_Time_Complete_Callback(Clock_Device_t *clock_dev);
 void Clock_Set_Full_Date_Complete_Callback(Clock_Device_t *clock_dev);
 void Clock_Set_Datetime_Complete_Callback(Clock_Device_t *clock_dev);
+void Clock_Set_Alarm_Complete_Callback(Clock_Device_t *clock_dev);
+
+/* When an armed alarm matches, from the clock's interrupt line. Called in interrupt context. */
+void Clock_Alarm_Callback(Clock_Device_t *clock_dev, Clock_Alarm_t alarm);
+
+/* Once a second, on the clock's own second boundary, from a clock whose tick output is wired up. Called in
+ * interrupt context. */
+void Clock_Tick_Callback(Clock_Device_t *clock_dev);
+
+/* Called instead of the complete callback when an interrupt-based call fails; ctrl_stage is CLOCK_CTRL_ERROR */
+void Clock_Error_Callback(Clock_Device_t *clock_dev);
 
 
 #ifdef DS3231
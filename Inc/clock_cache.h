@@ -0,0 +1,63 @@
+#ifndef CLOCK_CACHE_H_
+#define CLOCK_CACHE_H_
+
+#include <stdint.h>
+
+#include "clock.h"
+#include "stm32f407xx_tim_driver.h"
+
+/* A clock driver that keeps the time in RAM, in front of the one get_clock_driver() returns. It reads the chip
+ * once, then counts on by itself from a 1Hz timer, through the same minute, hour, day, month, year and century
+ * rollovers, in 12 or 24 hour mode, that the DS3231 makes. Getters are answered from that copy in constant
+ * time without touching the bus; an _IT getter fills in the device and calls its complete callback before it
+ * returns. Setters go through to the chip and into the copy.
+ *
+ * The copy goes back to the chip every resync period, from the first getter called after it falls due, or
+ * whenever Clock_Cache_Resync() is called. The timer is not locked to the chip's seconds, so in between the
+ * copy can be up to a second out, plus the drift of the timer against the chip's crystal. Setting the seconds
+ * brings the two back in phase, since the chip restarts its own second then too.
+ *
+ * A clock with its own tick wired up (DS3231_SQW_WIRED) can drive the copy instead: with the external tick
+ * source the timer is stopped and the application calls Clock_Cache_Tick() from Clock_Tick_Callback(). The
+ * copy then counts on exactly when the chip does. */
+
+#define CLOCK_CACHE_TIM                     TIM5
+#define CLOCK_CACHE_TIM_FREQ_HZ             10000   /* 1Hz is then a period of 10000 */
+#define CLOCK_CACHE_TIM_IRQ_PRIORITY        3       /* below the display timer; a late tick only delays the count */
+#define CLOCK_CACHE_DEFAULT_RESYNC_S        3600
+
+typedef enum
+{
+    CLOCK_CACHE_TICK_TIM,
+    CLOCK_CACHE_TICK_EXTERNAL
+} Clock_Cache_Tick_Source_t;
+
+typedef struct
+{
+    Clock_Driver_t                  *p_backend;
+    Clock_Device_t                  *clock_dev;
+    full_datetime_t                 datetime;           /* advanced by the tick interrupt */
+    uint32_t                        resync_period_s;
+    volatile uint32_t               secs_since_sync;
+    volatile uint8_t                resync_due;
+    uint32_t                        resyncs;
+    volatile uint32_t               ticks;
+    Clock_Cache_Tick_Source_t       tick_source;
+    TIM_Handle_t                    tim_handle;
+} Clock_Cache_Handle_t;
+
+Clock_Driver_t *get_cached_clock_driver(void);
+
+/* 0 leaves resyncing to Clock_Cache_Resync() */
+void Clock_Cache_Set_Resync_Period(uint32_t resync_period_s);
+/* Reads the chip now, with a blocking burst, so it must not be called from an interrupt. On a failed read the
+ * copy is kept and the device's ctrl_stage is left at CLOCK_CTRL_ERROR. */
+void Clock_Cache_Resync(void);
+uint32_t Clock_Cache_Get_Resyncs(void);
+/* May be called before or after Initialize; switching to the timer starts a fresh second */
+void Clock_Cache_Set_Tick_Source(Clock_Cache_Tick_Source_t tick_source);
+
+/* One second on. The timer's update callback, or the application's with the external tick source. */
+void Clock_Cache_Tick(void);
+
+#endif /* CLOCK_CACHE_H_ */
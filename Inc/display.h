@@ -5,9 +5,12 @@
 
 #define LCD1602A
 
-/* Do not really need to keep track of the Display control stage, since there is no
- * interrupt-based display APIs currently implemented. These would be useful for
- * interrupt-based logic, though. */
+/* Temperature in quarter degrees Celsius, the resolution of the DS3231 sensor */
+typedef int16_t temperature_t;
+
+/* The display driver moves ctrl_stage to UPDATING when an _IT call is accepted and
+ * back to IDLE right before the matching completion callback. An _IT call made while
+ * the display is UPDATING is dropped. */
 typedef enum
 {
     DISPLAY_CTRL_INIT,
@@ -19,6 +22,7 @@ typedef enum
 typedef struct
 {
     Display_Ctrl_Stage_t ctrl_stage;
+    uint32_t             frame_bytes_sent;      /* bytes sent to the display by the last update */
 } Display_Device_t;
 
 typedef struct
@@ -37,10 +41,56 @@ typedef struct
     void            (*Display_Update_Year)(year_t year, century_t century);
     void            (*Display_Update_Full_Date)(full_date_t full_date);
     void            (*Display_Update_Datetime)(full_datetime_t datetime);
+    /* Panels without room for these fields accept the calls and draw nothing */
+    void            (*Display_Update_Temperature)(temperature_t temperature);
+    void            (*Display_Update_Alarm)(hours_t hours, minutes_t minutes, uint8_t enabled);
+    /* Scrolls msg (up to 40 characters, blank padded) along the DDRAM line behind row, one display shift
+     * every step_ms. The shift moves every row, so the fields on the other rows are redrawn at shifted
+     * addresses each step; fields sharing the scrolled line come back on Display_Marquee_Stop. While a
+     * marquee runs, only the _IT calls may update the display. */
+    void            (*Display_Marquee_Start)(uint8_t row, const char *msg, uint32_t step_ms);
+    void            (*Display_Marquee_Stop)(void);
+    /* Large-format time face; takes over the whole panel until the next Display_Clear */
+    void            (*Display_Update_Big_Time)(full_time_t full_time);
+
+    /* Non-blocking variants; the bus traffic is clocked out from a timer interrupt. A blocking call
+     * made while one of these is in flight waits for it to finish, so blocking calls must not be made
+     * from an interrupt that preempts the display timer. One of these made while another update, queued or
+     * blocking, holds the display is refused and sets nothing on screen. */
+    void            (*Display_Clear_IT)(void);
+    void            (*Display_Update_Seconds_IT)(seconds_t seconds);
+    void            (*Display_Update_Minutes_IT)(minutes_t minutes);
+    void            (*Display_Update_Hours_IT)(hours_t hours);
+    void            (*Display_Update_Time_IT)(full_time_t full_time);
+    void            (*Display_Update_Date_IT)(date_t date);
+    void            (*Display_Update_Day_Of_Week_IT)(day_of_week_t dow);
+    void            (*Display_Update_Month_IT)(month_t month);
+    void            (*Display_Update_Year_IT)(year_t year, century_t century);
+    void            (*Display_Update_Full_Date_IT)(full_date_t full_date);
+    void            (*Display_Update_Datetime_IT)(full_datetime_t datetime);
+    void            (*Display_Update_Temperature_IT)(temperature_t temperature);
+    void            (*Display_Update_Alarm_IT)(hours_t hours, minutes_t minutes, uint8_t enabled);
+    void            (*Display_Update_Big_Time_IT)(full_time_t full_time);
 } Display_Driver_t;
 
 Display_Driver_t *get_display_driver();
 
+void Display_Clear_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Seconds_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Minutes_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Hours_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Time_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Date_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Day_Of_Week_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Month_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Year_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Full_Date_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Datetime_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Temperature_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Alarm_Complete_Callback(Display_Device_t *display_dev);
+void Display_Update_Big_Time_Complete_Callback(Display_Device_t *display_dev);
+void Display_Marquee_Step_Complete_Callback(Display_Device_t *display_dev);
+
 #ifdef LCD1602A
 #    include "lcd1602a_display_driver.h"
 #else
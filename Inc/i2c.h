@@ -4,13 +4,40 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "ring_buffer.h"
+
 typedef enum
 {
     I2C_CTRL_IDLE,
     I2C_CTRL_BUSY_TX,
-    I2C_CTRL_BUSY_RX
+    I2C_CTRL_BUSY_RX,
+    I2C_CTRL_BUSY_TX_DMA,
+    I2C_CTRL_BUSY_RX_DMA
 } I2C_Ctrl_Stage_t;
 
+/* Outcome of a transfer, returned by the blocking calls and handed to transaction callbacks */
+typedef enum
+{
+    I2C_OK,
+    I2C_ERR_NACK,                   /* address or data byte not acknowledged (AF) */
+    I2C_ERR_BUS,                    /* misplaced start or stop (BERR), or SDA still stuck after recovery */
+    I2C_ERR_ARB_LOST,               /* another master took the bus (ARLO) */
+    I2C_ERR_OVERRUN,                /* a received byte was lost (OVR), or the RX ring was full */
+    I2C_ERR_TIMEOUT,                /* a deadline passed, or SCL was held low too long */
+    I2C_ERR_DMA,                    /* transfer or direct mode error on the DMA stream */
+    I2C_ERR_BUSY,                   /* the queue, or the TX ring, had no room; the transfer never started */
+    I2C_ERR_CLOCK                   /* the peripheral clock is out of range; the peripheral is left disabled */
+} I2C_Status_t;
+
+/* The peripherals behind get_i2c_interface(). Each has its own queue, rings and interrupts. */
+typedef enum
+{
+    I2C_INSTANCE_1,
+    I2C_INSTANCE_2,
+    I2C_INSTANCE_3,
+    I2C_NUM_INSTANCES
+} I2C_Instance_t;
+
 typedef enum
 {
     I2C_DISABLE_SR,
@@ -21,55 +48,138 @@ typedef enum
 #define I2C_SPEED_SM                100000      /* 100kHz clock for standard mode */
 #define I2C_SPEED_FM                400000      /* 400kHz clock for fast mode */
 
+/* 2:1 or 16:9 for Tlow:Thigh clock signal (only applicable to fast mode) */
+#define I2C_FM_DUTY_2               0
+#define I2C_FM_DUTY_16_9            1
+
 /* Enable or disable acknowledge bit after data bit */
 #define I2C_ACK_EN                  1
 #define I2C_ACK_DI                  0
 
+#define I2C_QUEUE_SIZE              8           /* transactions waiting or in flight */
+#define I2C_STATS_LATENCY_BUCKETS   16
+
+/* One queued bus transaction: an optional write, then an optional read from the same slave behind a repeated
+ * start. A NULL buffer moves that phase through the TX or RX ring a byte per interrupt; the ring bytes for a
+ * write must already be in the TX ring when it is queued. A non-NULL buffer is moved by DMA in place and must
+ * stay valid until the callback. repeat_start applies to the end of the transaction, leaving the bus held
+ * for whatever is queued next. The callback runs in interrupt context once the transaction is off the bus,
+ * successfully or not. A failed ring-based read leaves whatever it had received in the RX ring. */
+typedef struct
+{
+    uint8_t                         slave_addr;
+    uint8_t                         *p_tx_buffer;
+    uint32_t                        tx_len;
+    uint8_t                         *p_rx_buffer;
+    uint32_t                        rx_len;
+    Repeated_Start_Enable_t         repeat_start;
+    void                            (*p_callback)(void *p_context, I2C_Status_t status);
+    void                            *p_context;
+} I2C_Transaction_t;
+
+/* Bus activity on one instance since it was initialized or its stats were reset. Queued transactions are
+ * timed from their start condition to their completion callback: latency_log2_us[n] counts those that took
+ * 2^n up to 2^(n+1) microseconds, bucket 0 also takes anything quicker and the last bucket anything slower.
+ * Blocking transfers are only counted, in blocking_transfers and the failure counts. */
 typedef struct
 {
-    void                            (*Initialize)();
-    void                            (*Read_Bytes)(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
+    uint32_t                        transactions;   /* queued ones retired, successfully or not */
+    uint32_t                        blocking_transfers;
+    uint32_t                        tx_bytes;       /* written by successful queued transactions */
+    uint32_t                        rx_bytes;       /* and read by them */
+    uint32_t                        nacks;
+    uint32_t                        errors;         /* every other failure */
+    uint32_t                        ev_irqs;        /* interrupt entries */
+    uint32_t                        er_irqs;
+    uint32_t                        dma_irqs;
+    uint32_t                        latency_max_us;
+    uint32_t                        latency_log2_us[I2C_STATS_LATENCY_BUCKETS];
+} I2C_Stats_t;
+
+typedef struct
+{
+    /* Initialize, Set_Speed and Clock_Changed return I2C_ERR_CLOCK if the peripheral cannot run from its clock */
+    I2C_Status_t                    (*Initialize)();
+    /* The blocking calls give up after I2C_TIMEOUT_US without progress on any one step */
+    I2C_Status_t                    (*Read_Bytes)(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
     void                            (*Read_Bytes_IT)(uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
-    void                            (*Write_Bytes)(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
+    I2C_Status_t                    (*Write_Bytes)(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
     void                            (*Write_Bytes_IT)(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
+    /* DMA transfers move the data bytes without an interrupt each. The buffer is used in place, so it must
+     * stay valid until the completion callback; received bytes land in it rather than in the RX ring. */
+    void                            (*Read_Bytes_DMA)(uint8_t *p_rx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
+    void                            (*Write_Bytes_DMA)(uint8_t *p_tx_buffer, uint32_t len, uint8_t slave_addr, uint8_t repeat_start);
+    /* Register read in one go: write, repeated start, read into the RX ring, stop. Reports only through
+     * I2C_Read_Complete_Callback, or I2C_Error_Callback. */
+    void                            (*Write_Read_IT)(uint8_t *p_tx_buffer, uint32_t tx_len, uint32_t rx_len, uint8_t slave_addr);
+    /* Copies the descriptor into the queue and returns 1, or returns 0 if the queue is full. The _IT and _DMA
+     * calls above queue a transaction each too, so they no longer need the bus to be idle. One that finds no
+     * room is answered at once, from the calling context, with I2C_Error_Callback and I2C_ERR_BUSY. */
+    uint8_t                         (*Queue_Transaction)(const I2C_Transaction_t *p_txn);
+    /* Any SCL rate up to I2C_SPEED_FM; fast mode timing above I2C_SPEED_SM. Waits for the queue to drain. */
+    I2C_Status_t                    (*Set_Speed)(uint32_t clock_speed, uint8_t fm_duty_cycle);
+    /* To be called after the system clock tree changes, so SCL is re-timed from the new APB1 clock. The core
+     * timebase its deadlines are counted in is re-read first. */
+    I2C_Status_t                    (*Clock_Changed)();
+    /* Aborts the transaction on the bus if it has overrun its deadline. Stalls raise no interrupt, so this
+     * needs calling from an idle loop or a periodic tick. It also runs any bus recovery an abort has asked for,
+     * so it must not be called from an interrupt; the queue waits behind that recovery. */
+    void                            (*Check_Timeout)();
+    /* Clocks SCL until a slave stuck mid-byte releases SDA, then sends a stop */
+    I2C_Status_t                    (*Recover_Bus)();
+    /* A consistent copy of the counters, taken with the interrupts masked */
+    void                            (*Get_Stats)(I2C_Stats_t *p_stats);
+    void                            (*Reset_Stats)();
     void                            (*Deinitialize)();
 } I2C_Interface_t;
 
 typedef struct
 {
+    I2C_Instance_t                  instance;       /* tells the shared weak callbacks which bus they are for */
     uint32_t                        clock_speed;
+    uint8_t                         fm_duty_cycle;
     uint8_t                         own_address;
-    uint8_t                         *p_tx_buffer;
-    uint8_t                         tx_ring_buffer_write_ptr;
-    uint8_t                         tx_ring_buffer_read_ptr;
-    uint8_t                         *p_rx_buffer;
-    uint8_t                         rx_ring_buffer_write_ptr;
-    uint8_t                         rx_ring_buffer_read_ptr;
+    Ring_Buffer_t                   tx_ring;        /* filled by the _IT calls, drained by the event ISR */
+    Ring_Buffer_t                   rx_ring;        /* filled by the event ISR, drained by the application */
     uint32_t                        tx_len;
     uint32_t                        rx_len;
     uint32_t                        rx_size;
-    I2C_Ctrl_Stage_t                control_stage;
+    volatile I2C_Ctrl_Stage_t       control_stage;
     uint8_t                         slave_addr;
     Repeated_Start_Enable_t         repeat_start;
     uint8_t                         ack_ctrl;
+    I2C_Transaction_t               txn_queue[I2C_QUEUE_SIZE];      /* head is the one on the bus */
+    uint8_t                         txn_queue_head;
+    uint8_t                         txn_queue_count;
+    uint32_t                        txn_start_cycles;               /* timebase reading when the head started */
+    uint32_t                        txn_budget_cycles;              /* and how long it may take */
+    volatile uint8_t                recovery_pending;               /* set by an abort, run from thread context */
+    I2C_Stats_t                     stats;
 } I2C_Device_t;
 
+/* Ring sizes must be powers of two */
 #define TX_RING_BUFFER_SIZE         256
 #define RX_RING_BUFFER_SIZE         256
 
-/* The I2C device which implements the I2C interface must implement a TX and RX ring buffer */
-uint8_t *I2C_RX_Ring_Buffer_Read(I2C_Device_t *p_i2c_dev, size_t num_bytes);
-void I2C_RX_Ring_Buffer_Write(I2C_Device_t *p_i2c_dev, uint8_t *p_src, size_t num_bytes);
-uint8_t *I2C_TX_Ring_Buffer_Read(I2C_Device_t *p_i2c_dev, size_t num_bytes);
-void I2C_TX_Ring_Buffer_Write(I2C_Device_t *p_i2c_dev, uint8_t *p_src, size_t num_bytes);
+/* The I2C device which implements the I2C interface must provide a TX and RX ring. Bytes received by the
+ * ring-based reads are taken straight out of rx_ring, with Ring_Buffer_Peek() and Ring_Buffer_Commit(), from
+ * I2C_Read_Complete_Callback or later. */
 
 /* These callbacks are called at the driver level, for whichever device driver is ipmlementing
  * this I2C interface. */
 void I2C_Write_Complete_Callback(I2C_Device_t *p_i2c_dev);
 void I2C_Read_Complete_Callback(I2C_Device_t *p_i2c_dev);
+/* Replaces the complete callback when an _IT or _DMA call fails */
+void I2C_Error_Callback(I2C_Device_t *p_i2c_dev, I2C_Status_t status);
+
+const char *I2C_Status_To_String(I2C_Status_t status);
 
-void I2C_Error_Handler();
+/* Shared by the interface implementations to keep their I2C_Stats_t */
+void I2C_Stats_Record(I2C_Stats_t *p_stats, const I2C_Transaction_t *p_txn, I2C_Status_t status, uint32_t latency_us);
+void I2C_Stats_Record_Blocking(I2C_Stats_t *p_stats, I2C_Status_t status);
+/* Formats the counters and the non-empty latency buckets through printf, and so through _write */
+void I2C_Print_Stats(I2C_Instance_t instance, const I2C_Stats_t *p_stats);
 
-I2C_Interface_t *get_i2c_interface();
+I2C_Interface_t *get_i2c_interface(I2C_Instance_t instance);
 
 #endif /* I2C_H_ */
@@ -0,0 +1,43 @@
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdint.h>
+
+/* Single-producer, single-consumer byte ring. Only the producer moves head and only the consumer moves tail;
+ * each side publishes its index with a release store and reads the other's with an acquire load, so an ISR on
+ * one side and thread code on the other need no lock. The indices run free and are masked on access, which
+ * needs a power-of-two size and lets every byte of the storage be used. */
+typedef struct
+{
+    uint8_t                         *p_storage;
+    uint32_t                        mask;
+    uint32_t                        head;
+    uint32_t                        tail;
+} Ring_Buffer_t;
+
+/* A run of ring bytes as at most two contiguous slices; the second is empty unless the run wraps */
+typedef struct
+{
+    uint8_t                         *p_slice[2];
+    uint32_t                        len[2];
+} Ring_Buffer_Span_t;
+
+uint8_t Ring_Buffer_Init(Ring_Buffer_t *p_ring, uint8_t *p_storage, uint32_t size);
+uint32_t Ring_Buffer_Count(const Ring_Buffer_t *p_ring);
+uint32_t Ring_Buffer_Space(const Ring_Buffer_t *p_ring);
+
+/* Producer side. Write copies all len bytes or none. Reserve/Publish let the producer fill the free space in
+ * place, e.g. from a peripheral, and only makes it visible to the consumer once Publish is called. */
+uint8_t Ring_Buffer_Write(Ring_Buffer_t *p_ring, const uint8_t *p_src, uint32_t len);
+uint32_t Ring_Buffer_Reserve(const Ring_Buffer_t *p_ring, Ring_Buffer_Span_t *p_span, uint32_t len);
+void Ring_Buffer_Publish(Ring_Buffer_t *p_ring, uint32_t len);
+
+/* Consumer side. Peek hands out up to len unread bytes in place; they stay valid until Commit releases them
+ * back to the producer. Read is the copying form of the two. */
+uint32_t Ring_Buffer_Peek(const Ring_Buffer_t *p_ring, Ring_Buffer_Span_t *p_span, uint32_t len);
+void Ring_Buffer_Commit(Ring_Buffer_t *p_ring, uint32_t len);
+uint32_t Ring_Buffer_Read(Ring_Buffer_t *p_ring, uint8_t *p_dst, uint32_t len);
+
+uint8_t Ring_Buffer_Span_Get(const Ring_Buffer_Span_t *p_span, uint32_t index);
+
+#endif /* RING_BUFFER_H_ */
@@ -85,4 +85,27 @@ typedef struct
     full_time_t         time;
 } full_datetime_t;
 
+/* How much of the time an alarm has to match. Each mode matches everything the one before it does, plus one
+ * more unit; the day and the date are alternatives at the top. */
+typedef enum
+{
+    ALARM_MATCH_EVERY_SECOND,
+    ALARM_MATCH_EVERY_MINUTE,       /* as each minute begins */
+    ALARM_MATCH_SECONDS,
+    ALARM_MATCH_MINUTES,
+    ALARM_MATCH_HOURS,
+    ALARM_MATCH_DATE,
+    ALARM_MATCH_DAY_OF_WEEK
+} alarm_match_t;
+
+typedef struct
+{
+    alarm_match_t       match;
+    seconds_t           seconds;
+    minutes_t           minutes;
+    hours_t             hours;
+    date_t              date;           /* only for ALARM_MATCH_DATE */
+    day_of_week_t       day_of_week;    /* only for ALARM_MATCH_DAY_OF_WEEK */
+} alarm_t;
+
 #endif /* TIME_H_ */
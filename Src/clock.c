@@ -120,3 +120,23 @@ __weak void Clock_Set_Datetime_Complete_Callback(Clock_Device_t *clock_dev)
 {
     /* implemented in application code */
 }
+
+__weak void Clock_Set_Alarm_Complete_Callback(Clock_Device_t *clock_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Clock_Alarm_Callback(Clock_Device_t *clock_dev, Clock_Alarm_t alarm)
+{
+    /* implemented in application code */
+}
+
+__weak void Clock_Tick_Callback(Clock_Device_t *clock_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Clock_Error_Callback(Clock_Device_t *clock_dev)
+{
+    /* implemented in application code */
+}
@@ -0,0 +1,406 @@
+#include <stddef.h>
+
+#include "clock_cache.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void Clock_Cache_Initialize(Clock_Device_t *clock_dev);
+static full_datetime_t Clock_Cache_Get_Full_Datetime(void);
+static void Clock_Cache_Get_Datetime_IT(void);
+static void Clock_Cache_Set_Full_Datetime(full_datetime_t full_datetime);
+static void Clock_Cache_Set_Full_Datetime_IT(full_datetime_t full_datetime);
+static void Clock_Cache_Set_Alarm(Clock_Alarm_t alarm, alarm_t alarm_time);
+static void Clock_Cache_Set_Alarm_IT(Clock_Alarm_t alarm, alarm_t alarm_time);
+static alarm_t Clock_Cache_Get_Alarm(Clock_Alarm_t alarm);
+static void Clock_Cache_Clear_Alarm(Clock_Alarm_t alarm);
+
+static full_datetime_t Clock_Cache_Snapshot(void);
+static void Clock_Cache_Store(const full_datetime_t *p_datetime, uint8_t restart_tick);
+static void Clock_Cache_Restart_Tick(void);
+static void Clock_Cache_Advance(full_datetime_t *p_datetime);
+static uint8_t Clock_Cache_Advance_Hour(hours_t *p_hours);
+static uint8_t Clock_Cache_Days_In_Month(month_t month, year_t year);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+#define CLOCK_CACHE_SECS_PER_MIN            60
+#define CLOCK_CACHE_MINS_PER_HOUR           60
+#define CLOCK_CACHE_HOURS_PER_DAY           24
+#define CLOCK_CACHE_DAYS_PER_WEEK           7
+#define CLOCK_CACHE_YEARS_PER_CENTURY       100
+#define CLOCK_CACHE_RESYNC_ATTEMPTS         3
+
+static Clock_Cache_Handle_t clock_cache_handle = {
+        .resync_period_s = CLOCK_CACHE_DEFAULT_RESYNC_S,
+};
+
+/* A blocking getter and its _IT twin, both answered from the copy. The _IT one sets only its own part of the
+ * device, as the chip's driver does, before calling back. */
+#define CLOCK_CACHE_DEFINE_GETTER(name, type, field)                                                        \
+static type Clock_Cache_Get_##name(void)                                                                    \
+{                                                                                                           \
+    return Clock_Cache_Snapshot().field;                                                                    \
+}                                                                                                           \
+                                                                                                            \
+static void Clock_Cache_Get_##name##_IT(void)                                                               \
+{                                                                                                           \
+    clock_cache_handle.clock_dev->field = Clock_Cache_Snapshot().field;                                     \
+    Clock_Get_##name##_Complete_Callback(clock_cache_handle.clock_dev);                                     \
+}
+
+/* A setter and its _IT twin: through to the chip, then into the copy. The _IT write is still queued when the
+ * copy changes, which is as close as the copy can get to when the chip will. */
+#define CLOCK_CACHE_DEFINE_SETTER(name, type, field, restart_tick)                                          \
+static void Clock_Cache_Set_##name(type value)                                                              \
+{                                                                                                           \
+    full_datetime_t datetime;                                                                               \
+                                                                                                            \
+    clock_cache_handle.p_backend->Set_##name(value);                                                        \
+    datetime = Clock_Cache_Snapshot();                                                                      \
+    datetime.field = value;                                                                                 \
+    Clock_Cache_Store(&datetime, restart_tick);                                                             \
+}                                                                                                           \
+                                                                                                            \
+static void Clock_Cache_Set_##name##_IT(type value)                                                         \
+{                                                                                                           \
+    full_datetime_t datetime;                                                                               \
+                                                                                                            \
+    clock_cache_handle.p_backend->Set_##name##_IT(value);                                                   \
+    datetime = Clock_Cache_Snapshot();                                                                      \
+    datetime.field = value;                                                                                 \
+    Clock_Cache_Store(&datetime, restart_tick);                                                             \
+}
+
+CLOCK_CACHE_DEFINE_GETTER(Seconds, seconds_t, time.seconds)
+CLOCK_CACHE_DEFINE_GETTER(Minutes, minutes_t, time.minutes)
+CLOCK_CACHE_DEFINE_GETTER(Hours, hours_t, time.hours)
+CLOCK_CACHE_DEFINE_GETTER(Day_Of_Week, day_of_week_t, date.day_of_week)
+CLOCK_CACHE_DEFINE_GETTER(Date, date_t, date.date)
+CLOCK_CACHE_DEFINE_GETTER(Month, month_t, date.month)
+CLOCK_CACHE_DEFINE_GETTER(Year, year_t, date.year)
+CLOCK_CACHE_DEFINE_GETTER(Century, century_t, date.century)
+CLOCK_CACHE_DEFINE_GETTER(Full_Date, full_date_t, date)
+CLOCK_CACHE_DEFINE_GETTER(Full_Time, full_time_t, time)
+
+/* Writing the seconds restarts the chip's own second, so the tick restarts with it */
+CLOCK_CACHE_DEFINE_SETTER(Seconds, seconds_t, time.seconds, 1)
+CLOCK_CACHE_DEFINE_SETTER(Minutes, minutes_t, time.minutes, 0)
+CLOCK_CACHE_DEFINE_SETTER(Hours, hours_t, time.hours, 0)
+CLOCK_CACHE_DEFINE_SETTER(Day_Of_Week, day_of_week_t, date.day_of_week, 0)
+CLOCK_CACHE_DEFINE_SETTER(Date, date_t, date.date, 0)
+CLOCK_CACHE_DEFINE_SETTER(Month, month_t, date.month, 0)
+CLOCK_CACHE_DEFINE_SETTER(Century, century_t, date.century, 0)
+CLOCK_CACHE_DEFINE_SETTER(Year, year_t, date.year, 0)
+CLOCK_CACHE_DEFINE_SETTER(Full_Date, full_date_t, date, 0)
+CLOCK_CACHE_DEFINE_SETTER(Full_Time, full_time_t, time, 1)
+
+static Clock_Driver_t clock_cache_driver = {
+        .Initialize              = Clock_Cache_Initialize,
+
+        .Get_Seconds             = Clock_Cache_Get_Seconds,
+        .Get_Minutes             = Clock_Cache_Get_Minutes,
+        .Get_Hours               = Clock_Cache_Get_Hours,
+        .Get_Day_Of_Week         = Clock_Cache_Get_Day_Of_Week,
+        .Get_Date                = Clock_Cache_Get_Date,
+        .Get_Month               = Clock_Cache_Get_Month,
+        .Get_Year                = Clock_Cache_Get_Year,
+        .Get_Century             = Clock_Cache_Get_Century,
+        .Get_Full_Date           = Clock_Cache_Get_Full_Date,
+        .Get_Full_Time           = Clock_Cache_Get_Full_Time,
+        .Get_Full_Datetime       = Clock_Cache_Get_Full_Datetime,
+
+        .Get_Seconds_IT          = Clock_Cache_Get_Seconds_IT,
+        .Get_Minutes_IT          = Clock_Cache_Get_Minutes_IT,
+        .Get_Hours_IT            = Clock_Cache_Get_Hours_IT,
+        .Get_Day_Of_Week_IT      = Clock_Cache_Get_Day_Of_Week_IT,
+        .Get_Date_IT             = Clock_Cache_Get_Date_IT,
+        .Get_Month_IT            = Clock_Cache_Get_Month_IT,
+        .Get_Year_IT             = Clock_Cache_Get_Year_IT,
+        .Get_Century_IT          = Clock_Cache_Get_Century_IT,
+        .Get_Full_Date_IT        = Clock_Cache_Get_Full_Date_IT,
+        .Get_Full_Time_IT        = Clock_Cache_Get_Full_Time_IT,
+        .Get_Datetime_IT         = Clock_Cache_Get_Datetime_IT,
+
+        .Set_Seconds             = Clock_Cache_Set_Seconds,
+        .Set_Minutes             = Clock_Cache_Set_Minutes,
+        .Set_Hours               = Clock_Cache_Set_Hours,
+        .Set_Day_Of_Week         = Clock_Cache_Set_Day_Of_Week,
+        .Set_Date                = Clock_Cache_Set_Date,
+        .Set_Month               = Clock_Cache_Set_Month,
+        .Set_Century             = Clock_Cache_Set_Century,
+        .Set_Year                = Clock_Cache_Set_Year,
+        .Set_Full_Date           = Clock_Cache_Set_Full_Date,
+        .Set_Full_Time           = Clock_Cache_Set_Full_Time,
+        .Set_Full_Datetime       = Clock_Cache_Set_Full_Datetime,
+
+        .Set_Seconds_IT          = Clock_Cache_Set_Seconds_IT,
+        .Set_Minutes_IT          = Clock_Cache_Set_Minutes_IT,
+        .Set_Hours_IT            = Clock_Cache_Set_Hours_IT,
+        .Set_Day_Of_Week_IT      = Clock_Cache_Set_Day_Of_Week_IT,
+        .Set_Date_IT             = Clock_Cache_Set_Date_IT,
+        .Set_Month_IT            = Clock_Cache_Set_Month_IT,
+        .Set_Year_IT             = Clock_Cache_Set_Year_IT,
+        .Set_Century_IT          = Clock_Cache_Set_Century_IT,
+        .Set_Full_Date_IT        = Clock_Cache_Set_Full_Date_IT,
+        .Set_Full_Time_IT        = Clock_Cache_Set_Full_Time_IT,
+        .Set_Full_Datetime_IT    = Clock_Cache_Set_Full_Datetime_IT,
+
+        .Set_Alarm               = Clock_Cache_Set_Alarm,
+        .Set_Alarm_IT            = Clock_Cache_Set_Alarm_IT,
+        .Get_Alarm               = Clock_Cache_Get_Alarm,
+        .Clear_Alarm             = Clock_Cache_Clear_Alarm
+};
+
+Clock_Driver_t *get_cached_clock_driver(void)
+{
+    return &clock_cache_driver;
+}
+
+void Clock_Cache_Set_Resync_Period(uint32_t resync_period_s)
+{
+    clock_cache_handle.resync_period_s = resync_period_s;
+}
+
+void Clock_Cache_Resync(void)
+{
+    Clock_Device_t *clock_dev = clock_cache_handle.clock_dev;
+    Clock_Ctrl_Stage_t stage = clock_dev->ctrl_stage;
+    full_datetime_t datetime;
+    uint32_t ticks;
+    uint32_t primask;
+    uint8_t stored = 0;
+
+    clock_dev->ctrl_stage = CLOCK_CTRL_BUSY_GETTING;
+    clock_cache_handle.resync_due = 0;
+    clock_cache_handle.secs_since_sync = 0;
+
+    /* A tick during the read may or may not be in what was read, so the read is only kept if none came */
+    for (uint8_t attempt = 0; attempt < CLOCK_CACHE_RESYNC_ATTEMPTS && !stored; attempt++)
+    {
+        ticks = clock_cache_handle.ticks;
+        datetime = clock_cache_handle.p_backend->Get_Full_Datetime();
+        if (clock_dev->ctrl_stage == CLOCK_CTRL_ERROR)
+            return;
+
+        primask = Critical_Section_Enter();
+        if (ticks == clock_cache_handle.ticks)
+        {
+            clock_cache_handle.datetime = datetime;
+            /* The chip's second is somewhere through when it is read; a fresh timer period is the best guess */
+            Clock_Cache_Restart_Tick();
+            stored = 1;
+        }
+        Critical_Section_Exit(primask);
+    }
+
+    /* A queued _IT call that completed meanwhile has already moved the stage on */
+    if (clock_dev->ctrl_stage == CLOCK_CTRL_BUSY_GETTING)
+        clock_dev->ctrl_stage = stage;
+    if (stored)
+        clock_cache_handle.resyncs++;
+}
+
+void Clock_Cache_Set_Tick_Source(Clock_Cache_Tick_Source_t tick_source)
+{
+    clock_cache_handle.tick_source = tick_source;
+
+    /* Before Initialize there is no timer yet; Initialize starts it if it is wanted */
+    if (clock_cache_handle.clock_dev == NULL)
+        return;
+    TIM_Stop(&clock_cache_handle.tim_handle);
+    Clock_Cache_Restart_Tick();
+}
+
+uint32_t Clock_Cache_Get_Resyncs(void)
+{
+    return clock_cache_handle.resyncs;
+}
+
+/* In the tick's interrupt. Reading the chip is left to the next getter, out of interrupt context. */
+void Clock_Cache_Tick(void)
+{
+    Clock_Cache_Advance(&clock_cache_handle.datetime);
+    clock_cache_handle.ticks++;
+
+    clock_cache_handle.secs_since_sync++;
+    if (clock_cache_handle.resync_period_s != 0
+            && clock_cache_handle.secs_since_sync >= clock_cache_handle.resync_period_s)
+    {
+        clock_cache_handle.resync_due = 1;
+    }
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void Clock_Cache_Initialize(Clock_Device_t *clock_dev)
+{
+    clock_cache_handle.p_backend = get_clock_driver();
+    clock_cache_handle.clock_dev = clock_dev;
+
+    clock_cache_handle.p_backend->Initialize(clock_dev);
+
+    clock_cache_handle.tim_handle.p_tim_x = CLOCK_CACHE_TIM;
+    clock_cache_handle.tim_handle.counter_freq_hz = CLOCK_CACHE_TIM_FREQ_HZ;
+    clock_cache_handle.tim_handle.period = CLOCK_CACHE_TIM_FREQ_HZ;
+    clock_cache_handle.tim_handle.irq_priority = CLOCK_CACHE_TIM_IRQ_PRIORITY;
+    clock_cache_handle.tim_handle.p_update_callback = Clock_Cache_Tick;
+    TIM_Init(&clock_cache_handle.tim_handle);
+
+    Clock_Cache_Resync();
+}
+
+static full_datetime_t Clock_Cache_Get_Full_Datetime(void)
+{
+    return Clock_Cache_Snapshot();
+}
+
+static void Clock_Cache_Get_Datetime_IT(void)
+{
+    full_datetime_t datetime = Clock_Cache_Snapshot();
+
+    clock_cache_handle.clock_dev->time = datetime.time;
+    clock_cache_handle.clock_dev->date = datetime.date;
+    Clock_Get_Datetime_Complete_Callback(clock_cache_handle.clock_dev);
+}
+
+static void Clock_Cache_Set_Full_Datetime(full_datetime_t full_datetime)
+{
+    clock_cache_handle.p_backend->Set_Full_Datetime(full_datetime);
+    Clock_Cache_Store(&full_datetime, 1);
+}
+
+static void Clock_Cache_Set_Full_Datetime_IT(full_datetime_t full_datetime)
+{
+    clock_cache_handle.p_backend->Set_Full_Datetime_IT(full_datetime);
+    Clock_Cache_Store(&full_datetime, 1);
+}
+
+/* Alarms live only in the chip, which does the matching */
+static void Clock_Cache_Set_Alarm(Clock_Alarm_t alarm, alarm_t alarm_time)
+{
+    clock_cache_handle.p_backend->Set_Alarm(alarm, alarm_time);
+}
+
+static void Clock_Cache_Set_Alarm_IT(Clock_Alarm_t alarm, alarm_t alarm_time)
+{
+    clock_cache_handle.p_backend->Set_Alarm_IT(alarm, alarm_time);
+}
+
+static alarm_t Clock_Cache_Get_Alarm(Clock_Alarm_t alarm)
+{
+    return clock_cache_handle.p_backend->Get_Alarm(alarm);
+}
+
+static void Clock_Cache_Clear_Alarm(Clock_Alarm_t alarm)
+{
+    clock_cache_handle.p_backend->Clear_Alarm(alarm);
+}
+
+/* The copy as of now, after a resync if one is due. Copied with the tick masked so it cannot tear. */
+static full_datetime_t Clock_Cache_Snapshot(void)
+{
+    full_datetime_t datetime;
+    uint32_t primask;
+
+    if (clock_cache_handle.resync_due)
+        Clock_Cache_Resync();
+
+    primask = Critical_Section_Enter();
+    datetime = clock_cache_handle.datetime;
+    Critical_Section_Exit(primask);
+
+    return datetime;
+}
+
+static void Clock_Cache_Store(const full_datetime_t *p_datetime, uint8_t restart_tick)
+{
+    uint32_t primask = Critical_Section_Enter();
+
+    clock_cache_handle.datetime = *p_datetime;
+    if (restart_tick)
+        Clock_Cache_Restart_Tick();
+    Critical_Section_Exit(primask);
+}
+
+/* Starts the timer's second afresh. An external tick follows the chip, which restarts its own second when
+ * the seconds are written. */
+static void Clock_Cache_Restart_Tick(void)
+{
+    if (clock_cache_handle.tick_source != CLOCK_CACHE_TICK_TIM)
+        return;
+
+    TIM_Stop(&clock_cache_handle.tim_handle);
+    TIM_Start(&clock_cache_handle.tim_handle);
+}
+
+/* The DS3231's counter chain: each unit carries into the next, the day of week runs 1-7 alongside the date */
+static void Clock_Cache_Advance(full_datetime_t *p_datetime)
+{
+    full_time_t *p_time = &p_datetime->time;
+    full_date_t *p_date = &p_datetime->date;
+
+    if (++p_time->seconds < CLOCK_CACHE_SECS_PER_MIN)
+        return;
+    p_time->seconds = 0;
+
+    if (++p_time->minutes < CLOCK_CACHE_MINS_PER_HOUR)
+        return;
+    p_time->minutes = 0;
+
+    if (!Clock_Cache_Advance_Hour(&p_time->hours))
+        return;
+
+    p_date->day_of_week = (p_date->day_of_week % CLOCK_CACHE_DAYS_PER_WEEK) + 1;
+    if (++p_date->date <= Clock_Cache_Days_In_Month(p_date->month, p_date->year))
+        return;
+    p_date->date = 1;
+
+    if (p_date->month < MONTH_DEC)
+    {
+        p_date->month++;
+        return;
+    }
+    p_date->month = MONTH_JAN;
+
+    if (++p_date->year < CLOCK_CACHE_YEARS_PER_CENTURY)
+        return;
+    p_date->year = 0;
+    p_date->century = (p_date->century == CENTURY_20TH) ? CENTURY_21ST : CENTURY_20TH;
+}
+
+/* Returns 1 when the hour passes midnight. In 12 hour mode 11 to 12 flips AM/PM and 12 to 1 does not. */
+static uint8_t Clock_Cache_Advance_Hour(hours_t *p_hours)
+{
+    if (p_hours->hour_format == HOUR_FORMAT_24_HOUR)
+    {
+        if (++p_hours->hour < CLOCK_CACHE_HOURS_PER_DAY)
+            return 0;
+        p_hours->hour = 0;
+        return 1;
+    }
+
+    if (p_hours->hour == 12)
+    {
+        p_hours->hour = 1;
+        return 0;
+    }
+    if (++p_hours->hour < 12)
+        return 0;
+
+    if (p_hours->am_pm == AM_PM_AM)
+    {
+        p_hours->am_pm = AM_PM_PM;
+        return 0;
+    }
+    p_hours->am_pm = AM_PM_AM;
+    return 1;
+}
+
+/* Every year divisible by four is a leap year, as the chip counts them */
+static uint8_t Clock_Cache_Days_In_Month(month_t month, year_t year)
+{
+    static const uint8_t DAYS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    if (month < MONTH_JAN || month > MONTH_DEC)
+        return DAYS[0];
+    if (month == MONTH_FEB && (year % 4) == 0)
+        return 29;
+    return DAYS[month - MONTH_JAN];
+}
@@ -1 +1,76 @@
 #include "display.h"
+
+__weak void Display_Clear_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Seconds_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Minutes_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Hours_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Time_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Date_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Day_Of_Week_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Month_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Year_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Full_Date_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Datetime_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Temperature_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Alarm_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Update_Big_Time_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
+
+__weak void Display_Marquee_Step_Complete_Callback(Display_Device_t *display_dev)
+{
+    /* implemented in application code */
+}
@@ -1,70 +1,103 @@
+#include <stdio.h>
+
 #include "i2c.h"
 
-uint8_t ring_buffer_output_buffer[256];
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static void I2C_Stats_Count_Failure(I2C_Stats_t *p_stats, I2C_Status_t status);
+static uint8_t I2C_Stats_Latency_Bucket(uint32_t latency_us);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
 
-void I2C_Error_Handler()
+const char *I2C_Status_To_String(I2C_Status_t status)
 {
-    while(1){}
+    switch (status)
+    {
+        case I2C_OK:            return "ok";
+        case I2C_ERR_NACK:      return "nack";
+        case I2C_ERR_BUS:       return "bus error";
+        case I2C_ERR_ARB_LOST:  return "arbitration lost";
+        case I2C_ERR_OVERRUN:   return "overrun";
+        case I2C_ERR_TIMEOUT:   return "timeout";
+        case I2C_ERR_DMA:       return "dma error";
+        case I2C_ERR_BUSY:      return "busy";
+        case I2C_ERR_CLOCK:     return "clock out of range";
+        default:                return "unknown";
+    }
 }
 
-uint8_t *I2C_RX_Ring_Buffer_Read(I2C_Device_t *p_i2c_dev, size_t num_bytes)
+/* Called as a queued transaction retires, from interrupt context or with interrupts masked */
+void I2C_Stats_Record(I2C_Stats_t *p_stats, const I2C_Transaction_t *p_txn, I2C_Status_t status, uint32_t latency_us)
 {
-    uint8_t *out_buffer_start = ring_buffer_output_buffer;
-    for (int i = 0; i < num_bytes; i++)
+    p_stats->transactions++;
+    p_stats->latency_log2_us[I2C_Stats_Latency_Bucket(latency_us)]++;
+    if (latency_us > p_stats->latency_max_us)
+        p_stats->latency_max_us = latency_us;
+
+    if (status != I2C_OK)
     {
-        *out_buffer_start = p_i2c_dev->p_rx_buffer[p_i2c_dev->rx_ring_buffer_read_ptr];
-        p_i2c_dev->rx_ring_buffer_read_ptr++;
-        p_i2c_dev->rx_ring_buffer_read_ptr %= RX_RING_BUFFER_SIZE;
-        out_buffer_start++;
+        I2C_Stats_Count_Failure(p_stats, status);
+        return;
     }
+    p_stats->tx_bytes += p_txn->tx_len;
+    p_stats->rx_bytes += p_txn->rx_len;
+}
 
-    return ring_buffer_output_buffer;
+void I2C_Stats_Record_Blocking(I2C_Stats_t *p_stats, I2C_Status_t status)
+{
+    p_stats->blocking_transfers++;
+    if (status != I2C_OK)
+        I2C_Stats_Count_Failure(p_stats, status);
 }
 
-void I2C_RX_Ring_Buffer_Write(I2C_Device_t *p_i2c_dev, uint8_t *p_src, size_t num_bytes)
+/* Integer formatting only, since newlib-nano's printf leaves floats out */
+void I2C_Print_Stats(I2C_Instance_t instance, const I2C_Stats_t *p_stats)
 {
-    for (int i = 0; i < num_bytes; i++)
+    unsigned long irqs = (unsigned long)p_stats->ev_irqs + p_stats->er_irqs + p_stats->dma_irqs;
+    unsigned long irqs_per_txn_x10 = p_stats->transactions ? (irqs * 10) / p_stats->transactions : 0;
+
+    printf("I2C%u: %lu txns, %lu blocking, %lu B out, %lu B in, %lu nacks, %lu errors\n",
+           (unsigned int) instance + 1,
+           (unsigned long) p_stats->transactions,
+           (unsigned long) p_stats->blocking_transfers,
+           (unsigned long) p_stats->tx_bytes,
+           (unsigned long) p_stats->rx_bytes,
+           (unsigned long) p_stats->nacks,
+           (unsigned long) p_stats->errors);
+    printf("  irqs: %lu ev, %lu er, %lu dma, %lu.%lu per txn\n",
+           (unsigned long) p_stats->ev_irqs,
+           (unsigned long) p_stats->er_irqs,
+           (unsigned long) p_stats->dma_irqs,
+           irqs_per_txn_x10 / 10, irqs_per_txn_x10 % 10);
+    printf("  latency us: max %lu\n", (unsigned long) p_stats->latency_max_us);
+
+    for (uint8_t i = 0; i < I2C_STATS_LATENCY_BUCKETS; i++)
     {
-        p_i2c_dev->p_rx_buffer[p_i2c_dev->rx_ring_buffer_write_ptr] = *p_src;
-        p_i2c_dev->rx_ring_buffer_write_ptr++;
-        p_i2c_dev->rx_ring_buffer_write_ptr %= TX_RING_BUFFER_SIZE;
+        if (p_stats->latency_log2_us[i] == 0)
+            continue;
 
-        if (p_i2c_dev->rx_ring_buffer_write_ptr == p_i2c_dev->rx_ring_buffer_read_ptr)
-        {
-            /* Write pointer has lapped read pointer - ring buffer overflow */
-            I2C_Error_Handler();
-        }
-        p_src++;
+        if (i == I2C_STATS_LATENCY_BUCKETS - 1)
+            printf("    >= %6lu: %lu\n", 1UL << i, (unsigned long) p_stats->latency_log2_us[i]);
+        else
+            printf("    < %7lu: %lu\n", 2UL << i, (unsigned long) p_stats->latency_log2_us[i]);
     }
 }
 
-uint8_t *I2C_TX_Ring_Buffer_Read(I2C_Device_t *p_i2c_dev, size_t num_bytes)
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static void I2C_Stats_Count_Failure(I2C_Stats_t *p_stats, I2C_Status_t status)
 {
-    uint8_t *out_buffer_start = ring_buffer_output_buffer;
-    for (int i = 0; i < num_bytes; i++)
-    {
-        *out_buffer_start = p_i2c_dev->p_tx_buffer[p_i2c_dev->tx_ring_buffer_read_ptr];
-        p_i2c_dev->tx_ring_buffer_read_ptr++;
-        p_i2c_dev->tx_ring_buffer_read_ptr %= TX_RING_BUFFER_SIZE;
-        out_buffer_start++;
-    }
-
-    return ring_buffer_output_buffer;
+    if (status == I2C_ERR_NACK)
+        p_stats->nacks++;
+    else
+        p_stats->errors++;
 }
 
-void I2C_TX_Ring_Buffer_Write(I2C_Device_t *p_i2c_dev, uint8_t *p_src, size_t num_bytes)
+/* floor(log2(latency_us)), with 0 and 1 both in bucket 0 */
+static uint8_t I2C_Stats_Latency_Bucket(uint32_t latency_us)
 {
-    for (int i = 0; i < num_bytes; i++)
-    {
-        p_i2c_dev->p_tx_buffer[p_i2c_dev->tx_ring_buffer_write_ptr] = *p_src;
-        p_i2c_dev->tx_ring_buffer_write_ptr++;
-        p_i2c_dev->tx_ring_buffer_write_ptr %= TX_RING_BUFFER_SIZE;
+    uint8_t bucket = 0;
 
-        if (p_i2c_dev->tx_ring_buffer_write_ptr == p_i2c_dev->tx_ring_buffer_read_ptr)
-        {
-            /* Write pointer has lapped read pointer - ring buffer overflow */
-            I2C_Error_Handler();
-        }
-        p_src++;
+    while ((latency_us >>= 1) != 0 && bucket < I2C_STATS_LATENCY_BUCKETS - 1)
+    {
+        bucket++;
     }
+    return bucket;
 }
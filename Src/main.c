@@ -1,10 +1,11 @@
 #include <stdio.h>
 
 #include "clock.h"
+#include "clock_cache.h"
 #include "display.h"
+#include "i2c.h"
 #include "main.h"
 
-
 #if !defined(__SOFT_FP__) && defined(__ARM_FP)
   #warning "FPU is not initialized, but the project is compiling for an FPU. Please initialize the FPU before use."
 #endif
@@ -13,9 +14,11 @@
  * The interface implementation is defined in the Drivers directory.
  * Implementation is selected by macro definition. For example, if DS3231
  * is defined, the clock driver uses DS32312 back-end. If LCD1602A is defined,
- * the display driver uses LCD1602A back-end.*/
+ * the display driver uses LCD1602A back-end. The clock is read through the
+ * cache in Inc/clock_cache.h, which keeps the time in RAM in front of it.*/
 Clock_Driver_t          *app_clock_driver;
 Display_Driver_t        *app_display_driver;
+I2C_Interface_t         *i2c_interface;
 
 /* These devices are how the user keeps track of the clock and display objects
  * in the application code. These are attached to handles which are managed
@@ -27,15 +30,26 @@ Display_Device_t        lcd1602a_dev = {
         .ctrl_stage = DISPLAY_CTRL_INIT,
 };
 
+#ifdef DS3231_SQW_WIRED
+static volatile uint8_t clock_ticked;
+#endif
+
 int main(void)
 {
     /* Specific driver implementations must be retrieved then initialized. */
-    app_clock_driver = get_clock_driver();
+    app_clock_driver = get_cached_clock_driver();
     app_display_driver = get_display_driver();
 
+#ifdef DS3231_SQW_WIRED
+    /* The chip's own second ticks the cache, so the display turns over with it */
+    Clock_Cache_Set_Tick_Source(CLOCK_CACHE_TICK_EXTERNAL);
+#endif
     app_clock_driver->Initialize(&ds3231_dev);
     ds3231_dev.ctrl_stage = CLOCK_CTRL_IDLE;
 
+    /* Nothing else watches the queued I2C transfers, so the wait loops below poll their deadlines */
+    i2c_interface = get_i2c_interface(DS3231_I2C_INSTANCE);
+
     app_display_driver->Display_Initialize(&lcd1602a_dev);
     lcd1602a_dev.ctrl_stage = DISPLAY_CTRL_IDLE;
 
@@ -56,23 +70,58 @@ int main(void)
             .minutes =      59,
             .seconds =      40
     };
+    I2C_Stats_t i2c_stats;
+    full_datetime_t now;
+#ifndef DS3231_SQW_WIRED
+    seconds_t shown_seconds;
+#endif
+
     ds3231_dev.date = date;
     ds3231_dev.time = time;
 
 
     ds3231_dev.ctrl_stage = CLOCK_CTRL_BUSY_SETTING;
     app_clock_driver->Set_Full_Datetime_IT(clock_device_get_datetime(&ds3231_dev));
-    while (ds3231_dev.ctrl_stage == CLOCK_CTRL_BUSY_SETTING) {}
+    while (ds3231_dev.ctrl_stage == CLOCK_CTRL_BUSY_SETTING)
+    {
+        i2c_interface->Check_Timeout();
+    }
 
     app_display_driver->Display_Update_Datetime(clock_device_get_datetime(&ds3231_dev));
+#ifndef DS3231_SQW_WIRED
+    shown_seconds = ds3231_dev.time.seconds;
+#endif
 
     for(;;)
     {
-        ds3231_dev.ctrl_stage = CLOCK_CTRL_BUSY_GETTING;
-        app_clock_driver->Get_Datetime_IT();
-        while (ds3231_dev.ctrl_stage == CLOCK_CTRL_BUSY_GETTING)
+#ifdef DS3231_SQW_WIRED
+        /* Nothing to do until the chip's next second */
+        if (!clock_ticked)
         {
             /* user code could go here! */
+            i2c_interface->Check_Timeout();
+            continue;
+        }
+        clock_ticked = 0;
+        now = app_clock_driver->Get_Full_Datetime();
+#else
+        /* From RAM; the bus is only used when the cache resyncs */
+        now = app_clock_driver->Get_Full_Datetime();
+        if (now.time.seconds == shown_seconds)
+        {
+            /* user code could go here! */
+            i2c_interface->Check_Timeout();
+            continue;
+        }
+        shown_seconds = now.time.seconds;
+#endif
+        app_display_driver->Display_Update_Datetime_IT(now);
+
+        /* Once a minute, show how little the clock now uses the bus */
+        if (now.time.seconds == 0)
+        {
+            i2c_interface->Get_Stats(&i2c_stats);
+            I2C_Print_Stats(DS3231_I2C_INSTANCE, &i2c_stats);
         }
     }
 }
@@ -82,32 +131,32 @@ int main(void)
  * has an associated callback which is called once the action is completed. */
 void Clock_Get_Seconds_Complete_Callback(Clock_Device_t *clock_dev)
 {
-    app_display_driver->Display_Update_Seconds(clock_dev->time.seconds);
+    app_display_driver->Display_Update_Seconds_IT(clock_dev->time.seconds);
 }
 
 void Clock_Get_Minutes_Complete_Callback(Clock_Device_t *clock_dev)
 {
-    app_display_driver->Display_Update_Minutes(clock_dev->time.minutes);
+    app_display_driver->Display_Update_Minutes_IT(clock_dev->time.minutes);
 }
 
 void Clock_Get_Hours_Complete_Callback(Clock_Device_t *clock_dev)
 {
-    app_display_driver->Display_Update_Hours(clock_dev->time.hours);
+    app_display_driver->Display_Update_Hours_IT(clock_dev->time.hours);
 }
 
 void Clock_Get_Day_Of_Week_Complete_Callback(Clock_Device_t *clock_dev)
 {
-    app_display_driver->Display_Update_Day_Of_Week(clock_dev->date.day_of_week);
+    app_display_driver->Display_Update_Day_Of_Week_IT(clock_dev->date.day_of_week);
 }
 
 void Clock_Get_Date_Complete_Callback(Clock_Device_t *clock_dev)
 {
-    app_display_driver->Display_Update_Date(clock_dev->date.date);
+    app_display_driver->Display_Update_Date_IT(clock_dev->date.date);
 }
 
 void Clock_Get_Month_Complete_Callback(Clock_Device_t *clock_dev)
 {
-    app_display_driver->Display_Update_Month(clock_dev->date.month);
+    app_display_driver->Display_Update_Month_IT(clock_dev->date.month);
 }
 
 void Clock_Get_Full_Time_Complete_Callback(Clock_Device_t *clock_dev)
@@ -117,7 +166,7 @@ void Clock_Get_Full_Time_Complete_Callback(Clock_Device_t *clock_dev)
             .minutes = clock_dev->time.minutes,
             .seconds = clock_dev->time.seconds
     };
-    app_display_driver->Display_Update_Time(full_time);
+    app_display_driver->Display_Update_Time_IT(full_time);
 }
 
 void Clock_Get_Datetime_Complete_Callback(Clock_Device_t *clock_dev)
@@ -138,10 +187,19 @@ void Clock_Get_Datetime_Complete_Callback(Clock_Device_t *clock_dev)
             .date = full_date,
             .time = full_time
     };
-    app_display_driver->Display_Update_Datetime(datetime);
+    app_display_driver->Display_Update_Datetime_IT(datetime);
     clock_dev->ctrl_stage = CLOCK_CTRL_IDLE;
 }
 
+#ifdef DS3231_SQW_WIRED
+/* The chip has just counted on a second; so does the cache */
+void Clock_Tick_Callback(Clock_Device_t *clock_dev)
+{
+    Clock_Cache_Tick();
+    clock_ticked = 1;
+}
+#endif
+
 void Clock_Set_Seconds_Complete_Callback(Clock_Device_t *clock_dev)
 {
     printf("Seconds Set: %u\n", (unsigned int) clock_dev->time.seconds);
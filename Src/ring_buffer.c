@@ -0,0 +1,126 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "ring_buffer.h"
+
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS START *****************/
+static uint32_t Ring_Buffer_Fill_Span(const Ring_Buffer_t *p_ring, Ring_Buffer_Span_t *p_span,
+                                      uint32_t start, uint32_t len);
+/*************** PRIVATE IMPLEMENTATION FUNCTION DECLARATIONS END *****************/
+
+/* Returns 0 and leaves the ring unusable if size is not a power of two */
+uint8_t Ring_Buffer_Init(Ring_Buffer_t *p_ring, uint8_t *p_storage, uint32_t size)
+{
+    p_ring->p_storage = NULL;
+    p_ring->mask = 0;
+    p_ring->head = 0;
+    p_ring->tail = 0;
+
+    if (p_storage == NULL || size == 0 || (size & (size - 1)) != 0)
+        return 0;
+
+    p_ring->p_storage = p_storage;
+    p_ring->mask = size - 1;
+    return 1;
+}
+
+uint32_t Ring_Buffer_Count(const Ring_Buffer_t *p_ring)
+{
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+
+    return head - tail;
+}
+
+uint32_t Ring_Buffer_Space(const Ring_Buffer_t *p_ring)
+{
+    if (p_ring->p_storage == NULL)
+        return 0;
+
+    return (p_ring->mask + 1) - Ring_Buffer_Count(p_ring);
+}
+
+/*************** PRODUCER *****************/
+uint8_t Ring_Buffer_Write(Ring_Buffer_t *p_ring, const uint8_t *p_src, uint32_t len)
+{
+    Ring_Buffer_Span_t span;
+
+    if (Ring_Buffer_Reserve(p_ring, &span, len) < len)
+        return 0;
+
+    memcpy(span.p_slice[0], p_src, span.len[0]);
+    memcpy(span.p_slice[1], p_src + span.len[0], span.len[1]);
+    Ring_Buffer_Publish(p_ring, len);
+    return 1;
+}
+
+/* Maps up to len bytes of free space. Returns how many were mapped, which is less than len when full. */
+uint32_t Ring_Buffer_Reserve(const Ring_Buffer_t *p_ring, Ring_Buffer_Span_t *p_span, uint32_t len)
+{
+    uint32_t space = Ring_Buffer_Space(p_ring);
+
+    if (len > space)
+        len = space;
+
+    return Ring_Buffer_Fill_Span(p_ring, p_span, p_ring->head, len);
+}
+
+/* The release store orders the data written into the reserved span before the new head */
+void Ring_Buffer_Publish(Ring_Buffer_t *p_ring, uint32_t len)
+{
+    __atomic_store_n(&p_ring->head, p_ring->head + len, __ATOMIC_RELEASE);
+}
+
+/*************** CONSUMER *****************/
+uint32_t Ring_Buffer_Peek(const Ring_Buffer_t *p_ring, Ring_Buffer_Span_t *p_span, uint32_t len)
+{
+    uint32_t count = Ring_Buffer_Count(p_ring);
+
+    if (len > count)
+        len = count;
+
+    return Ring_Buffer_Fill_Span(p_ring, p_span, p_ring->tail, len);
+}
+
+/* The release store keeps the reads of a peeked span ahead of handing its bytes back to the producer */
+void Ring_Buffer_Commit(Ring_Buffer_t *p_ring, uint32_t len)
+{
+    __atomic_store_n(&p_ring->tail, p_ring->tail + len, __ATOMIC_RELEASE);
+}
+
+uint32_t Ring_Buffer_Read(Ring_Buffer_t *p_ring, uint8_t *p_dst, uint32_t len)
+{
+    Ring_Buffer_Span_t span;
+
+    len = Ring_Buffer_Peek(p_ring, &span, len);
+    memcpy(p_dst, span.p_slice[0], span.len[0]);
+    memcpy(p_dst + span.len[0], span.p_slice[1], span.len[1]);
+    Ring_Buffer_Commit(p_ring, len);
+    return len;
+}
+
+/* Byte index counted across both slices, for decoding a span that may have wrapped */
+uint8_t Ring_Buffer_Span_Get(const Ring_Buffer_Span_t *p_span, uint32_t index)
+{
+    if (index < p_span->len[0])
+        return p_span->p_slice[0][index];
+
+    return p_span->p_slice[1][index - p_span->len[0]];
+}
+
+/*************** PRIVATE IMPLEMENTATION FUNCTIONS *****************/
+static uint32_t Ring_Buffer_Fill_Span(const Ring_Buffer_t *p_ring, Ring_Buffer_Span_t *p_span,
+                                      uint32_t start, uint32_t len)
+{
+    uint32_t offset = start & p_ring->mask;
+    uint32_t first = (p_ring->mask + 1) - offset;
+
+    if (first > len)
+        first = len;
+
+    p_span->p_slice[0] = p_ring->p_storage + offset;
+    p_span->len[0] = first;
+    p_span->p_slice[1] = p_ring->p_storage;
+    p_span->len[1] = len - first;
+    return len;
+}